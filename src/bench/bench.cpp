@@ -0,0 +1,176 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+	struct Entry {
+		const char* name;
+		Bench::Function fn;
+	};
+
+	// function-local so that registration from other translation units
+	// does not depend on static initialisation order
+	std::vector<Entry>& registry()
+	{
+		static std::vector<Entry> r;
+		return r;
+	}
+
+	struct Result {
+		const char* name;
+		Bench::State state;
+	};
+
+	std::string json_string(const std::string& s)
+	{
+		std::string r {"\""};
+		for (const char c : s) {
+			if (c == '"' || c == '\\')
+				r += '\\';
+			r += c;
+		}
+		return r + '"';
+	}
+
+	const char* compiler()
+	{
+#if defined(__clang__)
+		return "clang " __clang_version__;
+#elif defined(__GNUC__)
+		return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+		return "msvc";
+#else
+		return "unknown";
+#endif
+	}
+
+	// one object per benchmark, keyed by name, so that runs can be diffed
+	void write_json(std::ostream& out, const std::vector<Result>& results)
+	{
+		out << std::setprecision(10);
+		out << "{\n\t\"context\": {\n";
+		out << "\t\t\"compiler\": " << json_string(compiler()) << ",\n";
+#ifdef NDEBUG
+		out << "\t\t\"assertions\": false,\n";
+#else
+		out << "\t\t\"assertions\": true,\n";
+#endif
+		out << "\t\t\"hardware_threads\": " << std::thread::hardware_concurrency() << "\n";
+		out << "\t},\n\t\"benchmarks\": {";
+
+		for (std::size_t i = 0; i != results.size(); ++i) {
+			out << (i ? ",\n" : "\n") << "\t\t" << json_string(results[i].name) << ": {";
+			const auto& r = results[i].state.results();
+			for (std::size_t j = 0; j != r.size(); ++j) {
+				out << (j ? ",\n" : "\n") << "\t\t\t" << json_string(r[j].first) << ": ";
+				// JSON has no infinity or NaN
+				if (std::isfinite(r[j].second))
+					out << r[j].second;
+				else
+					out << "null";
+			}
+			out << "\n\t\t}";
+		}
+
+		out << "\n\t}\n}\n";
+	}
+}
+
+void Bench::State::report(std::string key, double value)
+{
+	result.emplace_back(std::move(key), value);
+}
+
+const std::vector<std::pair<std::string, double>>& Bench::State::results() const
+{
+	return result;
+}
+
+bool Bench::register_benchmark(const char* name, Function fn)
+{
+	registry().push_back({name, fn});
+	return true;
+}
+
+std::size_t Bench::peak_rss()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS pmc;
+	GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+	return pmc.PeakWorkingSetSize;
+#else
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+	return usage.ru_maxrss; // bytes
+#else
+	return static_cast<std::size_t>(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+#endif
+}
+
+std::vector<std::size_t> Bench::thread_counts()
+{
+	const std::size_t n {std::max(std::thread::hardware_concurrency(), 1u)};
+	std::vector<std::size_t> counts;
+	for (std::size_t t = 1; t < n; t *= 2)
+		counts.push_back(t);
+	counts.push_back(n);
+	return counts;
+}
+
+// usage: Glare_bench [filter] [--json file]
+// runs every benchmark whose name contains filter
+// with --json the results are also written to file, to track regressions
+int main(int argc, char* argv[])
+{
+	const char* filter {""};
+	const char* json {nullptr};
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+			json = argv[++i];
+		else
+			filter = argv[i];
+	}
+	std::cout << std::setprecision(10);
+
+	std::vector<Result> results;
+	for (const auto& x : registry()) {
+		if (!std::strstr(x.name, filter)) continue;
+
+		Bench::State state;
+		x.fn(state);
+
+		std::cout << x.name << '\n';
+		for (const auto& r : state.results())
+			std::cout << "    " << r.first << " = " << r.second << '\n';
+		std::cout.flush();
+
+		results.push_back({x.name, std::move(state)});
+	}
+
+	if (json) {
+		std::ofstream out {json};
+		write_json(out, results);
+		if (!out) {
+			std::cerr << "could not write " << json << '\n';
+			return 1;
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#ifndef GLARE_BENCH_BENCH_HPP
+#define GLARE_BENCH_BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// minimal benchmark harness, benchmarks register themselves
+// with GLARE_BENCHMARK and are run by bench.cpp
+namespace Bench {
+	// collects the measurements a benchmark wants printed
+	class State {
+	public:
+		void report(std::string key, double value);
+		const std::vector<std::pair<std::string, double>>& results() const;
+	private:
+		std::vector<std::pair<std::string, double>> result;
+	};
+
+	class Timer {
+		using Clock = std::chrono::steady_clock;
+	public:
+		Timer() :start {Clock::now()} {}
+
+		double seconds() const
+		{
+			return std::chrono::duration<double>(Clock::now() - start).count();
+		}
+	private:
+		Clock::time_point start;
+	};
+
+	using Function = void (*)(State&);
+
+	bool register_benchmark(const char* name, Function);
+
+	// peak resident set size of the process in bytes
+	std::size_t peak_rss();
+
+	// 1, 2, 4, ... up to the number of hardware threads, which is always included
+	std::vector<std::size_t> thread_counts();
+
+	// stop the optimiser from discarding a value
+	template<typename T>
+	inline void keep(const T& value)
+	{
+#if defined(_MSC_VER)
+		static volatile const void* sink;
+		sink = &value;
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+}
+
+#define GLARE_BENCHMARK(group, name) \
+	static void group##_##name(Bench::State&); \
+	[[maybe_unused]] static const bool group##_##name##_registered \
+		{Bench::register_benchmark(#group "." #name, group##_##name)}; \
+	static void group##_##name(Bench::State& state)
+
+#endif // !GLARE_BENCH_BENCH_HPP
@@ -0,0 +1,296 @@
+#include "bench.hpp"
+#include "../glare/slot_map.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// the same operations on Slot_map and the containers it replaces, swept
+// over element sizes and counts
+// each result is named operation_size_count, in nanoseconds per element
+namespace {
+	template<std::size_t Size>
+	struct Element {
+		std::uint32_t value[Size / sizeof(std::uint32_t)];
+	};
+
+	template<std::size_t Size>
+	Element<Size> make_element(std::size_t i)
+	{
+		Element<Size> e {};
+		e.value[0] = static_cast<std::uint32_t>(i);
+		return e;
+	}
+
+	constexpr std::size_t counts[] {1'000, 100'000, 1'000'000};
+	// combinations larger than this are skipped
+	constexpr std::size_t max_bytes {64u << 20};
+	// enough operations per measurement that small counts aren't all timer overhead
+	constexpr std::size_t min_operations {4'000'000};
+
+	template<typename T>
+	class Glare_adapter {
+		using Map = Glare::Slot_map<T>;
+	public:
+		using Handle = typename Map::Stable_index;
+
+		Handle add(const T& x) { return sm.add(x); }
+		void remove(Handle h) { sm.remove(h); }
+		const T& get(Handle h) const { return sm[typename Map::Stable_const_index {h}]; }
+
+		template<typename F>
+		void each(F f) const
+		{
+			for (const auto& x : sm.values())
+				f(x);
+		}
+	private:
+		Map sm;
+	};
+
+	// handles are positions, removal swaps the last element in, so a handle
+	// may end up pointing at another element, the lower bound on lookup cost
+	template<typename T>
+	class Vector_adapter {
+	public:
+		using Handle = std::size_t;
+
+		Handle add(const T& x)
+		{
+			v.push_back(x);
+			return v.size() - 1;
+		}
+		void remove(Handle h)
+		{
+			v[h % v.size()] = v.back();
+			v.pop_back();
+		}
+		const T& get(Handle h) const { return v[h % v.size()]; }
+
+		template<typename F>
+		void each(F f) const
+		{
+			for (const auto& x : v)
+				f(x);
+		}
+	private:
+		std::vector<T> v;
+	};
+
+	template<typename T>
+	class Unordered_map_adapter {
+	public:
+		using Handle = std::uint64_t;
+
+		Handle add(const T& x)
+		{
+			m.emplace(next, x);
+			return next++;
+		}
+		void remove(Handle h) { m.erase(h); }
+		const T& get(Handle h) const { return m.find(h)->second; }
+
+		template<typename F>
+		void each(F f) const
+		{
+			for (const auto& x : m)
+				f(x.second);
+		}
+	private:
+		std::unordered_map<std::uint64_t, T> m;
+		std::uint64_t next {0};
+	};
+
+	// the textbook slot map, values stay in their slots and iteration
+	// has to step over the empty ones
+	template<typename T>
+	class Baseline_adapter {
+	public:
+		struct Handle {
+			std::uint32_t index;
+			std::uint32_t generation;
+		};
+
+		Handle add(const T& x)
+		{
+			std::uint32_t i;
+			if (free.empty()) {
+				i = static_cast<std::uint32_t>(slots.size());
+				slots.push_back({x, 0, true});
+			} else {
+				i = free.back();
+				free.pop_back();
+				slots[i].value = x;
+				slots[i].occupied = true;
+			}
+			return {i, slots[i].generation};
+		}
+		void remove(Handle h)
+		{
+			auto& s = slots[h.index];
+			if (!s.occupied || s.generation != h.generation)
+				return;
+			s.occupied = false;
+			++s.generation;
+			free.push_back(h.index);
+		}
+		const T& get(Handle h) const
+		{
+			const auto& s = slots[h.index];
+			return s.occupied && s.generation == h.generation ? s.value : empty;
+		}
+
+		template<typename F>
+		void each(F f) const
+		{
+			for (const auto& s : slots)
+				if (s.occupied)
+					f(s.value);
+		}
+	private:
+		struct Slot {
+			T value;
+			std::uint32_t generation;
+			bool occupied;
+		};
+
+		std::vector<Slot> slots;
+		std::vector<std::uint32_t> free;
+		T empty {};
+	};
+
+	template<template<typename> class Adapter, std::size_t Size>
+	void sweep_size(Bench::State& state)
+	{
+		using T = Element<Size>;
+
+		for (const std::size_t count : counts) {
+			if (count * Size > max_bytes)
+				continue;
+
+			const std::size_t repeats {std::max<std::size_t>(1, min_operations / count)};
+			const std::string suffix {"_" + std::to_string(Size) + "B_" + std::to_string(count)};
+			double add {0};
+			double lookup {0};
+			double iterate {0};
+			double remove {0};
+
+			for (std::size_t r = 0; r != repeats; ++r) {
+				Adapter<T> c;
+				std::vector<typename Adapter<T>::Handle> handles;
+				handles.reserve(count);
+
+				Bench::Timer timer;
+				for (std::size_t i = 0; i != count; ++i)
+					handles.push_back(c.add(make_element<Size>(i)));
+				add += timer.seconds();
+
+				std::mt19937 rng {static_cast<std::uint32_t>(r)};
+				std::shuffle(handles.begin(), handles.end(), rng);
+
+				std::uint64_t sum {0};
+				timer = {};
+				for (const auto h : handles)
+					sum += c.get(h).value[0];
+				lookup += timer.seconds();
+
+				timer = {};
+				c.each([&sum](const T& x) { sum += x.value[0]; });
+				iterate += timer.seconds();
+
+				// a random half
+				timer = {};
+				for (std::size_t i = 0; i != count / 2; ++i)
+					c.remove(handles[i]);
+				remove += timer.seconds();
+
+				Bench::keep(sum);
+			}
+
+			const double n {static_cast<double>(count * repeats)};
+			state.report("add" + suffix, add * 1e9 / n);
+			state.report("lookup" + suffix, lookup * 1e9 / n);
+			state.report("iterate" + suffix, iterate * 1e9 / n);
+			state.report("remove" + suffix, remove * 2e9 / n);
+		}
+	}
+
+	template<template<typename> class Adapter>
+	void sweep(Bench::State& state)
+	{
+		sweep_size<Adapter, 4>(state);
+		sweep_size<Adapter, 16>(state);
+		sweep_size<Adapter, 64>(state);
+		sweep_size<Adapter, 256>(state);
+	}
+
+	// a twentieth of the elements despawned and as many spawned every frame,
+	// recorded with buffered_add and buffered_remove and applied by clean_buffers
+	template<std::size_t Size>
+	void buffered_churn(Bench::State& state)
+	{
+		using Map = Glare::Slot_map<Element<Size>>;
+		constexpr int frames {20};
+
+		for (const std::size_t count : counts) {
+			if (count * Size > max_bytes)
+				continue;
+
+			Map sm;
+			std::vector<typename Map::Stable_index> live;
+			for (std::size_t i = 0; i != count; ++i)
+				live.push_back(sm.add(make_element<Size>(i)));
+			std::mt19937 rng {42};
+
+			const std::size_t changes {count / 20};
+			double seconds {0};
+			for (int frame = 0; frame != frames; ++frame) {
+				std::shuffle(live.begin(), live.end(), rng);
+
+				const Bench::Timer timer;
+				for (std::size_t i = 0; i != changes; ++i) {
+					sm.buffered_remove(live[i]);
+					live[i] = sm.buffered_add(make_element<Size>(i));
+				}
+				sm.clean_buffers();
+				seconds += timer.seconds();
+			}
+
+			const std::string suffix {"_" + std::to_string(Size) + "B_" + std::to_string(count)};
+			state.report("frame_us" + suffix, seconds * 1e6 / frames);
+			state.report("churn" + suffix, seconds * 1e9 / (static_cast<double>(changes) * 2 * frames));
+		}
+	}
+}
+
+GLARE_BENCHMARK(Containers, SlotMap)
+{
+	sweep<Glare_adapter>(state);
+}
+
+GLARE_BENCHMARK(Containers, VectorBaseline)
+{
+	sweep<Vector_adapter>(state);
+}
+
+GLARE_BENCHMARK(Containers, UnorderedMapBaseline)
+{
+	sweep<Unordered_map_adapter>(state);
+}
+
+GLARE_BENCHMARK(Containers, TextbookSlotMapBaseline)
+{
+	sweep<Baseline_adapter>(state);
+}
+
+GLARE_BENCHMARK(Containers, SlotMapBufferedChurn)
+{
+	buffered_churn<4>(state);
+	buffered_churn<16>(state);
+	buffered_churn<64>(state);
+	buffered_churn<256>(state);
+}
@@ -0,0 +1,119 @@
+#include "bench.hpp"
+#include "../glare/culling.hpp"
+#include "../glare/ecs.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	using Glare::Math::Aabb;
+	using Glare::Math::Mat4;
+	using Glare::Math::Sphere;
+	using Spheres = Glare::Slot_map<Sphere>;
+	using Culler = Glare::Scene::Culler<Spheres::Stable_index>;
+
+	constexpr std::size_t object_count {1'000'000};
+	constexpr float world_size {2000};
+	constexpr int frames {10};
+
+	// objects scattered over a wide, fairly flat world, as in the spatial index benchmark
+	std::vector<Sphere> world()
+	{
+		std::mt19937 rng {1};
+		std::uniform_real_distribution<float> across {0, world_size};
+		std::uniform_real_distribution<float> up {0, 50};
+		std::uniform_real_distribution<float> radius {0.5f, 4};
+		std::vector<Sphere> s;
+		for (std::size_t i = 0; i != object_count; ++i)
+			s.push_back({{across(rng), up(rng), across(rng)}, radius(rng)});
+		return s;
+	}
+
+	// a camera in the middle of the world looking along it, seeing about a tenth
+	constexpr float eye[3] {world_size / 2, 20, world_size / 2};
+	const Mat4 to_clip {Mat4::perspective(1.2f, 16.0f / 9, 0.5f, 600) * Mat4::translation(-eye[0], -eye[1], -eye[2])};
+
+	template<typename C>
+	void set_view(C& c)
+	{
+		const float lods[] {50, 150, 300};
+		c.set_view(to_clip, eye);
+		c.set_lod_distances({lods, 3});
+		c.set_max_distance(500);
+	}
+}
+
+// a million spheres in a Slot_map, against testing them one at a time
+GLARE_BENCHMARK(Culling, Spheres1M)
+{
+	Spheres spheres;
+	for (const auto& s : world())
+		spheres.add(s);
+	Culler culler;
+	set_view(culler);
+	std::vector<Culler::Visible> out(object_count);
+
+	double single {0};
+	std::size_t visible {0};
+	for (const auto t : Bench::thread_counts()) {
+		Glare::Utility::Job_system jobs {t - 1};
+		culler.cull(jobs, spheres, {out.data(), out.size()}); // warm up
+
+		const Bench::Timer timer;
+		for (int f = 0; f != frames; ++f)
+			visible = culler.cull(jobs, spheres, {out.data(), out.size()});
+		const double seconds {timer.seconds() / frames};
+
+		if (t == 1)
+			single = seconds;
+		const std::string suffix {"_" + std::to_string(t) + "_threads"};
+		state.report("ms" + suffix, seconds * 1e3);
+		state.report("speedup" + suffix, single / seconds);
+	}
+	state.report("visible", static_cast<double>(visible));
+
+	const auto f = Glare::Math::frustum(to_clip);
+	std::size_t scanned {0};
+	const Bench::Timer scan;
+	for (auto it = spheres.begin(); it != spheres.end(); ++it) {
+		bool in {true};
+		for (const auto& p : f.planes)
+			in = in && p[0] * it->centre[0] + p[1] * it->centre[1] + p[2] * it->centre[2] + p[3] >= -it->radius;
+		if (in)
+			out[scanned++] = {Spheres::Stable_index {it}, 0};
+	}
+	state.report("scan_ms", scan.seconds() * 1e3);
+	Bench::keep(out);
+}
+
+// a million boxes as an Ecs component, over every thread
+GLARE_BENCHMARK(Culling, BoxesInView1M)
+{
+	using Manager = Glare::Ecs::Entity_manager<Aabb>;
+	using Box_culler = Glare::Scene::Culler<Manager::Entity, Aabb>;
+
+	Manager em;
+	for (const auto& s : world()) {
+		const float r {s.radius};
+		em.create(Aabb {{s.centre[0] - r, s.centre[1] - r, s.centre[2] - r}, {s.centre[0] + r, s.centre[1] + r, s.centre[2] + r}});
+	}
+	Box_culler culler;
+	set_view(culler);
+	std::vector<Box_culler::Visible> out(object_count);
+
+	Glare::Utility::Job_system jobs {std::max(std::thread::hardware_concurrency(), 1u) - 1};
+	const auto view = em.view<const Aabb>();
+	culler.cull(jobs, view, {out.data(), out.size()});
+
+	std::size_t visible {0};
+	const Bench::Timer timer;
+	for (int f = 0; f != frames; ++f)
+		visible = culler.cull(jobs, view, {out.data(), out.size()});
+	state.report("ms", timer.seconds() * 1e3 / frames);
+	state.report("visible", static_cast<double>(visible));
+	Bench::keep(out);
+}
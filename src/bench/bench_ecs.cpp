@@ -0,0 +1,279 @@
+#include "bench.hpp"
+#include "../glare/ecs.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+	struct Position {
+		float x, y, z;
+	};
+
+	struct Velocity {
+		float x, y, z;
+	};
+
+	struct Mass {
+		float value;
+	};
+
+	struct Health {
+		std::int32_t value;
+	};
+
+	using Manager = Glare::Ecs::Entity_manager<Position, Velocity, Mass, Health>;
+
+	struct Tracked_position {
+		float x, y, z;
+	};
+}
+
+template<>
+struct Glare::Ecs::Track_changes<Tracked_position> : std::true_type {};
+
+namespace {
+	using Tracked_manager = Glare::Ecs::Entity_manager<Tracked_position, Velocity>;
+
+	constexpr std::size_t entity_count {1'000'000};
+	constexpr int passes {50};
+
+	// a quarter of the entities in each of four archetypes that all match
+	// Position and Velocity, so the views below have to skip nothing but
+	// still cross archetype boundaries
+	void populate(Manager& em, std::size_t count = entity_count)
+	{
+		for (std::size_t i = 0; i < count; ++i) {
+			const Position p {static_cast<float>(i), 0, 0};
+			const Velocity v {1, 2, 3};
+			switch (i % 4) {
+			case 0: em.create(p, v); break;
+			case 1: em.create(p, v, Mass {1}); break;
+			case 2: em.create(p, v, Health {100}); break;
+			default: em.create(p, v, Mass {1}, Health {100}); break;
+			}
+		}
+	}
+}
+
+GLARE_BENCHMARK(Ecs, Create)
+{
+	const Bench::Timer timer;
+	Manager em;
+	populate(em);
+	const double seconds {timer.seconds()};
+
+	state.report("entities", static_cast<double>(em.size()));
+	state.report("ns_per_entity", seconds * 1e9 / entity_count);
+}
+
+// Position += Velocity, 24 bytes read and 12 written per entity
+GLARE_BENCHMARK(Ecs, ViewTwoComponents)
+{
+	Manager em;
+	populate(em);
+
+	const Bench::Timer timer;
+	for (int pass = 0; pass < passes; ++pass) {
+		em.view<Position, const Velocity>().each([](Position& p, const Velocity& v) {
+			p.x += v.x * (1.0f / 60.0f);
+			p.y += v.y * (1.0f / 60.0f);
+			p.z += v.z * (1.0f / 60.0f);
+		});
+		Bench::keep(em);
+	}
+	const double seconds {timer.seconds()};
+	const double touched {static_cast<double>(entity_count) * passes};
+
+	state.report("entities", static_cast<double>(entity_count));
+	state.report("ns_per_entity", seconds * 1e9 / touched);
+	state.report("gb_per_second", touched * (sizeof(Position) * 2 + sizeof(Velocity)) / seconds / 1e9);
+}
+
+// the same query from a thousand entities, which fit in cache, up to a million
+GLARE_BENCHMARK(Ecs, QueryScaling)
+{
+	for (std::size_t count = 1'000; count <= entity_count; count *= 10) {
+		Manager em;
+		populate(em, count);
+
+		const int repeats {static_cast<int>(entity_count / count) * passes};
+		const Bench::Timer timer;
+		for (int pass = 0; pass < repeats; ++pass) {
+			em.view<Position, const Velocity>().each([](Position& p, const Velocity& v) {
+				p.x += v.x * (1.0f / 60.0f);
+				p.y += v.y * (1.0f / 60.0f);
+				p.z += v.z * (1.0f / 60.0f);
+			});
+			Bench::keep(em);
+		}
+		const double seconds {timer.seconds()};
+
+		state.report("ns_per_entity_" + std::to_string(count), seconds * 1e9 / (static_cast<double>(count) * repeats));
+	}
+}
+
+// only half the entities have Mass, the other archetypes are skipped whole
+GLARE_BENCHMARK(Ecs, ViewThreeComponents)
+{
+	Manager em;
+	populate(em);
+
+	std::size_t matched {0};
+	const Bench::Timer timer;
+	for (int pass = 0; pass < passes; ++pass) {
+		auto view = em.view<Position, const Velocity, const Mass>();
+		matched = view.size();
+		view.each([](Position& p, const Velocity& v, const Mass& m) {
+			const float k {(1.0f / 60.0f) / m.value};
+			p.x += v.x * k;
+			p.y += v.y * k;
+			p.z += v.z * k;
+		});
+		Bench::keep(em);
+	}
+	const double seconds {timer.seconds()};
+
+	state.report("entities", static_cast<double>(matched));
+	state.report("ns_per_entity", seconds * 1e9 / (static_cast<double>(matched) * passes));
+}
+
+// moves every entity to another archetype and back
+GLARE_BENCHMARK(Ecs, AddRemoveComponent)
+{
+	Manager em;
+	std::vector<Manager::Entity> entities;
+	entities.reserve(entity_count);
+	for (std::size_t i = 0; i < entity_count; ++i)
+		entities.push_back(em.create(Position {}, Velocity {}));
+
+	const Bench::Timer timer;
+	for (auto e : entities)
+		em.add<Mass>(e, 1.0f);
+	for (auto e : entities)
+		em.remove<Mass>(e);
+	const double seconds {timer.seconds()};
+
+	state.report("ns_per_change", seconds * 1e9 / (entity_count * 2));
+}
+
+namespace {
+	using Sparse_manager = Glare::Ecs::Sparse_entity_manager<Position, Velocity, Mass, Health>;
+
+	// same entities as populate, created in an order that scatters the pools
+	void populate(Sparse_manager& em)
+	{
+		for (std::size_t i = 0; i < entity_count; ++i) {
+			const Position p {static_cast<float>(i), 0, 0};
+			const Velocity v {1, 2, 3};
+			switch (i % 4) {
+			case 0: em.create(p, v); break;
+			case 1: em.create(Mass {1}, v, p); break;
+			case 2: em.create(Health {100}, p, v); break;
+			default: em.create(v, Mass {1}, Health {100}, p); break;
+			}
+		}
+	}
+
+	template<typename View>
+	void integrate_with_mass(Bench::State& state, View view)
+	{
+		const std::size_t matched {view.size()};
+		const Bench::Timer timer;
+		for (int pass = 0; pass < passes; ++pass) {
+			view.each([](Position& p, const Velocity& v, const Mass& m) {
+				const float k {(1.0f / 60.0f) / m.value};
+				p.x += v.x * k;
+				p.y += v.y * k;
+				p.z += v.z * k;
+			});
+			Bench::keep(view);
+		}
+		const double seconds {timer.seconds()};
+
+		state.report("entities", static_cast<double>(matched));
+		state.report("ns_per_entity", seconds * 1e9 / (static_cast<double>(matched) * passes));
+	}
+}
+
+// joins through the sparse arrays of Velocity and Mass
+// one entity in twenty is moved each pass, then a consumer that rebuilds a
+// render proxy either scans every Position or visits only the changed ones
+GLARE_BENCHMARK(Ecs, ChangedFilter)
+{
+	Tracked_manager em;
+	std::vector<Tracked_manager::Entity> v;
+	v.reserve(entity_count);
+	for (std::size_t i = 0; i < entity_count; ++i)
+		v.push_back(em.create(Tracked_position {static_cast<float>(i), 0, 0}, Velocity {1, 2, 3}));
+
+	// stands in for building a matrix and copying it out
+	float proxy {0};
+	const auto sync = [&proxy](const Tracked_position& p) {
+		proxy += std::sin(p.x) * std::cos(p.y) + p.z;
+	};
+
+	double full {0};
+	double filtered {0};
+	std::size_t visited {0};
+	for (int pass = 0; pass < passes; ++pass) {
+		em.next_tick();
+		for (std::size_t i = pass % 20; i < entity_count; i += 20)
+			em.get<Tracked_position>(v[i]).x += 1;
+
+		Bench::Timer timer;
+		em.view<const Tracked_position>().each(sync);
+		Bench::keep(proxy);
+		full += timer.seconds();
+
+		timer = {};
+		em.view<const Tracked_position>().changed<Tracked_position>().each([&](const Tracked_position& p) {
+			sync(p);
+			++visited;
+		});
+		Bench::keep(proxy);
+		filtered += timer.seconds();
+	}
+
+	state.report("entities", static_cast<double>(entity_count));
+	state.report("visited_per_pass", static_cast<double>(visited) / passes);
+	state.report("full_scan_ms", full * 1e3 / passes);
+	state.report("changed_filter_ms", filtered * 1e3 / passes);
+}
+
+GLARE_BENCHMARK(Ecs, SparseViewThreeComponents)
+{
+	Sparse_manager em;
+	populate(em);
+	integrate_with_mass(state, em.view<Position, const Velocity, const Mass>());
+}
+
+// the same join after grouping, compare with ViewThreeComponents
+GLARE_BENCHMARK(Ecs, SparseGroupThreeComponents)
+{
+	Sparse_manager em;
+	populate(em);
+	em.group<Position, Velocity, Mass>();
+	integrate_with_mass(state, em.view<Position, const Velocity, const Mass>());
+}
+
+GLARE_BENCHMARK(Ecs, SparseAddRemoveComponent)
+{
+	Sparse_manager em;
+	em.group<Position, Velocity, Mass>();
+	std::vector<Sparse_manager::Entity> entities;
+	entities.reserve(entity_count);
+	for (std::size_t i = 0; i < entity_count; ++i)
+		entities.push_back(em.create(Position {}, Velocity {}));
+
+	const Bench::Timer timer;
+	for (auto e : entities)
+		em.add<Mass>(e, 1.0f);
+	for (auto e : entities)
+		em.remove<Mass>(e);
+	const double seconds {timer.seconds()};
+
+	state.report("ns_per_change", seconds * 1e9 / (entity_count * 2));
+}
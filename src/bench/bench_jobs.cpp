@@ -0,0 +1,129 @@
+#include "bench.hpp"
+#include "../glare/job_system.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	using Glare::Utility::Job_system;
+
+	constexpr std::size_t job_count {1 << 20};
+	// submitted from outside between waits, within the default pool
+	constexpr std::size_t batch {2048};
+
+	// a few hundred nanoseconds of arithmetic
+	float work(std::size_t seed)
+	{
+		float x {static_cast<float>(seed % 97)};
+		for (int i = 0; i < 32; ++i)
+			x = std::sqrt(x * x + 1.0f);
+		return x;
+	}
+
+	// every job spawns two more until depth runs out, so most jobs are
+	// pushed and popped by workers and the rest are stolen
+	void spawn(Job_system& jobs, Job_system::Counter& counter, int depth, bool fine, std::vector<float>& out)
+	{
+		if (fine)
+			out[jobs.thread_index()] += work(static_cast<std::size_t>(depth));
+		if (depth == 0)
+			return;
+		for (int i = 0; i != 2; ++i)
+			jobs.submit([&jobs, &counter, depth, fine, &out] { spawn(jobs, counter, depth - 1, fine, out); }, counter);
+	}
+
+	// runs f(jobs) for every thread count and reports time per job and speedup
+	template<typename F>
+	void scale(Bench::State& state, std::size_t jobs_run, F f)
+	{
+		double single {0};
+		for (const auto t : Bench::thread_counts()) {
+			Job_system jobs {t - 1}; // the calling thread makes one more
+			f(jobs); // warm up
+
+			const Bench::Timer timer;
+			f(jobs);
+			const double seconds {timer.seconds()};
+
+			if (t == 1)
+				single = seconds;
+			const std::string suffix {"_" + std::to_string(t) + "_threads"};
+			state.report("ns_per_job" + suffix, seconds * 1e9 / static_cast<double>(jobs_run));
+			state.report("mjobs_per_s" + suffix, static_cast<double>(jobs_run) / seconds / 1e6);
+			state.report("speedup" + suffix, single / seconds);
+		}
+	}
+
+	void from_outside(Bench::State& state, bool fine)
+	{
+		std::vector<float> out(std::thread::hardware_concurrency() + 1);
+		scale(state, job_count, [&](Job_system& jobs) {
+			Job_system::Counter counter;
+			for (std::size_t i = 0; i < job_count; i += batch) {
+				for (std::size_t j = i; j != i + batch; ++j) {
+					if (fine)
+						jobs.submit([&jobs, &out, j] { out[jobs.thread_index()] += work(j); }, counter);
+					else
+						jobs.submit([] {}, counter);
+				}
+				jobs.wait(counter);
+			}
+		});
+		Bench::keep(out);
+	}
+
+	void nested(Bench::State& state, bool fine)
+	{
+		// 2^20 jobs, 2^21 - 1 counting the roots' descendants
+		constexpr int depth {20};
+		std::vector<float> out(std::thread::hardware_concurrency() + 1);
+		scale(state, (std::size_t {2} << depth) - 1, [&](Job_system& jobs) {
+			Job_system::Counter counter;
+			jobs.submit([&] { spawn(jobs, counter, depth, fine, out); }, counter);
+			jobs.wait(counter);
+		});
+		Bench::keep(out);
+	}
+}
+
+// submitted by the calling thread through the shared queue
+GLARE_BENCHMARK(Jobs, Empty)
+{
+	from_outside(state, false);
+}
+
+GLARE_BENCHMARK(Jobs, FineGrained)
+{
+	from_outside(state, true);
+}
+
+// submitted by workers to their own deques
+GLARE_BENCHMARK(Jobs, EmptyNested)
+{
+	nested(state, false);
+}
+
+GLARE_BENCHMARK(Jobs, FineGrainedNested)
+{
+	nested(state, true);
+}
+
+// a chain of continuations, each queued as the one before finishes
+GLARE_BENCHMARK(Jobs, ContinuationChain)
+{
+	constexpr std::size_t links {100'000};
+	Job_system jobs;
+	std::vector<Job_system::Counter> counters(links);
+
+	const Bench::Timer timer;
+	jobs.submit([] {}, counters[0]);
+	for (std::size_t i = 1; i != links; ++i)
+		jobs.submit_after(counters[i - 1], [] {}, counters[i]);
+	jobs.wait(counters.back());
+
+	state.report("ns_per_link", timer.seconds() * 1e9 / links);
+}
@@ -0,0 +1,93 @@
+#include "bench.hpp"
+#include "../glare/ecs.hpp"
+#include "../glare/parallel.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace {
+	struct Particle {
+		float position[3];
+		float velocity[3];
+	};
+
+	constexpr std::size_t particle_count {4'000'000};
+	constexpr int passes {10};
+
+	// enough arithmetic per element that threads aren't just waiting on memory
+	void step(float* position, float* velocity)
+	{
+		const float speed {std::sqrt(velocity[0] * velocity[0] + velocity[1] * velocity[1] + velocity[2] * velocity[2])};
+		const float drag {1.0f / (1.0f + 0.01f * speed)};
+		for (int i = 0; i < 3; ++i) {
+			velocity[i] *= drag;
+			position[i] += velocity[i] * (1.0f / 60.0f);
+		}
+	}
+
+	// runs f(jobs) for every thread count and reports time per element and speedup
+	template<typename F>
+	void scale(Bench::State& state, std::size_t elements, F f)
+	{
+		double single {0};
+		for (const auto t : Bench::thread_counts()) {
+			Glare::Utility::Job_system jobs {t - 1}; // the calling thread makes one more
+			f(jobs); // warm up
+
+			const Bench::Timer timer;
+			for (int pass = 0; pass < passes; ++pass)
+				f(jobs);
+			const double seconds {timer.seconds()};
+
+			if (t == 1)
+				single = seconds;
+			const std::string suffix {"_" + std::to_string(t) + "_threads"};
+			state.report("ns_per_element" + suffix, seconds * 1e9 / (static_cast<double>(elements) * passes));
+			state.report("speedup" + suffix, single / seconds);
+		}
+	}
+}
+
+GLARE_BENCHMARK(Parallel, SlotMapScaling)
+{
+	Glare::Slot_map<Particle> sm;
+	sm.reserve(particle_count);
+	for (std::size_t i = 0; i < particle_count; ++i)
+		sm.add(Particle {{0, 0, 0}, {1, 2, static_cast<float>(i % 7)}});
+
+	scale(state, particle_count, [&](Glare::Utility::Job_system& jobs) {
+		Glare::parallel_for_each(jobs, sm, [](Particle& p) { step(p.position, p.velocity); }, 4096);
+	});
+}
+
+namespace {
+	struct Position {
+		float value[3];
+	};
+
+	struct Velocity {
+		float value[3];
+	};
+
+	struct Tag {};
+}
+
+GLARE_BENCHMARK(Parallel, ViewScaling)
+{
+	using Manager = Glare::Ecs::Entity_manager<Position, Velocity, Tag>;
+	Manager em;
+	for (std::size_t i = 0; i < particle_count; ++i) {
+		if (i % 2)
+			em.create(Position {}, Velocity {{1, 2, static_cast<float>(i % 7)}});
+		else
+			em.create(Position {}, Velocity {{1, 2, static_cast<float>(i % 7)}}, Tag {});
+	}
+
+	scale(state, particle_count, [&](Glare::Utility::Job_system& jobs) {
+		Glare::parallel_for_each(jobs, em.view<Position, Velocity>(), [](Position& p, Velocity& v) {
+			step(p.value, v.value);
+		}, 4096);
+	});
+}
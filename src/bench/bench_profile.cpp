@@ -0,0 +1,48 @@
+#include "bench.hpp"
+#include "../glare/profile.hpp"
+
+#include <cstdint>
+
+namespace {
+	constexpr int zones {10'000'000};
+	// zones per frame, end_frame drains the buffers in between
+	constexpr int frame {10'000};
+
+	// kept out of line so that the zone isn't hoisted out of the loop
+#if defined(__GNUC__)
+	__attribute__((noinline))
+#elif defined(_MSC_VER)
+	__declspec(noinline)
+#endif
+	void zoned(std::uint64_t& x)
+	{
+		GLARE_PROFILE_ZONE("bench");
+		++x;
+	}
+
+	double ns_per_zone(bool enabled)
+	{
+		auto& p = Glare::Utility::Profiler::global();
+		p.enable(enabled);
+
+		std::uint64_t x {0};
+		double seconds {0};
+		for (int i = 0; i < zones; i += frame) {
+			const Bench::Timer timer;
+			for (int j = 0; j != frame; ++j)
+				zoned(x);
+			seconds += timer.seconds();
+			p.end_frame();
+		}
+		Bench::keep(x);
+
+		p.enable(false);
+		return seconds * 1e9 / zones;
+	}
+}
+
+GLARE_BENCHMARK(Profile, ZoneCost)
+{
+	state.report("ns_per_zone_disabled", ns_per_zone(false));
+	state.report("ns_per_zone_enabled", ns_per_zone(true));
+}
@@ -0,0 +1,95 @@
+#include "bench.hpp"
+#include "terrain.hpp"
+#include "../glare/ray_tracer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+	using Glare::Math::Mat4;
+	using Glare::Video::Hit;
+	using Glare::Video::Ray;
+	using Glare::Video::Ray_tracer;
+	using Bench::Terrain;
+
+	constexpr std::size_t width {1920};
+	constexpr std::size_t height {1080};
+	constexpr int frames {3};
+
+	const Mat4 to_clip {Mat4::perspective(1.0f, static_cast<float>(width) / height, 0.1f, 300)};
+}
+
+// a ray per pixel at 1920x1080 over about 130 thousand triangles
+GLARE_BENCHMARK(RayTracer, Primary1080p)
+{
+	Terrain terrain {256};
+	Ray_tracer r {width, height};
+	r.add_mesh({terrain.vertices.data(), terrain.vertices.size()}, {terrain.indices.data(), terrain.indices.size()});
+
+	double single {0};
+	for (const auto t : Bench::thread_counts()) {
+		Glare::Utility::Job_system jobs {t - 1};
+		r.render(jobs, to_clip); // warm up, and builds the hierarchy
+
+		const Bench::Timer timer;
+		for (int f = 0; f != frames; ++f)
+			r.render(jobs, to_clip);
+		const double seconds {timer.seconds() / frames};
+
+		if (t == 1)
+			single = seconds;
+		const std::string suffix {"_" + std::to_string(t) + "_threads"};
+		state.report("ms_per_frame" + suffix, seconds * 1e3);
+		state.report("mrays_per_s" + suffix, static_cast<double>(r.ray_count()) / seconds / 1e6);
+		state.report("speedup" + suffix, single / seconds);
+	}
+	Bench::keep(r.image()[width * height / 2]);
+}
+
+// rays in every direction from points on the terrain, as a lightmap baker casts them
+GLARE_BENCHMARK(RayTracer, Incoherent)
+{
+	Terrain terrain {256};
+	Ray_tracer r {1, 1};
+	r.add_mesh({terrain.vertices.data(), terrain.vertices.size()}, {terrain.indices.data(), terrain.indices.size()});
+	r.update();
+
+	std::mt19937 rng {1};
+	std::uniform_int_distribution<std::size_t> vertex {0, terrain.vertices.size() - 1};
+	std::normal_distribution<float> direction;
+	std::vector<Ray> rays(1 << 20);
+	for (auto& ray : rays) {
+		const float* p {terrain.vertices[vertex(rng)].position};
+		ray = {{p[0], p[1] + 0.01f, p[2]}, {direction(rng), std::abs(direction(rng)), direction(rng)}, 50};
+	}
+	std::vector<Hit> hits(rays.size());
+
+	const Bench::Timer timer;
+	r.intersect({rays.data(), rays.size()}, {hits.data(), hits.size()});
+	const double seconds {timer.seconds()};
+
+	state.report("mrays_per_s", static_cast<double>(rays.size()) / seconds / 1e6);
+	Bench::keep(hits[rays.size() / 2].t);
+}
+
+// a full build and a refit to moved vertices of the same terrain
+GLARE_BENCHMARK(RayTracer, BuildAndRefit)
+{
+	Terrain terrain {256};
+	Ray_tracer r {1, 1};
+	r.add_mesh({terrain.vertices.data(), terrain.vertices.size()}, {terrain.indices.data(), terrain.indices.size()});
+
+	const Bench::Timer build;
+	r.update();
+	state.report("build_ms", build.seconds() * 1e3);
+	state.report("nodes", static_cast<double>(r.node_count()));
+
+	terrain.animate(1);
+	r.update_mesh(0, {terrain.vertices.data(), terrain.vertices.size()});
+	const Bench::Timer refit;
+	r.update();
+	state.report("refit_ms", refit.seconds() * 1e3);
+}
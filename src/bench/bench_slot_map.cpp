@@ -0,0 +1,343 @@
+#include "bench.hpp"
+#include "../glare/slot_map.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+// keeps a fixed working set alive and replaces one element per cycle,
+// memory use should stay flat no matter how many cycles are run
+GLARE_BENCHMARK(SlotMap, SoakAddRemove)
+{
+	constexpr std::size_t live_count {10'000};
+	constexpr std::uint64_t cycles {100'000'000};
+
+	Glare::Slot_map<std::uint64_t> sm;
+	std::vector<Glare::Slot_map<std::uint64_t>::Stable_index> live;
+	for (std::size_t i = 0; i < live_count; ++i)
+		live.push_back(sm.add(i));
+
+	const std::size_t rss_before {Bench::peak_rss()};
+	const Bench::Timer timer;
+
+	for (std::uint64_t i = 0; i < cycles; ++i) {
+		auto& p = live[i % live_count];
+		sm.remove(p);
+		p = sm.add(i);
+	}
+
+	const double seconds {timer.seconds()};
+	Bench::keep(sm[live.front()]);
+
+	state.report("cycles", static_cast<double>(cycles));
+	state.report("ns_per_cycle", seconds * 1e9 / cycles);
+	state.report("slot_count", static_cast<double>(sm.slot_count()));
+	state.report("retired_count", static_cast<double>(sm.retired_count()));
+	state.report("peak_rss_before_bytes", static_cast<double>(rss_before));
+	state.report("peak_rss_bytes", static_cast<double>(Bench::peak_rss()));
+}
+
+namespace {
+	// the layout handles had before Handle_traits, two size_t side by side
+	struct Unpacked_handle_traits {
+		struct value_type {
+			std::size_t index;
+			std::size_t counter;
+		};
+		using index_type = std::size_t;
+		using counter_type = std::size_t;
+
+		static constexpr index_type null_index {std::numeric_limits<std::size_t>::max()};
+		static constexpr counter_type null_counter {std::numeric_limits<std::size_t>::max()};
+		static constexpr value_type null_value {null_index, null_counter};
+
+		static constexpr value_type pack(index_type index, counter_type counter)
+		{
+			return {index, counter};
+		}
+
+		static constexpr index_type index(value_type x) { return x.index; }
+		static constexpr counter_type counter(value_type x) { return x.counter; }
+	};
+
+	// dereferences handles in random order, so each lookup is a cache miss
+	// on both the handle array and elem_indirect
+	template<typename Handle>
+	void random_dereference(Bench::State& state)
+	{
+		constexpr std::size_t count {1'000'000};
+		constexpr int passes {10};
+
+		using Map = Glare::Slot_map<std::uint32_t, Handle>;
+		Map sm;
+		std::vector<typename Map::Stable_index> handles;
+		handles.reserve(count);
+		for (std::size_t i = 0; i < count; ++i)
+			handles.push_back(sm.add(static_cast<std::uint32_t>(i)));
+
+		std::mt19937 rng {42};
+		std::shuffle(handles.begin(), handles.end(), rng);
+
+		std::uint64_t sum {0};
+		const Bench::Timer timer;
+		for (int pass = 0; pass < passes; ++pass) {
+			for (auto p : handles)
+				sum += sm[p];
+		}
+		const double seconds {timer.seconds()};
+		Bench::keep(sum);
+
+		state.report("handle_bytes", sizeof(typename Map::Stable_index));
+		state.report("elements", count);
+		state.report("ns_per_lookup", seconds * 1e9 / (count * passes));
+	}
+}
+
+GLARE_BENCHMARK(SlotMap, RandomDereferenceUnpacked)
+{
+	random_dereference<Unpacked_handle_traits>(state);
+}
+
+GLARE_BENCHMARK(SlotMap, RandomDereference64)
+{
+	random_dereference<Glare::Handle_traits<>>(state);
+}
+
+GLARE_BENCHMARK(SlotMap, RandomDereference32)
+{
+	random_dereference<Glare::Compact_handle_traits>(state);
+}
+
+namespace {
+	struct Vec3 {
+		float x, y, z;
+	};
+
+	float sum(float x) { return x; }
+	float sum(const Vec3& v) { return v.x + v.y + v.z; }
+
+	// linear pass over every element, after some churn so that
+	// the slot indices no longer match the dense order
+	template<typename T, typename Storage>
+	void iterate(Bench::State& state)
+	{
+		constexpr std::size_t count {1'000'000};
+		constexpr int passes {20};
+
+		Glare::Slot_map<T, Glare::Handle_traits<>, Storage> sm;
+		for (std::size_t i = 0; i < count; ++i)
+			sm.add(T {});
+		for (std::size_t i = 0; i < sm.size(); i += 3)
+			sm.remove(i);
+
+		float total {0};
+		const Bench::Timer timer;
+		for (int pass = 0; pass < passes; ++pass) {
+			for (const auto& x : sm)
+				total += sum(x);
+		}
+		const double seconds {timer.seconds()};
+		Bench::keep(total);
+
+		state.report("element_bytes", sizeof(T));
+		state.report("elements", sm.size());
+		state.report("ns_per_element", seconds * 1e9 / (sm.size() * passes));
+	}
+}
+
+GLARE_BENCHMARK(SlotMap, IterateAosFloat)
+{
+	iterate<float, Glare::Aos_storage>(state);
+}
+
+GLARE_BENCHMARK(SlotMap, IterateSoaFloat)
+{
+	iterate<float, Glare::Soa_storage>(state);
+}
+
+GLARE_BENCHMARK(SlotMap, IterateAosVec3)
+{
+	iterate<Vec3, Glare::Aos_storage>(state);
+}
+
+GLARE_BENCHMARK(SlotMap, IterateSoaVec3)
+{
+	iterate<Vec3, Glare::Soa_storage>(state);
+}
+
+namespace {
+	struct Transform {
+		float position[3];
+		float velocity[3];
+	};
+
+	void integrate(Transform& t)
+	{
+		for (int i = 0; i < 3; ++i)
+			t.position[i] += t.velocity[i] * (1.0f / 60.0f);
+	}
+
+	constexpr std::size_t transform_count {200'000};
+	constexpr int transform_passes {100};
+
+	template<typename Range>
+	void update_transforms(Bench::State& state, Range& range)
+	{
+		const Bench::Timer timer;
+		for (int pass = 0; pass < transform_passes; ++pass) {
+			for (auto& t : range)
+				integrate(t);
+			Bench::keep(range);
+		}
+		const double seconds {timer.seconds()};
+
+		state.report("elements", transform_count);
+		state.report("ns_per_element", seconds * 1e9 / (transform_count * transform_passes));
+	}
+}
+
+GLARE_BENCHMARK(SlotMap, UpdateIterator)
+{
+	Glare::Slot_map<Transform> sm;
+	for (std::size_t i = 0; i < transform_count; ++i)
+		sm.add(Transform {{0, 0, 0}, {1, 2, 3}});
+	update_transforms(state, sm);
+}
+
+GLARE_BENCHMARK(SlotMap, UpdateValues)
+{
+	Glare::Slot_map<Transform> sm;
+	for (std::size_t i = 0; i < transform_count; ++i)
+		sm.add(Transform {{0, 0, 0}, {1, 2, 3}});
+	auto values = sm.values();
+	update_transforms(state, values);
+}
+
+GLARE_BENCHMARK(SlotMap, UpdateVectorBaseline)
+{
+	std::vector<Transform> v(transform_count, Transform {{0, 0, 0}, {1, 2, 3}});
+	update_transforms(state, v);
+}
+
+// spawning and cancelling projectiles within the same frame
+GLARE_BENCHMARK(SlotMap, BufferedCancelStorm)
+{
+	constexpr std::size_t adds {100'000};
+	constexpr std::size_t cancels {50'000};
+	constexpr int frames {20};
+
+	Glare::Slot_map<std::uint64_t> sm;
+	std::vector<Glare::Slot_map<std::uint64_t>::Stable_index> handles;
+	handles.reserve(adds);
+	std::mt19937 rng {42};
+
+	double frame_seconds {0};
+	for (int frame = 0; frame < frames; ++frame) {
+		handles.clear();
+		const Bench::Timer timer;
+
+		for (std::size_t i = 0; i < adds; ++i)
+			handles.push_back(sm.buffered_add(i));
+
+		// cancel a random half, while everything is still pending
+		std::shuffle(handles.begin(), handles.end(), rng);
+		for (std::size_t i = 0; i < cancels; ++i)
+			sm.buffered_remove(handles[i]);
+
+		sm.clean_buffers();
+		frame_seconds += timer.seconds();
+
+		// despawn the survivors so every frame starts empty
+		for (std::size_t i = cancels; i < adds; ++i)
+			sm.buffered_remove(handles[i]);
+		sm.clean_buffers();
+	}
+
+	state.report("adds_per_frame", adds);
+	state.report("cancels_per_frame", cancels);
+	state.report("ms_per_frame", frame_seconds * 1e3 / frames);
+}
+
+// end of frame commit of a large batch of structural changes
+GLARE_BENCHMARK(SlotMap, CleanBuffers)
+{
+	constexpr std::size_t live_count {200'000};
+	constexpr std::size_t changes {30'000};
+	constexpr int frames {50};
+
+	Glare::Slot_map<Transform> sm;
+	std::vector<Glare::Slot_map<Transform>::Stable_index> live;
+	for (std::size_t i = 0; i < live_count; ++i)
+		live.push_back(sm.add());
+	std::mt19937 rng {42};
+
+	double seconds {0};
+	double worst {0};
+	for (int frame = 0; frame < frames; ++frame) {
+		// despawn random elements and spawn the same number of new ones
+		std::shuffle(live.begin(), live.end(), rng);
+		for (std::size_t i = 0; i < changes; ++i) {
+			sm.buffered_remove(live[i]);
+			live[i] = sm.buffered_add();
+		}
+
+		const Bench::Timer timer;
+		const auto stats = sm.clean_buffers();
+		const double t {timer.seconds()};
+		Bench::keep(stats);
+
+		seconds += t;
+		worst = std::max(worst, t);
+	}
+
+	state.report("elements", live_count);
+	state.report("changes_per_frame", changes * 2);
+	state.report("ms_per_clean", seconds * 1e3 / frames);
+	state.report("worst_ms", worst * 1e3);
+}
+
+namespace {
+	struct Large_component {
+		float data[64];
+	};
+
+	// a world region streaming in adds a large batch of entities at once,
+	// the worst batch is the one that has to reallocate a vector
+	template<typename Map>
+	void stream_in(Bench::State& state)
+	{
+		constexpr std::size_t batch {50'000};
+		constexpr int batches {20};
+
+		Map sm;
+		double seconds {0};
+		double worst {0};
+		for (int i = 0; i < batches; ++i) {
+			for (std::size_t j = 0; j < batch; ++j)
+				sm.buffered_add();
+
+			const Bench::Timer timer;
+			sm.clean_buffers();
+			const double t {timer.seconds()};
+
+			seconds += t;
+			worst = std::max(worst, t);
+		}
+		Bench::keep(sm[0]);
+
+		state.report("elements", sm.size());
+		state.report("ms_per_batch", seconds * 1e3 / batches);
+		state.report("worst_ms", worst * 1e3);
+	}
+}
+
+GLARE_BENCHMARK(SlotMap, StreamInContiguous)
+{
+	stream_in<Glare::Slot_map<Large_component>>(state);
+}
+
+GLARE_BENCHMARK(SlotMap, StreamInPaged)
+{
+	stream_in<Glare::Paged_slot_map<Large_component>>(state);
+}
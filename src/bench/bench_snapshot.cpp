@@ -0,0 +1,179 @@
+#include "bench.hpp"
+#include "../glare/history.hpp"
+#include "../glare/snapshot.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+	struct Body {
+		float x, y, z;
+	};
+
+	struct Velocity {
+		float x, y, z;
+	};
+
+	struct Health {
+		int value;
+	};
+
+	using Manager = Glare::Ecs::Entity_manager<Body, Velocity, Health>;
+
+	constexpr std::size_t entity_count {1000000};
+	constexpr int passes {10};
+
+	const std::string path {"bench_snapshot.snp"};
+
+	void fill(Manager& em)
+	{
+		for (std::size_t i = 0; i != entity_count; ++i) {
+			const auto f = static_cast<float>(i);
+			if (i % 4 == 0)
+				em.create(Body {f, f, f}, Health {static_cast<int>(i)});
+			else
+				em.create(Body {f, f, f}, Velocity {1, 0, 0}, Health {static_cast<int>(i)});
+		}
+	}
+
+	double file_size()
+	{
+		const Glare::Snapshot::Reader r {path, false};
+		const auto& last = r.blob(r.blob_count() - 1);
+		return static_cast<double>(last.offset + last.element_size * last.count);
+	}
+}
+
+GLARE_BENCHMARK(Snapshot, EntityManagerSave)
+{
+	Manager em;
+	fill(em);
+
+	const Bench::Timer timer;
+	for (int pass = 0; pass < passes; ++pass) {
+		Glare::Snapshot::Writer w {path};
+		Glare::Snapshot::save(w, em);
+		w.finish();
+	}
+	const double seconds {timer.seconds() / passes};
+
+	state.report("entities", static_cast<double>(entity_count));
+	state.report("ms_per_save", seconds * 1e3);
+	state.report("gb_per_s", file_size() / seconds / 1e9);
+	std::remove(path.c_str());
+}
+
+// the file is in the page cache after the first pass, so this measures
+// checking and copying out the arrays rather than the disk
+GLARE_BENCHMARK(Snapshot, EntityManagerLoad)
+{
+	{
+		Manager em;
+		fill(em);
+		Glare::Snapshot::Writer w {path};
+		Glare::Snapshot::save(w, em);
+		w.finish();
+	}
+
+	double verified {0};
+	double unverified {0};
+	for (int pass = 0; pass < passes; ++pass) {
+		for (const bool verify : {true, false}) {
+			Manager em;
+			const Bench::Timer timer;
+			Glare::Snapshot::load(Glare::Snapshot::Reader {path, verify}, em);
+			(verify ? verified : unverified) += timer.seconds();
+			Bench::keep(em);
+		}
+	}
+
+	const double bytes {file_size()};
+	state.report("entities", static_cast<double>(entity_count));
+	state.report("ms_per_load", verified / passes * 1e3);
+	state.report("gb_per_s", bytes * passes / verified / 1e9);
+	state.report("ms_per_load_unverified", unverified / passes * 1e3);
+	state.report("gb_per_s_unverified", bytes * passes / unverified / 1e9);
+	std::remove(path.c_str());
+}
+
+// opening a Slot_map in place costs the same whatever its size
+GLARE_BENCHMARK(Snapshot, SlotMapView)
+{
+	using Map = Glare::Slot_map<Body>;
+	{
+		Map sm;
+		for (std::size_t i = 0; i != entity_count; ++i)
+			sm.add(Body {static_cast<float>(i), 0, 0});
+		Glare::Snapshot::Writer w {path};
+		Glare::Snapshot::save(w, sm);
+		w.finish();
+	}
+
+	double open {0};
+	double sum {0};
+	Bench::Timer timer;
+	for (int pass = 0; pass < passes; ++pass) {
+		timer = {};
+		const Glare::Snapshot::Reader r {path, false};
+		const Glare::Snapshot::Slot_map_view<Map> view {r};
+		open += timer.seconds();
+		for (const auto& b : view.values())
+			sum += b.x;
+	}
+	Bench::keep(sum);
+
+	state.report("elements", static_cast<double>(entity_count));
+	state.report("us_per_open", open / passes * 1e6);
+	std::remove(path.c_str());
+}
+
+// one element in a hundred changed each frame, in runs of ten as moving
+// objects tend to be near each other, against copying the Slot_map
+GLARE_BENCHMARK(Snapshot, HistoryRecord)
+{
+	using Map = Glare::Slot_map<Body>;
+	constexpr int frames {60};
+
+	Map sm;
+	std::vector<Map::Stable_index> handles;
+	for (std::size_t i = 0; i != entity_count; ++i)
+		handles.push_back(sm.add(Body {static_cast<float>(i), 0, 0}));
+
+	const auto change = [&](int frame) {
+		for (std::size_t i = static_cast<std::size_t>(frame) * 10 % 1000; i < entity_count; i += 1000)
+			for (std::size_t j = i; j != i + 10; ++j)
+				sm[handles[j]].y += 1;
+	};
+
+	Glare::Snapshot::History<Map> history {frames, 256 << 20};
+	history.record(sm, 0);
+	double record {0};
+	for (int f = 1; f <= frames; ++f) {
+		change(f);
+		const Bench::Timer timer;
+		history.record(sm, static_cast<Glare::Snapshot::History<Map>::Frame>(f));
+		record += timer.seconds();
+	}
+
+	std::vector<Map> copies(8);
+	double copy {0};
+	for (int f = 1; f <= frames; ++f) {
+		change(f);
+		const Bench::Timer timer;
+		copies[static_cast<std::size_t>(f) % copies.size()] = sm;
+		copy += timer.seconds();
+	}
+
+	const double bytes {static_cast<double>(history.bytes_used())};
+	const Bench::Timer timer;
+	history.restore(sm, frames - 8);
+	const double restore {timer.seconds()};
+
+	state.report("elements", static_cast<double>(entity_count));
+	state.report("ms_per_record", record / frames * 1e3);
+	state.report("ms_per_copy_baseline", copy / frames * 1e3);
+	state.report("bytes_per_frame", bytes / frames);
+	state.report("ms_to_restore_8_back", restore * 1e3);
+}
@@ -0,0 +1,168 @@
+#include "bench.hpp"
+#include "../glare/slot_map.hpp"
+#include "../glare/spatial_index.hpp"
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace {
+	using Glare::Math::Aabb;
+	using Glare::Math::Mat4;
+	using Glare::Math::Sphere;
+	using Objects = Glare::Slot_map<Aabb>;
+	using Index = Glare::Scene::Spatial_index<Objects::Stable_index>;
+
+	constexpr std::size_t object_count {500'000};
+	constexpr float world_size {2000};
+
+	Aabb box_at(float x, float y, float z, float size)
+	{
+		return {{x, y, z}, {x + size, y + size, z + size}};
+	}
+
+	// objects scattered over a wide, fairly flat world, as in an open level
+	struct World {
+		World()
+		{
+			std::uniform_real_distribution<float> across {0, world_size};
+			std::uniform_real_distribution<float> up {0, 50};
+			std::uniform_real_distribution<float> size {0.5f, 4};
+			for (std::size_t i = 0; i != object_count; ++i) {
+				const auto h = objects.add(box_at(across(rng), up(rng), across(rng), size(rng)));
+				proxies.push_back(index.insert(h, objects[h]));
+			}
+		}
+
+		std::mt19937 rng {1};
+		Objects objects;
+		Index index {0.5f};
+		std::vector<Index::Proxy> proxies;
+	};
+
+	// a camera in the middle of the world looking along it, seeing about a tenth
+	Glare::Math::Frustum camera()
+	{
+		const Mat4 projection {Mat4::perspective(1.2f, 16.0f / 9, 0.5f, 600)};
+		return Glare::Math::frustum(projection * Mat4::translation(-world_size / 2, -20, -world_size / 2));
+	}
+
+	// whether any corner of b is in front of every plane, the test a linear scan makes
+	bool visible(const Glare::Math::Frustum& f, const Aabb& b)
+	{
+		for (const auto& p : f.planes) {
+			float d {p[3]};
+			for (int i = 0; i != 3; ++i)
+				d += p[i] * (p[i] > 0 ? b.max[i] : b.min[i]);
+			if (d < 0)
+				return false;
+		}
+		return true;
+	}
+}
+
+// building by inserting 500 thousand objects one at a time, then rebuilding
+GLARE_BENCHMARK(SpatialIndex, Insert)
+{
+	const Bench::Timer timer;
+	World w;
+	state.report("ms", timer.seconds() * 1e3);
+	state.report("height", static_cast<double>(w.index.height()));
+
+	const Bench::Timer optimize;
+	w.index.optimize();
+	state.report("optimize_ms", optimize.seconds() * 1e3);
+	state.report("optimized_height", static_cast<double>(w.index.height()));
+}
+
+// a tenth of the objects move a little each frame, and one in a hundred of those jumps
+GLARE_BENCHMARK(SpatialIndex, Move)
+{
+	World w;
+	std::uniform_int_distribution<std::size_t> pick {0, object_count - 1};
+	std::uniform_real_distribution<float> step {-0.2f, 0.2f};
+	std::uniform_real_distribution<float> jump {-50, 50};
+
+	std::size_t reinserted {0};
+	const Bench::Timer timer;
+	for (std::size_t i = 0; i != object_count / 10; ++i) {
+		const auto p = w.proxies[pick(w.rng)];
+		Aabb& b {w.objects[w.index.handle(p)]};
+		const float d {i % 100 == 0 ? jump(w.rng) : step(w.rng)};
+		b.min[0] += d;
+		b.max[0] += d;
+		reinserted += w.index.move(p, b);
+	}
+	state.report("ms_per_frame", timer.seconds() * 1e3);
+	state.report("reinserted", static_cast<double>(reinserted));
+}
+
+// camera culling, against testing every object
+GLARE_BENCHMARK(SpatialIndex, Frustum)
+{
+	World w;
+	const auto f = camera();
+	std::vector<Objects::Stable_index> out(object_count);
+
+	const Bench::Timer query;
+	const auto found = w.index.query(f, {out.data(), out.size()});
+	state.report("query_ms", query.seconds() * 1e3);
+
+	w.index.optimize();
+	const Bench::Timer optimized;
+	w.index.query(f, {out.data(), out.size()});
+	state.report("optimized_query_ms", optimized.seconds() * 1e3);
+
+	std::size_t scanned {0};
+	const Bench::Timer scan;
+	for (auto it = w.objects.begin(); it != w.objects.end(); ++it)
+		if (visible(f, *it))
+			out[scanned++] = Objects::Stable_index {it};
+	state.report("scan_ms", scan.seconds() * 1e3);
+	state.report("visible", static_cast<double>(found));
+	Bench::keep(out);
+}
+
+// a thousand perception queries of 30 units, against testing every object for each
+GLARE_BENCHMARK(SpatialIndex, Sphere)
+{
+	World w;
+	constexpr int queries {1000};
+	std::uniform_real_distribution<float> across {0, world_size};
+	std::vector<Sphere> spheres;
+	for (int i = 0; i != queries; ++i)
+		spheres.push_back({{across(w.rng), 20, across(w.rng)}, 30});
+	std::vector<Objects::Stable_index> out(object_count);
+
+	std::size_t found {0};
+	const Bench::Timer query;
+	for (const auto& s : spheres)
+		found += w.index.query(s, {out.data(), out.size()});
+	state.report("us_per_query", query.seconds() * 1e6 / queries);
+	state.report("found_per_query", static_cast<double>(found) / queries);
+
+	w.index.optimize();
+	const Bench::Timer optimized;
+	for (const auto& s : spheres)
+		w.index.query(s, {out.data(), out.size()});
+	state.report("optimized_us_per_query", optimized.seconds() * 1e6 / queries);
+
+	// only a few, it is slow
+	constexpr int scans {10};
+	std::size_t scanned {0};
+	const Bench::Timer scan;
+	for (int i = 0; i != scans; ++i) {
+		const Sphere& s {spheres[i]};
+		for (auto it = w.objects.begin(); it != w.objects.end(); ++it) {
+			float d {0};
+			for (int a = 0; a != 3; ++a) {
+				const float x {std::max(std::max(it->min[a] - s.centre[a], s.centre[a] - it->max[a]), 0.0f)};
+				d += x * x;
+			}
+			if (d <= s.radius * s.radius)
+				out[scanned++] = Objects::Stable_index {it};
+		}
+	}
+	state.report("scan_us_per_query", scan.seconds() * 1e6 / scans);
+	Bench::keep(out);
+}
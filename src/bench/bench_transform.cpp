@@ -0,0 +1,153 @@
+#include "bench.hpp"
+#include "../glare/transform.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+	using Glare::Math::Mat4;
+	using Hierarchy = Glare::Scene::Transform_hierarchy;
+
+	// 100 rigs of 1000 bones, each bone hanging off one of the last few
+	// so that the rigs are a few hundred levels deep with some branching
+	constexpr std::size_t rig_count {100};
+	constexpr std::size_t bones_per_rig {1000};
+	constexpr std::size_t node_count {rig_count * bones_per_rig};
+	constexpr int passes {50};
+
+	std::size_t parent_of(std::size_t bone)
+	{
+		return bone - 1 - bone % 3 % bone;
+	}
+
+	Mat4 bone_matrix(std::size_t bone, int pass)
+	{
+		return Mat4::translation(0.01f * static_cast<float>(bone % 7), 0.1f, 0.001f * static_cast<float>(pass));
+	}
+
+	Hierarchy build(std::vector<Hierarchy::Node>& nodes)
+	{
+		Hierarchy h;
+		nodes.clear();
+		nodes.reserve(node_count);
+		for (std::size_t r = 0; r < rig_count; ++r) {
+			const std::size_t first {nodes.size()};
+			nodes.push_back(h.create(bone_matrix(0, 0)));
+			for (std::size_t b = 1; b < bones_per_rig; ++b)
+				nodes.push_back(h.create(bone_matrix(b, 0), nodes[first + parent_of(b)]));
+		}
+		h.update();
+		return h;
+	}
+
+	// a tree of separately allocated nodes walked recursively, for comparison
+	struct Pointer_node {
+		Mat4 local;
+		Mat4 world;
+		std::vector<std::unique_ptr<Pointer_node>> children;
+	};
+
+	void propagate(Pointer_node& n, const Mat4& parent)
+	{
+		Glare::Math::multiply(parent, n.local, n.world);
+		for (auto& c : n.children)
+			propagate(*c, n.world);
+	}
+}
+
+// every bone animated every pass
+GLARE_BENCHMARK(Transform, FullUpdate)
+{
+	std::vector<Hierarchy::Node> nodes;
+	Hierarchy h {build(nodes)};
+
+	const Bench::Timer timer;
+	for (int pass = 0; pass < passes; ++pass) {
+		for (std::size_t i = 0; i < node_count; ++i)
+			h.set_local(nodes[i], bone_matrix(i % bones_per_rig, pass));
+		h.update();
+	}
+	const double seconds {timer.seconds()};
+
+	state.report("nodes", static_cast<double>(node_count));
+	state.report("ns_per_node", seconds * 1e9 / (static_cast<double>(node_count) * passes));
+}
+
+// the same, walking separately allocated nodes recursively
+GLARE_BENCHMARK(Transform, PointerChasingBaseline)
+{
+	std::vector<std::unique_ptr<Pointer_node>> roots;
+	std::vector<Pointer_node*> all;
+	all.reserve(node_count);
+	for (std::size_t r = 0; r < rig_count; ++r) {
+		roots.push_back(std::make_unique<Pointer_node>());
+		const std::size_t first {all.size()};
+		all.push_back(roots.back().get());
+		for (std::size_t b = 1; b < bones_per_rig; ++b) {
+			auto& siblings = all[first + parent_of(b)]->children;
+			siblings.push_back(std::make_unique<Pointer_node>());
+			all.push_back(siblings.back().get());
+		}
+	}
+
+	const Bench::Timer timer;
+	for (int pass = 0; pass < passes; ++pass) {
+		for (std::size_t i = 0; i < node_count; ++i)
+			all[i]->local = bone_matrix(i % bones_per_rig, pass);
+		for (auto& r : roots)
+			propagate(*r, Mat4::identity());
+		Bench::keep(roots);
+	}
+	const double seconds {timer.seconds()};
+
+	state.report("nodes", static_cast<double>(node_count));
+	state.report("ns_per_node", seconds * 1e9 / (static_cast<double>(node_count) * passes));
+}
+
+// one bone in twenty animated, near the leaves
+GLARE_BENCHMARK(Transform, SparseUpdate)
+{
+	std::vector<Hierarchy::Node> nodes;
+	Hierarchy h {build(nodes)};
+
+	const Bench::Timer timer;
+	for (int pass = 0; pass < passes; ++pass) {
+		for (std::size_t r = 0; r < rig_count; ++r)
+			for (std::size_t b = bones_per_rig - bones_per_rig / 20; b < bones_per_rig; ++b)
+				h.set_local(nodes[r * bones_per_rig + b], bone_matrix(b, pass));
+		h.update();
+	}
+	const double seconds {timer.seconds()};
+
+	state.report("nodes", static_cast<double>(node_count));
+	state.report("ns_per_node", seconds * 1e9 / (static_cast<double>(node_count) * passes));
+}
+
+GLARE_BENCHMARK(Transform, ParallelScaling)
+{
+	std::vector<Hierarchy::Node> nodes;
+	Hierarchy h {build(nodes)};
+
+	double single {0};
+	for (const auto t : Bench::thread_counts()) {
+		Glare::Utility::Job_system jobs {t - 1};
+
+		double seconds {0};
+		for (int pass = 0; pass < passes; ++pass) {
+			for (std::size_t i = 0; i < node_count; ++i)
+				h.set_local(nodes[i], bone_matrix(i % bones_per_rig, pass));
+
+			const Bench::Timer timer;
+			h.update(jobs);
+			seconds += timer.seconds();
+		}
+
+		if (t == 1)
+			single = seconds;
+		const std::string suffix {"_" + std::to_string(t) + "_threads"};
+		state.report("ns_per_node" + suffix, seconds * 1e9 / (static_cast<double>(node_count) * passes));
+		state.report("speedup" + suffix, single / seconds);
+	}
+}
@@ -0,0 +1,68 @@
+#include "bench.hpp"
+#include "terrain.hpp"
+#include "../glare/video.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+	using Glare::Math::Mat4;
+	using Glare::Video::Rasterizer;
+	using Bench::Terrain;
+
+	constexpr std::size_t width {1920};
+	constexpr std::size_t height {1080};
+	constexpr int frames {10};
+
+	void frame(Rasterizer& r, const Terrain& t, int f)
+	{
+		const Mat4 projection {Mat4::perspective(1.0f, static_cast<float>(width) / height, 0.1f, 300)};
+		const Mat4 to_clip {projection * Mat4::translation(std::sin(static_cast<float>(f)), 0, 0)};
+		r.draw({t.vertices.data(), t.vertices.size()}, {t.indices.data(), t.indices.size()}, to_clip);
+	}
+
+	void render_scaling(Bench::State& state, std::uint32_t size)
+	{
+		const Terrain terrain {size};
+		Rasterizer r {width, height};
+		r.set_cull_back_faces(true);
+
+		double single {0};
+		for (const auto t : Bench::thread_counts()) {
+			Glare::Utility::Job_system jobs {t - 1};
+			frame(r, terrain, 0);
+			r.render(jobs); // warm up
+
+			const Bench::Timer timer;
+			for (int f = 0; f != frames; ++f) {
+				frame(r, terrain, f);
+				r.render(jobs);
+			}
+			const double seconds {timer.seconds() / frames};
+
+			if (t == 1)
+				single = seconds;
+			const std::string suffix {"_" + std::to_string(t) + "_threads"};
+			state.report("ms_per_frame" + suffix, seconds * 1e3);
+			state.report("mtris_per_s" + suffix, static_cast<double>(terrain.indices.size() / 3) / seconds / 1e6);
+			state.report("speedup" + suffix, single / seconds);
+		}
+		state.report("triangles_drawn", static_cast<double>(r.triangle_count()));
+		Bench::keep(r.image()[width * height / 2]);
+	}
+}
+
+// 1920x1080 with about 130 thousand triangles queued
+GLARE_BENCHMARK(Video, Render1080p)
+{
+	render_scaling(state, 256);
+}
+
+// the same with about a million, where setup and binning dominate
+GLARE_BENCHMARK(Video, Render1080pDense)
+{
+	render_scaling(state, 724);
+}
@@ -0,0 +1,51 @@
+#ifndef GLARE_BENCH_TERRAIN_HPP
+#define GLARE_BENCH_TERRAIN_HPP
+
+#include "../glare/video.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Bench {
+	// rolling terrain of size x size quads seen from just above it, running
+	// from behind the camera to the horizon so that near clipping happens,
+	// and dense enough that most triangles cover a few pixels
+	struct Terrain {
+		explicit Terrain(std::uint32_t size)
+		{
+			for (std::uint32_t z = 0; z <= size; ++z) {
+				for (std::uint32_t x = 0; x <= size; ++x) {
+					const float fx {static_cast<float>(x) / static_cast<float>(size) * 200 - 100};
+					const float fz {static_cast<float>(z) / static_cast<float>(size) * -200 + 5};
+					const float y {height(fx, fz, 0)};
+					vertices.push_back({{fx, y, fz}, Glare::Video::rgba(static_cast<std::uint8_t>(x * 7),
+						static_cast<std::uint8_t>(z * 5), static_cast<std::uint8_t>(128 + y * 20))});
+				}
+			}
+			for (std::uint32_t z = 0; z != size; ++z) {
+				for (std::uint32_t x = 0; x != size; ++x) {
+					const std::uint32_t i {z * (size + 1) + x};
+					indices.insert(indices.end(), {i, i + 1, i + size + 2, i, i + size + 2, i + size + 1});
+				}
+			}
+		}
+
+		static float height(float x, float z, float phase)
+		{
+			return std::sin(x * 0.3f + phase) * std::cos(z * 0.2f) * 2 - 3;
+		}
+
+		// the waves roll on, for refitting
+		void animate(float phase)
+		{
+			for (auto& v : vertices)
+				v.position[1] = height(v.position[0], v.position[2], phase);
+		}
+
+		std::vector<Glare::Video::Vertex> vertices;
+		std::vector<std::uint32_t> indices;
+	};
+}
+
+#endif // !GLARE_BENCH_TERRAIN_HPP
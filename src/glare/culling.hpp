@@ -0,0 +1,604 @@
+#ifndef GLARE_CULLING_HPP
+#define GLARE_CULLING_HPP
+
+#include "error.hpp"
+#include "job_system.hpp"
+#include "math.hpp"
+#include "parallel.hpp"
+#include "profile.hpp"
+#include "slot_map.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Glare {
+	namespace Scene {
+		// an object a Culler found visible, and the level of detail it should be drawn at
+		template<typename Handle>
+		struct Visible {
+			Handle handle;
+			std::uint32_t lod; // 0 is the most detailed
+		};
+
+		// finds which objects a camera sees by testing every one of their bounds,
+		// a Math::Sphere or Math::Aabb, straight from the dense storage of a
+		// Slot_map or the columns an Ecs view walks
+		// bounds are tested a batch at a time with the widest SIMD available, and
+		// split into chunks that run on a Job_system
+		// suits objects that mostly move each frame, where a Spatial_index would
+		// spend longer keeping up than the test takes
+		template<typename Handle, typename Bound = Math::Sphere>
+		class Culler {
+			static_assert(std::is_same<Bound, Math::Sphere>::value || std::is_same<Bound, Math::Aabb>::value,
+						  "bounds must be spheres or boxes");
+		public:
+			using size_type = std::size_t;
+			using Visible = Scene::Visible<Handle>;
+
+			using Too_many_lods = Error::Scene_too_many_lods;
+
+			static constexpr size_type batch {16}; // objects tested per iteration
+			static constexpr size_type max_lods {8};
+			// objects per job, a whole number of batches
+			static constexpr size_type chunk_size {batch * 2048};
+
+			// sees everything until a view is set
+			Culler();
+
+			// sees what the frustum of to_clip holds, from eye in the same space
+			void set_view(const Math::Mat4& to_clip, const float (&eye)[3]);
+			// objects whose centre is at least distances[i] from the eye get lod
+			// i + 1 or coarser, distances should be ascending
+			// throws Too_many_lods past max_lods - 1 distances
+			void set_lod_distances(Utility::Span<const float> distances);
+			// objects wholly further than this from the eye are culled, none are by default
+			void set_max_distance(float);
+
+			// each writes the objects in view with their level of detail to out, as
+			// many as fit, and returns how many there were in all
+			// objects come out in the order they are stored
+			// Handle must be the Stable_index or Stable_const_index of the Slot_map
+			template<typename H, typename A>
+			size_type cull(Utility::Job_system&, Slot_map<Bound, H, Soa_storage, A>&, Utility::Span<Visible> out);
+			template<typename H, typename A>
+			size_type cull(Slot_map<Bound, H, Soa_storage, A>&, Utility::Span<Visible> out);
+			// a view of Bound alone, from an Entity_manager whose Entity is Handle
+			template<typename View>
+			size_type cull(Utility::Job_system&, const View&, Utility::Span<Visible> out);
+			template<typename View>
+			size_type cull(const View&, Utility::Span<Visible> out);
+		private:
+			// the visible objects of one chunk, kept between frames to reuse the memory
+			struct Chunk {
+				std::vector<Visible> visible;
+				size_type count {0};
+			};
+
+			template<typename H, typename A>
+			size_type cull_map(Utility::Job_system*, Slot_map<Bound, H, Soa_storage, A>&, Utility::Span<Visible> out);
+			template<typename View>
+			size_type cull_view(Utility::Job_system*, const View&, Utility::Span<Visible> out);
+
+			// makes room for count chunks of up to size objects each
+			void prepare(size_type count);
+			void prepare(Chunk&, size_type size);
+			// calls f(c) for every chunk c < count, on jobs if there are any
+			template<typename F>
+			static void run(Utility::Job_system*, size_type count, F&& f);
+			// copies the first count chunks to out in order
+			size_type gather(Utility::Job_system*, size_type count, Utility::Span<Visible> out) const;
+
+			// the view with every constant set across the lanes of L, made once
+			// per chunk rather than once per batch
+			template<typename L>
+			struct Prepared {
+				typename L::F plane[6][4];
+				typename L::F reach[6][3]; // magnitudes of the plane normals, for boxes
+				typename L::F eye[3];
+				typename L::F max_distance;
+				typename L::F lod_squared[max_lods - 1];
+			};
+
+			template<typename L>
+			Prepared<L> prepared() const;
+			// writes the visible objects of [p, p + n) to out, handle(i) naming
+			// object i, and returns how many there were
+			template<typename L, typename F>
+			size_type cull_range(const Prepared<L>&, const Bound* p, size_type n, F handle, Visible* out) const;
+			// tests batch objects from p, returning a bit for each visible one and
+			// writing the level of detail of each to lods
+			template<typename L>
+			std::uint32_t test(const Prepared<L>&, const Bound* p, float* lods) const;
+			template<typename L>
+			std::uint32_t test_lanes(const Prepared<L>&, const Bound* p, float* lods) const;
+
+			Math::Frustum frustum;
+			float eye[3] {};
+			float lod_squared[max_lods - 1] {}; // lod distances squared
+			size_type lod_count {0};
+			float max_distance {std::numeric_limits<float>::infinity()};
+			std::vector<Chunk> chunks;
+		};
+
+		namespace Impl {
+			// a group of bounds tested at once, as wide as the instruction set allows
+			// loads take bounds as laid out in memory and turn them into one
+			// register per field
+			struct Scalar_cull_lanes {
+				static constexpr int width {1};
+				using F = float;
+				using M = bool;
+
+				static F set(float x) { return x; }
+				static F add(F a, F b) { return a + b; }
+				static F sub(F a, F b) { return a - b; }
+				static F mul(F a, F b) { return a * b; }
+				static F sqrt(F x) { return std::sqrt(x); }
+				static M greater_equal(F a, F b) { return a >= b; }
+				static M less_equal(F a, F b) { return a <= b; }
+				static M both(M a, M b) { return a && b; }
+				static F ones(M m) { return m ? 1.0f : 0.0f; }
+				static std::uint32_t bits(M m) { return m; }
+				static void store(float* p, F x) { *p = x; }
+
+				static void load(const Math::Sphere* p, F (&centre)[3], F& radius)
+				{
+					for (int i = 0; i != 3; ++i)
+						centre[i] = p->centre[i];
+					radius = p->radius;
+				}
+				static void load(const Math::Aabb* p, F (&min)[3], F (&max)[3])
+				{
+					for (int i = 0; i != 3; ++i) {
+						min[i] = p->min[i];
+						max[i] = p->max[i];
+					}
+				}
+			};
+
+#if defined(GLARE_AVX2)
+			struct Cull_lanes {
+				static constexpr int width {8};
+				using F = __m256;
+				using M = __m256;
+
+				static F set(float x) { return _mm256_set1_ps(x); }
+				static F add(F a, F b) { return _mm256_add_ps(a, b); }
+				static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+				static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+				static F sqrt(F x) { return _mm256_sqrt_ps(x); }
+				static M greater_equal(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+				static M less_equal(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+				static M both(M a, M b) { return _mm256_and_ps(a, b); }
+				static F ones(M m) { return _mm256_and_ps(m, set(1)); }
+				static std::uint32_t bits(M m) { return static_cast<std::uint32_t>(_mm256_movemask_ps(m)); }
+				static void store(float* p, F x) { _mm256_storeu_ps(p, x); }
+
+				// 4 floats from each of p and p + stride * 4, the second in the upper half
+				static F row(const float* p, std::size_t stride)
+				{
+					return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + stride * 4), 1);
+				}
+				// transposes each half of the rows as a 4x4 matrix
+				static void transpose(F& a, F& b, F& c, F& d)
+				{
+					const F t0 {_mm256_unpacklo_ps(a, b)}, t1 {_mm256_unpacklo_ps(c, d)};
+					const F t2 {_mm256_unpackhi_ps(a, b)}, t3 {_mm256_unpackhi_ps(c, d)};
+					a = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+					b = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+					c = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+					d = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+				}
+
+				static void load(const Math::Sphere* p, F (&centre)[3], F& radius)
+				{
+					constexpr std::size_t stride {sizeof(Math::Sphere) / sizeof(float)};
+					const float* f {p->centre};
+					centre[0] = row(f, stride);
+					centre[1] = row(f + stride, stride);
+					centre[2] = row(f + stride * 2, stride);
+					radius = row(f + stride * 3, stride);
+					transpose(centre[0], centre[1], centre[2], radius);
+				}
+				// min and max are each loaded as 4 floats, with the last of min
+				// overlapping the first of max
+				static void load(const Math::Aabb* p, F (&min)[3], F (&max)[3])
+				{
+					constexpr std::size_t stride {sizeof(Math::Aabb) / sizeof(float)};
+					const float* f {p->min};
+					F low[4], high[4];
+					for (std::size_t i = 0; i != 4; ++i) {
+						low[i] = row(f + stride * i, stride);
+						high[i] = row(f + stride * i + 2, stride);
+					}
+					transpose(low[0], low[1], low[2], low[3]);
+					transpose(high[0], high[1], high[2], high[3]);
+					for (int i = 0; i != 3; ++i) {
+						min[i] = low[i];
+						max[i] = high[i + 1];
+					}
+				}
+			};
+#elif defined(GLARE_SSE)
+			struct Cull_lanes {
+				static constexpr int width {4};
+				using F = __m128;
+				using M = __m128;
+
+				static F set(float x) { return _mm_set1_ps(x); }
+				static F add(F a, F b) { return _mm_add_ps(a, b); }
+				static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+				static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+				static F sqrt(F x) { return _mm_sqrt_ps(x); }
+				static M greater_equal(F a, F b) { return _mm_cmpge_ps(a, b); }
+				static M less_equal(F a, F b) { return _mm_cmple_ps(a, b); }
+				static M both(M a, M b) { return _mm_and_ps(a, b); }
+				static F ones(M m) { return _mm_and_ps(m, set(1)); }
+				static std::uint32_t bits(M m) { return static_cast<std::uint32_t>(_mm_movemask_ps(m)); }
+				static void store(float* p, F x) { _mm_storeu_ps(p, x); }
+
+				static void load(const Math::Sphere* p, F (&centre)[3], F& radius)
+				{
+					constexpr std::size_t stride {sizeof(Math::Sphere) / sizeof(float)};
+					const float* f {p->centre};
+					centre[0] = _mm_loadu_ps(f);
+					centre[1] = _mm_loadu_ps(f + stride);
+					centre[2] = _mm_loadu_ps(f + stride * 2);
+					radius = _mm_loadu_ps(f + stride * 3);
+					_MM_TRANSPOSE4_PS(centre[0], centre[1], centre[2], radius);
+				}
+				// min and max are each loaded as 4 floats, with the last of min
+				// overlapping the first of max
+				static void load(const Math::Aabb* p, F (&min)[3], F (&max)[3])
+				{
+					constexpr std::size_t stride {sizeof(Math::Aabb) / sizeof(float)};
+					const float* f {p->min};
+					F low[4], high[4];
+					for (std::size_t i = 0; i != 4; ++i) {
+						low[i] = _mm_loadu_ps(f + stride * i);
+						high[i] = _mm_loadu_ps(f + stride * i + 2);
+					}
+					_MM_TRANSPOSE4_PS(low[0], low[1], low[2], low[3]);
+					_MM_TRANSPOSE4_PS(high[0], high[1], high[2], high[3]);
+					for (int i = 0; i != 3; ++i) {
+						min[i] = low[i];
+						max[i] = high[i + 1];
+					}
+				}
+			};
+#else
+			using Cull_lanes = Scalar_cull_lanes;
+#endif
+
+			inline int lowest_bit(std::uint32_t x)
+			{
+#if defined(__GNUC__)
+				return __builtin_ctz(x);
+#else
+				int i {0};
+				for (; !(x & 1); x >>= 1)
+					++i;
+				return i;
+#endif
+			}
+		}
+	}
+}
+
+/***** IMPLEMENTATION *****/
+
+template<typename Handle, typename Bound>
+Glare::Scene::Culler<Handle, Bound>::Culler()
+{
+	for (auto& p : frustum.planes) {
+		p[0] = p[1] = p[2] = 0;
+		p[3] = 1;
+	}
+}
+
+template<typename Handle, typename Bound>
+void Glare::Scene::Culler<Handle, Bound>::set_view(const Math::Mat4& to_clip, const float (&e)[3])
+{
+	frustum = Math::frustum(to_clip);
+	std::copy(e, e + 3, eye);
+}
+
+template<typename Handle, typename Bound>
+void Glare::Scene::Culler<Handle, Bound>::set_lod_distances(Utility::Span<const float> distances)
+{
+	if (distances.size() >= max_lods)
+		throw Too_many_lods("Culler given more level of detail distances than max_lods - 1");
+
+	lod_count = distances.size();
+	for (size_type i = 0; i != lod_count; ++i)
+		lod_squared[i] = distances[i] * distances[i];
+}
+
+template<typename Handle, typename Bound>
+void Glare::Scene::Culler<Handle, Bound>::set_max_distance(float distance)
+{
+	max_distance = distance;
+}
+
+template<typename Handle, typename Bound>
+template<typename H, typename A>
+typename Glare::Scene::Culler<Handle, Bound>::size_type
+Glare::Scene::Culler<Handle, Bound>::cull(Utility::Job_system& jobs, Slot_map<Bound, H, Soa_storage, A>& sm,
+										  Utility::Span<Visible> out)
+{
+	return cull_map(&jobs, sm, out);
+}
+
+template<typename Handle, typename Bound>
+template<typename H, typename A>
+typename Glare::Scene::Culler<Handle, Bound>::size_type
+Glare::Scene::Culler<Handle, Bound>::cull(Slot_map<Bound, H, Soa_storage, A>& sm, Utility::Span<Visible> out)
+{
+	return cull_map(nullptr, sm, out);
+}
+
+template<typename Handle, typename Bound>
+template<typename View>
+typename Glare::Scene::Culler<Handle, Bound>::size_type
+Glare::Scene::Culler<Handle, Bound>::cull(Utility::Job_system& jobs, const View& view, Utility::Span<Visible> out)
+{
+	return cull_view(&jobs, view, out);
+}
+
+template<typename Handle, typename Bound>
+template<typename View>
+typename Glare::Scene::Culler<Handle, Bound>::size_type
+Glare::Scene::Culler<Handle, Bound>::cull(const View& view, Utility::Span<Visible> out)
+{
+	return cull_view(nullptr, view, out);
+}
+
+template<typename Handle, typename Bound>
+template<typename H, typename A>
+typename Glare::Scene::Culler<Handle, Bound>::size_type
+Glare::Scene::Culler<Handle, Bound>::cull_map(Utility::Job_system* jobs, Slot_map<Bound, H, Soa_storage, A>& sm,
+											  Utility::Span<Visible> out)
+{
+	GLARE_PROFILE_ZONE("Culler::cull");
+
+	const Utility::Span<const Bound> values {sm.values().data(), sm.size()};
+	const size_type count {(values.size() + chunk_size - 1) / chunk_size};
+	prepare(count);
+	for (size_type c = 0; c != count; ++c)
+		prepare(chunks[c], std::min(chunk_size, values.size() - c * chunk_size));
+
+	const auto first = sm.begin();
+	run(jobs, count, [this, values, first](size_type c) {
+		const size_type begin {c * chunk_size};
+		const size_type end {std::min(begin + chunk_size, values.size())};
+		const auto handle = [first, begin](size_type i) {
+			return Handle(first + static_cast<std::ptrdiff_t>(begin + i));
+		};
+		const Prepared<Impl::Cull_lanes> v {prepared<Impl::Cull_lanes>()};
+		chunks[c].count = cull_range(v, values.data() + begin, end - begin, handle, chunks[c].visible.data());
+	});
+	return gather(jobs, count, out);
+}
+
+template<typename Handle, typename Bound>
+template<typename View>
+typename Glare::Scene::Culler<Handle, Bound>::size_type
+Glare::Scene::Culler<Handle, Bound>::cull_view(Utility::Job_system* jobs, const View& view, Utility::Span<Visible> out)
+{
+	GLARE_PROFILE_ZONE("Culler::cull");
+
+	// chunks are counted first, so that none move while jobs write to them
+	size_type count {0};
+	Glare::Impl::for_each_view_chunk(view, chunk_size, nullptr, [&count](const auto&, size_type, size_type) { ++count; });
+	prepare(count);
+
+	// entities are copied a batch at a time, as a part might skip some
+	const auto cull_part = [this](const auto& part, size_type begin, size_type end, Chunk& chunk) {
+		const Prepared<Impl::Cull_lanes> v {prepared<Impl::Cull_lanes>()};
+		Handle handles[batch];
+		Bound bounds[batch];
+		size_type n {0};
+		Visible* o {chunk.visible.data()};
+		auto collect = [&](Handle h, const Bound& b) {
+			handles[n] = h;
+			bounds[n] = b;
+			if (++n == batch) {
+				o += cull_range(v, bounds, batch, [&handles](size_type i) { return handles[i]; }, o);
+				n = 0;
+			}
+		};
+		part(collect, begin, end);
+		o += cull_range(v, bounds, n, [&handles](size_type i) { return handles[i]; }, o);
+		chunk.count = static_cast<size_type>(o - chunk.visible.data());
+	};
+
+	std::vector<std::shared_ptr<const void>> parts;
+	Utility::Job_system::Counter counter;
+	size_type c {0};
+	Glare::Impl::for_each_view_chunk(view, chunk_size, jobs ? &parts : nullptr,
+		[&](const auto& part, size_type begin, size_type end) {
+			Chunk& chunk {chunks[c++]};
+			prepare(chunk, end - begin);
+			if (jobs)
+				jobs->submit([&cull_part, p = &part, begin, end, &chunk] { cull_part(*p, begin, end, chunk); }, counter);
+			else
+				cull_part(part, begin, end, chunk);
+		});
+	if (jobs)
+		jobs->wait(counter);
+
+	return gather(jobs, count, out);
+}
+
+template<typename Handle, typename Bound>
+void Glare::Scene::Culler<Handle, Bound>::prepare(size_type count)
+{
+	// never shrinks, so that the chunks keep their memory
+	if (chunks.size() < count)
+		chunks.resize(count);
+}
+
+template<typename Handle, typename Bound>
+void Glare::Scene::Culler<Handle, Bound>::prepare(Chunk& chunk, size_type size)
+{
+	if (chunk.visible.size() < size)
+		chunk.visible.resize(size);
+	chunk.count = 0;
+}
+
+template<typename Handle, typename Bound>
+template<typename F>
+void Glare::Scene::Culler<Handle, Bound>::run(Utility::Job_system* jobs, size_type count, F&& f)
+{
+	if (!jobs) {
+		for (size_type c = 0; c != count; ++c)
+			f(c);
+		return;
+	}
+
+	Utility::Job_system::Counter counter;
+	for (size_type c = 0; c != count; ++c)
+		jobs->submit([&f, c] { f(c); }, counter);
+	jobs->wait(counter);
+}
+
+template<typename Handle, typename Bound>
+typename Glare::Scene::Culler<Handle, Bound>::size_type
+Glare::Scene::Culler<Handle, Bound>::gather(Utility::Job_system* jobs, size_type count, Utility::Span<Visible> out) const
+{
+	std::vector<size_type> offsets(count + 1);
+	for (size_type c = 0; c != count; ++c)
+		offsets[c + 1] = offsets[c] + chunks[c].count;
+
+	run(jobs, count, [this, &offsets, out](size_type c) {
+		const size_type begin {std::min(offsets[c], out.size())};
+		const size_type end {std::min(offsets[c + 1], out.size())};
+		std::copy(chunks[c].visible.data(), chunks[c].visible.data() + (end - begin), out.data() + begin);
+	});
+	return offsets[count];
+}
+
+template<typename Handle, typename Bound>
+template<typename L, typename F>
+typename Glare::Scene::Culler<Handle, Bound>::size_type
+Glare::Scene::Culler<Handle, Bound>::cull_range(const Prepared<L>& v, const Bound* p, size_type n, F handle,
+												Visible* out) const
+{
+	Visible* o {out};
+	float lods[batch];
+	const auto emit = [&](std::uint32_t bits, size_type first) {
+		for (; bits; bits &= bits - 1) {
+			const int k {Impl::lowest_bit(bits)};
+			*o++ = {handle(first + static_cast<size_type>(k)), static_cast<std::uint32_t>(lods[k])};
+		}
+	};
+
+	size_type i {0};
+	for (; i + batch <= n; i += batch)
+		emit(test(v, p + i, lods), i);
+
+	// the last few are tested from a copy, so that loads stay in bounds
+	if (i != n) {
+		Bound rest[batch] {};
+		std::copy(p + i, p + n, rest);
+		emit(test(v, rest, lods) & ((1u << (n - i)) - 1), i);
+	}
+	return static_cast<size_type>(o - out);
+}
+
+template<typename Handle, typename Bound>
+template<typename L>
+typename Glare::Scene::Culler<Handle, Bound>::template Prepared<L> Glare::Scene::Culler<Handle, Bound>::prepared() const
+{
+	Prepared<L> v;
+	for (int i = 0; i != 6; ++i) {
+		for (int j = 0; j != 4; ++j)
+			v.plane[i][j] = L::set(frustum.planes[i][j]);
+		for (int j = 0; j != 3; ++j)
+			v.reach[i][j] = L::set(std::abs(frustum.planes[i][j]));
+	}
+	for (int i = 0; i != 3; ++i)
+		v.eye[i] = L::set(eye[i]);
+	v.max_distance = L::set(max_distance);
+	for (size_type i = 0; i != lod_count; ++i)
+		v.lod_squared[i] = L::set(lod_squared[i]);
+	return v;
+}
+
+template<typename Handle, typename Bound>
+template<typename L>
+std::uint32_t Glare::Scene::Culler<Handle, Bound>::test(const Prepared<L>& v, const Bound* p, float* lods) const
+{
+	std::uint32_t bits {0};
+	for (size_type k = 0; k != batch; k += L::width)
+		bits |= test_lanes<L>(v, p + k, lods + k) << k;
+	return bits;
+}
+
+template<typename Handle, typename Bound>
+template<typename L>
+std::uint32_t Glare::Scene::Culler<Handle, Bound>::test_lanes(const Prepared<L>& v, const Bound* p, float* lods) const
+{
+	using F = typename L::F;
+	using M = typename L::M;
+
+	// centres, and how far each reaches towards a plane
+	F centre[3], extent[3], radius;
+	if constexpr (std::is_same<Bound, Math::Sphere>::value) {
+		L::load(p, centre, radius);
+	} else {
+		F min[3], max[3];
+		L::load(p, min, max);
+		for (int i = 0; i != 3; ++i) {
+			centre[i] = L::mul(L::add(min[i], max[i]), L::set(0.5f));
+			extent[i] = L::mul(L::sub(max[i], min[i]), L::set(0.5f));
+		}
+	}
+
+	const F zero {L::set(0)};
+	M in {L::greater_equal(zero, zero)};
+	for (int i = 0; i != 6; ++i) {
+		const auto& q = v.plane[i];
+		const F distance {L::add(L::add(L::add(L::mul(q[0], centre[0]), L::mul(q[1], centre[1])),
+			L::mul(q[2], centre[2])), q[3])};
+		F reach;
+		if constexpr (std::is_same<Bound, Math::Sphere>::value)
+			reach = radius;
+		else
+			reach = L::add(L::add(L::mul(v.reach[i][0], extent[0]), L::mul(v.reach[i][1], extent[1])),
+				L::mul(v.reach[i][2], extent[2]));
+		in = L::both(in, L::greater_equal(L::add(distance, reach), zero));
+	}
+
+	std::uint32_t bits {L::bits(in)};
+	if (!bits)
+		return 0;
+
+	F d[3];
+	for (int i = 0; i != 3; ++i)
+		d[i] = L::sub(centre[i], v.eye[i]);
+	const F squared {L::add(L::add(L::mul(d[0], d[0]), L::mul(d[1], d[1])), L::mul(d[2], d[2]))};
+
+	if (max_distance != std::numeric_limits<float>::infinity()) {
+		if constexpr (std::is_same<Bound, Math::Aabb>::value)
+			radius = L::sqrt(L::add(L::add(L::mul(extent[0], extent[0]), L::mul(extent[1], extent[1])),
+				L::mul(extent[2], extent[2])));
+		const F reach {L::add(v.max_distance, radius)};
+		bits &= L::bits(L::less_equal(squared, L::mul(reach, reach)));
+	}
+
+	F lod {zero};
+	for (size_type i = 0; i != lod_count; ++i)
+		lod = L::add(lod, L::ones(L::greater_equal(squared, v.lod_squared[i])));
+	L::store(lods, lod);
+	return bits;
+}
+
+#endif // !GLARE_CULLING_HPP
@@ -1,11 +1,22 @@
 #ifndef GLARE_ECS_HPP
 #define GLARE_ECS_HPP
 
+#include "error.hpp"
+#include "profile.hpp"
 #include "utility.hpp"
 #include "slot_map.hpp"
+#include "sparse_set.hpp"
 
+#include <array>
+#include <initializer_list>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace Glare {
 	// Entity component system
@@ -20,32 +31,1572 @@ namespace Glare {
 			template<template<typename> class Cont, typename T>
 			using Variadic_cont = decltype(typelist_helper<Cont>(std::declval<T>()));
 
-			template<typename T>
-			struct Indexed_element {
-				// TODO
-			};
+			// position of T in Ts
+			template<typename T, typename... Ts>
+			struct Index_of;
+
+			template<typename T, typename... Ts>
+			struct Index_of<T, T, Ts...> : std::integral_constant<std::size_t, 0> {};
+
+			template<typename T, typename U, typename... Ts>
+			struct Index_of<T, U, Ts...> : std::integral_constant<std::size_t, 1 + Index_of<T, Ts...>::value> {};
+
+			template<typename T, typename... Ts>
+			struct Contains : std::disjunction<std::is_same<T, Ts>...> {};
+
+			// true if no type appears twice in Ts
+			template<typename... Ts>
+			struct Are_unique : std::true_type {};
 
+			template<typename T, typename... Ts>
+			struct Are_unique<T, Ts...>
+				: std::bool_constant<!Contains<T, Ts...>::value && Are_unique<Ts...>::value> {};
+
+			// one contiguous array per component type
 			template<typename T>
-			using Slot_pointer = typename Slot_map<T>::pointer;
+			using Column = std::vector<T>;
 		}
 
+		// specialise as std::true_type to have Entity_manager record when
+		// components of type T are added or changed, see View::changed
+		template<typename T>
+		struct Track_changes : std::false_type {};
+
 		// a manager class, how original
 		// T is a list of all the component types usable by Entities
+		// entities with the same set of components (an archetype) are stored
+		// together, with one contiguous array per component, so that a view
+		// only walks the arrays of the archetypes that match it
 		template<typename... T>
 		class Entity_manager {
+			static_assert(sizeof...(T) <= 64, "at most 64 component types are supported");
+			static_assert(Impl::Are_unique<T...>::value, "component types must be distinct");
+
+			using Archetype_index = std::uint32_t;
+			using Row = std::uint32_t;
+
+			// where the components of an entity are stored
+			struct Record {
+				Archetype_index archetype;
+				Row row;
+			};
+
+			using Record_map = Slot_map<Record>;
+
+			// writes and reads the archetypes directly, see snapshot.hpp
+			friend struct Snapshot::Impl::Access;
 		public:
-			Entity_manager() = default;
+			using size_type = std::size_t;
+			using Mask = std::uint64_t; // bit n set if the nth component is present
+			using Tick = std::uint32_t;
+
+			using Missing_component = Error::Ecs_missing_component;
+			using Not_valid = typename Record_map::Not_valid;
 
+			// handle to an entity, stays valid until the entity is destroyed
 			class Entity {
 			public:
+				friend class Entity_manager;
+
+				Entity() = default; // doesn't refer to an entity
 
+				bool operator==(Entity) const;
+				bool operator!=(Entity) const;
 			private:
-				std::tuple<Impl::Slot_pointer<T>...> ptr;
+				explicit Entity(typename Record_map::Stable_index);
+
+				typename Record_map::Stable_index index;
 			};
+
+			// all entities that have every component in C
+			// a const component is only passed by const reference, a non-const
+			// one is marked changed for every entity visited if it is tracked
+			template<typename... C>
+			class View {
+			public:
+				friend class Entity_manager;
+
+				// the same view, keeping only entities whose U was changed or
+				// added after since, U must be tracked
+				// since defaults to the tick before the current one, keeping only
+				// changes made during this tick
+				template<typename U>
+				View changed(Tick since) const;
+				template<typename U>
+				View changed() const;
+				template<typename U>
+				View added(Tick since) const;
+				template<typename U>
+				View added() const;
+
+				// calls f(C&...) or f(Entity, C&...) for every matching entity
+				template<typename F>
+				void each(F&& f) const;
+
+				// splits the matching entities into runs for parallel iteration
+				// calls g(n, part) for every run of n entities, where part(f, begin, end)
+				// calls f like each does for the entities [begin, end) of the run
+				// parts are invalidated along with references to components
+				template<typename G>
+				void partition(G&& g) const;
+
+				size_type size() const;
+			private:
+				explicit View(Entity_manager*);
+
+				// tick columns compared against by the filters, for one archetype
+				struct Filters {
+					// checks every filter but the first
+					bool accepts(size_type row) const;
+
+					std::array<const Tick*, 2 * sizeof...(T)> tick;
+					std::array<Tick, 2 * sizeof...(T)> since;
+					size_type count {0};
+				};
+
+				Filters filters(Archetype_index) const;
+
+				Entity_manager* manager;
+				Mask changed_mask {0};
+				Mask added_mask {0};
+				std::array<Tick, sizeof...(T)> changed_since {};
+				std::array<Tick, sizeof...(T)> added_since {};
+			};
+
+			// creations and destructions recorded by several threads at once,
+			// each thread using its own Buffer, with no locking
+			// an entity gets its handle as soon as it is queued, commit then
+			// creates every queued entity and destroys every queued one, going
+			// through the buffers in order so the result doesn't depend on timing
+			// the manager must not be changed between reset and commit
+			class Command_queue {
+			public:
+				class Buffer {
+				public:
+					friend class Command_queue;
+
+					// the entity is valid once the queue has been committed
+					template<typename... C>
+					Entity create(C&&... components);
+					// invalid entities are ignored at commit
+					void destroy(Entity);
+				private:
+					struct Creation {
+						Entity entity;
+						Mask mask;
+					};
+
+					Buffer(Command_queue*, size_type);
+
+					void clear();
+
+					Command_queue* queue;
+					size_type index; // of the matching Record_map buffer
+					std::vector<Creation> creation;
+					Impl::Variadic_cont<Impl::Column, Impl::Typelist<T...>> components; // in order of creation
+					std::vector<Entity> deletion;
+				};
+
+				explicit Command_queue(Entity_manager&, size_type buffer_count = 1);
+
+				Command_queue(const Command_queue&) = delete;
+				Command_queue& operator=(const Command_queue&) = delete;
+
+				using Out_of_range = Error::Slot_map_out_of_range;
+
+				// starts a new round with buffer_count empty buffers
+				// buffers past the count keep their memory for later rounds
+				// invalidates references to buffers
+				void reset(size_type buffer_count);
+				size_type buffer_count() const;
+				// throws Out_of_range past buffer_count
+				Buffer& buffer(size_type);
+
+				void commit();
+			private:
+				template<typename C>
+				void move_component(Buffer&, std::array<size_type, sizeof...(T)>& next, Archetype_index);
+
+				Entity_manager* manager;
+				typename Record_map::Command_queue records;
+				std::vector<Buffer> buffers;
+				size_type active {0}; // buffers in use this round
+			};
+
+			Entity_manager();
+
+			// creates an entity with the given components
+			template<typename... C>
+			Entity create(C&&... components);
+			// invalid entities are ignored
+			void destroy(Entity);
+			bool is_valid(Entity) const;
+			// number of live entities
+			size_type size() const;
+
+			// constructs component C from args, replacing it if already present
+			template<typename C, typename... Args>
+			C& add(Entity, Args&&... args);
+			// does nothing if the entity doesn't have C
+			template<typename C>
+			void remove(Entity);
+
+			template<typename C>
+			bool has(Entity) const;
+			// throws Missing_component if the entity doesn't have C
+			template<typename C>
+			C& get(Entity);
+			template<typename C>
+			const C& get(Entity) const;
+			// nullptr if the entity doesn't have C
+			template<typename C>
+			C* try_get(Entity);
+			template<typename C>
+			const C* try_get(Entity) const;
+
+			// adding or removing components or entities invalidates references
+			// to components, and must not be done while iterating over a view
+			template<typename... C>
+			View<C...> view();
+
+			// number of distinct component sets currently in use
+			size_type archetype_count() const;
+
+			// creating an entity, adding a tracked component and any mutable
+			// access to one stamp it with the current tick
+			// systems that run before the writers should keep the tick they
+			// last ran at, and filter on changes since then
+			Tick tick() const;
+			// starts a new tick, usually once per frame, and returns it
+			Tick next_tick();
+			// stamps C of an entity as changed without accessing it
+			template<typename C>
+			void mark_changed(Entity);
+
+			// the set of components C, ignoring const
+			template<typename... C>
+			static constexpr Mask mask();
 		private:
-			Impl::Variadic_cont<Slot_map, Impl::Typelist<Impl::Indexed_element<T>...>> vec;
+			static constexpr Archetype_index null_archetype {std::numeric_limits<Archetype_index>::max()};
+
+			struct Archetype {
+				explicit Archetype(Mask);
+
+				Mask mask;
+				std::vector<Entity> entities;
+				Impl::Variadic_cont<Impl::Column, Impl::Typelist<T...>> columns; // unused unless in mask
+				// ticks of each tracked component
+				std::array<std::vector<Tick>, sizeof...(T)> added_tick;
+				std::array<std::vector<Tick>, sizeof...(T)> changed_tick;
+				// archetype reached by adding or removing each component, cached on first use
+				std::array<Archetype_index, sizeof...(T)> add_edge;
+				std::array<Archetype_index, sizeof...(T)> remove_edge;
+			};
+
+			template<typename C>
+			static constexpr Mask bit();
+			template<typename C>
+			static Impl::Column<C>& column(Archetype&);
+			template<typename C>
+			static const Impl::Column<C>& column(const Archetype&);
+
+			const Record& record(Entity) const;
+
+			// true if t is a later tick than since, allowing for wrap around
+			static bool is_newer(Tick t, Tick since);
+			template<typename C>
+			static void push_ticks(Archetype&, Tick added, Tick changed);
+
+			Archetype_index find_archetype(Mask);
+			template<typename C>
+			Archetype_index with(Archetype_index);
+			template<typename C>
+			Archetype_index without(Archetype_index);
+
+			// moves the components of an entity that are also in to
+			// the caller must already have added any component only in to,
+			// these are dropped again if a move throws
+			void migrate(Record&, Archetype_index to);
+			template<typename C>
+			void move_component(Archetype& from, Row, Archetype& to);
+			// swaps the last row into row
+			void remove_row(Archetype&, Row);
+			template<typename C>
+			void remove_component(Archetype&, Row);
+			// drops any components and ticks past the first rows of a, left by a
+			// row that threw part way through being pushed
+			static void truncate(Archetype& a, Row rows);
+			template<typename C>
+			static void truncate_component(Archetype&, Row rows);
+
+			Record_map records;
+			std::vector<Archetype> archetypes;
+			std::unordered_map<Mask, Archetype_index> archetype_lookup;
+			Tick current_tick {1};
 		};
+
+		// entity manager keeping each component type in its own Sparse_set
+		// adding or removing a component never moves the others of an entity
+		// a view joins its pools through the sparse arrays, unless a group owns
+		// exactly the components it asks for: a group keeps its entities at the
+		// front of every owned pool, in the same order, so that the view walks
+		// the packed arrays side by side with no lookups at all
+		template<typename... T>
+		class Sparse_entity_manager {
+			static_assert(sizeof...(T) <= 64, "at most 64 component types are supported");
+			static_assert(Impl::Are_unique<T...>::value, "component types must be distinct");
+
+			using Handle = Handle_traits<>;
+			using Id = typename Sparse_set<int>::Id;
+			using Counter = typename Handle::counter_type;
+			using Group_index = std::uint32_t;
+		public:
+			using size_type = std::size_t;
+			using Mask = std::uint64_t; // bit n set if the nth component is present
+
+			using Missing_component = Error::Ecs_missing_component;
+			using Not_valid = Error::Slot_map_stable_index_not_valid;
+			using Group_conflict = Error::Ecs_group_conflict;
+
+			// handle to an entity, stays valid until the entity is destroyed
+			class Entity {
+			public:
+				friend class Sparse_entity_manager;
+
+				Entity() = default; // doesn't refer to an entity
+
+				bool operator==(Entity) const;
+				bool operator!=(Entity) const;
+			private:
+				Entity(Id, Counter);
+
+				Id id() const;
+				Counter counter() const;
+
+				typename Handle::value_type value {Handle::null_value};
+			};
+
+			// all entities that have every component in C
+			// a const component is only passed by const reference
+			template<typename... C>
+			class View {
+			public:
+				friend class Sparse_entity_manager;
+
+				// calls f(C&...) or f(Entity, C&...) for every matching entity
+				template<typename F>
+				void each(F&& f) const;
+
+				// splits the matching entities into runs for parallel iteration
+				// calls g(n, part) for every run of n entities, where part(f, begin, end)
+				// calls f like each does for the entities [begin, end) of the run
+				// parts are invalidated along with references to components
+				template<typename G>
+				void partition(G&& g) const;
+
+				size_type size() const;
+				// true if a group makes this view walk the pools directly
+				bool is_grouped() const;
+			private:
+				explicit View(Sparse_entity_manager*);
+
+				Sparse_entity_manager* manager;
+			};
+
+			Sparse_entity_manager();
+
+			// creates an entity with the given components
+			template<typename... C>
+			Entity create(C&&... components);
+			// invalid entities are ignored
+			void destroy(Entity);
+			bool is_valid(Entity) const;
+			// number of live entities
+			size_type size() const;
+
+			// constructs component C from args, replacing it if already present
+			template<typename C, typename... Args>
+			C& add(Entity, Args&&... args);
+			// does nothing if the entity doesn't have C
+			template<typename C>
+			void remove(Entity);
+
+			template<typename C>
+			bool has(Entity) const;
+			// throws Missing_component if the entity doesn't have C
+			template<typename C>
+			C& get(Entity);
+			template<typename C>
+			const C& get(Entity) const;
+			// nullptr if the entity doesn't have C
+			template<typename C>
+			C* try_get(Entity);
+			template<typename C>
+			const C* try_get(Entity) const;
+
+			// adding or removing components or entities invalidates references
+			// to components, and must not be done while iterating over a view
+			template<typename... C>
+			View<C...> view();
+
+			// takes ownership of the pools of C and sorts them so that
+			// view<C...>() needs no lookups, calling it again is harmless
+			// throws Group_conflict if another group already owns one of C
+			template<typename... C>
+			View<C...> group();
+
+			// the packed storage of C, grouped entities first
+			template<typename C>
+			const Sparse_set<C>& pool() const;
+
+			// the set of components C, ignoring const
+			template<typename... C>
+			static constexpr Mask mask();
+		private:
+			static constexpr Group_index null_group {std::numeric_limits<Group_index>::max()};
+			// largest counter a handle can hold, null_counter marks an invalid handle
+			static constexpr Counter max_counter {Handle::null_counter - 1};
+
+			struct Slot {
+				Counter counter;
+				Mask mask;
+			};
+
+			// the first size entities of every owned pool are the members
+			struct Group {
+				Mask owned;
+				size_type size;
+			};
+
+			template<typename C>
+			static constexpr Mask bit();
+			template<typename C>
+			Sparse_set<C>& storage();
+
+			// throws Not_valid
+			Id checked_id(Entity) const;
+
+			// finds the group owning exactly the components in mask
+			Group_index find_group(Mask) const;
+			// keep the group owning C sorted, call after adding C or before removing it
+			template<typename C>
+			void enter_group(Id);
+			template<typename C>
+			void leave_group(Id);
+			template<typename C>
+			void swap_to(Id, size_type position, const Group&);
+
+			template<typename C, typename... Args>
+			C& add_component(Id, Args&&...);
+			template<typename C>
+			void remove_component(Id);
+
+			std::tuple<Sparse_set<T>...> pools;
+			std::array<Group_index, sizeof...(T)> owner; // group that sorts each pool
+			std::vector<Group> groups;
+
+			std::vector<Slot> slots;
+			std::vector<Id> free_index;
+			size_type live {0};
+		};
+	}
+}
+
+/***** IMPLEMENTATION *****/
+
+template<typename... T>
+bool Glare::Ecs::Entity_manager<T...>::Entity::operator==(Entity e) const
+{
+	return index == e.index;
+}
+
+template<typename... T>
+bool Glare::Ecs::Entity_manager<T...>::Entity::operator!=(Entity e) const
+{
+	return !(*this == e);
+}
+
+template<typename... T>
+Glare::Ecs::Entity_manager<T...>::Entity::Entity(typename Record_map::Stable_index index)
+	:index {index}
+{}
+
+template<typename... T>
+template<typename... C>
+template<typename F>
+void Glare::Ecs::Entity_manager<T...>::View<C...>::each(F&& f) const
+{
+	partition([&f](size_type n, const auto& part) { part(f, 0, n); });
+}
+
+template<typename... T>
+template<typename... C>
+template<typename U>
+typename Glare::Ecs::Entity_manager<T...>::template View<C...>
+Glare::Ecs::Entity_manager<T...>::View<C...>::changed(Tick since) const
+{
+	static_assert(Track_changes<U>::value, "changes to this component are not tracked");
+
+	View v {*this};
+	v.changed_mask |= bit<U>();
+	v.changed_since[Impl::Index_of<U, T...>::value] = since;
+	return v;
+}
+
+template<typename... T>
+template<typename... C>
+template<typename U>
+typename Glare::Ecs::Entity_manager<T...>::template View<C...>
+Glare::Ecs::Entity_manager<T...>::View<C...>::changed() const
+{
+	return changed<U>(manager->current_tick - 1);
+}
+
+template<typename... T>
+template<typename... C>
+template<typename U>
+typename Glare::Ecs::Entity_manager<T...>::template View<C...>
+Glare::Ecs::Entity_manager<T...>::View<C...>::added(Tick since) const
+{
+	static_assert(Track_changes<U>::value, "changes to this component are not tracked");
+
+	View v {*this};
+	v.added_mask |= bit<U>();
+	v.added_since[Impl::Index_of<U, T...>::value] = since;
+	return v;
+}
+
+template<typename... T>
+template<typename... C>
+template<typename U>
+typename Glare::Ecs::Entity_manager<T...>::template View<C...>
+Glare::Ecs::Entity_manager<T...>::View<C...>::added() const
+{
+	return added<U>(manager->current_tick - 1);
+}
+
+template<typename... T>
+template<typename... C>
+template<typename G>
+void Glare::Ecs::Entity_manager<T...>::View<C...>::partition(G&& g) const
+{
+	constexpr Mask required {mask<C...>()};
+	// tracked components that may be written are stamped on every visit
+	constexpr bool stamps {(false || ... || (!std::is_const<C>::value && Track_changes<std::remove_const_t<C>>::value))};
+	const Tick now {manager->current_tick};
+
+	for (Archetype_index x = 0; x != manager->archetypes.size(); ++x) {
+		auto& a = manager->archetypes[x];
+		if ((a.mask & (required | changed_mask | added_mask)) != (required | changed_mask | added_mask)
+			|| a.entities.empty())
+			continue;
+
+		const Entity* entity {a.entities.data()};
+		// pointers are loaded once per archetype rather than per entity
+		const std::tuple<C*...> data {column<std::remove_const_t<C>>(a).data()...};
+		const std::array<Tick*, sizeof...(C)> stamp {
+			(!std::is_const<C>::value && Track_changes<std::remove_const_t<C>>::value
+			 ? a.changed_tick[Impl::Index_of<std::remove_const_t<C>, T...>::value].data() : nullptr)...};
+		const Filters filter {filters(x)};
+
+		g(a.entities.size(), [entity, data, stamp, filter, now](auto& f, size_type begin, size_type end) {
+			std::apply([&](auto*... p) {
+				const auto visit = [&](size_type i) {
+					if constexpr (stamps)
+						for (const auto t : stamp)
+							if (t)
+								t[i] = now;
+
+					if constexpr (std::is_invocable<decltype(f), Entity, C&...>::value)
+						f(entity[i], p[i]...);
+					else
+						f(p[i]...);
+				};
+
+				if (filter.count == 0) {
+					for (size_type i {begin}; i != end; ++i)
+						visit(i);
+					return;
+				}
+
+				// the first filter rejects most rows, so it gets a tight loop of its own
+				const Tick* tick {filter.tick[0]};
+				const Tick since {filter.since[0]};
+				for (size_type i {begin}; i != end; ++i)
+					if (is_newer(tick[i], since) && filter.accepts(i))
+						visit(i);
+			}, data);
+		});
+	}
+}
+
+template<typename... T>
+template<typename... C>
+typename Glare::Ecs::Entity_manager<T...>::size_type
+Glare::Ecs::Entity_manager<T...>::View<C...>::size() const
+{
+	const Mask required {mask<C...>() | changed_mask | added_mask};
+
+	size_type n {0};
+	for (Archetype_index x = 0; x != manager->archetypes.size(); ++x) {
+		const auto& a = manager->archetypes[x];
+		if ((a.mask & required) != required)
+			continue;
+
+		if (!(changed_mask | added_mask)) {
+			n += a.entities.size();
+			continue;
+		}
+
+		const auto filter = filters(x);
+		for (size_type i = 0; i != a.entities.size(); ++i)
+			n += is_newer(filter.tick[0][i], filter.since[0]) && filter.accepts(i);
+	}
+
+	return n;
+}
+
+template<typename... T>
+template<typename... C>
+typename Glare::Ecs::Entity_manager<T...>::template View<C...>::Filters
+Glare::Ecs::Entity_manager<T...>::View<C...>::filters(Archetype_index x) const
+{
+	const auto& a = manager->archetypes[x];
+
+	Filters f;
+	for (size_type k = 0; k != sizeof...(T); ++k) {
+		if (changed_mask >> k & 1) {
+			f.tick[f.count] = a.changed_tick[k].data();
+			f.since[f.count++] = changed_since[k];
+		}
+		if (added_mask >> k & 1) {
+			f.tick[f.count] = a.added_tick[k].data();
+			f.since[f.count++] = added_since[k];
+		}
+	}
+
+	return f;
+}
+
+template<typename... T>
+template<typename... C>
+bool Glare::Ecs::Entity_manager<T...>::View<C...>::Filters::accepts(size_type row) const
+{
+	for (size_type k = 1; k < count; ++k)
+		if (!is_newer(tick[k][row], since[k]))
+			return false;
+
+	return true;
+}
+
+template<typename... T>
+template<typename... C>
+Glare::Ecs::Entity_manager<T...>::View<C...>::View(Entity_manager* manager)
+	:manager {manager}
+{}
+
+template<typename... T>
+template<typename... C>
+typename Glare::Ecs::Entity_manager<T...>::Entity
+Glare::Ecs::Entity_manager<T...>::Command_queue::Buffer::create(C&&... components)
+{
+	static_assert(Impl::Are_unique<std::decay_t<C>...>::value, "component types must be distinct");
+
+	// the components go in before the handle is reserved, so that if any of
+	// them throws the columns are put back and no entity is left half queued
+	const std::array<size_type, sizeof...(C)> sizes {std::get<Impl::Column<std::decay_t<C>>>(this->components).size()...};
+	Entity e;
+	try {
+		(Glare::Impl::emplace_back(std::get<Impl::Column<std::decay_t<C>>>(this->components),
+								   std::forward<C>(components)), ...);
+		creation.reserve(creation.size() + 1);
+		e = Entity {queue->records.buffer(index).buffered_add(Record {null_archetype, 0})};
+	}
+	catch (...) {
+		size_type i {0};
+		((std::get<Impl::Column<std::decay_t<C>>>(this->components).size() != sizes[i++]
+		  ? std::get<Impl::Column<std::decay_t<C>>>(this->components).pop_back() : void()), ...);
+		throw;
+	}
+	creation.push_back({e, mask<std::decay_t<C>...>()});
+
+	return e;
+}
+
+template<typename... T>
+void Glare::Ecs::Entity_manager<T...>::Command_queue::Buffer::destroy(Entity e)
+{
+	deletion.push_back(e);
+}
+
+template<typename... T>
+Glare::Ecs::Entity_manager<T...>::Command_queue::Buffer::Buffer(Command_queue* queue, size_type index)
+	:queue {queue},
+	index {index}
+{}
+
+template<typename... T>
+void Glare::Ecs::Entity_manager<T...>::Command_queue::Buffer::clear()
+{
+	creation.clear();
+	std::apply([](auto&... c) { (c.clear(), ...); }, components);
+	deletion.clear();
+}
+
+template<typename... T>
+Glare::Ecs::Entity_manager<T...>::Command_queue::Command_queue(Entity_manager& manager, size_type buffer_count)
+	:manager {&manager},
+	records {manager.records, buffer_count}
+{
+	reset(buffer_count);
+}
+
+template<typename... T>
+void Glare::Ecs::Entity_manager<T...>::Command_queue::reset(size_type buffer_count)
+{
+	records.reset(buffer_count);
+
+	for (auto& b : buffers)
+		b.clear();
+	while (buffers.size() < buffer_count)
+		buffers.push_back(Buffer {this, buffers.size()});
+	active = buffer_count;
+}
+
+template<typename... T>
+typename Glare::Ecs::Entity_manager<T...>::size_type
+Glare::Ecs::Entity_manager<T...>::Command_queue::buffer_count() const
+{
+	return active;
+}
+
+template<typename... T>
+typename Glare::Ecs::Entity_manager<T...>::Command_queue::Buffer&
+Glare::Ecs::Entity_manager<T...>::Command_queue::buffer(size_type i)
+{
+	if (i >= active)
+		throw Out_of_range {"Command_queue buffer past buffer_count"};
+	return buffers[i];
+}
+
+template<typename... T>
+void Glare::Ecs::Entity_manager<T...>::Command_queue::commit()
+{
+	GLARE_PROFILE_ZONE("Entity_manager::Command_queue::commit");
+
+	auto& m = *manager;
+
+	// the records are created first, then pointed at their rows
+	records.commit();
+	m.records.clean_buffers();
+
+	for (auto& b : buffers) {
+		std::array<size_type, sizeof...(T)> next {}; // first unused component of each type
+		for (const auto& c : b.creation) {
+			const auto a = m.find_archetype(c.mask);
+			auto& archetype = m.archetypes[a];
+
+			m.records[c.entity.index] = {a, static_cast<Row>(archetype.entities.size())};
+			(((c.mask & bit<T>()) ? move_component<T>(b, next, a) : void()), ...);
+			archetype.entities.push_back(c.entity);
+		}
+	}
+
+	for (auto& b : buffers) {
+		for (const auto e : b.deletion)
+			m.destroy(e);
+		b.clear();
+	}
+}
+
+template<typename... T>
+template<typename C>
+void Glare::Ecs::Entity_manager<T...>::Command_queue::move_component(Buffer& b, std::array<size_type, sizeof...(T)>& next,
+																	 Archetype_index to)
+{
+	auto& i = next[Impl::Index_of<C, T...>::value];
+	auto& archetype = manager->archetypes[to];
+	Glare::Impl::emplace_back(column<C>(archetype), std::move(std::get<Impl::Column<C>>(b.components)[i++]));
+	push_ticks<C>(archetype, manager->current_tick, manager->current_tick);
+}
+
+template<typename... T>
+Glare::Ecs::Entity_manager<T...>::Entity_manager()
+{
+	find_archetype(0); // entities without components
+}
+
+template<typename... T>
+template<typename... C>
+typename Glare::Ecs::Entity_manager<T...>::Entity
+Glare::Ecs::Entity_manager<T...>::create(C&&... components)
+{
+	static_assert(Impl::Are_unique<std::decay_t<C>...>::value, "component types must be distinct");
+
+	const auto a = find_archetype(mask<std::decay_t<C>...>());
+	auto& archetype = archetypes[a];
+	const auto row = static_cast<Row>(archetype.entities.size());
+
+	// the record is only added once every component is in, so that a
+	// throwing one leaves no entity behind
+	Entity e;
+	try {
+		(Glare::Impl::emplace_back(column<std::decay_t<C>>(archetype), std::forward<C>(components)), ...);
+		(push_ticks<std::decay_t<C>>(archetype, current_tick, current_tick), ...);
+		archetype.entities.reserve(row + size_type {1});
+		e = Entity {records.add({a, row})};
+	}
+	catch (...) {
+		truncate(archetype, row);
+		throw;
+	}
+	archetype.entities.push_back(e);
+
+	return e;
+}
+
+template<typename... T>
+void Glare::Ecs::Entity_manager<T...>::destroy(Entity e)
+{
+	if (!is_valid(e))
+		return;
+
+	const auto r = records[e.index];
+	remove_row(archetypes[r.archetype], r.row);
+	records.remove(e.index);
+}
+
+template<typename... T>
+bool Glare::Ecs::Entity_manager<T...>::is_valid(Entity e) const
+{
+	return records.is_valid(e.index);
+}
+
+template<typename... T>
+typename Glare::Ecs::Entity_manager<T...>::size_type
+Glare::Ecs::Entity_manager<T...>::size() const
+{
+	return records.size();
+}
+
+template<typename... T>
+template<typename C, typename... Args>
+C& Glare::Ecs::Entity_manager<T...>::add(Entity e, Args&&... args)
+{
+	auto& r = records[e.index];
+
+	if (archetypes[r.archetype].mask & bit<C>()) {
+		auto& c = *try_get<C>(e);
+		c = Glare::Impl::construct<C>(std::forward<Args>(args)...);
+		return c;
+	}
+
+	const auto a = with<C>(r.archetype);
+	// constructed first so that a throwing constructor leaves everything intact,
+	// and migrate drops it again if moving the others throws
+	auto& col = column<C>(archetypes[a]);
+	Glare::Impl::emplace_back(col, std::forward<Args>(args)...);
+	push_ticks<C>(archetypes[a], current_tick, current_tick);
+	migrate(r, a);
+
+	return col.back();
+}
+
+template<typename... T>
+template<typename C>
+void Glare::Ecs::Entity_manager<T...>::remove(Entity e)
+{
+	auto& r = records[e.index];
+
+	if (archetypes[r.archetype].mask & bit<C>())
+		migrate(r, without<C>(r.archetype));
+}
+
+template<typename... T>
+template<typename C>
+bool Glare::Ecs::Entity_manager<T...>::has(Entity e) const
+{
+	return archetypes[record(e).archetype].mask & bit<C>();
+}
+
+template<typename... T>
+template<typename C>
+C& Glare::Ecs::Entity_manager<T...>::get(Entity e)
+{
+	if (const auto c = try_get<C>(e))
+		return *c;
+
+	throw Missing_component {"Entity does not have the requested component"};
+}
+
+template<typename... T>
+template<typename C>
+const C& Glare::Ecs::Entity_manager<T...>::get(Entity e) const
+{
+	if (const auto c = try_get<C>(e))
+		return *c;
+
+	throw Missing_component {"Entity does not have the requested component"};
+}
+
+template<typename... T>
+template<typename C>
+C* Glare::Ecs::Entity_manager<T...>::try_get(Entity e)
+{
+	const auto& r = record(e);
+	auto& a = archetypes[r.archetype];
+	if (!(a.mask & bit<C>()))
+		return nullptr;
+
+	if constexpr (Track_changes<C>::value)
+		a.changed_tick[Impl::Index_of<C, T...>::value][r.row] = current_tick;
+	return &column<C>(a)[r.row];
+}
+
+template<typename... T>
+template<typename C>
+const C* Glare::Ecs::Entity_manager<T...>::try_get(Entity e) const
+{
+	const auto& r = record(e);
+	const auto& a = archetypes[r.archetype];
+
+	return a.mask & bit<C>() ? &column<C>(a)[r.row] : nullptr;
+}
+
+template<typename... T>
+template<typename... C>
+typename Glare::Ecs::Entity_manager<T...>::template View<C...>
+Glare::Ecs::Entity_manager<T...>::view()
+{
+	static_assert(Impl::Are_unique<std::remove_const_t<C>...>::value, "component types must be distinct");
+	return View<C...> {this};
+}
+
+template<typename... T>
+typename Glare::Ecs::Entity_manager<T...>::size_type
+Glare::Ecs::Entity_manager<T...>::archetype_count() const
+{
+	return archetypes.size();
+}
+
+template<typename... T>
+typename Glare::Ecs::Entity_manager<T...>::Tick
+Glare::Ecs::Entity_manager<T...>::tick() const
+{
+	return current_tick;
+}
+
+template<typename... T>
+typename Glare::Ecs::Entity_manager<T...>::Tick
+Glare::Ecs::Entity_manager<T...>::next_tick()
+{
+	return ++current_tick;
+}
+
+template<typename... T>
+template<typename C>
+void Glare::Ecs::Entity_manager<T...>::mark_changed(Entity e)
+{
+	static_assert(Track_changes<C>::value, "changes to this component are not tracked");
+
+	if (!try_get<C>(e))
+		throw Missing_component {"Entity does not have the requested component"};
+}
+
+template<typename... T>
+Glare::Ecs::Entity_manager<T...>::Archetype::Archetype(Mask mask)
+	:mask {mask}
+{
+	add_edge.fill(null_archetype);
+	remove_edge.fill(null_archetype);
+}
+
+template<typename... T>
+template<typename... C>
+constexpr typename Glare::Ecs::Entity_manager<T...>::Mask
+Glare::Ecs::Entity_manager<T...>::mask()
+{
+	return (Mask {0} | ... | bit<std::remove_const_t<C>>());
+}
+
+template<typename... T>
+template<typename C>
+constexpr typename Glare::Ecs::Entity_manager<T...>::Mask
+Glare::Ecs::Entity_manager<T...>::bit()
+{
+	static_assert(Impl::Contains<C, T...>::value, "not a component type of this Entity_manager");
+	return Mask {1} << Impl::Index_of<C, T...>::value;
+}
+
+template<typename... T>
+template<typename C>
+Glare::Ecs::Impl::Column<C>& Glare::Ecs::Entity_manager<T...>::column(Archetype& a)
+{
+	return std::get<Impl::Index_of<C, T...>::value>(a.columns);
+}
+
+template<typename... T>
+template<typename C>
+const Glare::Ecs::Impl::Column<C>& Glare::Ecs::Entity_manager<T...>::column(const Archetype& a)
+{
+	return std::get<Impl::Index_of<C, T...>::value>(a.columns);
+}
+
+template<typename... T>
+const typename Glare::Ecs::Entity_manager<T...>::Record&
+Glare::Ecs::Entity_manager<T...>::record(Entity e) const
+{
+	return records[typename Record_map::Stable_const_index {e.index}];
+}
+
+template<typename... T>
+bool Glare::Ecs::Entity_manager<T...>::is_newer(Tick t, Tick since)
+{
+	return static_cast<std::make_signed_t<Tick>>(t - since) > 0;
+}
+
+template<typename... T>
+template<typename C>
+void Glare::Ecs::Entity_manager<T...>::push_ticks(Archetype& a, Tick added, Tick changed)
+{
+	if constexpr (Track_changes<C>::value) {
+		constexpr auto n = Impl::Index_of<C, T...>::value;
+		a.added_tick[n].push_back(added);
+		a.changed_tick[n].push_back(changed);
 	}
 }
 
+template<typename... T>
+typename Glare::Ecs::Entity_manager<T...>::Archetype_index
+Glare::Ecs::Entity_manager<T...>::find_archetype(Mask mask)
+{
+	const auto [it, inserted] = archetype_lookup.try_emplace(mask, static_cast<Archetype_index>(archetypes.size()));
+	if (inserted)
+		archetypes.emplace_back(mask);
+
+	return it->second;
+}
+
+template<typename... T>
+template<typename C>
+typename Glare::Ecs::Entity_manager<T...>::Archetype_index
+Glare::Ecs::Entity_manager<T...>::with(Archetype_index a)
+{
+	constexpr auto n = Impl::Index_of<C, T...>::value;
+
+	if (archetypes[a].add_edge[n] == null_archetype) {
+		// may reallocate archetypes
+		const auto to = find_archetype(archetypes[a].mask | bit<C>());
+		archetypes[a].add_edge[n] = to;
+		archetypes[to].remove_edge[n] = a;
+	}
+
+	return archetypes[a].add_edge[n];
+}
+
+template<typename... T>
+template<typename C>
+typename Glare::Ecs::Entity_manager<T...>::Archetype_index
+Glare::Ecs::Entity_manager<T...>::without(Archetype_index a)
+{
+	constexpr auto n = Impl::Index_of<C, T...>::value;
+
+	if (archetypes[a].remove_edge[n] == null_archetype) {
+		const auto to = find_archetype(archetypes[a].mask & ~bit<C>());
+		archetypes[a].remove_edge[n] = to;
+		archetypes[to].add_edge[n] = a;
+	}
+
+	return archetypes[a].remove_edge[n];
+}
+
+template<typename... T>
+void Glare::Ecs::Entity_manager<T...>::migrate(Record& r, Archetype_index to)
+{
+	auto& from_archetype = archetypes[r.archetype];
+	auto& to_archetype = archetypes[to];
+	const auto row = static_cast<Row>(to_archetype.entities.size());
+
+	try {
+		(move_component<T>(from_archetype, r.row, to_archetype), ...);
+		to_archetype.entities.push_back(from_archetype.entities[r.row]);
+	}
+	catch (...) {
+		truncate(to_archetype, row);
+		throw;
+	}
+	remove_row(from_archetype, r.row);
+
+	r = {to, row};
+}
+
+template<typename... T>
+template<typename C>
+void Glare::Ecs::Entity_manager<T...>::move_component(Archetype& from, Row row, Archetype& to)
+{
+	if (from.mask & to.mask & bit<C>()) {
+		column<C>(to).push_back(std::move(column<C>(from)[row]));
+
+		if constexpr (Track_changes<C>::value) {
+			constexpr auto n = Impl::Index_of<C, T...>::value;
+			push_ticks<C>(to, from.added_tick[n][row], from.changed_tick[n][row]);
+		}
+	}
+}
+
+template<typename... T>
+void Glare::Ecs::Entity_manager<T...>::remove_row(Archetype& a, Row row)
+{
+	(remove_component<T>(a, row), ...);
+
+	if (row != a.entities.size() - 1) {
+		a.entities[row] = a.entities.back();
+		records[a.entities[row].index].row = row;
+	}
+	a.entities.pop_back();
+}
+
+template<typename... T>
+template<typename C>
+void Glare::Ecs::Entity_manager<T...>::remove_component(Archetype& a, Row row)
+{
+	if (a.mask & bit<C>()) {
+		auto& col = column<C>(a);
+		if (row != col.size() - 1)
+			col[row] = std::move(col.back());
+		col.pop_back();
+
+		if constexpr (Track_changes<C>::value) {
+			constexpr auto n = Impl::Index_of<C, T...>::value;
+			a.added_tick[n][row] = a.added_tick[n].back();
+			a.added_tick[n].pop_back();
+			a.changed_tick[n][row] = a.changed_tick[n].back();
+			a.changed_tick[n].pop_back();
+		}
+	}
+}
+
+template<typename... T>
+void Glare::Ecs::Entity_manager<T...>::truncate(Archetype& a, Row rows)
+{
+	(truncate_component<T>(a, rows), ...);
+}
+
+template<typename... T>
+template<typename C>
+void Glare::Ecs::Entity_manager<T...>::truncate_component(Archetype& a, Row rows)
+{
+	if (a.mask & bit<C>()) {
+		auto& col = column<C>(a);
+		while (col.size() > rows)
+			col.pop_back();
+
+		if constexpr (Track_changes<C>::value) {
+			constexpr auto n = Impl::Index_of<C, T...>::value;
+			if (a.added_tick[n].size() > rows)
+				a.added_tick[n].resize(rows);
+			if (a.changed_tick[n].size() > rows)
+				a.changed_tick[n].resize(rows);
+		}
+	}
+}
+
+template<typename... T>
+bool Glare::Ecs::Sparse_entity_manager<T...>::Entity::operator==(Entity e) const
+{
+	return value == e.value;
+}
+
+template<typename... T>
+bool Glare::Ecs::Sparse_entity_manager<T...>::Entity::operator!=(Entity e) const
+{
+	return !(*this == e);
+}
+
+template<typename... T>
+Glare::Ecs::Sparse_entity_manager<T...>::Entity::Entity(Id id, Counter counter)
+	:value {Handle::pack(id, counter)}
+{}
+
+template<typename... T>
+typename Glare::Ecs::Sparse_entity_manager<T...>::Id
+Glare::Ecs::Sparse_entity_manager<T...>::Entity::id() const
+{
+	return Handle::index(value);
+}
+
+template<typename... T>
+typename Glare::Ecs::Sparse_entity_manager<T...>::Counter
+Glare::Ecs::Sparse_entity_manager<T...>::Entity::counter() const
+{
+	return Handle::counter(value);
+}
+
+template<typename... T>
+template<typename... C>
+template<typename F>
+void Glare::Ecs::Sparse_entity_manager<T...>::View<C...>::each(F&& f) const
+{
+	partition([&f](size_type n, const auto& part) { part(f, 0, n); });
+}
+
+template<typename... T>
+template<typename... C>
+template<typename G>
+void Glare::Ecs::Sparse_entity_manager<T...>::View<C...>::partition(G&& g) const
+{
+	constexpr Mask required {mask<C...>()};
+	const Sparse_entity_manager* m {manager};
+
+	const std::initializer_list<Utility::Span<const Id>> ids {manager->template storage<std::remove_const_t<C>>().ids()...};
+
+	const auto group = m->find_group(required);
+	if (group != null_group) {
+		// the first size elements of every owned pool belong to the same entities
+		const Id* id {ids.begin()->data()};
+		const std::tuple<C*...> data {manager->template storage<std::remove_const_t<C>>().values().data()...};
+
+		g(m->groups[group].size, [m, id, data](auto& f, size_type begin, size_type end) {
+			std::apply([&](auto*... p) {
+				for (size_type i {begin}; i != end; ++i) {
+					if constexpr (std::is_invocable<decltype(f), Entity, C&...>::value)
+						f(Entity {id[i], m->slots[id[i]].counter}, p[i]...);
+					else
+						f(p[i]...);
+				}
+			}, data);
+		});
+		return;
+	}
+
+	// walk the smallest pool and skip entities missing any of the others
+	auto smallest = *ids.begin();
+	for (const auto x : ids)
+		if (x.size() < smallest.size())
+			smallest = x;
+
+	g(smallest.size(), [manager = manager, smallest](auto& f, size_type begin, size_type end) {
+		for (size_type i {begin}; i != end; ++i) {
+			const auto id = smallest[i];
+			if ((manager->slots[id].mask & required) != required)
+				continue;
+
+			if constexpr (std::is_invocable<decltype(f), Entity, C&...>::value)
+				f(Entity {id, manager->slots[id].counter}, manager->template storage<std::remove_const_t<C>>().get(id)...);
+			else
+				f(manager->template storage<std::remove_const_t<C>>().get(id)...);
+		}
+	});
+}
+
+template<typename... T>
+template<typename... C>
+typename Glare::Ecs::Sparse_entity_manager<T...>::size_type
+Glare::Ecs::Sparse_entity_manager<T...>::View<C...>::size() const
+{
+	const auto g = manager->find_group(mask<C...>());
+	if (g != null_group)
+		return manager->groups[g].size;
+
+	size_type n {0};
+	each([&](C&...) { ++n; });
+	return n;
+}
+
+template<typename... T>
+template<typename... C>
+bool Glare::Ecs::Sparse_entity_manager<T...>::View<C...>::is_grouped() const
+{
+	return manager->find_group(mask<C...>()) != null_group;
+}
+
+template<typename... T>
+template<typename... C>
+Glare::Ecs::Sparse_entity_manager<T...>::View<C...>::View(Sparse_entity_manager* manager)
+	:manager {manager}
+{}
+
+template<typename... T>
+Glare::Ecs::Sparse_entity_manager<T...>::Sparse_entity_manager()
+{
+	owner.fill(null_group);
+}
+
+template<typename... T>
+template<typename... C>
+typename Glare::Ecs::Sparse_entity_manager<T...>::Entity
+Glare::Ecs::Sparse_entity_manager<T...>::create(C&&... components)
+{
+	static_assert(Impl::Are_unique<std::decay_t<C>...>::value, "component types must be distinct");
+
+	Id id;
+	if (free_index.empty()) {
+		id = static_cast<Id>(slots.size());
+		if (id == Handle::null_index)
+			throw Error::Slot_map_full {"Sparse_entity_manager has run out of entities"};
+		slots.push_back({0, 0});
+	} else {
+		id = free_index.back();
+		free_index.pop_back();
+	}
+	++live;
+
+	(add_component<std::decay_t<C>>(id, std::forward<C>(components)), ...);
+
+	return {id, slots[id].counter};
+}
+
+template<typename... T>
+void Glare::Ecs::Sparse_entity_manager<T...>::destroy(Entity e)
+{
+	if (!is_valid(e))
+		return;
+
+	const auto id = e.id();
+	(remove_component<T>(id), ...);
+
+	auto& slot = slots[id];
+	--live;
+	// a slot whose counter is used up is never handed out again
+	if (slot.counter == max_counter) {
+		slot.counter = Handle::null_counter;
+		return;
+	}
+	++slot.counter;
+	free_index.push_back(id);
+}
+
+template<typename... T>
+bool Glare::Ecs::Sparse_entity_manager<T...>::is_valid(Entity e) const
+{
+	return e.id() < slots.size() && slots[e.id()].counter == e.counter();
+}
+
+template<typename... T>
+typename Glare::Ecs::Sparse_entity_manager<T...>::size_type
+Glare::Ecs::Sparse_entity_manager<T...>::size() const
+{
+	return live;
+}
+
+template<typename... T>
+template<typename C, typename... Args>
+C& Glare::Ecs::Sparse_entity_manager<T...>::add(Entity e, Args&&... args)
+{
+	const auto id = checked_id(e);
+
+	if (slots[id].mask & bit<C>()) {
+		auto& c = storage<C>().get(id);
+		c = Glare::Impl::construct<C>(std::forward<Args>(args)...);
+		return c;
+	}
+
+	return add_component<C>(id, std::forward<Args>(args)...);
+}
+
+template<typename... T>
+template<typename C>
+void Glare::Ecs::Sparse_entity_manager<T...>::remove(Entity e)
+{
+	remove_component<C>(checked_id(e));
+}
+
+template<typename... T>
+template<typename C>
+bool Glare::Ecs::Sparse_entity_manager<T...>::has(Entity e) const
+{
+	return slots[checked_id(e)].mask & bit<C>();
+}
+
+template<typename... T>
+template<typename C>
+C& Glare::Ecs::Sparse_entity_manager<T...>::get(Entity e)
+{
+	return const_cast<C&>(static_cast<const Sparse_entity_manager&>(*this).get<C>(e));
+}
+
+template<typename... T>
+template<typename C>
+const C& Glare::Ecs::Sparse_entity_manager<T...>::get(Entity e) const
+{
+	if (const auto c = try_get<C>(e))
+		return *c;
+
+	throw Missing_component {"Entity does not have the requested component"};
+}
+
+template<typename... T>
+template<typename C>
+C* Glare::Ecs::Sparse_entity_manager<T...>::try_get(Entity e)
+{
+	return const_cast<C*>(static_cast<const Sparse_entity_manager&>(*this).try_get<C>(e));
+}
+
+template<typename... T>
+template<typename C>
+const C* Glare::Ecs::Sparse_entity_manager<T...>::try_get(Entity e) const
+{
+	const auto id = checked_id(e);
+	return slots[id].mask & bit<C>() ? &pool<C>().get(id) : nullptr;
+}
+
+template<typename... T>
+template<typename... C>
+typename Glare::Ecs::Sparse_entity_manager<T...>::template View<C...>
+Glare::Ecs::Sparse_entity_manager<T...>::view()
+{
+	static_assert(sizeof...(C) > 0, "a view needs at least one component");
+	static_assert(Impl::Are_unique<std::remove_const_t<C>...>::value, "component types must be distinct");
+	return View<C...> {this};
+}
+
+template<typename... T>
+template<typename... C>
+typename Glare::Ecs::Sparse_entity_manager<T...>::template View<C...>
+Glare::Ecs::Sparse_entity_manager<T...>::group()
+{
+	constexpr Mask owned {mask<C...>()};
+
+	if (find_group(owned) == null_group) {
+		if (((owner[Impl::Index_of<std::remove_const_t<C>, T...>::value] != null_group) || ...))
+			throw Group_conflict {"Component is already owned by another group"};
+
+		const auto g = static_cast<Group_index>(groups.size());
+		groups.push_back({owned, 0});
+		((owner[Impl::Index_of<std::remove_const_t<C>, T...>::value] = g), ...);
+
+		// members found so far are all in front of the current position,
+		// so whatever gets swapped back into it has been looked at already
+		using First = std::remove_const_t<std::tuple_element_t<0, std::tuple<C...>>>;
+		const auto ids = storage<First>().ids();
+		for (size_type i {0}; i != ids.size(); ++i) {
+			const auto id = ids[i];
+			if ((slots[id].mask & owned) == owned) {
+				auto& group = groups[g];
+				(swap_to<std::remove_const_t<C>>(id, group.size, group), ...);
+				++group.size;
+			}
+		}
+	}
+
+	return view<C...>();
+}
+
+template<typename... T>
+template<typename C>
+const Glare::Ecs::Sparse_set<C>& Glare::Ecs::Sparse_entity_manager<T...>::pool() const
+{
+	return std::get<Impl::Index_of<C, T...>::value>(pools);
+}
+
+template<typename... T>
+template<typename... C>
+constexpr typename Glare::Ecs::Sparse_entity_manager<T...>::Mask
+Glare::Ecs::Sparse_entity_manager<T...>::mask()
+{
+	return (Mask {0} | ... | bit<std::remove_const_t<C>>());
+}
+
+template<typename... T>
+template<typename C>
+constexpr typename Glare::Ecs::Sparse_entity_manager<T...>::Mask
+Glare::Ecs::Sparse_entity_manager<T...>::bit()
+{
+	static_assert(Impl::Contains<C, T...>::value, "not a component type of this Sparse_entity_manager");
+	return Mask {1} << Impl::Index_of<C, T...>::value;
+}
+
+template<typename... T>
+template<typename C>
+Glare::Ecs::Sparse_set<C>& Glare::Ecs::Sparse_entity_manager<T...>::storage()
+{
+	return std::get<Impl::Index_of<C, T...>::value>(pools);
+}
+
+template<typename... T>
+typename Glare::Ecs::Sparse_entity_manager<T...>::Id
+Glare::Ecs::Sparse_entity_manager<T...>::checked_id(Entity e) const
+{
+	if (!is_valid(e))
+		throw Not_valid {"Entity is no longer valid"};
+
+	return e.id();
+}
+
+template<typename... T>
+typename Glare::Ecs::Sparse_entity_manager<T...>::Group_index
+Glare::Ecs::Sparse_entity_manager<T...>::find_group(Mask mask) const
+{
+	for (Group_index g {0}; g != groups.size(); ++g)
+		if (groups[g].owned == mask)
+			return g;
+
+	return null_group;
+}
+
+template<typename... T>
+template<typename C>
+void Glare::Ecs::Sparse_entity_manager<T...>::enter_group(Id id)
+{
+	const auto g = owner[Impl::Index_of<C, T...>::value];
+	if (g == null_group)
+		return;
+
+	auto& group = groups[g];
+	if ((slots[id].mask & group.owned) != group.owned)
+		return;
+
+	(swap_to<T>(id, group.size, group), ...);
+	++group.size;
+}
+
+template<typename... T>
+template<typename C>
+void Glare::Ecs::Sparse_entity_manager<T...>::leave_group(Id id)
+{
+	const auto g = owner[Impl::Index_of<C, T...>::value];
+	if (g == null_group)
+		return;
+
+	auto& group = groups[g];
+	if ((slots[id].mask & group.owned) != group.owned)
+		return;
+
+	--group.size;
+	(swap_to<T>(id, group.size, group), ...);
+}
+
+template<typename... T>
+template<typename C>
+void Glare::Ecs::Sparse_entity_manager<T...>::swap_to(Id id, size_type position, const Group& group)
+{
+	if (group.owned & bit<C>()) {
+		auto& p = storage<C>();
+		p.swap_positions(p.position(id), position);
+	}
+}
+
+template<typename... T>
+template<typename C, typename... Args>
+C& Glare::Ecs::Sparse_entity_manager<T...>::add_component(Id id, Args&&... args)
+{
+	storage<C>().emplace(id, std::forward<Args>(args)...);
+	slots[id].mask |= bit<C>();
+	enter_group<C>(id);
+
+	return storage<C>().get(id);
+}
+
+template<typename... T>
+template<typename C>
+void Glare::Ecs::Sparse_entity_manager<T...>::remove_component(Id id)
+{
+	if (!(slots[id].mask & bit<C>()))
+		return;
+
+	leave_group<C>(id);
+	storage<C>().remove(id);
+	slots[id].mask &= ~bit<C>();
+}
+
 #endif // !GLARE_ECS_HPP
@@ -20,6 +20,71 @@ namespace Glare {
 		public:
 			Slot_map_out_of_range(std::string s) :Glare_error {std::move(s)}{};
 		};
+
+		class Slot_map_full : public Glare_error {
+		public:
+			Slot_map_full(std::string s) :Glare_error {std::move(s)}{};
+		};
+
+		class Ecs_missing_component : public Glare_error {
+		public:
+			Ecs_missing_component(std::string s) :Glare_error {std::move(s)}{};
+		};
+
+		class Ecs_group_conflict : public Glare_error {
+		public:
+			Ecs_group_conflict(std::string s) :Glare_error {std::move(s)}{};
+		};
+
+		class Scene_hierarchy_cycle : public Glare_error {
+		public:
+			Scene_hierarchy_cycle(std::string s) :Glare_error {std::move(s)}{};
+		};
+
+		class Scene_too_many_lods : public Glare_error {
+		public:
+			Scene_too_many_lods(std::string s) :Glare_error {std::move(s)}{};
+		};
+
+		class Snapshot_io_error : public Glare_error {
+		public:
+			Snapshot_io_error(std::string s) :Glare_error {std::move(s)}{};
+		};
+
+		class Snapshot_not_valid : public Glare_error {
+		public:
+			Snapshot_not_valid(std::string s) :Glare_error {std::move(s)}{};
+		};
+
+		class Snapshot_pending_changes : public Glare_error {
+		public:
+			Snapshot_pending_changes(std::string s) :Glare_error {std::move(s)}{};
+		};
+
+		class Snapshot_frame_not_found : public Glare_error {
+		public:
+			Snapshot_frame_not_found(std::string s) :Glare_error {std::move(s)}{};
+		};
+
+		class Snapshot_frame_order : public Glare_error {
+		public:
+			Snapshot_frame_order(std::string s) :Glare_error {std::move(s)}{};
+		};
+
+		class Snapshot_frame_too_large : public Glare_error {
+		public:
+			Snapshot_frame_too_large(std::string s) :Glare_error {std::move(s)}{};
+		};
+
+		class Video_index_out_of_range : public Glare_error {
+		public:
+			Video_index_out_of_range(std::string s) :Glare_error {std::move(s)}{};
+		};
+
+		class Video_vertex_count_mismatch : public Glare_error {
+		public:
+			Video_vertex_count_mismatch(std::string s) :Glare_error {std::move(s)}{};
+		};
 	}
 }
 
@@ -1,9 +1,22 @@
 #ifndef GLARE_GLARE_HPP
 #define GLARE_GLARE_HPP
 
+#include "culling.hpp"
 #include "ecs.hpp"
 #include "error.hpp"
+#include "history.hpp"
+#include "import.hpp"
+#include "job_system.hpp"
+#include "math.hpp"
+#include "parallel.hpp"
+#include "profile.hpp"
+#include "ray_tracer.hpp"
+#include "scheduler.hpp"
 #include "slot_map.hpp"
+#include "snapshot.hpp"
+#include "spatial_index.hpp"
+#include "sparse_set.hpp"
+#include "transform.hpp"
 #include "utility.hpp"
 #include "video.hpp"
 
@@ -0,0 +1,592 @@
+#ifndef GLARE_HISTORY_HPP
+#define GLARE_HISTORY_HPP
+
+#include "error.hpp"
+#include "slot_map.hpp"
+#include "snapshot.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Glare {
+	namespace Snapshot {
+		namespace Impl {
+			// one internal array of a Slot_map as of the newest recorded frame
+			// compared against the array now a chunk at a time, and the
+			// old contents of the chunks that differ saved as undo data
+			template<typename E>
+			class Delta_array {
+			public:
+				// [begin, end) in elements
+				struct Range {
+					std::size_t begin;
+					std::size_t end;
+				};
+
+				static_assert(std::is_trivially_copyable<E>::value, "only trivially copyable types can be recorded");
+
+				// finds the ranges that differ from now, returns the size of their undo data
+				std::size_t scan(const E* now, std::size_t count);
+				// writes the undo data of the ranges found by scan, then catches up with now
+				unsigned char* write(unsigned char* out, const E* now, std::size_t count);
+				// takes the array back to the frame before the undo data was written
+				const unsigned char* undo(const unsigned char* in);
+
+				void assign(const E* now, std::size_t count);
+				const E* data() const;
+				std::size_t size() const;
+				// as of the last scan, including elements past the end of now
+				const std::vector<Range>& changed() const;
+			private:
+				// compared with a single memcmp
+				static constexpr std::size_t chunk_bytes {256};
+				static constexpr std::size_t chunk {chunk_bytes / sizeof(E) ? chunk_bytes / sizeof(E) : 1};
+
+				void add_range(std::size_t begin, std::size_t end);
+
+				std::vector<E> mirror;
+				std::vector<Range> ranges;
+			};
+		}
+
+		// history of a Slot_map over its last few frames, for rollback and replay
+		// each frame records the ranges of the internal arrays that changed since
+		// the previous one, so a frame costs a scan of the Slot_map plus a copy
+		// of what changed, and going back k frames costs the changes of those k
+		// frames plus a copy of the whole Slot_map
+		// frames are kept in a ring of fixed size that reuses the same memory,
+		// and the oldest are dropped when either the frames or the bytes run out
+		// the element type must be trivially copyable, Soa_storage is scanned
+		// in place and other storages are gathered into one array first
+		template<typename Map>
+		class History {
+			using Index = typename Map::Index;
+			using Checked_index = typename Map::Checked_index;
+		public:
+			using size_type = std::size_t;
+			using Frame = std::uint64_t;
+			using value_type = typename Map::value_type;
+			using Stable_index = typename Map::Stable_index;
+
+			using Pending_changes = Error::Snapshot_pending_changes;
+			using Frame_not_found = Error::Snapshot_frame_not_found;
+			using Frame_order = Error::Snapshot_frame_order;
+			using Frame_too_large = Error::Snapshot_frame_too_large;
+
+			// keeps at most frame_count frames, at least one, whose changes
+			// fit in byte_capacity bytes
+			History(size_type frame_count, size_type byte_capacity);
+
+			// records the state of sm as frame, which must be later than any
+			// frame held, otherwise throws Frame_order
+			// throws Pending_changes unless clean_buffers has been called since
+			// the last buffered change, and Frame_too_large if the changes
+			// since the newest frame don't fit in byte_capacity
+			void record(const Map& sm, Frame);
+			// puts sm back into the state it was in at frame, handles included,
+			// and drops every later frame
+			// throws Frame_not_found if frame isn't held
+			void restore(Map& sm, Frame);
+			void clear();
+
+			bool contains(Frame) const;
+			size_type size() const;
+			bool empty() const;
+			// throw Frame_not_found if empty
+			Frame oldest() const;
+			Frame newest() const;
+			// of the changes held
+			size_type bytes_used() const;
+
+			// handles that became valid or stopped being valid between the
+			// frame held before frame and frame itself
+			// throws Frame_not_found if frame isn't held or is the oldest held
+			Utility::Span<const Stable_index> added(Frame) const;
+			Utility::Span<const Stable_index> removed(Frame) const;
+		private:
+			// blocks of undo data are aligned for the events at their start
+			static constexpr size_type block_alignment {alignof(std::max_align_t)};
+
+			struct Record {
+				Frame frame;
+				size_type retired; // Slot_map::retired at the frame
+				// undo data taking the next frame back to this one, and the
+				// events leading from this frame to the next
+				size_type offset;
+				size_type bytes;
+				size_type added_count;
+				size_type removed_count;
+			};
+
+			Record& at(size_type i);
+			const Record& at(size_type i) const;
+			// position of frame among the records held, size() if not held
+			size_type find(Frame) const;
+
+			void drop_oldest();
+			// makes room for n bytes of undo data, dropping the oldest frames if needed
+			size_type allocate(size_type n);
+			const Record& next_of(Frame) const;
+			void collect_events(const Checked_index* now, size_type count);
+			void copy_into(Map& sm, const Record&) const;
+
+			static size_type align(size_type n);
+
+			std::vector<Record> records; // ring
+			size_type first {0};
+			size_type count {0};
+
+			std::vector<unsigned char> arena;
+			size_type tail {0}; // end of the newest block
+			size_type used {0};
+
+			Impl::Delta_array<value_type> values;
+			Impl::Delta_array<Index> indices;
+			Impl::Delta_array<Checked_index> slots;
+			Impl::Delta_array<Index> free;
+
+			// kept to reuse their memory
+			std::vector<value_type> gathered_values;
+			std::vector<Index> gathered_indices;
+			std::vector<Stable_index> added_events;
+			std::vector<Stable_index> removed_events;
+		};
+	}
+}
+
+/***** IMPLEMENTATION *****/
+
+template<typename E>
+std::size_t Glare::Snapshot::Impl::Delta_array<E>::scan(const E* now, std::size_t count)
+{
+	ranges.clear();
+
+	const std::size_t common {std::min(count, mirror.size())};
+	for (std::size_t i = 0; i < common; i += chunk) {
+		const std::size_t end {std::min(i + chunk, common)};
+		if (std::memcmp(now + i, mirror.data() + i, (end - i) * sizeof(E)) != 0)
+			add_range(i, end);
+	}
+	// elements that are about to be dropped
+	if (mirror.size() > count)
+		add_range(count, mirror.size());
+
+	std::size_t bytes {2 * sizeof(std::uint64_t)};
+	for (const auto r : ranges)
+		bytes += 2 * sizeof(std::uint64_t) + (r.end - r.begin) * sizeof(E);
+	return bytes;
+}
+
+template<typename E>
+unsigned char* Glare::Snapshot::Impl::Delta_array<E>::write(unsigned char* out, const E* now, std::size_t count)
+{
+	const auto put = [&out](std::uint64_t x) {
+		std::memcpy(out, &x, sizeof x);
+		out += sizeof x;
+	};
+
+	put(mirror.size());
+	put(ranges.size());
+	for (const auto r : ranges) {
+		put(r.begin);
+		put(r.end);
+		std::memcpy(out, mirror.data() + r.begin, (r.end - r.begin) * sizeof(E));
+		out += (r.end - r.begin) * sizeof(E);
+	}
+
+	const std::size_t old {mirror.size()};
+	if (count < old)
+		mirror.erase(mirror.begin() + count, mirror.end());
+	for (const auto r : ranges)
+		if (r.begin < count)
+			std::memcpy(mirror.data() + r.begin, now + r.begin, (std::min(r.end, count) - r.begin) * sizeof(E));
+	if (count > old)
+		mirror.insert(mirror.end(), now + old, now + count);
+
+	return out;
+}
+
+template<typename E>
+const unsigned char* Glare::Snapshot::Impl::Delta_array<E>::undo(const unsigned char* in)
+{
+	const auto get = [&in] {
+		std::uint64_t x;
+		std::memcpy(&x, in, sizeof x);
+		in += sizeof x;
+		return static_cast<std::size_t>(x);
+	};
+
+	const std::size_t old {get()};
+	const std::size_t range_count {get()};
+	if (mirror.size() > old)
+		mirror.erase(mirror.begin() + old, mirror.end());
+	mirror.reserve(old);
+
+	for (std::size_t k = 0; k != range_count; ++k) {
+		const std::size_t begin {get()};
+		const std::size_t end {get()};
+
+		// the part that is still there is overwritten, the rest was dropped
+		const std::size_t kept {std::min(end, std::max(begin, mirror.size()))};
+		std::memcpy(mirror.data() + begin, in, (kept - begin) * sizeof(E));
+		for (std::size_t i = kept; i != end; ++i) {
+			alignas(E) unsigned char element[sizeof(E)];
+			std::memcpy(element, in + (i - begin) * sizeof(E), sizeof(E));
+			mirror.push_back(*std::launder(reinterpret_cast<const E*>(element)));
+		}
+		in += (end - begin) * sizeof(E);
+	}
+
+	return in;
+}
+
+template<typename E>
+void Glare::Snapshot::Impl::Delta_array<E>::assign(const E* now, std::size_t count)
+{
+	mirror.assign(now, now + count);
+	ranges.clear();
+}
+
+template<typename E>
+const E* Glare::Snapshot::Impl::Delta_array<E>::data() const
+{
+	return mirror.data();
+}
+
+template<typename E>
+std::size_t Glare::Snapshot::Impl::Delta_array<E>::size() const
+{
+	return mirror.size();
+}
+
+template<typename E>
+const std::vector<typename Glare::Snapshot::Impl::Delta_array<E>::Range>&
+Glare::Snapshot::Impl::Delta_array<E>::changed() const
+{
+	return ranges;
+}
+
+template<typename E>
+void Glare::Snapshot::Impl::Delta_array<E>::add_range(std::size_t begin, std::size_t end)
+{
+	if (!ranges.empty() && ranges.back().end == begin)
+		ranges.back().end = end;
+	else
+		ranges.push_back({begin, end});
+}
+
+template<typename Map>
+Glare::Snapshot::History<Map>::History(size_type frame_count, size_type byte_capacity)
+	:records(std::max(frame_count, size_type {1})),
+	arena(byte_capacity)
+{
+}
+
+template<typename Map>
+void Glare::Snapshot::History<Map>::record(const Map& sm, Frame frame)
+{
+	static_assert(std::is_trivially_copyable<value_type>::value, "only trivially copyable types can be recorded");
+
+	if (!sm.creation_buffer.empty() || !sm.deletion_buffer.empty())
+		throw Pending_changes {"Slot_map has buffered changes that have not been cleaned"};
+	if (count && frame <= newest())
+		throw Frame_order {"Frames must be recorded in increasing order"};
+
+	const value_type* now_values;
+	const Index* now_indices;
+	const size_type n {sm.elem.size()};
+	if constexpr (std::is_same<std::remove_const_t<decltype(sm.elem)>,
+		Glare::Impl::Soa_container<value_type, Index, typename Map::allocator_type>>::value) {
+		now_values = sm.elem.data();
+		now_indices = sm.elem.index_data();
+	} else {
+		gathered_values.clear();
+		gathered_indices.clear();
+		for (size_type i = 0; i != n; ++i) {
+			gathered_values.push_back(sm.elem.value(i));
+			gathered_indices.push_back(sm.elem.index(i));
+		}
+		now_values = gathered_values.data();
+		now_indices = gathered_indices.data();
+	}
+	const Checked_index* now_slots {sm.elem_indirect.data()};
+	const Index* now_free {sm.free_index.data()};
+
+	if (count == records.size())
+		drop_oldest();
+
+	// nothing to go back to, only the state itself is needed
+	if (count == 0) {
+		values.assign(now_values, n);
+		indices.assign(now_indices, n);
+		slots.assign(now_slots, sm.elem_indirect.size());
+		free.assign(now_free, sm.free_index.size());
+		tail = 0;
+		used = 0;
+		first = 0;
+		at(count++) = {frame, sm.retired, 0, 0, 0, 0};
+		return;
+	}
+
+	size_type deltas {values.scan(now_values, n)};
+	deltas += indices.scan(now_indices, n);
+	deltas += slots.scan(now_slots, sm.elem_indirect.size());
+	deltas += free.scan(now_free, sm.free_index.size());
+	collect_events(now_slots, sm.elem_indirect.size());
+
+	const size_type events {align((added_events.size() + removed_events.size()) * sizeof(Stable_index))};
+	const size_type bytes {align(events + deltas)};
+	if (bytes > arena.size())
+		throw Frame_too_large {"Changes since the last frame do not fit in the history"};
+
+	Record& previous {at(count - 1)};
+	previous.offset = allocate(bytes);
+	previous.bytes = bytes;
+	previous.added_count = added_events.size();
+	previous.removed_count = removed_events.size();
+	used += bytes;
+
+	unsigned char* out {arena.data() + previous.offset};
+	std::memcpy(out, added_events.data(), added_events.size() * sizeof(Stable_index));
+	std::memcpy(out + added_events.size() * sizeof(Stable_index), removed_events.data(),
+		removed_events.size() * sizeof(Stable_index));
+	out += events;
+	out = values.write(out, now_values, n);
+	out = indices.write(out, now_indices, n);
+	out = slots.write(out, now_slots, sm.elem_indirect.size());
+	free.write(out, now_free, sm.free_index.size());
+
+	at(count++) = {frame, sm.retired, tail, 0, 0, 0};
+}
+
+template<typename Map>
+void Glare::Snapshot::History<Map>::restore(Map& sm, Frame frame)
+{
+	const size_type p {find(frame)};
+	if (p == count)
+		throw Frame_not_found {"Frame is not held in the history"};
+
+	// newest first, each block takes its frame's successor back to it
+	for (size_type i = count - 1; i-- > p;) {
+		const Record& r {at(i)};
+		const unsigned char* in {arena.data() + r.offset};
+		in += align((r.added_count + r.removed_count) * sizeof(Stable_index));
+		in = values.undo(in);
+		in = indices.undo(in);
+		in = slots.undo(in);
+		free.undo(in);
+	}
+
+	// the blocks undone were the newest ones, so the arena now ends where the first of them began
+	bool first_block {true};
+	for (size_type i = p; i + 1 < count; ++i) {
+		const Record& r {at(i)};
+		if (r.bytes && first_block) {
+			tail = r.offset;
+			first_block = false;
+		}
+		used -= r.bytes;
+	}
+
+	Record& r {at(p)};
+	r.bytes = 0;
+	r.added_count = 0;
+	r.removed_count = 0;
+	count = p + 1;
+
+	copy_into(sm, r);
+}
+
+template<typename Map>
+void Glare::Snapshot::History<Map>::clear()
+{
+	first = 0;
+	count = 0;
+	tail = 0;
+	used = 0;
+}
+
+template<typename Map>
+bool Glare::Snapshot::History<Map>::contains(Frame frame) const
+{
+	return find(frame) != count;
+}
+
+template<typename Map>
+typename Glare::Snapshot::History<Map>::size_type Glare::Snapshot::History<Map>::size() const
+{
+	return count;
+}
+
+template<typename Map>
+bool Glare::Snapshot::History<Map>::empty() const
+{
+	return count == 0;
+}
+
+template<typename Map>
+typename Glare::Snapshot::History<Map>::Frame Glare::Snapshot::History<Map>::oldest() const
+{
+	if (empty())
+		throw Frame_not_found {"History is empty"};
+
+	return at(0).frame;
+}
+
+template<typename Map>
+typename Glare::Snapshot::History<Map>::Frame Glare::Snapshot::History<Map>::newest() const
+{
+	if (empty())
+		throw Frame_not_found {"History is empty"};
+
+	return at(count - 1).frame;
+}
+
+template<typename Map>
+typename Glare::Snapshot::History<Map>::size_type Glare::Snapshot::History<Map>::bytes_used() const
+{
+	return used;
+}
+
+template<typename Map>
+Glare::Utility::Span<const typename Glare::Snapshot::History<Map>::Stable_index>
+Glare::Snapshot::History<Map>::added(Frame frame) const
+{
+	const Record& r {next_of(frame)};
+	return {reinterpret_cast<const Stable_index*>(arena.data() + r.offset), r.added_count};
+}
+
+template<typename Map>
+Glare::Utility::Span<const typename Glare::Snapshot::History<Map>::Stable_index>
+Glare::Snapshot::History<Map>::removed(Frame frame) const
+{
+	const Record& r {next_of(frame)};
+	return {reinterpret_cast<const Stable_index*>(arena.data() + r.offset) + r.added_count, r.removed_count};
+}
+
+template<typename Map>
+typename Glare::Snapshot::History<Map>::Record& Glare::Snapshot::History<Map>::at(size_type i)
+{
+	return records[(first + i) % records.size()];
+}
+
+template<typename Map>
+const typename Glare::Snapshot::History<Map>::Record& Glare::Snapshot::History<Map>::at(size_type i) const
+{
+	return records[(first + i) % records.size()];
+}
+
+template<typename Map>
+typename Glare::Snapshot::History<Map>::size_type Glare::Snapshot::History<Map>::find(Frame frame) const
+{
+	// frames are held in increasing order
+	size_type lo {0};
+	size_type hi {count};
+	while (lo != hi) {
+		const size_type mid {lo + (hi - lo) / 2};
+		if (at(mid).frame < frame)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo != count && at(lo).frame == frame ? lo : count;
+}
+
+template<typename Map>
+void Glare::Snapshot::History<Map>::drop_oldest()
+{
+	used -= at(0).bytes;
+	first = (first + 1) % records.size();
+	--count;
+}
+
+template<typename Map>
+typename Glare::Snapshot::History<Map>::size_type Glare::Snapshot::History<Map>::allocate(size_type n)
+{
+	for (;;) {
+		// blocks are allocated in frame order, so the oldest one is the head of the ring
+		const Record* oldest_block {nullptr};
+		for (size_type i = 0; i + 1 < count && !oldest_block; ++i)
+			if (at(i).bytes)
+				oldest_block = &at(i);
+
+		size_type p {arena.size()};
+		if (!oldest_block)
+			p = 0;
+		else if (tail > oldest_block->offset) {
+			if (tail + n <= arena.size())
+				p = tail;
+			else if (n <= oldest_block->offset)
+				p = 0;
+		} else if (tail + n <= oldest_block->offset)
+			p = tail;
+
+		if (p != arena.size()) {
+			tail = p + n;
+			return p;
+		}
+
+		drop_oldest();
+	}
+}
+
+template<typename Map>
+const typename Glare::Snapshot::History<Map>::Record& Glare::Snapshot::History<Map>::next_of(Frame frame) const
+{
+	const size_type p {find(frame)};
+	if (p == count || p == 0)
+		throw Frame_not_found {"Frame is not held in the history"};
+
+	return at(p - 1);
+}
+
+template<typename Map>
+void Glare::Snapshot::History<Map>::collect_events(const Checked_index* now, size_type n)
+{
+	added_events.clear();
+	removed_events.clear();
+
+	const Checked_index* old {slots.data()};
+	const size_type old_count {slots.size()};
+	const auto visit = [&](size_type i) {
+		const bool was {i < old_count && old[i].index != Map::null_index};
+		const bool is {i < n && now[i].index != Map::null_index};
+		const bool reused {was && is && old[i].counter != now[i].counter};
+		if (was && (!is || reused))
+			removed_events.push_back({static_cast<Index>(i), old[i].counter});
+		if (is && (!was || reused))
+			added_events.push_back({static_cast<Index>(i), now[i].counter});
+	};
+
+	for (const auto r : slots.changed())
+		for (size_type i = r.begin; i != r.end; ++i)
+			visit(i);
+	for (size_type i = old_count; i < n; ++i)
+		visit(i);
+}
+
+template<typename Map>
+void Glare::Snapshot::History<Map>::copy_into(Map& sm, const Record& r) const
+{
+	sm.elem.assign(values.data(), indices.data(), values.size());
+	sm.elem_indirect.assign(slots.data(), slots.data() + slots.size());
+	sm.free_index.assign(free.data(), free.data() + free.size());
+	sm.creation_buffer.clear();
+	sm.deletion_buffer.clear();
+	sm.retired = r.retired;
+}
+
+template<typename Map>
+typename Glare::Snapshot::History<Map>::size_type Glare::Snapshot::History<Map>::align(size_type n)
+{
+	return (n + block_alignment - 1) / block_alignment * block_alignment;
+}
+
+#endif // !GLARE_HISTORY_HPP
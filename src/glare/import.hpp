@@ -0,0 +1,104 @@
+#ifndef GLARE_IMPORT_HPP
+#define GLARE_IMPORT_HPP
+
+#include "ray_tracer.hpp"
+#include "video.hpp"
+
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Glare {
+	namespace Video {
+		// the triangles of an aiMesh as the renderers take them
+		struct Imported_mesh {
+			std::vector<Vertex> vertices;
+			std::vector<std::uint32_t> indices;
+		};
+
+		// polygons are split into fans, points and lines are dropped
+		// colours come from the first vertex colour set, or else the diffuse
+		// colour of the mesh's material, or else white
+		// positions are transformed by to_world, row major as assimp's matrices are
+		Imported_mesh import_mesh(const aiScene&, const aiMesh&, const aiMatrix4x4& to_world = aiMatrix4x4 {});
+
+		// adds a mesh for every time the node tree of the scene places one,
+		// transformed into world space, and returns the indices add_mesh gave
+		// them in depth first order
+		// meshes without triangles are skipped, and a scene without nodes has
+		// each of its meshes added once as it is
+		std::vector<Ray_tracer::size_type> import_meshes(const aiScene&, Ray_tracer&);
+
+		namespace Impl {
+			inline std::uint32_t to_rgba(const aiColor4D& c)
+			{
+				const auto channel = [](float x) {
+					return static_cast<std::uint8_t>(std::min(std::max(x, 0.0f), 1.0f) * 255 + 0.5f);
+				};
+				return rgba(channel(c.r), channel(c.g), channel(c.b), channel(c.a));
+			}
+
+			inline void add_imported(const aiScene& scene, const aiMesh& mesh, const aiMatrix4x4& to_world,
+									 Ray_tracer& r, std::vector<Ray_tracer::size_type>& added)
+			{
+				const Imported_mesh m {import_mesh(scene, mesh, to_world)};
+				if (!m.indices.empty())
+					added.push_back(r.add_mesh({m.vertices.data(), m.vertices.size()}, {m.indices.data(), m.indices.size()}));
+			}
+
+			inline void import_node(const aiScene& scene, const aiNode& node, const aiMatrix4x4& parent,
+									Ray_tracer& r, std::vector<Ray_tracer::size_type>& added)
+			{
+				const aiMatrix4x4 to_world {parent * node.mTransformation};
+				for (unsigned i = 0; i != node.mNumMeshes; ++i)
+					add_imported(scene, *scene.mMeshes[node.mMeshes[i]], to_world, r, added);
+				for (unsigned i = 0; i != node.mNumChildren; ++i)
+					import_node(scene, *node.mChildren[i], to_world, r, added);
+			}
+		}
+	}
+}
+
+/***** IMPLEMENTATION *****/
+
+inline Glare::Video::Imported_mesh
+Glare::Video::import_mesh(const aiScene& scene, const aiMesh& mesh, const aiMatrix4x4& to_world)
+{
+	std::uint32_t color {rgba(255, 255, 255)};
+	if (mesh.mMaterialIndex < scene.mNumMaterials) {
+		aiColor4D diffuse;
+		if (scene.mMaterials[mesh.mMaterialIndex]->Get(AI_MATKEY_COLOR_DIFFUSE, diffuse) == aiReturn_SUCCESS)
+			color = Impl::to_rgba(diffuse);
+	}
+
+	Imported_mesh m;
+	m.vertices.reserve(mesh.mNumVertices);
+	for (unsigned i = 0; i != mesh.mNumVertices; ++i) {
+		const aiVector3D p {to_world * mesh.mVertices[i]};
+		m.vertices.push_back({{p.x, p.y, p.z}, mesh.HasVertexColors(0) ? Impl::to_rgba(mesh.mColors[0][i]) : color});
+	}
+
+	for (unsigned i = 0; i != mesh.mNumFaces; ++i) {
+		const aiFace& f {mesh.mFaces[i]};
+		for (unsigned k = 2; k < f.mNumIndices; ++k)
+			m.indices.insert(m.indices.end(), {f.mIndices[0], f.mIndices[k - 1], f.mIndices[k]});
+	}
+	return m;
+}
+
+inline std::vector<Glare::Video::Ray_tracer::size_type>
+Glare::Video::import_meshes(const aiScene& scene, Ray_tracer& r)
+{
+	std::vector<Ray_tracer::size_type> added;
+	if (scene.mRootNode) {
+		Impl::import_node(scene, *scene.mRootNode, aiMatrix4x4 {}, r, added);
+	} else {
+		for (unsigned i = 0; i != scene.mNumMeshes; ++i)
+			Impl::add_imported(scene, *scene.mMeshes[i], aiMatrix4x4 {}, r, added);
+	}
+	return added;
+}
+
+#endif // !GLARE_IMPORT_HPP
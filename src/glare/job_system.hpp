@@ -0,0 +1,598 @@
+#ifndef GLARE_JOB_SYSTEM_HPP
+#define GLARE_JOB_SYSTEM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Glare {
+	namespace Impl {
+		constexpr std::size_t cache_line {64};
+	}
+
+	namespace Utility {
+		namespace Impl {
+			// fixed size Chase-Lev deque, the owning thread pushes and pops
+			// at the bottom while any thread steals from the top
+			template<typename T>
+			class Work_deque {
+			public:
+				// capacity is rounded up to a power of two
+				explicit Work_deque(std::size_t capacity);
+
+				// owner only, returns false if full
+				bool push(T*);
+				// owner only, newest first, nullptr if empty
+				T* pop();
+				// any thread, oldest first, nullptr if empty or another thread won
+				T* steal();
+			private:
+				alignas(Glare::Impl::cache_line) std::atomic<std::int64_t> top {0};
+				alignas(Glare::Impl::cache_line) std::atomic<std::int64_t> bottom {0};
+				std::int64_t mask;
+				std::unique_ptr<std::atomic<T*>[]> items;
+			};
+
+			// fixed size queue that any thread can push to and pop from
+			template<typename T>
+			class Work_queue {
+			public:
+				// capacity is rounded up to a power of two
+				explicit Work_queue(std::size_t capacity);
+
+				// returns false if full
+				bool push(T*);
+				// oldest first, nullptr if empty
+				T* pop();
+			private:
+				struct Cell {
+					// the position a push or pop may next use this cell for
+					std::atomic<std::size_t> sequence;
+					T* item;
+				};
+
+				alignas(Glare::Impl::cache_line) std::atomic<std::size_t> head {0};
+				alignas(Glare::Impl::cache_line) std::atomic<std::size_t> tail {0};
+				std::size_t mask;
+				std::unique_ptr<Cell[]> cells;
+			};
+
+			inline std::size_t round_up_pow2(std::size_t n)
+			{
+				std::size_t p {1};
+				while (p < n)
+					p *= 2;
+				return p;
+			}
+		}
+
+		// pool of worker threads that each own a deque of jobs
+		// a worker takes its newest job first, and steals the oldest job
+		// of another deque once its own and the shared queue run dry
+		// jobs live in a fixed pool, so submitting never allocates
+		class Job_system {
+			struct Job;
+		public:
+			// largest callable a job can hold, capture big state by reference
+			static constexpr std::size_t max_job_size {96};
+			static constexpr std::size_t default_job_capacity {4096};
+
+			// number of unfinished jobs submitted with it, which can be waited on
+			// or have jobs run once it reaches zero
+			// must outlive its jobs, and can be reused once done
+			class Counter {
+			public:
+				Counter() = default;
+
+				Counter(const Counter&) = delete;
+				Counter& operator=(const Counter&) = delete;
+
+				std::size_t count() const;
+				// no jobs left, and none still finishing, so the counter can be destroyed
+				bool done() const;
+			private:
+				friend class Job_system;
+
+				// the high half counts threads that are still finishing a job
+				static constexpr std::uint64_t finishing {std::uint64_t {1} << 32};
+
+				std::atomic<std::uint64_t> state {0};
+				std::atomic<Job*> continuations {nullptr};
+			};
+
+			// with no workers, jobs only run when a thread calls run_one or waits
+			// at most job_capacity jobs can be queued at once, past that
+			// submit runs the job itself
+			explicit Job_system(std::size_t worker_count = default_worker_count(),
+								std::size_t job_capacity = default_job_capacity);
+			// finishes every queued job first
+			~Job_system();
+
+			Job_system(const Job_system&) = delete;
+			Job_system& operator=(const Job_system&) = delete;
+
+			// queues a job on the calling worker's deque, or on a shared queue
+			// when called from another thread, jobs must not throw
+			template<typename F>
+			void submit(F&&);
+			// as above, counter counts the job until it has returned
+			template<typename F>
+			void submit(F&&, Counter&);
+			// queues the job once after reaches zero, or right away if it is already done
+			template<typename F>
+			void submit_after(Counter& after, F&&);
+			template<typename F>
+			void submit_after(Counter& after, F&&, Counter&);
+
+			// runs one queued job on the calling thread
+			// returns false if there was nothing to run
+			bool run_one();
+			// runs queued jobs on the calling thread until counter is done
+			void wait(const Counter&);
+			// runs queued jobs on the calling thread until pending reaches zero
+			void wait(const std::atomic<std::size_t>& pending);
+
+			std::size_t worker_count() const;
+			// number of distinct values thread_index can return
+			std::size_t thread_count() const;
+			// index of the calling worker, or worker_count() for any other thread
+			std::size_t thread_index() const;
+
+			// one worker per hardware thread besides the calling one
+			static std::size_t default_worker_count();
+			// process wide system with the default number of workers, started on first use
+			// shared by everything that runs jobs, so that they don't oversubscribe the cores
+			static Job_system& shared();
+		private:
+			struct alignas(Glare::Impl::cache_line) Job {
+				void (*call)(Job&); // runs and destroys the callable
+				Counter* counter;
+				Job* next_continuation;
+				std::atomic<std::uint32_t> next_free;
+				alignas(std::max_align_t) unsigned char storage[max_job_size];
+			};
+
+			template<typename F>
+			void submit(F&&, Counter* after, Counter*);
+
+			Job* allocate();
+			void recycle(Job*);
+			// queues a job made by allocate, or runs it if the queue is full
+			void push(Job*);
+			Job* take(std::size_t queue);
+			void run(Job*);
+			void finish(Counter&);
+			void work(std::size_t queue);
+
+			std::size_t capacity;
+			std::unique_ptr<Job[]> pool;
+			// index of the first free job, tagged with a count of changes in the
+			// high half so that a stale compare_exchange fails
+			alignas(Glare::Impl::cache_line) std::atomic<std::uint64_t> free_head;
+
+			std::vector<std::unique_ptr<Impl::Work_deque<Job>>> deques;
+			Impl::Work_queue<Job> shared_queue;
+			std::vector<std::thread> workers;
+
+			alignas(Glare::Impl::cache_line) std::atomic<std::size_t> queued {0};
+			std::atomic<std::size_t> sleeping {0};
+			std::mutex sleep_mutex;
+			std::condition_variable sleep;
+			bool stopping {false}; // guarded by sleep_mutex
+		};
+
+		namespace Impl {
+			// which Job_system the calling thread works for, if any
+			struct Worker_context {
+				const Job_system* system;
+				std::size_t queue;
+			};
+
+			inline thread_local Worker_context current_worker {nullptr, 0};
+		}
+	}
+}
+
+/***** IMPLEMENTATION *****/
+
+template<typename T>
+Glare::Utility::Impl::Work_deque<T>::Work_deque(std::size_t capacity)
+	:mask {static_cast<std::int64_t>(round_up_pow2(capacity)) - 1},
+	items {std::make_unique<std::atomic<T*>[]>(static_cast<std::size_t>(mask) + 1)}
+{}
+
+template<typename T>
+bool Glare::Utility::Impl::Work_deque<T>::push(T* x)
+{
+	const auto b = bottom.load(std::memory_order_relaxed);
+	const auto t = top.load(std::memory_order_acquire);
+	if (b - t > mask)
+		return false;
+
+	items[b & mask].store(x, std::memory_order_relaxed);
+	bottom.store(b + 1, std::memory_order_release);
+	return true;
+}
+
+template<typename T>
+T* Glare::Utility::Impl::Work_deque<T>::pop()
+{
+	// claim the bottom before looking at the top, so that a thief
+	// either sees the claim or loses the race for the last item
+	const auto b = bottom.load(std::memory_order_relaxed) - 1;
+	bottom.store(b, std::memory_order_seq_cst);
+	auto t = top.load(std::memory_order_seq_cst);
+
+	if (t > b) {
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	T* x {items[b & mask].load(std::memory_order_relaxed)};
+	if (t == b) {
+		// the last item, whoever moves the top gets it
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			x = nullptr;
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+	return x;
+}
+
+template<typename T>
+T* Glare::Utility::Impl::Work_deque<T>::steal()
+{
+	auto t = top.load(std::memory_order_seq_cst);
+	const auto b = bottom.load(std::memory_order_seq_cst);
+	if (t >= b)
+		return nullptr;
+
+	T* x {items[t & mask].load(std::memory_order_relaxed)};
+	if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return nullptr;
+	return x;
+}
+
+template<typename T>
+Glare::Utility::Impl::Work_queue<T>::Work_queue(std::size_t capacity)
+	:mask {round_up_pow2(capacity) - 1},
+	cells {std::make_unique<Cell[]>(mask + 1)}
+{
+	for (std::size_t i = 0; i <= mask; ++i)
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template<typename T>
+bool Glare::Utility::Impl::Work_queue<T>::push(T* x)
+{
+	auto pos = tail.load(std::memory_order_relaxed);
+	for (;;) {
+		auto& cell = cells[pos & mask];
+		const auto seq = cell.sequence.load(std::memory_order_acquire);
+		const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+		if (diff == 0) {
+			if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				cell.item = x;
+				cell.sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			return false; // a lap behind, full
+		} else {
+			pos = tail.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template<typename T>
+T* Glare::Utility::Impl::Work_queue<T>::pop()
+{
+	auto pos = head.load(std::memory_order_relaxed);
+	for (;;) {
+		auto& cell = cells[pos & mask];
+		const auto seq = cell.sequence.load(std::memory_order_acquire);
+		const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+		if (diff == 0) {
+			if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				T* x {cell.item};
+				cell.sequence.store(pos + mask + 1, std::memory_order_release);
+				return x;
+			}
+		} else if (diff < 0) {
+			return nullptr; // not written yet, empty
+		} else {
+			pos = head.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+inline std::size_t Glare::Utility::Job_system::Counter::count() const
+{
+	return static_cast<std::size_t>(state.load(std::memory_order_acquire) & (finishing - 1));
+}
+
+inline bool Glare::Utility::Job_system::Counter::done() const
+{
+	return state.load(std::memory_order_acquire) == 0;
+}
+
+inline Glare::Utility::Job_system::Job_system(std::size_t worker_count, std::size_t job_capacity)
+	:capacity {std::max<std::size_t>(job_capacity, 1)},
+	pool {std::make_unique<Job[]>(capacity)},
+	free_head {0},
+	shared_queue {capacity}
+{
+	for (std::size_t i = 0; i < capacity; ++i)
+		pool[i].next_free.store(static_cast<std::uint32_t>(i + 1), std::memory_order_relaxed);
+
+	deques.reserve(worker_count);
+	for (std::size_t i = 0; i < worker_count; ++i)
+		deques.push_back(std::make_unique<Impl::Work_deque<Job>>(capacity));
+
+	workers.reserve(worker_count);
+	for (std::size_t i = 0; i < worker_count; ++i)
+		workers.emplace_back([this, i] { work(i); });
+}
+
+inline Glare::Utility::Job_system::~Job_system()
+{
+	{
+		std::lock_guard<std::mutex> lock {sleep_mutex};
+		stopping = true;
+	}
+	sleep.notify_all();
+
+	for (auto& t : workers)
+		t.join();
+
+	while (run_one()) {}
+}
+
+template<typename F>
+void Glare::Utility::Job_system::submit(F&& f)
+{
+	submit(std::forward<F>(f), nullptr, nullptr);
+}
+
+template<typename F>
+void Glare::Utility::Job_system::submit(F&& f, Counter& counter)
+{
+	submit(std::forward<F>(f), nullptr, &counter);
+}
+
+template<typename F>
+void Glare::Utility::Job_system::submit_after(Counter& after, F&& f)
+{
+	submit(std::forward<F>(f), &after, nullptr);
+}
+
+template<typename F>
+void Glare::Utility::Job_system::submit_after(Counter& after, F&& f, Counter& counter)
+{
+	submit(std::forward<F>(f), &after, &counter);
+}
+
+template<typename F>
+void Glare::Utility::Job_system::submit(F&& f, Counter* after, Counter* counter)
+{
+	using Fn = std::decay_t<F>;
+	static_assert(sizeof(Fn) <= max_job_size, "job is too large, capture its state by reference");
+	static_assert(alignof(Fn) <= alignof(std::max_align_t), "job is over-aligned");
+
+	if (counter)
+		counter->state.fetch_add(1, std::memory_order_relaxed);
+
+	Job* job {allocate()};
+	if (!job) {
+		// every job is queued or running, so do this one here
+		if (after)
+			wait(*after);
+		Fn {std::forward<F>(f)}();
+		if (counter)
+			finish(*counter);
+		return;
+	}
+
+	::new (static_cast<void*>(job->storage)) Fn {std::forward<F>(f)};
+	job->call = [](Job& j) {
+		Fn& fn {*std::launder(reinterpret_cast<Fn*>(j.storage))};
+		fn();
+		fn.~Fn();
+	};
+	job->counter = counter;
+
+	if (!after || after->count() == 0) {
+		push(job);
+		return;
+	}
+
+	// hang the job on after, whichever thread sees it reach zero
+	// afterwards takes the whole list and queues it
+	job->next_continuation = after->continuations.load(std::memory_order_seq_cst);
+	while (!after->continuations.compare_exchange_weak(job->next_continuation, job, std::memory_order_seq_cst)) {}
+
+	if (after->count() == 0) {
+		for (Job* j {after->continuations.exchange(nullptr, std::memory_order_seq_cst)}; j;) {
+			Job* next {j->next_continuation};
+			push(j);
+			j = next;
+		}
+	}
+}
+
+inline bool Glare::Utility::Job_system::run_one()
+{
+	Job* job {take(thread_index())};
+	if (!job)
+		return false;
+
+	run(job);
+	return true;
+}
+
+inline void Glare::Utility::Job_system::wait(const Counter& counter)
+{
+	while (!counter.done())
+		if (!run_one())
+			std::this_thread::yield();
+}
+
+inline void Glare::Utility::Job_system::wait(const std::atomic<std::size_t>& pending)
+{
+	while (pending.load(std::memory_order_acquire) != 0)
+		if (!run_one())
+			std::this_thread::yield();
+}
+
+inline std::size_t Glare::Utility::Job_system::worker_count() const
+{
+	return workers.size();
+}
+
+inline std::size_t Glare::Utility::Job_system::thread_count() const
+{
+	return deques.size() + 1;
+}
+
+inline std::size_t Glare::Utility::Job_system::thread_index() const
+{
+	// every thread that isn't a worker shares the last index
+	return Impl::current_worker.system == this ? Impl::current_worker.queue : deques.size();
+}
+
+inline std::size_t Glare::Utility::Job_system::default_worker_count()
+{
+	return std::max(std::thread::hardware_concurrency(), 1u) - 1;
+}
+
+inline Glare::Utility::Job_system& Glare::Utility::Job_system::shared()
+{
+	static Job_system system;
+	return system;
+}
+
+inline Glare::Utility::Job_system::Job* Glare::Utility::Job_system::allocate()
+{
+	auto head = free_head.load(std::memory_order_acquire);
+	for (;;) {
+		const auto i = static_cast<std::uint32_t>(head);
+		if (i == capacity)
+			return nullptr;
+
+		const std::uint64_t next {pool[i].next_free.load(std::memory_order_relaxed) | ((head >> 32) + 1) << 32};
+		if (free_head.compare_exchange_weak(head, next, std::memory_order_acquire))
+			return &pool[i];
+	}
+}
+
+inline void Glare::Utility::Job_system::recycle(Job* job)
+{
+	const auto i = static_cast<std::uint64_t>(job - pool.get());
+	auto head = free_head.load(std::memory_order_relaxed);
+	do
+		job->next_free.store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+	while (!free_head.compare_exchange_weak(head, i | ((head >> 32) + 1) << 32, std::memory_order_release,
+											std::memory_order_relaxed));
+}
+
+inline void Glare::Utility::Job_system::push(Job* job)
+{
+	// counted before it can be taken, so that queued never goes below zero
+	queued.fetch_add(1, std::memory_order_seq_cst);
+
+	const auto q = thread_index();
+	if (!(q == deques.size() ? shared_queue.push(job) : deques[q]->push(job))) {
+		queued.fetch_sub(1, std::memory_order_relaxed);
+		run(job);
+		return;
+	}
+
+	// a worker counts itself in sleeping before checking queued, so
+	// either it sees the job or it is seen here and woken
+	if (sleeping.load(std::memory_order_seq_cst) != 0) {
+		{
+			std::lock_guard<std::mutex> lock {sleep_mutex};
+		}
+		sleep.notify_one();
+	}
+}
+
+inline Glare::Utility::Job_system::Job* Glare::Utility::Job_system::take(std::size_t queue)
+{
+	if (queued.load(std::memory_order_acquire) == 0)
+		return nullptr;
+
+	const auto n = deques.size();
+	Job* job {queue == n ? nullptr : deques[queue]->pop()};
+	if (!job)
+		job = shared_queue.pop();
+	for (std::size_t i = 1; !job && i <= n; ++i)
+		job = deques[(queue + i) % n]->steal();
+
+	if (job)
+		queued.fetch_sub(1, std::memory_order_relaxed);
+	return job;
+}
+
+inline void Glare::Utility::Job_system::run(Job* job)
+{
+	Counter* counter {job->counter};
+	job->call(*job);
+	recycle(job);
+	if (counter)
+		finish(*counter);
+}
+
+inline void Glare::Utility::Job_system::finish(Counter& counter)
+{
+	// while other jobs are left this can't be the last touch
+	auto old = counter.state.load(std::memory_order_relaxed);
+	while ((old & (Counter::finishing - 1)) > 1)
+		if (counter.state.compare_exchange_weak(old, old - 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return;
+
+	// marked as finishing while the continuations are queued, so that
+	// a waiter can't destroy the counter under us
+	old = counter.state.fetch_add(Counter::finishing - 1, std::memory_order_seq_cst);
+	if ((old & (Counter::finishing - 1)) == 1) {
+		for (Job* j {counter.continuations.exchange(nullptr, std::memory_order_seq_cst)}; j;) {
+			Job* next {j->next_continuation};
+			push(j);
+			j = next;
+		}
+	}
+	counter.state.fetch_sub(Counter::finishing, std::memory_order_release);
+}
+
+inline void Glare::Utility::Job_system::work(std::size_t queue)
+{
+	Impl::current_worker = {this, queue};
+
+	// looks again a few times before sleeping, as more work tends to follow soon
+	constexpr int spins {64};
+
+	for (;;) {
+		bool ran {false};
+		for (int i = 0; i < spins && !(ran = run_one()); ++i)
+			std::this_thread::yield();
+		if (ran)
+			continue;
+
+		sleeping.fetch_add(1, std::memory_order_seq_cst);
+		std::unique_lock<std::mutex> lock {sleep_mutex};
+		sleep.wait(lock, [this] { return stopping || queued.load(std::memory_order_seq_cst) != 0; });
+		sleeping.fetch_sub(1, std::memory_order_relaxed);
+		if (stopping && queued.load(std::memory_order_acquire) == 0)
+			return;
+	}
+}
+
+#endif // !GLARE_JOB_SYSTEM_HPP
@@ -0,0 +1,226 @@
+#ifndef GLARE_MATH_HPP
+#define GLARE_MATH_HPP
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define GLARE_SSE 1
+#include <xmmintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GLARE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define GLARE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace Glare {
+	namespace Math {
+		// 4x4 float matrix stored column by column, the same layout as glm::mat4,
+		// so either can be copied into the other with memcpy
+		struct alignas(16) Mat4 {
+			// column c, row r is m[c * 4 + r]
+			float m[16];
+
+			float& operator()(std::size_t row, std::size_t col);
+			float operator()(std::size_t row, std::size_t col) const;
+
+			static Mat4 identity();
+			static Mat4 translation(float x, float y, float z);
+			static Mat4 scale(float x, float y, float z);
+			// OpenGL projection as glm::perspective makes it, fov_y in radians
+			static Mat4 perspective(float fov_y, float aspect, float z_near, float z_far);
+		};
+
+		// out = a * b, out may alias a or b
+		void multiply(const Mat4& a, const Mat4& b, Mat4& out);
+		Mat4 operator*(const Mat4&, const Mat4&);
+		// a must be invertible
+		Mat4 inverse(const Mat4& a);
+
+		bool operator==(const Mat4&, const Mat4&);
+		bool operator!=(const Mat4&, const Mat4&);
+
+		struct Aabb {
+			float min[3];
+			float max[3];
+		};
+
+		struct Sphere {
+			float centre[3];
+			float radius;
+		};
+
+		struct Ray {
+			float origin[3];
+			float direction[3]; // needn't be normalised, t counts in multiples of it
+			float max_t;
+		};
+
+		// planes as (a, b, c, d) with normals facing in, normalised so that
+		// a * x + b * y + c * z + d is the distance of a point inside
+		struct Frustum {
+			float planes[6][4]; // left, right, bottom, top, near, far
+		};
+
+		// the volume an OpenGL projection keeps, in the space to_clip transforms from
+		Frustum frustum(const Mat4& to_clip);
+	}
+}
+
+/***** IMPLEMENTATION *****/
+
+inline float& Glare::Math::Mat4::operator()(std::size_t row, std::size_t col)
+{
+	return m[col * 4 + row];
+}
+
+inline float Glare::Math::Mat4::operator()(std::size_t row, std::size_t col) const
+{
+	return m[col * 4 + row];
+}
+
+inline Glare::Math::Mat4 Glare::Math::Mat4::identity()
+{
+	return scale(1, 1, 1);
+}
+
+inline Glare::Math::Mat4 Glare::Math::Mat4::translation(float x, float y, float z)
+{
+	Mat4 t {identity()};
+	t.m[12] = x;
+	t.m[13] = y;
+	t.m[14] = z;
+	return t;
+}
+
+inline Glare::Math::Mat4 Glare::Math::Mat4::scale(float x, float y, float z)
+{
+	return {{x, 0, 0, 0,  0, y, 0, 0,  0, 0, z, 0,  0, 0, 0, 1}};
+}
+
+inline Glare::Math::Mat4 Glare::Math::Mat4::perspective(float fov_y, float aspect, float z_near, float z_far)
+{
+	const float f {1 / std::tan(fov_y / 2)};
+	return {{f / aspect, 0, 0, 0,  0, f, 0, 0,  0, 0, (z_far + z_near) / (z_near - z_far), -1,
+			 0, 0, 2 * z_far * z_near / (z_near - z_far), 0}};
+}
+
+inline void Glare::Math::multiply(const Mat4& a, const Mat4& b, Mat4& out)
+{
+#ifdef GLARE_SSE
+	// each column of the result is the columns of a weighted by a column of b
+	const __m128 a0 {_mm_load_ps(a.m)};
+	const __m128 a1 {_mm_load_ps(a.m + 4)};
+	const __m128 a2 {_mm_load_ps(a.m + 8)};
+	const __m128 a3 {_mm_load_ps(a.m + 12)};
+
+	__m128 col[4];
+	for (int c = 0; c != 4; ++c) {
+		const __m128 x {_mm_mul_ps(a0, _mm_set1_ps(b.m[c * 4]))};
+		const __m128 y {_mm_mul_ps(a1, _mm_set1_ps(b.m[c * 4 + 1]))};
+		const __m128 z {_mm_mul_ps(a2, _mm_set1_ps(b.m[c * 4 + 2]))};
+		const __m128 w {_mm_mul_ps(a3, _mm_set1_ps(b.m[c * 4 + 3]))};
+		col[c] = _mm_add_ps(_mm_add_ps(x, y), _mm_add_ps(z, w));
+	}
+
+	// stored last in case out aliases a or b
+	for (int c = 0; c != 4; ++c)
+		_mm_store_ps(out.m + c * 4, col[c]);
+#else
+	Mat4 r;
+	for (int c = 0; c != 4; ++c)
+		for (int i = 0; i != 4; ++i)
+			r.m[c * 4 + i] = a.m[i] * b.m[c * 4] + a.m[4 + i] * b.m[c * 4 + 1]
+				+ a.m[8 + i] * b.m[c * 4 + 2] + a.m[12 + i] * b.m[c * 4 + 3];
+	out = r;
+#endif
+}
+
+inline Glare::Math::Mat4 Glare::Math::operator*(const Mat4& a, const Mat4& b)
+{
+	Mat4 r;
+	multiply(a, b, r);
+	return r;
+}
+
+inline Glare::Math::Mat4 Glare::Math::inverse(const Mat4& a)
+{
+	// the adjugate from 2x2 minors of the top and bottom two rows, over the determinant
+	const float* m {a.m};
+	const auto at = [m](int row, int col) { return m[col * 4 + row]; };
+
+	float s[6], c[6];
+	const int pairs[6][2] {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}};
+	for (int i = 0; i != 6; ++i) {
+		const int j {pairs[i][0]};
+		const int k {pairs[i][1]};
+		s[i] = at(0, j) * at(1, k) - at(0, k) * at(1, j);
+		c[i] = at(2, j) * at(3, k) - at(2, k) * at(3, j);
+	}
+
+	const float det {s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0]};
+	const float d {1 / det};
+
+	Mat4 r;
+	auto set = [&r](int row, int col, float x) { r.m[col * 4 + row] = x; };
+	set(0, 0, ( at(1, 1) * c[5] - at(1, 2) * c[4] + at(1, 3) * c[3]) * d);
+	set(0, 1, (-at(0, 1) * c[5] + at(0, 2) * c[4] - at(0, 3) * c[3]) * d);
+	set(0, 2, ( at(3, 1) * s[5] - at(3, 2) * s[4] + at(3, 3) * s[3]) * d);
+	set(0, 3, (-at(2, 1) * s[5] + at(2, 2) * s[4] - at(2, 3) * s[3]) * d);
+
+	set(1, 0, (-at(1, 0) * c[5] + at(1, 2) * c[2] - at(1, 3) * c[1]) * d);
+	set(1, 1, ( at(0, 0) * c[5] - at(0, 2) * c[2] + at(0, 3) * c[1]) * d);
+	set(1, 2, (-at(3, 0) * s[5] + at(3, 2) * s[2] - at(3, 3) * s[1]) * d);
+	set(1, 3, ( at(2, 0) * s[5] - at(2, 2) * s[2] + at(2, 3) * s[1]) * d);
+
+	set(2, 0, ( at(1, 0) * c[4] - at(1, 1) * c[2] + at(1, 3) * c[0]) * d);
+	set(2, 1, (-at(0, 0) * c[4] + at(0, 1) * c[2] - at(0, 3) * c[0]) * d);
+	set(2, 2, ( at(3, 0) * s[4] - at(3, 1) * s[2] + at(3, 3) * s[0]) * d);
+	set(2, 3, (-at(2, 0) * s[4] + at(2, 1) * s[2] - at(2, 3) * s[0]) * d);
+
+	set(3, 0, (-at(1, 0) * c[3] + at(1, 1) * c[1] - at(1, 2) * c[0]) * d);
+	set(3, 1, ( at(0, 0) * c[3] - at(0, 1) * c[1] + at(0, 2) * c[0]) * d);
+	set(3, 2, (-at(3, 0) * s[3] + at(3, 1) * s[1] - at(3, 2) * s[0]) * d);
+	set(3, 3, ( at(2, 0) * s[3] - at(2, 1) * s[1] + at(2, 2) * s[0]) * d);
+	return r;
+}
+
+inline Glare::Math::Frustum Glare::Math::frustum(const Mat4& to_clip)
+{
+	// -w <= x <= w and so on, as sums and differences of the rows
+	Frustum f;
+	for (int p = 0; p != 6; ++p) {
+		const int row {p / 2};
+		const float sign {p % 2 ? -1.0f : 1.0f};
+		for (int c = 0; c != 4; ++c)
+			f.planes[p][c] = to_clip(3, c) + sign * to_clip(row, c);
+
+		const float* n {f.planes[p]};
+		const float length {std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2])};
+		for (int c = 0; c != 4; ++c)
+			f.planes[p][c] /= length;
+	}
+	return f;
+}
+
+inline bool Glare::Math::operator==(const Mat4& a, const Mat4& b)
+{
+	for (int i = 0; i != 16; ++i)
+		if (a.m[i] != b.m[i])
+			return false;
+
+	return true;
+}
+
+inline bool Glare::Math::operator!=(const Mat4& a, const Mat4& b)
+{
+	return !(a == b);
+}
+
+#endif // !GLARE_MATH_HPP
@@ -0,0 +1,195 @@
+#ifndef GLARE_PARALLEL_HPP
+#define GLARE_PARALLEL_HPP
+
+#include "job_system.hpp"
+#include "slot_map.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Glare {
+	namespace Impl {
+		// calls f(begin, end) for consecutive chunks covering [0, n)
+		// chunks hold a multiple of grain elements, rounded so that chunks never
+		// share a cache line when element i of size element_size lives at base + i * element_size
+		template<typename F>
+		void for_each_chunk(std::size_t n, std::size_t grain, std::uintptr_t base, std::size_t element_size, F&& f)
+		{
+			const std::size_t line {cache_line / std::gcd(cache_line, element_size)}; // elements per whole lines
+			const std::size_t chunk {std::max<std::size_t>((grain + line - 1) / line, 1) * line};
+
+			// shorten the first chunk so that the rest start on a line, if any element does
+			std::size_t first {0};
+			while (first < line && (base + first * element_size) % cache_line != 0)
+				++first;
+			if (first == line)
+				first = 0;
+
+			std::size_t begin {0};
+			for (std::size_t end {first ? first : chunk}; begin < n; end += chunk) {
+				f(begin, std::min(end, n));
+				begin = end;
+			}
+		}
+
+		// calls f(part, begin, end) for consecutive chunks of about grain entities
+		// covering every part of an Ecs view
+		// a part can be larger than a job holds, so if parts is given each is
+		// copied into it once and f is passed the copy, which lives as long as parts
+		// a part's columns aren't visible from here, so chunks are only rounded to
+		// a multiple of cache_line entities, which spans whole lines of any
+		// component type but lines up with them only where a column starts on one
+		template<typename View, typename F>
+		void for_each_view_chunk(const View& view, std::size_t grain,
+								 std::vector<std::shared_ptr<const void>>* parts, F&& f)
+		{
+			view.partition([&](std::size_t n, const auto& part) {
+				using Part = std::decay_t<decltype(part)>;
+				const Part* p {&part};
+				if (parts) {
+					const auto copy = std::make_shared<const Part>(part);
+					parts->push_back(copy);
+					p = copy.get();
+				}
+
+				for_each_chunk(n, grain, 0, 1, [&](std::size_t begin, std::size_t end) { f(*p, begin, end); });
+			});
+		}
+
+		// counts outstanding jobs and keeps the first exception any of them threw
+		class Job_group {
+		public:
+			template<typename F>
+			void submit(Utility::Job_system& jobs, F&& f)
+			{
+				jobs.submit([this, f = std::forward<F>(f)]() mutable {
+					try {
+						f();
+					} catch (...) {
+						std::lock_guard<std::mutex> lock {error_mutex};
+						if (!error)
+							error = std::current_exception();
+					}
+				}, pending);
+			}
+
+			// rethrows the first exception once every job has finished
+			void wait(Utility::Job_system& jobs)
+			{
+				jobs.wait(pending);
+				if (error)
+					std::rethrow_exception(error);
+			}
+		private:
+			Utility::Job_system::Counter pending;
+			std::mutex error_mutex;
+			std::exception_ptr error;
+		};
+	}
+
+	constexpr std::size_t default_grain {1024};
+
+	// calls f on every element of sm, split into chunks of about grain elements
+	// that run on jobs, returns once all are done
+	// f is called as f(T&), f(Stable_index, T&), f(T&, Buffer&) or f(Stable_index, T&, Buffer&)
+	// each chunk gets its own Slot_map::Buffer for structural changes, these are
+	// committed in order afterwards and take effect at the next clean_buffers
+	template<typename T, typename Handle, typename Storage, typename Allocator, typename F>
+	void parallel_for_each(Utility::Job_system& jobs, Slot_map<T, Handle, Storage, Allocator>& sm,
+						   F&& f, std::size_t grain = default_grain);
+
+	// calls f on every entity of an Ecs view as view.each(f) would, split into
+	// chunks of about grain entities that run on jobs, returns once all are done
+	template<typename View, typename F>
+	void parallel_for_each(Utility::Job_system& jobs, const View& view, F&& f, std::size_t grain = default_grain);
+
+	// as above on Job_system::shared()
+	template<typename Range, typename F>
+	void parallel_for_each(Range&& range, F&& f, std::size_t grain = default_grain);
+}
+
+/***** IMPLEMENTATION *****/
+
+template<typename T, typename Handle, typename Storage, typename Allocator, typename F>
+void Glare::parallel_for_each(Utility::Job_system& jobs, Slot_map<T, Handle, Storage, Allocator>& sm,
+							  F&& f, std::size_t grain)
+{
+	using Map = Slot_map<T, Handle, Storage, Allocator>;
+	using Stable_index = typename Map::Stable_index;
+	using Buffer = typename Map::Buffer;
+
+	// chunks are fixed up front and each gets its own buffer, so that the
+	// changes are committed in the same order however the chunks were scheduled
+	std::vector<std::pair<std::size_t, std::size_t>> chunks;
+	if constexpr (std::is_same<Storage, Soa_storage>::value) {
+		const auto values = sm.values();
+		Impl::for_each_chunk(values.size(), grain, reinterpret_cast<std::uintptr_t>(values.data()), sizeof(T),
+			[&](std::size_t begin, std::size_t end) { chunks.emplace_back(begin, end); });
+	} else {
+		// element addresses aren't contiguous, so the grain is only rounded
+		// to a multiple of cache_line elements
+		Impl::for_each_chunk(sm.size(), grain, 0, 1,
+			[&](std::size_t begin, std::size_t end) { chunks.emplace_back(begin, end); });
+	}
+
+	typename Map::Command_queue commands {sm, chunks.size()};
+	const auto first = sm.begin();
+
+	const auto call = [&](T& x, std::size_t i, Buffer& b) {
+		if constexpr (std::is_invocable<F&, Stable_index, T&, Buffer&>::value)
+			f(Stable_index(first + i), x, b);
+		else if constexpr (std::is_invocable<F&, T&, Buffer&>::value)
+			f(x, b);
+		else if constexpr (std::is_invocable<F&, Stable_index, T&>::value)
+			f(Stable_index(first + i), x);
+		else
+			f(x);
+	};
+
+	Impl::Job_group group;
+
+	for (std::size_t c = 0; c != chunks.size(); ++c) {
+		group.submit(jobs, [&call, &sm, first, &b = commands.buffer(c), range = chunks[c]] {
+			if constexpr (std::is_same<Storage, Soa_storage>::value) {
+				const auto elem = sm.values().data();
+				for (std::size_t i {range.first}; i != range.second; ++i)
+					call(elem[i], i, b);
+			} else {
+				for (std::size_t i {range.first}; i != range.second; ++i)
+					call(first[i], i, b);
+			}
+		});
+	}
+
+	group.wait(jobs);
+	commands.commit();
+}
+
+template<typename View, typename F>
+void Glare::parallel_for_each(Utility::Job_system& jobs, const View& view, F&& f, std::size_t grain)
+{
+	std::vector<std::shared_ptr<const void>> parts;
+	Impl::Job_group group;
+
+	Impl::for_each_view_chunk(view, grain, &parts, [&](const auto& part, std::size_t begin, std::size_t end) {
+		group.submit(jobs, [&f, part = &part, begin, end] { (*part)(f, begin, end); });
+	});
+
+	group.wait(jobs);
+}
+
+template<typename Range, typename F>
+void Glare::parallel_for_each(Range&& range, F&& f, std::size_t grain)
+{
+	parallel_for_each(Utility::Job_system::shared(), range, std::forward<F>(f), grain);
+}
+
+#endif // !GLARE_PARALLEL_HPP
@@ -0,0 +1,409 @@
+#ifndef GLARE_PROFILE_HPP
+#define GLARE_PROFILE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GLARE_PROFILE_RDTSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+// zones are compiled in unless GLARE_PROFILE is defined to 0,
+// in which case the macros below expand to nothing
+#ifndef GLARE_PROFILE
+#define GLARE_PROFILE 1
+#endif
+
+namespace Glare {
+	namespace Utility {
+		// what a zone is called and where it is, one per GLARE_PROFILE_ZONE
+		struct Profile_zone_info {
+			const char* name;
+			const char* file;
+			std::uint32_t line;
+		};
+
+		// collects timed zones from every thread
+		// each thread writes the zones it closes into a ring buffer of its own,
+		// without locking, and end_frame gathers them into totals per zone
+		// while disabled a zone costs a relaxed load and a branch
+		class Profiler {
+		public:
+			using size_type = std::size_t;
+			// rdtsc where available, steady_clock nanoseconds otherwise
+			using Ticks = std::uint64_t;
+
+			struct Zone_stats {
+				const Profile_zone_info* zone;
+				size_type calls;
+				double total_ms; // including nested zones
+				double max_ms;
+			};
+
+			Profiler(const Profiler&) = delete;
+			Profiler& operator=(const Profiler&) = delete;
+
+			// the one every zone reports to
+			static Profiler& global();
+			static Ticks now();
+
+			// disabled to begin with
+			void enable(bool = true);
+			bool enabled() const;
+
+			// gathers the zones closed since the last call, from one thread
+			// at a time, usually the main thread once per frame
+			void end_frame();
+			// as of the last end_frame, slowest first
+			const std::vector<Zone_stats>& frame_stats() const;
+			double frame_ms() const;
+			// zones lost because a thread's buffer filled up between two
+			// calls to end_frame, in total
+			size_type dropped() const;
+
+			// zones gathered while capturing are kept for write_chrome_trace
+			void start_capture();
+			void stop_capture();
+			void clear_capture();
+			// JSON for chrome://tracing or Perfetto
+			void write_chrome_trace(std::ostream&);
+
+			// shown in traces for the calling thread instead of its number
+			void set_thread_name(const std::string&);
+			// zone info for a name only known at run time, the same one for the
+			// same name, kept as long as the program runs
+			const Profile_zone_info& intern(const std::string& name);
+
+			// called by Profile_zone
+			void record(const Profile_zone_info*, Ticks begin, Ticks end);
+		private:
+			struct Event {
+				const Profile_zone_info* zone;
+				Ticks begin;
+				Ticks end;
+			};
+
+			// written by its thread, read by end_frame
+			struct Thread_buffer {
+				static constexpr size_type capacity {size_type {1} << 14};
+
+				std::unique_ptr<Event[]> events {new Event[capacity]};
+				std::atomic<size_type> head {0};
+				std::atomic<size_type> tail {0};
+				std::atomic<size_type> dropped {0};
+				std::atomic<bool> in_use {true};
+				std::uint32_t id {0};
+				std::string name;
+			};
+
+			// hands the buffer back when its thread exits
+			struct Thread_slot {
+				~Thread_slot();
+				Thread_buffer* buffer {nullptr};
+			};
+
+			struct Captured {
+				Event event;
+				std::uint32_t thread;
+			};
+
+			Profiler();
+
+			Thread_buffer& buffer();
+			// measured against steady_clock since the profiler was created
+			double ms_per_tick() const;
+
+			static thread_local Thread_slot local;
+
+			std::atomic<bool> on {false};
+			const Ticks start_ticks;
+			const std::chrono::steady_clock::time_point start_time;
+
+			std::mutex mutex; // guards threads and interned
+			std::vector<std::unique_ptr<Thread_buffer>> threads;
+			std::unordered_map<std::string, Profile_zone_info> interned;
+
+			// only touched by end_frame and the capture functions
+			std::vector<Zone_stats> stats;
+			std::unordered_map<const Profile_zone_info*, size_type> stats_index;
+			std::vector<Captured> captured;
+			bool capturing {false};
+			Ticks last_frame;
+			double last_frame_ms {0};
+			size_type dropped_total {0};
+		};
+
+		// times the scope it lives in, use through GLARE_PROFILE_ZONE
+		class Profile_zone {
+		public:
+			explicit Profile_zone(const Profile_zone_info&);
+			~Profile_zone();
+
+			Profile_zone(const Profile_zone&) = delete;
+			Profile_zone& operator=(const Profile_zone&) = delete;
+		private:
+			const Profile_zone_info* info;
+			Profiler::Ticks begin;
+		};
+	}
+}
+
+#define GLARE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GLARE_PROFILE_CONCAT(a, b) GLARE_PROFILE_CONCAT_IMPL(a, b)
+
+#if GLARE_PROFILE
+// times the rest of the enclosing scope under name, a string literal
+#define GLARE_PROFILE_ZONE(name) \
+	static constexpr ::Glare::Utility::Profile_zone_info GLARE_PROFILE_CONCAT(glare_zone_info_, __LINE__) \
+		{name, __FILE__, __LINE__}; \
+	const ::Glare::Utility::Profile_zone GLARE_PROFILE_CONCAT(glare_zone_, __LINE__) \
+		{GLARE_PROFILE_CONCAT(glare_zone_info_, __LINE__)}
+// the same for a Profile_zone_info made elsewhere, such as by Profiler::intern
+#define GLARE_PROFILE_ZONE_INFO(info) \
+	const ::Glare::Utility::Profile_zone GLARE_PROFILE_CONCAT(glare_zone_, __LINE__) {info}
+#else
+#define GLARE_PROFILE_ZONE(name) static_cast<void>(0)
+#define GLARE_PROFILE_ZONE_INFO(info) static_cast<void>(0)
+#endif
+
+/***** IMPLEMENTATION *****/
+
+inline thread_local Glare::Utility::Profiler::Thread_slot Glare::Utility::Profiler::local;
+
+inline Glare::Utility::Profiler& Glare::Utility::Profiler::global()
+{
+	static Profiler p;
+	return p;
+}
+
+inline Glare::Utility::Profiler::Ticks Glare::Utility::Profiler::now()
+{
+#ifdef GLARE_PROFILE_RDTSC
+	return __rdtsc();
+#else
+	return static_cast<Ticks>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+inline void Glare::Utility::Profiler::enable(bool x)
+{
+	on.store(x, std::memory_order_relaxed);
+}
+
+inline bool Glare::Utility::Profiler::enabled() const
+{
+	return on.load(std::memory_order_relaxed);
+}
+
+inline void Glare::Utility::Profiler::end_frame()
+{
+	const Ticks t {now()};
+	const double ms {ms_per_tick()};
+
+	stats.clear();
+	stats_index.clear();
+
+	std::lock_guard<std::mutex> lock {mutex};
+	for (auto& b : threads) {
+		const size_type head {b->head.load(std::memory_order_acquire)};
+		for (size_type i {b->tail.load(std::memory_order_relaxed)}; i != head; ++i) {
+			const Event& e {b->events[i & (Thread_buffer::capacity - 1)]};
+			const double length {static_cast<double>(e.end - e.begin) * ms};
+
+			const auto [it, inserted] = stats_index.try_emplace(e.zone, stats.size());
+			if (inserted)
+				stats.push_back({e.zone, 0, 0, 0});
+			auto& s = stats[it->second];
+			++s.calls;
+			s.total_ms += length;
+			s.max_ms = std::max(s.max_ms, length);
+
+			if (capturing)
+				captured.push_back({e, b->id});
+		}
+		// the events may be overwritten from here on
+		b->tail.store(head, std::memory_order_release);
+		dropped_total += b->dropped.exchange(0, std::memory_order_relaxed);
+	}
+
+	std::sort(stats.begin(), stats.end(), [](const Zone_stats& a, const Zone_stats& b) {
+		return a.total_ms > b.total_ms;
+	});
+	last_frame_ms = static_cast<double>(t - last_frame) * ms;
+	last_frame = t;
+}
+
+inline const std::vector<Glare::Utility::Profiler::Zone_stats>& Glare::Utility::Profiler::frame_stats() const
+{
+	return stats;
+}
+
+inline double Glare::Utility::Profiler::frame_ms() const
+{
+	return last_frame_ms;
+}
+
+inline Glare::Utility::Profiler::size_type Glare::Utility::Profiler::dropped() const
+{
+	return dropped_total;
+}
+
+inline void Glare::Utility::Profiler::start_capture()
+{
+	capturing = true;
+}
+
+inline void Glare::Utility::Profiler::stop_capture()
+{
+	capturing = false;
+}
+
+inline void Glare::Utility::Profiler::clear_capture()
+{
+	captured.clear();
+}
+
+inline void Glare::Utility::Profiler::write_chrome_trace(std::ostream& out)
+{
+	const auto string = [&out](const char* s) {
+		out << '"';
+		for (; *s; ++s) {
+			if (*s == '"' || *s == '\\')
+				out << '\\';
+			out << *s;
+		}
+		out << '"';
+	};
+	const double us {ms_per_tick() * 1e3};
+
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first {true};
+	{
+		std::lock_guard<std::mutex> lock {mutex};
+		for (const auto& b : threads) {
+			if (b->name.empty())
+				continue;
+			out << (first ? "\n" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << b->id
+				<< ",\"args\":{\"name\":";
+			string(b->name.c_str());
+			out << "}}";
+			first = false;
+		}
+	}
+
+	for (const auto& c : captured) {
+		out << (first ? "\n" : ",\n") << "{\"ph\":\"X\",\"name\":";
+		string(c.event.zone->name);
+		out << ",\"pid\":1,\"tid\":" << c.thread
+			<< ",\"ts\":" << static_cast<double>(c.event.begin - start_ticks) * us
+			<< ",\"dur\":" << static_cast<double>(c.event.end - c.event.begin) * us
+			<< ",\"args\":{\"file\":";
+		string(c.event.zone->file);
+		out << ",\"line\":" << c.event.zone->line << "}}";
+		first = false;
+	}
+	out << "\n]}\n";
+}
+
+inline void Glare::Utility::Profiler::set_thread_name(const std::string& name)
+{
+	Thread_buffer& b {buffer()};
+	std::lock_guard<std::mutex> lock {mutex};
+	b.name = name;
+}
+
+inline const Glare::Utility::Profile_zone_info& Glare::Utility::Profiler::intern(const std::string& name)
+{
+	std::lock_guard<std::mutex> lock {mutex};
+	const auto [it, inserted] = interned.try_emplace(name);
+	// the key stays where it is for as long as the node does
+	if (inserted)
+		it->second = {it->first.c_str(), "", 0};
+	return it->second;
+}
+
+inline void Glare::Utility::Profiler::record(const Profile_zone_info* zone, Ticks begin, Ticks end)
+{
+	Thread_buffer& b {buffer()};
+
+	const size_type head {b.head.load(std::memory_order_relaxed)};
+	if (head - b.tail.load(std::memory_order_acquire) == Thread_buffer::capacity) {
+		b.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	b.events[head & (Thread_buffer::capacity - 1)] = {zone, begin, end};
+	b.head.store(head + 1, std::memory_order_release);
+}
+
+inline Glare::Utility::Profiler::Thread_slot::~Thread_slot()
+{
+	if (buffer)
+		buffer->in_use.store(false, std::memory_order_release);
+}
+
+inline Glare::Utility::Profiler::Profiler()
+	:start_ticks {now()},
+	start_time {std::chrono::steady_clock::now()},
+	last_frame {start_ticks}
+{}
+
+inline Glare::Utility::Profiler::Thread_buffer& Glare::Utility::Profiler::buffer()
+{
+	if (local.buffer)
+		return *local.buffer;
+
+	std::lock_guard<std::mutex> lock {mutex};
+	// a buffer left behind by a thread that has exited, once end_frame has emptied it
+	for (auto& b : threads) {
+		if (!b->in_use.load(std::memory_order_acquire)
+			&& b->head.load(std::memory_order_relaxed) == b->tail.load(std::memory_order_acquire)) {
+			b->in_use.store(true, std::memory_order_relaxed);
+			b->name.clear();
+			return *(local.buffer = b.get());
+		}
+	}
+
+	threads.push_back(std::make_unique<Thread_buffer>());
+	threads.back()->id = static_cast<std::uint32_t>(threads.size());
+	return *(local.buffer = threads.back().get());
+}
+
+inline double Glare::Utility::Profiler::ms_per_tick() const
+{
+#ifdef GLARE_PROFILE_RDTSC
+	const Ticks ticks {now() - start_ticks};
+	const double ms {std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count()};
+	return ticks ? ms / static_cast<double>(ticks) : 0;
+#else
+	return 1e-6;
+#endif
+}
+
+inline Glare::Utility::Profile_zone::Profile_zone(const Profile_zone_info& zone)
+	:info {Profiler::global().enabled() ? &zone : nullptr},
+	begin {info ? Profiler::now() : 0}
+{}
+
+inline Glare::Utility::Profile_zone::~Profile_zone()
+{
+	if (info)
+		Profiler::global().record(info, begin, Profiler::now());
+}
+
+#endif // !GLARE_PROFILE_HPP
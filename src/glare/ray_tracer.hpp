@@ -0,0 +1,643 @@
+#ifndef GLARE_RAY_TRACER_HPP
+#define GLARE_RAY_TRACER_HPP
+
+#include "error.hpp"
+#include "job_system.hpp"
+#include "math.hpp"
+#include "profile.hpp"
+#include "sah.hpp"
+#include "utility.hpp"
+#include "video.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace Glare {
+	namespace Video {
+		using Ray = Math::Ray;
+
+		struct Hit {
+			static constexpr std::uint32_t none {0xffffffff};
+
+			float t; // max_t of the ray if it hit nothing
+			float u, v; // weights of the second and third vertex
+			std::uint32_t mesh; // none if it hit nothing
+			std::uint32_t triangle; // within the mesh, the first index over three
+		};
+
+		// renders meshes into an rgba8 image laid out as the Rasterizer's, by
+		// casting a ray through every pixel, and traces batches of rays for baking
+		// triangles are held in a bounding volume hierarchy built by the surface
+		// area heuristic, and refit rather than rebuilt when meshes only move
+		// rays go through it in packets as wide as Impl::Lanes, unless they point
+		// different ways, and the image is traced in tiles that each run as a job
+		class Ray_tracer {
+		public:
+			using size_type = std::size_t;
+
+			static constexpr size_type tile_size {32};
+			// larger nodes are always split
+			static constexpr size_type max_leaf_size {4};
+
+			Ray_tracer(size_type width, size_type height);
+
+			void resize(size_type width, size_type height);
+			// what pixels no triangle covers are
+			void set_clear(std::uint32_t color);
+
+			// copies every three indices in as a triangle and returns the index
+			// of the mesh, counting from 0
+			// throws Video_index_out_of_range if an index is past the vertices
+			size_type add_mesh(Utility::Span<const Vertex>, Utility::Span<const std::uint32_t> indices);
+			// replaces the vertices of a mesh, keeping its indices
+			// throws Video_index_out_of_range if there is no such mesh and
+			// Video_vertex_count_mismatch if the count isn't the one it was added with
+			void update_mesh(size_type mesh, Utility::Span<const Vertex>);
+			void clear();
+			// rebuilds the hierarchy if meshes were added since the last update,
+			// or refits it if any were only updated, render calls this itself
+			void update();
+
+			// the nearest hit of each ray before its max_t, hits[i] for rays[i]
+			// the hierarchy is as of the last update
+			// throws Video_index_out_of_range if hits is smaller than rays
+			void intersect(Utility::Span<const Ray> rays, Utility::Span<Hit> hits) const;
+
+			// a ray through the centre of each pixel from the near plane to the far
+			// plane of to_clip, coloured from the vertices of the nearest triangle
+			// as the Rasterizer would colour the same pixel
+			void render(Utility::Job_system&, const Math::Mat4& to_clip);
+			void render(const Math::Mat4& to_clip);
+
+			size_type width() const;
+			size_type height() const;
+			// rows start from the bottom, as in Rasterizer::image
+			Utility::Span<const std::uint32_t> image() const;
+			// cast by the last render
+			size_type ray_count() const;
+			size_type node_count() const;
+		private:
+			struct Node {
+				float min[3];
+				// first child, the second follows it, or the first triangle of a leaf
+				std::uint32_t first;
+				float max[3];
+				std::uint16_t count; // triangles in a leaf, 0 for inner nodes
+				std::uint16_t axis; // the children were split along
+			};
+
+			// a triangle as the intersection test takes it, in leaf order
+			struct Prepared {
+				float v0[3];
+				float e1[3]; // v1 - v0
+				float e2[3]; // v2 - v0
+			};
+
+			struct Mesh {
+				size_type first_vertex;
+				size_type vertex_count;
+				size_type first_triangle;
+			};
+
+			// rays traced together, one to each of the lanes of L
+			template<typename L>
+			struct Packet {
+				typename L::F origin[3];
+				typename L::F direction[3];
+				typename L::F inverse[3]; // of direction, for the slab test
+				typename L::F t; // of the nearest hit so far, max_t to begin with
+				typename L::F u;
+				typename L::F v;
+				// children are visited nearest first along the first ray
+				bool positive[3];
+				std::uint32_t slot[L::width]; // in leaf order, none for a miss
+			};
+
+			// deeper nodes are split at the median, which bounds the traversal stack
+			static constexpr int max_sah_depth {64};
+			static constexpr int stack_size {128};
+
+			void build();
+			void refit();
+			void prepare_triangles();
+			// count rays from rays, the last repeated to fill the packet
+			template<typename L>
+			static void load(Packet<L>&, const Ray* rays, int count);
+			template<typename L>
+			void trace(Packet<L>&) const;
+			// from the packet's lanes into hits
+			template<typename L>
+			void store(const Packet<L>&, Hit* hits, int count) const;
+			void draw_tile(size_type tile, const Math::Mat4& from_clip);
+			std::uint32_t shade(std::uint32_t slot, float u, float v) const;
+
+			size_type w;
+			size_type h;
+			size_type tiles_x;
+			size_type tiles_y;
+			std::uint32_t clear_color {rgba(0, 0, 0)};
+
+			std::vector<Vertex> vertices;
+			std::vector<Mesh> meshes;
+			std::vector<std::uint32_t> indices; // into vertices, by mesh
+			bool added {false};
+			bool moved {false};
+
+			std::vector<Node> nodes;
+			std::vector<std::uint32_t> order; // the triangle in each leaf slot
+			std::vector<Prepared> prepared;
+
+			std::vector<std::uint32_t> pixels;
+			size_type rays {0};
+		};
+	}
+}
+
+/***** IMPLEMENTATION *****/
+
+inline Glare::Video::Ray_tracer::Ray_tracer(size_type width, size_type height)
+{
+	resize(width, height);
+}
+
+inline void Glare::Video::Ray_tracer::resize(size_type width, size_type height)
+{
+	w = width;
+	h = height;
+	tiles_x = (w + tile_size - 1) / tile_size;
+	tiles_y = (h + tile_size - 1) / tile_size;
+	pixels.assign(w * h, clear_color);
+}
+
+inline void Glare::Video::Ray_tracer::set_clear(std::uint32_t color)
+{
+	clear_color = color;
+}
+
+inline Glare::Video::Ray_tracer::size_type Glare::Video::Ray_tracer::add_mesh(
+	Utility::Span<const Vertex> mesh_vertices, Utility::Span<const std::uint32_t> mesh_indices)
+{
+	for (const auto i : mesh_indices)
+		if (i >= mesh_vertices.size())
+			throw Error::Video_index_out_of_range {"Index " + std::to_string(i) + " is past the "
+				+ std::to_string(mesh_vertices.size()) + " vertices"};
+
+	const auto first_vertex = static_cast<std::uint32_t>(vertices.size());
+	meshes.push_back({vertices.size(), mesh_vertices.size(), indices.size() / 3});
+	vertices.insert(vertices.end(), mesh_vertices.begin(), mesh_vertices.end());
+	// a trailing partial triangle is dropped, as the Rasterizer does
+	for (size_type i = 0; i != mesh_indices.size() - mesh_indices.size() % 3; ++i)
+		indices.push_back(first_vertex + mesh_indices[i]);
+
+	added = true;
+	return meshes.size() - 1;
+}
+
+inline void Glare::Video::Ray_tracer::update_mesh(size_type mesh, Utility::Span<const Vertex> mesh_vertices)
+{
+	if (mesh >= meshes.size())
+		throw Error::Video_index_out_of_range {"There is no mesh " + std::to_string(mesh)};
+	const Mesh& m {meshes[mesh]};
+	if (mesh_vertices.size() != m.vertex_count)
+		throw Error::Video_vertex_count_mismatch {"Mesh " + std::to_string(mesh) + " has "
+			+ std::to_string(m.vertex_count) + " vertices, not " + std::to_string(mesh_vertices.size())};
+
+	std::copy(mesh_vertices.begin(), mesh_vertices.end(), vertices.begin() + m.first_vertex);
+	moved = true;
+}
+
+inline void Glare::Video::Ray_tracer::clear()
+{
+	vertices.clear();
+	meshes.clear();
+	indices.clear();
+	added = true;
+}
+
+inline void Glare::Video::Ray_tracer::update()
+{
+	if (added)
+		build();
+	else if (moved)
+		refit();
+
+	added = false;
+	moved = false;
+}
+
+inline void Glare::Video::Ray_tracer::intersect(Utility::Span<const Ray> ray_span, Utility::Span<Hit> hits) const
+{
+	if (hits.size() < ray_span.size())
+		throw Error::Video_index_out_of_range {std::to_string(ray_span.size()) + " rays don't fit in "
+			+ std::to_string(hits.size()) + " hits"};
+
+	using L = Impl::Lanes;
+	for (size_type first = 0; first < ray_span.size(); first += L::width) {
+		const Ray* group {ray_span.data() + first};
+		const int count {static_cast<int>(std::min<size_type>(L::width, ray_span.size() - first))};
+
+		// rays going different ways would drag each other through most of the
+		// hierarchy, so they are traced one at a time
+		bool coherent {true};
+		for (int l = 1; l < count; ++l)
+			for (int a = 0; a != 3; ++a)
+				coherent = coherent && (group[l].direction[a] >= 0) == (group[0].direction[a] >= 0);
+
+		if (coherent) {
+			Packet<L> p;
+			load(p, group, count);
+			trace(p);
+			store(p, hits.data() + first, count);
+		} else {
+			for (int l = 0; l != count; ++l) {
+				Packet<Impl::Scalar_lanes> p;
+				load(p, group + l, 1);
+				trace(p);
+				store(p, hits.data() + first + l, 1);
+			}
+		}
+	}
+}
+
+inline void Glare::Video::Ray_tracer::render(Utility::Job_system& jobs, const Math::Mat4& to_clip)
+{
+	GLARE_PROFILE_ZONE("Ray_tracer::render");
+
+	update();
+	const Math::Mat4 from_clip {Math::inverse(to_clip)};
+
+	Utility::Job_system::Counter counter;
+	for (size_type t = 0; t != tiles_x * tiles_y; ++t)
+		jobs.submit([this, t, &from_clip] { draw_tile(t, from_clip); }, counter);
+	jobs.wait(counter);
+
+	rays = w * h;
+}
+
+inline void Glare::Video::Ray_tracer::render(const Math::Mat4& to_clip)
+{
+	GLARE_PROFILE_ZONE("Ray_tracer::render");
+
+	update();
+	const Math::Mat4 from_clip {Math::inverse(to_clip)};
+	for (size_type t = 0; t != tiles_x * tiles_y; ++t)
+		draw_tile(t, from_clip);
+
+	rays = w * h;
+}
+
+inline Glare::Video::Ray_tracer::size_type Glare::Video::Ray_tracer::width() const
+{
+	return w;
+}
+
+inline Glare::Video::Ray_tracer::size_type Glare::Video::Ray_tracer::height() const
+{
+	return h;
+}
+
+inline Glare::Utility::Span<const std::uint32_t> Glare::Video::Ray_tracer::image() const
+{
+	return {pixels.data(), pixels.size()};
+}
+
+inline Glare::Video::Ray_tracer::size_type Glare::Video::Ray_tracer::ray_count() const
+{
+	return rays;
+}
+
+inline Glare::Video::Ray_tracer::size_type Glare::Video::Ray_tracer::node_count() const
+{
+	return nodes.size();
+}
+
+inline void Glare::Video::Ray_tracer::build()
+{
+	GLARE_PROFILE_ZONE("Ray_tracer::build");
+
+	const size_type triangle_count {indices.size() / 3};
+	std::vector<Math::Aabb> boxes(triangle_count);
+	std::vector<float> centroids(triangle_count * 3);
+	for (size_type t = 0; t != triangle_count; ++t) {
+		Math::Aabb& b {boxes[t]};
+		for (int a = 0; a != 3; ++a)
+			b.min[a] = b.max[a] = vertices[indices[t * 3]].position[a];
+		for (int i = 1; i != 3; ++i) {
+			const float* p {vertices[indices[t * 3 + i]].position};
+			for (int a = 0; a != 3; ++a) {
+				b.min[a] = std::min(b.min[a], p[a]);
+				b.max[a] = std::max(b.max[a], p[a]);
+			}
+		}
+		for (int a = 0; a != 3; ++a)
+			centroids[t * 3 + a] = (b.min[a] + b.max[a]) / 2;
+	}
+
+	order.resize(triangle_count);
+	std::iota(order.begin(), order.end(), 0);
+	nodes.clear();
+	if (triangle_count == 0) {
+		prepared.clear();
+		return;
+	}
+	// a binary tree with at least one triangle per leaf, so nodes never move
+	nodes.reserve(triangle_count * 2);
+	nodes.push_back({});
+
+	struct Task {
+		std::uint32_t node;
+		size_type begin;
+		size_type end;
+		int depth;
+	};
+	std::vector<Task> tasks {{0, 0, triangle_count, 0}};
+
+	while (!tasks.empty()) {
+		const Task task {tasks.back()};
+		tasks.pop_back();
+		const size_type count {task.end - task.begin};
+
+		Math::Aabb node_bounds {boxes[order[task.begin]]};
+		for (size_type i {task.begin + 1}; i != task.end; ++i)
+			node_bounds = Glare::Impl::merge(node_bounds, boxes[order[i]]);
+		Node& node {nodes[task.node]};
+		std::copy(node_bounds.min, node_bounds.min + 3, node.min);
+		std::copy(node_bounds.max, node_bounds.max + 3, node.max);
+
+		if (count <= max_leaf_size) {
+			node.first = static_cast<std::uint32_t>(task.begin);
+			node.count = static_cast<std::uint16_t>(count);
+			continue;
+		}
+
+		const auto split = Glare::Impl::sah_split(order.begin() + task.begin, order.begin() + task.end,
+			boxes.data(), centroids.data(), task.depth < max_sah_depth);
+		const size_type middle {task.begin + split.middle};
+
+		const auto first = static_cast<std::uint32_t>(nodes.size());
+		node.first = first;
+		node.count = 0;
+		node.axis = static_cast<std::uint16_t>(split.axis);
+		nodes.push_back({});
+		nodes.push_back({});
+		tasks.push_back({first, task.begin, middle, task.depth + 1});
+		tasks.push_back({first + 1, middle, task.end, task.depth + 1});
+	}
+
+	prepare_triangles();
+}
+
+inline void Glare::Video::Ray_tracer::refit()
+{
+	GLARE_PROFILE_ZONE("Ray_tracer::refit");
+
+	prepare_triangles();
+
+	// children always come after their parent
+	for (size_type i = nodes.size(); i-- != 0;) {
+		Node& node {nodes[i]};
+		std::fill(node.min, node.min + 3, INFINITY);
+		std::fill(node.max, node.max + 3, -INFINITY);
+		const auto grow = [&node](const float* lo, const float* hi) {
+			for (int a = 0; a != 3; ++a) {
+				node.min[a] = std::min(node.min[a], lo[a]);
+				node.max[a] = std::max(node.max[a], hi[a]);
+			}
+		};
+
+		if (node.count == 0) {
+			grow(nodes[node.first].min, nodes[node.first].max);
+			grow(nodes[node.first + 1].min, nodes[node.first + 1].max);
+			continue;
+		}
+		for (std::uint32_t s {node.first}; s != node.first + node.count; ++s) {
+			const Prepared& t {prepared[s]};
+			const float v1[3] {t.v0[0] + t.e1[0], t.v0[1] + t.e1[1], t.v0[2] + t.e1[2]};
+			const float v2[3] {t.v0[0] + t.e2[0], t.v0[1] + t.e2[1], t.v0[2] + t.e2[2]};
+			grow(t.v0, t.v0);
+			grow(v1, v1);
+			grow(v2, v2);
+		}
+	}
+}
+
+inline void Glare::Video::Ray_tracer::prepare_triangles()
+{
+	prepared.resize(order.size());
+	for (size_type s = 0; s != order.size(); ++s) {
+		const std::uint32_t* index {&indices[order[s] * 3]};
+		const float* v0 {vertices[index[0]].position};
+		const float* v1 {vertices[index[1]].position};
+		const float* v2 {vertices[index[2]].position};
+		for (int a = 0; a != 3; ++a) {
+			prepared[s].v0[a] = v0[a];
+			prepared[s].e1[a] = v1[a] - v0[a];
+			prepared[s].e2[a] = v2[a] - v0[a];
+		}
+	}
+}
+
+template<typename L>
+void Glare::Video::Ray_tracer::load(Packet<L>& p, const Ray* ray, int count)
+{
+	float lanes[7][L::width];
+	for (int l = 0; l != L::width; ++l) {
+		const Ray& r {ray[std::min(l, count - 1)]};
+		for (int a = 0; a != 3; ++a) {
+			lanes[a][l] = r.origin[a];
+			lanes[3 + a][l] = r.direction[a];
+		}
+		lanes[6][l] = r.max_t;
+		p.slot[l] = Hit::none;
+	}
+
+	for (int a = 0; a != 3; ++a) {
+		p.origin[a] = L::load(lanes[a]);
+		p.direction[a] = L::load(lanes[3 + a]);
+		p.inverse[a] = L::div(L::set(1), p.direction[a]);
+		p.positive[a] = ray[0].direction[a] >= 0;
+	}
+	p.t = L::load(lanes[6]);
+	p.u = L::set(0);
+	p.v = L::set(0);
+}
+
+template<typename L>
+void Glare::Video::Ray_tracer::trace(Packet<L>& p) const
+{
+	if (nodes.empty())
+		return;
+
+	std::uint32_t stack[stack_size];
+	int top {0};
+	stack[top++] = 0;
+
+	using F = typename L::F;
+	using M = typename L::M;
+	const F zero {L::set(0)};
+	const F one {L::set(1)};
+
+	while (top != 0) {
+		const Node& node {nodes[stack[--top]]};
+
+		// slab test, against the nearest hit so far
+		F entry {zero};
+		F exit {p.t};
+		for (int a = 0; a != 3; ++a) {
+			const F lo {L::mul(L::sub(L::set(node.min[a]), p.origin[a]), p.inverse[a])};
+			const F hi {L::mul(L::sub(L::set(node.max[a]), p.origin[a]), p.inverse[a])};
+			entry = L::max(entry, L::min(lo, hi));
+			exit = L::min(exit, L::max(lo, hi));
+		}
+		if (!L::any(L::less_equal(entry, exit)))
+			continue;
+
+		if (node.count == 0) {
+			// the nearer child is pushed last so that it comes off first
+			const bool left_first {p.positive[node.axis]};
+			stack[top++] = node.first + left_first;
+			stack[top++] = node.first + !left_first;
+			continue;
+		}
+
+		// Moller-Trumbore against every lane
+		for (std::uint32_t s {node.first}; s != node.first + node.count; ++s) {
+			const Prepared& t {prepared[s]};
+			const F e1[3] {L::set(t.e1[0]), L::set(t.e1[1]), L::set(t.e1[2])};
+			const F e2[3] {L::set(t.e2[0]), L::set(t.e2[1]), L::set(t.e2[2])};
+			const F* d {p.direction};
+			const F o[3] {
+				L::sub(p.origin[0], L::set(t.v0[0])),
+				L::sub(p.origin[1], L::set(t.v0[1])),
+				L::sub(p.origin[2], L::set(t.v0[2]))
+			};
+			const auto cross = [](const F* a, const F* b, F* out) {
+				out[0] = L::sub(L::mul(a[1], b[2]), L::mul(a[2], b[1]));
+				out[1] = L::sub(L::mul(a[2], b[0]), L::mul(a[0], b[2]));
+				out[2] = L::sub(L::mul(a[0], b[1]), L::mul(a[1], b[0]));
+			};
+			const auto dot = [](const F* a, const F* b) {
+				return L::add(L::add(L::mul(a[0], b[0]), L::mul(a[1], b[1])), L::mul(a[2], b[2]));
+			};
+
+			F pv[3];
+			cross(d, e2, pv);
+			// parallel rays divide by zero and fail every comparison below
+			const F inv_det {L::div(one, dot(e1, pv))};
+			const F u {L::mul(dot(o, pv), inv_det)};
+			F qv[3];
+			cross(o, e1, qv);
+			const F v {L::mul(dot(d, qv), inv_det)};
+			const F dist {L::mul(dot(e2, qv), inv_det)};
+
+			const M hit {L::both(L::both(L::less_equal(zero, u), L::less_equal(zero, v)),
+				L::both(L::less_equal(L::add(u, v), one), L::both(L::greater(dist, zero), L::less(dist, p.t))))};
+			if (!L::any(hit))
+				continue;
+
+			p.t = L::select(hit, dist, p.t);
+			p.u = L::select(hit, u, p.u);
+			p.v = L::select(hit, v, p.v);
+			for (int bits {L::bits(hit)}, l {0}; bits != 0; bits >>= 1, ++l)
+				if (bits & 1)
+					p.slot[l] = s;
+		}
+	}
+}
+
+template<typename L>
+void Glare::Video::Ray_tracer::store(const Packet<L>& p, Hit* hits, int count) const
+{
+	float t[L::width], u[L::width], v[L::width];
+	L::store(t, p.t);
+	L::store(u, p.u);
+	L::store(v, p.v);
+	for (int l = 0; l != count; ++l) {
+		Hit& hit {hits[l]};
+		hit.t = t[l];
+		hit.u = u[l];
+		hit.v = v[l];
+		hit.mesh = Hit::none;
+		hit.triangle = Hit::none;
+		if (p.slot[l] != Hit::none) {
+			const std::uint32_t triangle {order[p.slot[l]]};
+			const auto m = std::upper_bound(meshes.begin(), meshes.end(), triangle,
+				[](std::uint32_t x, const Mesh& mesh) { return x < mesh.first_triangle; }) - 1;
+			hit.mesh = static_cast<std::uint32_t>(m - meshes.begin());
+			hit.triangle = static_cast<std::uint32_t>(triangle - m->first_triangle);
+		}
+	}
+}
+
+inline void Glare::Video::Ray_tracer::draw_tile(size_type tile, const Math::Mat4& from_clip)
+{
+	GLARE_PROFILE_ZONE("Ray_tracer::draw_tile");
+
+	using L = Impl::Lanes;
+
+	const size_type x0 {tile % tiles_x * tile_size};
+	const size_type y0 {tile / tiles_x * tile_size};
+	const size_type x1 {std::min(x0 + tile_size, w)};
+	const size_type y1 {std::min(y0 + tile_size, h)};
+
+	// a point on the near or far plane, in world space
+	const auto unproject = [&from_clip](float x, float y, float z, float* out) {
+		const float* m {from_clip.m};
+		float p[4];
+		for (int r = 0; r != 4; ++r)
+			p[r] = m[r] * x + m[4 + r] * y + m[8 + r] * z + m[12 + r];
+		for (int a = 0; a != 3; ++a)
+			out[a] = p[a] / p[3];
+	};
+
+	for (size_type y {y0}; y != y1; ++y) {
+		const float ndc_y {(static_cast<float>(y) + 0.5f) / static_cast<float>(h) * 2 - 1};
+		for (size_type x {x0}; x < x1; x += L::width) {
+			const int count {static_cast<int>(std::min<size_type>(L::width, x1 - x))};
+
+			Ray ray[L::width];
+			for (int l = 0; l != count; ++l) {
+				const float ndc_x {(static_cast<float>(x + l) + 0.5f) / static_cast<float>(w) * 2 - 1};
+				float end[3];
+				unproject(ndc_x, ndc_y, -1, ray[l].origin);
+				unproject(ndc_x, ndc_y, 1, end);
+				for (int a = 0; a != 3; ++a)
+					ray[l].direction[a] = end[a] - ray[l].origin[a];
+				ray[l].max_t = 1;
+			}
+
+			Packet<L> p;
+			load(p, ray, count);
+			trace(p);
+
+			float u[L::width], v[L::width];
+			L::store(u, p.u);
+			L::store(v, p.v);
+			std::uint32_t* out {&pixels[y * w + x]};
+			for (int l = 0; l != count; ++l)
+				out[l] = p.slot[l] == Hit::none ? clear_color : shade(p.slot[l], u[l], v[l]);
+		}
+	}
+}
+
+inline std::uint32_t Glare::Video::Ray_tracer::shade(std::uint32_t slot, float u, float v) const
+{
+	const std::uint32_t* index {&indices[order[slot] * 3]};
+	const float weight[3] {1 - u - v, u, v};
+
+	std::uint32_t color {0};
+	for (int c = 0; c != 4; ++c) {
+		float x {0};
+		for (int i = 0; i != 3; ++i)
+			x += weight[i] * static_cast<float>(vertices[index[i]].color >> (8 * c) & 0xff);
+		color |= static_cast<std::uint32_t>(std::min(std::max(std::nearbyint(x), 0.0f), 255.0f)) << (8 * c);
+	}
+	return color;
+}
+
+#endif // !GLARE_RAY_TRACER_HPP
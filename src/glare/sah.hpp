@@ -0,0 +1,130 @@
+#ifndef GLARE_SAH_HPP
+#define GLARE_SAH_HPP
+
+#include "math.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace Glare {
+	namespace Impl {
+		constexpr int sah_bin_count {16};
+
+		inline Math::Aabb merge(const Math::Aabb& a, const Math::Aabb& b)
+		{
+			Math::Aabb r;
+			for (int i = 0; i != 3; ++i) {
+				r.min[i] = std::min(a.min[i], b.min[i]);
+				r.max[i] = std::max(a.max[i], b.max[i]);
+			}
+			return r;
+		}
+
+		// half the surface area, which is all that costs compare
+		inline float area(const Math::Aabb& a)
+		{
+			const float x {a.max[0] - a.min[0]}, y {a.max[1] - a.min[1]}, z {a.max[2] - a.min[2]};
+			return x * y + y * z + z * x;
+		}
+
+		struct Sah_split {
+			std::size_t middle; // items on the left
+			int axis;
+		};
+
+		// splits a node of a bounding volume hierarchy built from the top down,
+		// holding the items in [first, last) that index boxes and centroids
+		// items are binned by centroid along each axis and the split between bins
+		// with the least area times count on its two sides wins
+		// without sah, or if every centroid is in the same place, they are split
+		// at the median along the axis their centroids spread furthest on
+		// the items on the left are moved to the front
+		template<typename It>
+		Sah_split sah_split(It first, It last, const Math::Aabb* boxes, const float* centroids, bool sah);
+	}
+}
+
+/***** IMPLEMENTATION *****/
+
+template<typename It>
+Glare::Impl::Sah_split Glare::Impl::sah_split(It first, It last, const Math::Aabb* boxes, const float* centroids, bool sah)
+{
+	constexpr int bin_count {sah_bin_count};
+
+	Math::Aabb centroid_bounds {{INFINITY, INFINITY, INFINITY}, {-INFINITY, -INFINITY, -INFINITY}};
+	for (It k {first}; k != last; ++k) {
+		const float* c {&centroids[*k * 3]};
+		for (int i = 0; i != 3; ++i) {
+			centroid_bounds.min[i] = std::min(centroid_bounds.min[i], c[i]);
+			centroid_bounds.max[i] = std::max(centroid_bounds.max[i], c[i]);
+		}
+	}
+
+	// the cheapest split between bins along any axis
+	int best_axis {-1};
+	int best_split {0};
+	float best_cost {INFINITY};
+	float bin_scale[3];
+	for (int i = 0; i != 3; ++i)
+		bin_scale[i] = bin_count / (centroid_bounds.max[i] - centroid_bounds.min[i]);
+	const auto bin_of = [&](std::size_t item, int axis) {
+		const int b {static_cast<int>((centroids[item * 3 + axis] - centroid_bounds.min[axis]) * bin_scale[axis])};
+		return std::min(b, bin_count - 1);
+	};
+
+	if (sah) {
+		for (int axis = 0; axis != 3; ++axis) {
+			if (!(centroid_bounds.max[axis] > centroid_bounds.min[axis]))
+				continue;
+
+			Math::Aabb bins[bin_count];
+			std::size_t counts[bin_count] {};
+			for (It k {first}; k != last; ++k) {
+				const int b {bin_of(*k, axis)};
+				bins[b] = counts[b] ? merge(bins[b], boxes[*k]) : boxes[*k];
+				++counts[b];
+			}
+
+			// cost of the left side of each split, then add the right
+			float cost[bin_count - 1];
+			Math::Aabb side {};
+			std::size_t side_count {0};
+			for (int b = 0; b != bin_count - 1; ++b) {
+				if (counts[b])
+					side = side_count ? merge(side, bins[b]) : bins[b];
+				side_count += counts[b];
+				cost[b] = side_count ? area(side) * static_cast<float>(side_count) : INFINITY;
+			}
+			side_count = 0;
+			for (int b = bin_count - 1; b != 0; --b) {
+				if (counts[b])
+					side = side_count ? merge(side, bins[b]) : bins[b];
+				side_count += counts[b];
+				const float c {side_count ? cost[b - 1] + area(side) * static_cast<float>(side_count) : INFINITY};
+				if (c < best_cost) {
+					best_cost = c;
+					best_axis = axis;
+					best_split = b;
+				}
+			}
+		}
+	}
+
+	if (best_axis >= 0) {
+		const It middle {std::partition(first, last, [&](std::size_t item) { return bin_of(item, best_axis) < best_split; })};
+		return {static_cast<std::size_t>(middle - first), best_axis};
+	}
+
+	best_axis = 0;
+	for (int i = 1; i != 3; ++i)
+		if (centroid_bounds.max[i] - centroid_bounds.min[i] > centroid_bounds.max[best_axis] - centroid_bounds.min[best_axis])
+			best_axis = i;
+	const auto middle = static_cast<std::size_t>(last - first) / 2;
+	std::nth_element(first, first + middle, last, [&](std::size_t a, std::size_t b) {
+		return centroids[a * 3 + best_axis] < centroids[b * 3 + best_axis];
+	});
+	return {middle, best_axis};
+}
+
+#endif // !GLARE_SAH_HPP
@@ -0,0 +1,186 @@
+#ifndef GLARE_SCHEDULER_HPP
+#define GLARE_SCHEDULER_HPP
+
+#include "job_system.hpp"
+#include "profile.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Glare {
+	namespace Ecs {
+		// runs systems over the entities of an Entity_manager or Sparse_entity_manager
+		// each system declares the components it reads (const) and writes, and
+		// a system only waits for earlier systems that write what it touches
+		// or touch what it writes, everything else runs at the same time
+		template<typename Manager>
+		class Scheduler {
+		public:
+			using size_type = std::size_t;
+
+			explicit Scheduler(Manager&);
+
+			Scheduler(const Scheduler&) = delete;
+			Scheduler& operator=(const Scheduler&) = delete;
+
+			// f is called for every entity as by view<C...>().each(f)
+			// returns the position of the system, systems run in that order
+			// unless they don't conflict
+			template<typename... C, typename F>
+			size_type system(F&& f);
+
+			// runs every system once, the calling thread helps until all are done
+			// if systems throw, the rest still run and the first exception is rethrown
+			void run(Utility::Job_system&);
+			// runs every system once on the calling thread, in order
+			void run();
+
+			size_type system_count() const;
+			// earlier systems that system i waits for
+			const std::vector<size_type>& dependencies(size_type i) const;
+			// what system i is called in profiles, "System i" by default
+			void set_name(size_type i, const std::string&);
+		private:
+			using Mask = typename Manager::Mask;
+
+			struct System {
+				std::function<void()> run;
+				const Utility::Profile_zone_info* zone;
+				Mask reads;
+				Mask writes;
+				std::vector<size_type> dependencies;
+				std::vector<size_type> dependents;
+			};
+
+			void submit(size_type, Utility::Job_system&);
+			void execute(size_type, Utility::Job_system&);
+
+			Manager* manager;
+			std::vector<System> systems;
+
+			// state of the current run
+			std::unique_ptr<std::atomic<size_type>[]> waiting_on; // unfinished dependencies
+			Utility::Job_system::Counter unfinished;
+			std::mutex error_mutex;
+			std::exception_ptr error;
+		};
+	}
+}
+
+/***** IMPLEMENTATION *****/
+
+template<typename Manager>
+Glare::Ecs::Scheduler<Manager>::Scheduler(Manager& manager)
+	:manager {&manager}
+{}
+
+template<typename Manager>
+template<typename... C, typename F>
+typename Glare::Ecs::Scheduler<Manager>::size_type
+Glare::Ecs::Scheduler<Manager>::system(F&& f)
+{
+	System s {
+		[m = manager, f = std::forward<F>(f)]() mutable { m->template view<C...>().each(f); },
+		nullptr,
+		(Mask {0} | ... | (std::is_const<C>::value ? Manager::template mask<C>() : Mask {0})),
+		(Mask {0} | ... | (std::is_const<C>::value ? Mask {0} : Manager::template mask<C>())),
+		{},
+		{}
+	};
+
+	const auto i = systems.size();
+	s.zone = &Utility::Profiler::global().intern("System " + std::to_string(i));
+	for (size_type j = 0; j < i; ++j) {
+		auto& earlier = systems[j];
+		if (earlier.writes & (s.reads | s.writes) || s.writes & earlier.reads) {
+			s.dependencies.push_back(j);
+			earlier.dependents.push_back(i);
+		}
+	}
+
+	systems.push_back(std::move(s));
+	waiting_on = std::make_unique<std::atomic<size_type>[]>(systems.size());
+
+	return i;
+}
+
+template<typename Manager>
+void Glare::Ecs::Scheduler<Manager>::run(Utility::Job_system& jobs)
+{
+	if (systems.empty())
+		return;
+
+	for (size_type i = 0; i < systems.size(); ++i)
+		waiting_on[i].store(systems[i].dependencies.size(), std::memory_order_relaxed);
+
+	for (size_type i = 0; i < systems.size(); ++i)
+		if (systems[i].dependencies.empty())
+			submit(i, jobs);
+
+	jobs.wait(unfinished);
+
+	if (error)
+		std::rethrow_exception(std::exchange(error, nullptr));
+}
+
+template<typename Manager>
+void Glare::Ecs::Scheduler<Manager>::run()
+{
+	for (auto& s : systems) {
+		GLARE_PROFILE_ZONE_INFO(*s.zone);
+		s.run();
+	}
+}
+
+template<typename Manager>
+typename Glare::Ecs::Scheduler<Manager>::size_type
+Glare::Ecs::Scheduler<Manager>::system_count() const
+{
+	return systems.size();
+}
+
+template<typename Manager>
+const std::vector<typename Glare::Ecs::Scheduler<Manager>::size_type>&
+Glare::Ecs::Scheduler<Manager>::dependencies(size_type i) const
+{
+	return systems[i].dependencies;
+}
+
+template<typename Manager>
+void Glare::Ecs::Scheduler<Manager>::set_name(size_type i, const std::string& name)
+{
+	systems[i].zone = &Utility::Profiler::global().intern(name);
+}
+
+template<typename Manager>
+void Glare::Ecs::Scheduler<Manager>::submit(size_type i, Utility::Job_system& jobs)
+{
+	jobs.submit([this, i, &jobs] { execute(i, jobs); }, unfinished);
+}
+
+template<typename Manager>
+void Glare::Ecs::Scheduler<Manager>::execute(size_type i, Utility::Job_system& jobs)
+{
+	try {
+		GLARE_PROFILE_ZONE_INFO(*systems[i].zone);
+		systems[i].run();
+	} catch (...) {
+		std::lock_guard<std::mutex> lock {error_mutex};
+		if (!error)
+			error = std::current_exception();
+	}
+
+	for (const auto d : systems[i].dependents)
+		if (waiting_on[d].fetch_sub(1, std::memory_order_acq_rel) == 1)
+			submit(d, jobs);
+}
+
+#endif // !GLARE_SCHEDULER_HPP
@@ -2,29 +2,443 @@
 #define GLARE_SLOT_MAP_HPP
 
 #include "error.hpp"
+#include "profile.hpp"
+#include "utility.hpp"
 
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>
 #include <stdexcept>
 #include <algorithm>
+#include <atomic>
+#include <functional>
 #include <limits>
+#include <memory>
+#include <memory_resource>
 
 namespace Glare {
-	template<typename T>
+	namespace Snapshot {
+		namespace Impl {
+			struct Access;
+		}
+
+		template<typename Map>
+		class History;
+	}
+
+	// what happens to a slot once its counter has been used up
+	enum class Retirement_policy {
+		retire, // never hand the slot out again, so stale handles can never match
+		wrap // start the counter again from zero, trading safety for bounded memory
+	};
+
+	namespace Impl {
+		// narrowest unsigned type with at least Bits bits
+		template<unsigned Bits>
+		using Uint_least = std::conditional_t<Bits <= 8, std::uint8_t,
+			std::conditional_t<Bits <= 16, std::uint16_t,
+			std::conditional_t<Bits <= 32, std::uint32_t, std::uint64_t>>>;
+
+		template<typename T>
+		constexpr T low_bits(unsigned bits)
+		{
+			// cast before shifting, small types are promoted to int by ~
+			return bits == 0 ? T {0}
+				: static_cast<T>(static_cast<T>(~T {0}) >> (std::numeric_limits<T>::digits - bits));
+		}
+	}
+
+	// packs a slot index and a counter into a single unsigned integer
+	// all ones in either field is reserved to mark an invalid handle
+	template<typename Value = std::uint64_t,
+			 unsigned Index_bits = 32,
+			 unsigned Counter_bits = std::numeric_limits<Value>::digits - Index_bits>
+	struct Handle_traits {
+		static_assert(std::is_unsigned<Value>::value, "Handle must be an unsigned integer");
+		static_assert(Index_bits > 0 && Counter_bits > 0
+					  && Index_bits + Counter_bits <= std::numeric_limits<Value>::digits,
+					  "Index and counter do not fit in the handle");
+
+		using value_type = Value;
+		using index_type = Impl::Uint_least<Index_bits>;
+		using counter_type = Impl::Uint_least<Counter_bits>;
+
+		static constexpr index_type null_index {Impl::low_bits<index_type>(Index_bits)};
+		static constexpr counter_type null_counter {Impl::low_bits<counter_type>(Counter_bits)};
+		static constexpr value_type null_value {
+			static_cast<value_type>(static_cast<value_type>(null_counter) << Index_bits | null_index)};
+
+		static constexpr value_type pack(index_type index, counter_type counter)
+		{
+			return static_cast<value_type>(static_cast<value_type>(counter) << Index_bits | index);
+		}
+
+		static constexpr index_type index(value_type x)
+		{
+			return static_cast<index_type>(x & null_index);
+		}
+
+		static constexpr counter_type counter(value_type x)
+		{
+			return static_cast<counter_type>(x >> Index_bits & null_counter);
+		}
+	};
+
+	// 4 byte handle, up to about a million live elements
+	using Compact_handle_traits = Handle_traits<std::uint32_t, 20>;
+
+	namespace Impl {
+		// T(args...) if there is a matching constructor, otherwise T{args...}
+		// so that aggregates can be emplaced too
+		template<typename T, typename... Args>
+		T construct(Args&&... args)
+		{
+			if constexpr (std::is_constructible<T, Args&&...>::value)
+				return T(std::forward<Args>(args)...);
+			else
+				return T {std::forward<Args>(args)...};
+		}
+
+		// same as construct, but straight into a vector
+		// aggregates without a matching constructor are moved in once
+		template<typename Vector, typename... Args>
+		void emplace_back(Vector& v, Args&&... args)
+		{
+			using T = typename Vector::value_type;
+			if constexpr (std::is_constructible<T, Args&&...>::value)
+				v.emplace_back(std::forward<Args>(args)...);
+			else
+				v.push_back(T {std::forward<Args>(args)...});
+		}
+
+		// vector of U allocated by Allocator rebound to U
+		template<typename U, typename Allocator>
+		using Vector = std::vector<U, typename std::allocator_traits<Allocator>::template rebind_alloc<U>>;
+
+		// an element together with the slot that refers to it
+		template<typename T, typename Index>
+		struct Indexed_element {
+			template<typename... Args>
+			Indexed_element(Index index, Args&&... args)
+				:val(construct<T>(std::forward<Args>(args)...)), // guaranteed copy elision
+				index {index}
+			{}
+
+			T val;
+			Index index;
+		};
+
+		// array of structures, each element is stored next to its slot index
+		template<typename T, typename Index, typename Allocator>
+		class Aos_container {
+		public:
+			using size_type = std::size_t;
+
+			Aos_container() = default;
+			explicit Aos_container(const Allocator& a) :elem(a) {}
+
+			size_type size() const { return elem.size(); }
+			bool empty() const { return elem.empty(); }
+			size_type capacity() const { return elem.capacity(); }
+			void reserve(size_type n) { elem.reserve(n); }
+
+			// makes room for n elements, growing geometrically
+			void grow(size_type n)
+			{
+				if (elem.capacity() < n)
+					elem.reserve(std::max(n, elem.capacity() * 2));
+			}
+			void clear() { elem.clear(); }
+
+			template<typename... Args>
+			void emplace_back(Index index, Args&&... args)
+			{
+				elem.emplace_back(index, std::forward<Args>(args)...);
+			}
+
+			void pop_back() { elem.pop_back(); }
+
+			// replaces the element at to with the one at from
+			void move_element(size_type from, size_type to) { elem[to] = std::move(elem[from]); }
+
+			T& value(size_type i) { return elem[i].val; }
+			const T& value(size_type i) const { return elem[i].val; }
+			Index& index(size_type i) { return elem[i].index; }
+			Index index(size_type i) const { return elem[i].index; }
+
+			// replaces the contents with n elements and their indices
+			void assign(const T* values, const Index* indices, size_type n)
+			{
+				clear();
+				reserve(n);
+				for (size_type i = 0; i < n; ++i)
+					emplace_back(indices[i], values[i]);
+			}
+		private:
+			Vector<Indexed_element<T, Index>, Allocator> elem;
+		};
+
+		// structure of arrays, elements are contiguous and the slot indices
+		// live in a separate array that iteration never touches
+		template<typename T, typename Index, typename Allocator>
+		class Soa_container {
+		public:
+			using size_type = std::size_t;
+
+			Soa_container() = default;
+			explicit Soa_container(const Allocator& a) :val(a), ind(a) {}
+
+			size_type size() const { return val.size(); }
+			bool empty() const { return val.empty(); }
+			size_type capacity() const { return val.capacity(); }
+
+			void reserve(size_type n)
+			{
+				val.reserve(n);
+				ind.reserve(n);
+			}
+
+			void grow(size_type n)
+			{
+				if (val.capacity() < n)
+					reserve(std::max(n, val.capacity() * 2));
+			}
+
+			void clear()
+			{
+				val.clear();
+				ind.clear();
+			}
+
+			template<typename... Args>
+			void emplace_back(Index index, Args&&... args)
+			{
+				Impl::emplace_back(val, std::forward<Args>(args)...);
+				ind.push_back(index);
+			}
+
+			void pop_back()
+			{
+				val.pop_back();
+				ind.pop_back();
+			}
+
+			void move_element(size_type from, size_type to)
+			{
+				val[to] = std::move(val[from]);
+				ind[to] = ind[from];
+			}
+
+			T& value(size_type i) { return val[i]; }
+			const T& value(size_type i) const { return val[i]; }
+			T* data() { return val.data(); }
+			const T* data() const { return val.data(); }
+			Index& index(size_type i) { return ind[i]; }
+			Index index(size_type i) const { return ind[i]; }
+			const Index* index_data() const { return ind.data(); }
+
+			void assign(const T* values, const Index* indices, size_type n)
+			{
+				val.assign(values, values + n);
+				ind.assign(indices, indices + n);
+			}
+		private:
+			Vector<T, Allocator> val;
+			Vector<Index, Allocator> ind;
+		};
+
+		// elements live in fixed size pages that are never reallocated,
+		// so growing never moves an element or invalidates a reference to it
+		template<typename T, typename Index, typename Allocator, std::size_t Page_size>
+		class Paged_container {
+			static_assert(Page_size > 0 && (Page_size & (Page_size - 1)) == 0,
+						  "Page_size must be a power of two");
+
+			using Page_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+			using Page_traits = std::allocator_traits<Page_allocator>;
+		public:
+			using size_type = std::size_t;
+
+			Paged_container() = default;
+			explicit Paged_container(const Allocator& a) :alloc(a), pages(a), ind(a) {}
+
+			Paged_container(const Paged_container& x)
+				:alloc(Page_traits::select_on_container_copy_construction(x.alloc)),
+				pages(alloc),
+				ind(x.ind)
+			{
+				try {
+					reserve(x.count);
+					for (size_type i = 0; i < x.count; ++i) {
+						::new (static_cast<void*>(slot(i))) T(x.value(i));
+						++count;
+					}
+				}
+				catch (...) {
+					release();
+					throw;
+				}
+			}
+
+			Paged_container(Paged_container&& x) noexcept
+				:alloc(std::move(x.alloc)),
+				pages(std::move(x.pages)),
+				ind(std::move(x.ind)),
+				count {x.count}
+			{
+				x.pages.clear();
+				x.count = 0;
+			}
+
+			Paged_container& operator=(Paged_container x) noexcept
+			{
+				swap(x);
+				return *this;
+			}
+
+			~Paged_container()
+			{
+				release();
+			}
+
+			void swap(Paged_container& x) noexcept
+			{
+				using std::swap;
+				swap(alloc, x.alloc);
+				swap(pages, x.pages);
+				swap(ind, x.ind);
+				swap(count, x.count);
+			}
+
+			size_type size() const { return count; }
+			bool empty() const { return count == 0; }
+			size_type capacity() const { return pages.size() * Page_size; }
+
+			void reserve(size_type n)
+			{
+				while (capacity() < n)
+					pages.push_back(Page_traits::allocate(alloc, Page_size));
+				ind.reserve(n);
+			}
+
+			// pages never move, so there is nothing to amortise
+			void grow(size_type n) { reserve(n); }
+
+			// keeps the pages for reuse
+			void clear()
+			{
+				while (count > 0) pop_back();
+			}
+
+			template<typename... Args>
+			void emplace_back(Index index, Args&&... args)
+			{
+				if (count == capacity())
+					pages.push_back(Page_traits::allocate(alloc, Page_size));
+				::new (static_cast<void*>(slot(count))) T(construct<T>(std::forward<Args>(args)...));
+				try {
+					ind.push_back(index);
+				}
+				catch (...) {
+					slot(count)->~T();
+					throw;
+				}
+				++count;
+			}
+
+			void pop_back()
+			{
+				--count;
+				slot(count)->~T();
+				ind.pop_back();
+			}
+
+			void move_element(size_type from, size_type to)
+			{
+				value(to) = std::move(value(from));
+				ind[to] = ind[from];
+			}
+
+			T& value(size_type i) { return *slot(i); }
+			const T& value(size_type i) const { return *slot(i); }
+			Index& index(size_type i) { return ind[i]; }
+			Index index(size_type i) const { return ind[i]; }
+
+			void assign(const T* values, const Index* indices, size_type n)
+			{
+				clear();
+				reserve(n);
+				for (size_type i = 0; i < n; ++i)
+					emplace_back(indices[i], values[i]);
+			}
+
+			// number of pages holding at least one element
+			size_type page_count() const { return (count + Page_size - 1) / Page_size; }
+
+			// the elements of page i, only the last page can be partially filled
+			T* page_data(size_type i) const { return pages[i]; }
+			size_type page_size(size_type i) const { return std::min(Page_size, count - i * Page_size); }
+		private:
+			T* slot(size_type i) const { return pages[i / Page_size] + i % Page_size; }
+
+			// destroys every element and frees every page
+			void release()
+			{
+				clear();
+				for (T* page : pages)
+					Page_traits::deallocate(alloc, page, Page_size);
+				pages.clear();
+			}
+
+			Page_allocator alloc;
+			Vector<T*, Allocator> pages;
+			Vector<Index, Allocator> ind;
+			size_type count {0};
+		};
+	}
+
+	// storage policies for the densely packed elements of a Slot_map
+	struct Aos_storage {
+		template<typename T, typename Index, typename Allocator>
+		using container = Impl::Aos_container<T, Index, Allocator>;
+	};
+
+	struct Soa_storage {
+		template<typename T, typename Index, typename Allocator>
+		using container = Impl::Soa_container<T, Index, Allocator>;
+	};
+
+	template<std::size_t Page_size>
+	struct Paged_storage {
+		template<typename T, typename Index, typename Allocator>
+		using container = Impl::Paged_container<T, Index, Allocator, Page_size>;
+	};
+
+	// every internal array is allocated with Allocator, rebound as needed
+	template<typename T,
+			 typename Handle = Handle_traits<>,
+			 typename Storage = Soa_storage,
+			 typename Allocator = std::allocator<T>>
 	class Slot_map {
-		using Index = size_t; // index to elem_indirect
+		using Index = typename Handle::index_type; // index to elem_indirect
 		using Direct_index = size_t; // index to elem
-		using Counter = size_t;
-		static constexpr size_t null_index {std::numeric_limits<size_t>::max()};
+		using Counter = typename Handle::counter_type;
+		static constexpr Index null_index {Handle::null_index};
 	public:
 		using value_type = T;
+		using allocator_type = Allocator;
 		using size_type = Direct_index;
-		using difference_type = int;
+		using difference_type = std::ptrdiff_t;
 
 		using Not_valid = Error::Slot_map_stable_index_not_valid;
 		using Out_of_range = Error::Slot_map_out_of_range;
+		using Full = Error::Slot_map_full;
 
 		template<bool Is_const>
 		class Iterator_base;
@@ -40,12 +454,12 @@ namespace Glare {
 			// HACK: messy but works
 			// for equality check between indexes and iterators
 			template<bool U>
-			friend class Slot_map<T>::Iterator_base;
+			friend class Slot_map<T, Handle, Storage, Allocator>::Iterator_base;
 
-			friend class Slot_map<T>;
+			friend class Slot_map<T, Handle, Storage, Allocator>;
 
 			Index_base() = default; // doesn't point to a valid object
-			Index_base(Direct_index, Counter);
+			Index_base(Index, Counter);
 			// default copy, move, destructor are fine
 
 			Index_base& reset();
@@ -56,41 +470,54 @@ namespace Glare {
 			bool operator!=(Index_base<U>) const;
 
 			template<bool U>
-			bool operator==(Slot_map<T>::Iterator_base<U>) const;
+			bool operator==(Slot_map<T, Handle, Storage, Allocator>::Iterator_base<U>) const;
 			template<bool U>
-			bool operator!=(Slot_map<T>::Iterator_base<U>) const;
+			bool operator!=(Slot_map<T, Handle, Storage, Allocator>::Iterator_base<U>) const;
 
 			template<bool U>
 			explicit operator Index_base<U>() const;
 		private:
-			Index index {null_index};
-			Counter counter {null_index};
+			Index index() const;
+			Counter counter() const;
+
+			typename Handle::value_type value {Handle::null_value};
 		}; // Index_base
 
+		// random access iterator over the dense elements
+		// dereferencing is unchecked unless GLARE_CHECKED_ITERATORS is defined,
+		// in which case out of range access throws Out_of_range
 		template<bool Is_const>
 		class Iterator_base {
 			using iterator_type = std::conditional_t<Is_const, const Slot_map*, Slot_map*>;
 		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = Slot_map::difference_type;
+			using pointer = std::conditional_t<Is_const, const T*, T*>;
+			using reference = std::conditional_t<Is_const, const T&, T&>;
+
 			// allow members to access both versions of Iterator_base
 			template<bool U>
 			friend class Iterator_base;
 			// HACK: messy but works
 			// for equality check between indexes and iterators
 			template<bool U>
-			friend class Slot_map<T>::Index_base;
+			friend class Slot_map<T, Handle, Storage, Allocator>::Index_base;
 
+			Iterator_base() = default; // singular, may only be assigned to
 			Iterator_base(iterator_type, Direct_index);
 			// default copy, move, destructor are fine
 
-			std::conditional_t<Is_const, const T*, T*> operator->() const;
-			std::conditional_t<Is_const, const T&, T&> operator*() const;
-			std::conditional_t<Is_const, const T&, T&> operator[](int) const;
+			pointer operator->() const;
+			reference operator*() const;
+			reference operator[](difference_type) const;
 
 			void buffered_remove();
 
 			Iterator_base& operator++();
 			Iterator_base& operator--();
-			// no postfix operations for you
+			Iterator_base operator++(int);
+			Iterator_base operator--(int);
 
 			Iterator_base& operator+=(difference_type);
 			Iterator_base& operator-=(difference_type);
@@ -101,6 +528,11 @@ namespace Glare {
 			Iterator_base operator+(difference_type) const;
 			Iterator_base operator-(difference_type) const;
 
+			friend Iterator_base operator+(difference_type lhs, Iterator_base rhs)
+			{
+				return rhs + lhs;
+			}
+
 			template<bool U>
 			difference_type operator-(Iterator_base<U>) const;
 
@@ -108,19 +540,29 @@ namespace Glare {
 			bool operator==(Iterator_base<U>) const;
 			template<bool U>
 			bool operator!=(Iterator_base<U>) const;
+			template<bool U>
+			bool operator<(Iterator_base<U>) const;
+			template<bool U>
+			bool operator>(Iterator_base<U>) const;
+			template<bool U>
+			bool operator<=(Iterator_base<U>) const;
+			template<bool U>
+			bool operator>=(Iterator_base<U>) const;
 
 			template<bool U>
-			bool operator==(Slot_map<T>::Index_base<U>) const;
+			bool operator==(Slot_map<T, Handle, Storage, Allocator>::Index_base<U>) const;
 			template<bool U>
-			bool operator!=(Slot_map<T>::Index_base<U>) const;
+			bool operator!=(Slot_map<T, Handle, Storage, Allocator>::Index_base<U>) const;
 
 			template<bool U>
 			explicit operator Iterator_base<U>() const;
 			template<bool U>
 			explicit operator Index_base<U>() const;
 		private:
-			iterator_type ptr;
-			Direct_index index;
+			reference get(Direct_index) const;
+
+			iterator_type ptr {nullptr};
+			Direct_index index {0};
 		}; // Iterator_base
 
 		using Stable_index = Index_base<false>;
@@ -129,23 +571,111 @@ namespace Glare {
 		using const_iterator = Iterator_base<true>;
 
 		Slot_map() = default;
-		Slot_map(std::initializer_list<T>);
+		explicit Slot_map(const Allocator&);
+		explicit Slot_map(Retirement_policy, const Allocator& = Allocator {});
+		Slot_map(std::initializer_list<T>, const Allocator& = Allocator {});
 		Slot_map& operator=(std::initializer_list<T>);
 
-		Stable_index add(T = {});
-		// TODO: emplace
+		Stable_index add(T&& = {});
+		Stable_index add(const T&);
+		// constructs the element in place from args
+		template<typename... Args>
+		Stable_index emplace(Args&&...);
 		Slot_map& remove(Direct_index);
 		Slot_map& remove(Stable_index);
 
-		Stable_index buffered_add(T = {});
-		// TODO: buffered_emplace
+		Stable_index buffered_add(T&& = {});
+		Stable_index buffered_add(const T&);
+		template<typename... Args>
+		Stable_index buffered_emplace(Args&&...);
 		Slot_map& buffered_remove(Direct_index);
 		Slot_map& buffered_remove(Stable_index);
 
-		Slot_map& clean_buffers();
+		// what a call to clean_buffers changed
+		struct Clean_stats {
+			size_type added;
+			size_type removed;
+		};
+
+		// applies all buffered additions and removals at once
+		Clean_stats clean_buffers();
+
+		class Command_queue;
+
+		// additions and removals queued by one thread, see Command_queue
+		class Buffer {
+		public:
+			friend class Command_queue;
+
+			// the handle is reserved straight away, and refers to the element
+			// once the queue has been committed
+			Stable_index buffered_add(T&&);
+			Stable_index buffered_add(const T&);
+			template<typename... Args>
+			Stable_index buffered_emplace(Args&&...);
+			void buffered_remove(Stable_index);
+
+			bool empty() const;
+		private:
+			Buffer(Command_queue&, const Allocator&);
+
+			Command_queue* queue;
+			Impl::Vector<Impl::Indexed_element<T, Index>, Allocator> creation;
+			Impl::Vector<Stable_index, Allocator> deletion;
+		};
+
+		// buffers that several threads fill at once, each thread using its own
+		// handles for additions are reserved with atomic counters instead of a lock
+		// commit replays the buffers in order, so the elements end up in the
+		// same order however the threads were scheduled
+		// the Slot_map must not be changed other than through the buffers
+		// between reset and commit
+		class Command_queue {
+		public:
+			friend class Buffer;
+
+			explicit Command_queue(Slot_map&, size_type buffer_count = 1);
+
+			Command_queue(const Command_queue&) = delete;
+			Command_queue& operator=(const Command_queue&) = delete;
+
+			// starts a new round with buffer_count empty buffers
+			// buffers past the count keep their memory for later rounds
+			// not thread safe, call before handing out the buffers
+			void reset(size_type buffer_count);
+			size_type buffer_count() const;
+			// throws Out_of_range past buffer_count
+			Buffer& buffer(size_type);
+
+			// queues the contents of every buffer on the Slot_map as if by
+			// buffered_add and buffered_remove, to take effect at the next
+			// clean_buffers, then empties the buffers
+			void commit();
+		private:
+			Stable_index reserve();
+
+			Slot_map* map;
+			std::vector<Buffer> buffers;
+			size_type active {0}; // buffers in use this round
+
+			// free_index and elem_indirect sizes when the round started
+			size_type free_count {0};
+			size_type slot_count {0};
+			// taken from the back of free_index, then past the end of elem_indirect
+			std::atomic<size_type> free_taken {0};
+			std::atomic<size_type> fresh_taken {0};
+		};
 
 		void clear();
 		size_type size() const;
+		// makes room for n elements without reallocating
+		void reserve(size_type n);
+
+		// number of slots ever allocated, including free and retired ones
+		size_type slot_count() const;
+		size_type retired_count() const;
+		Retirement_policy retirement_policy() const;
+		Allocator get_allocator() const;
 
 		iterator begin();
 		const_iterator begin() const;
@@ -163,309 +693,653 @@ namespace Glare {
 
 		const T& operator[](Direct_index) const;
 		T& operator[](Direct_index);
+
+		// all elements as one contiguous range, in the same order as iteration
+		// only available when Storage keeps the elements contiguous
+		Utility::Span<T> values();
+		Utility::Span<const T> values() const;
+
+		// the elements in blocks, in the same order as iteration
+		// only available with Paged_storage
+		size_type page_count() const;
+		Utility::Span<T> page(size_type);
+		Utility::Span<const T> page(size_type) const;
 	private:
-		void clean_add_buffer();
-		void clean_remove_buffer();
+		// write and read the internal arrays directly, see snapshot.hpp and history.hpp
+		friend struct Snapshot::Impl::Access;
+		template<typename Map>
+		friend class Snapshot::History;
+
+		template<bool Is_const>
+		static Index index_of(Index_base<Is_const> p) { return p.index(); }
+		template<bool Is_const>
+		static Counter counter_of(Index_base<Is_const> p) { return p.counter(); }
+
+		size_type clean_add_buffer();
+		size_type clean_remove_buffer();
 
 		Index get_free();
+		// invalidates all handles to a slot and makes it available for reuse
+		void release(Index);
 
-		// will check if element with that index is scheduled for creation
-		// returns null_index for "not found"
-		Direct_index elem_in_creation_buffer(Index);
+		// true if p refers to an element that is still in creation_buffer
+		bool is_pending(Stable_index p) const;
 
-		struct Indexed_element {
-			T val;
-			Index index;
-		};
+		using Indexed_element = Impl::Indexed_element<T, Index>;
 
+		// counter is bumped every time the slot is released
+		// so that handles to the previous occupant are rejected
+		// while an element waits in creation_buffer, index holds its position
+		// there with pending_flag set, so that it can be cancelled in O(1)
 		struct Checked_index {
-			Direct_index index;
+			Index index; // into elem, or creation_buffer if pending
 			Counter counter;
 		};
 
-		std::vector<Indexed_element> elem;
-		std::vector<Checked_index> elem_indirect;
-		std::vector<Index> free_index;
+		// largest counter a handle can hold, null_counter marks an invalid handle
+		static constexpr Counter max_counter {Handle::null_counter - 1};
+
+		static constexpr Index pending_flag {Index {1} << (std::numeric_limits<Index>::digits - 1)};
+		// every position in elem or creation_buffer must fit below pending_flag
+		static constexpr Index max_slots {null_index < pending_flag ? null_index : pending_flag};
+
+		template<typename U>
+		using Vector = Impl::Vector<U, Allocator>;
+
+		typename Storage::template container<T, Index, Allocator> elem;
+		Vector<Checked_index> elem_indirect;
+		Vector<Index> free_index;
 
 		// creation and deletion is buffered so that it does not invalidate iterators
-		std::vector<Stable_index> deletion_buffer;
-		std::vector<Indexed_element> creation_buffer;
+		Vector<Stable_index> deletion_buffer;
+		Vector<Indexed_element> creation_buffer;
+		// positions to remove during clean_remove_buffer, kept to reuse its memory
+		Vector<Direct_index> removal_order;
 
-		// starts at 0 and increments each time an object is added
-		// used to validate handles
-		Counter counter {0};
+		Retirement_policy retirement {Retirement_policy::retire};
+		size_type retired {0};
 	}; // Slot_map
+
+	// Slot_map whose elements never move while it grows
+	template<typename T,
+			 std::size_t Page_size = 1024,
+			 typename Handle = Handle_traits<>,
+			 typename Allocator = std::allocator<T>>
+	using Paged_slot_map = Slot_map<T, Handle, Paged_storage<Page_size>, Allocator>;
+
+	// Slot_map using a polymorphic allocator, like std::pmr::vector
+	namespace Pmr {
+		template<typename T, typename Handle = Handle_traits<>, typename Storage = Soa_storage>
+		using Slot_map = Glare::Slot_map<T, Handle, Storage, std::pmr::polymorphic_allocator<T>>;
+	}
 }
 
 /***** IMPLEMENTATION *****/
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
-Glare::Slot_map<T>::Iterator_base<Is_const>
-Glare::Slot_map<T>::Iterator_base<Is_const>::operator+(difference_type rhs) const
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator+(difference_type rhs) const
 {
 	return {ptr, index + rhs};
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
-Glare::Slot_map<T>::Iterator_base<Is_const>
-Glare::Slot_map<T>::Iterator_base<Is_const>::operator-(difference_type rhs) const
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator-(difference_type rhs) const
 {
 	return {ptr, index - rhs};
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
-Glare::Slot_map<T>::Iterator_base<Is_const>::Iterator_base
-(typename Glare::Slot_map<T>::Iterator_base<Is_const>::iterator_type ptr,
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::Iterator_base
+(typename Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::iterator_type ptr,
  Direct_index index)
 	:ptr {ptr},
 	index {index}
 {}
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
-Glare::Slot_map<T>::Index_base<Is_const>::Index_base
+Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<Is_const>::Index_base
 (Index index, Counter counter)
-	:index {index},
-	counter {counter}
+	:value {Handle::pack(index, counter)}
 {}
 
-template<typename T>
-const T& Glare::Slot_map<T>::operator[]
-(typename Glare::Slot_map<T>::Stable_const_index p) const
+template<typename T, typename Handle, typename Storage, typename Allocator>
+template<bool Is_const>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Index
+Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<Is_const>::index() const
+{
+	return Handle::index(value);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+template<bool Is_const>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Counter
+Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<Is_const>::counter() const
+{
+	return Handle::counter(value);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+const T& Glare::Slot_map<T, Handle, Storage, Allocator>::operator[]
+(typename Glare::Slot_map<T, Handle, Storage, Allocator>::Stable_const_index p) const
 {
 	if (!is_valid(p)) throw Not_valid {"Invalid Stable_index dereferenced"};
 
-	const Direct_index redirect {elem_indirect[p.index].index};
-	return elem[redirect].val;
+	const Direct_index redirect {elem_indirect[p.index()].index};
+	return elem.value(redirect);
 }
 
-template<typename T>
-T& Glare::Slot_map<T>::operator[]
-(typename Glare::Slot_map<T>::Stable_index p)
+template<typename T, typename Handle, typename Storage, typename Allocator>
+T& Glare::Slot_map<T, Handle, Storage, Allocator>::operator[]
+(typename Glare::Slot_map<T, Handle, Storage, Allocator>::Stable_index p)
 {
 	if (!is_valid(p)) throw Not_valid {"Invalid Stable_index dereferenced"};
 
-	const Direct_index redirect {elem_indirect[p.index].index};
-	return elem[redirect].val;
+	const Direct_index redirect {elem_indirect[p.index()].index};
+	return elem.value(redirect);
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
-bool Glare::Slot_map<T>::is_valid(Glare::Slot_map<T>::Index_base<Is_const> p) const
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::is_valid(Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<Is_const> p) const
 {
 	// check that index and counter are in the correct range
-	if (p.counter == Glare::Slot_map<T>::null_index
-		|| p.index < 0
-		|| p.index >= elem_indirect.size())
+	if (p.counter() == Handle::null_counter
+		|| p.index() >= elem_indirect.size())
 		return false;
 
-	const auto redirect = elem_indirect[p.index];
-	return redirect.counter == p.counter // check counters
-		&& redirect.index != Glare::Slot_map<T>::null_index;
+	const auto redirect = elem_indirect[p.index()];
+	return redirect.counter == p.counter() // check counters
+		&& redirect.index != Glare::Slot_map<T, Handle, Storage, Allocator>::null_index
+		&& !(redirect.index & pending_flag);
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::is_pending(Stable_index p) const
+{
+	if (p.index() >= elem_indirect.size())
+		return false;
+
+	const auto redirect = elem_indirect[p.index()];
+	return redirect.counter == p.counter()
+		&& redirect.index != Glare::Slot_map<T, Handle, Storage, Allocator>::null_index
+		&& (redirect.index & pending_flag);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
-Glare::Slot_map<T>::Index_base<Is_const>&
-Glare::Slot_map<T>::Index_base<Is_const>::reset()
+Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<Is_const>&
+Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<Is_const>::reset()
 {
-	index = Glare::Slot_map<T>::null_index;
-	counter = Glare::Slot_map<T>::null_index;
+	value = Handle::null_value;
 	return *this;
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
 template<bool U>
-bool Glare::Slot_map<T>::Index_base<Is_const>::operator==
-(Glare::Slot_map<T>::Index_base<U> rhs) const
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<Is_const>::operator==
+(Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<U> rhs) const
 {
-	return index == rhs.index
-		&& counter == rhs.counter;
+	return index() == rhs.index()
+		&& counter() == rhs.counter();
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
 template<bool U>
-bool Glare::Slot_map<T>::Index_base<Is_const>::operator!=
-(Glare::Slot_map<T>::Index_base<U> rhs) const
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<Is_const>::operator!=
+(Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<U> rhs) const
 {
 	return !(*this == rhs);
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
 template<bool U>
-bool Glare::Slot_map<T>::Index_base<Is_const>::operator==
-(Glare::Slot_map<T>::Iterator_base<U> rhs) const
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<Is_const>::operator==
+(Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<U> rhs) const
 {
 	return *this == Index_base<U>{rhs};
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
 template<bool U>
-bool Glare::Slot_map<T>::Index_base<Is_const>::operator!=
-(Glare::Slot_map<T>::Iterator_base<U> rhs) const
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<Is_const>::operator!=
+(Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<U> rhs) const
 {
 	return !(*this == rhs);
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
-std::conditional_t<Is_const, const T*, T*> Glare::Slot_map<T>::Iterator_base<Is_const>::operator->() const
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::template Iterator_base<Is_const>::reference
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::get(Direct_index x) const
 {
-	return &((*ptr)[index]);
+#if defined(GLARE_CHECKED_ITERATORS)
+	return (*ptr)[x];
+#else
+	assert(x < ptr->size());
+	return ptr->elem.value(x);
+#endif
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
-std::conditional_t<Is_const, const T&, T&> Glare::Slot_map<T>::Iterator_base<Is_const>::operator*() const
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::template Iterator_base<Is_const>::pointer
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator->() const
 {
-	return (*ptr)[index];
+	return &get(index);
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
-std::conditional_t<Is_const, const T&, T&> Glare::Slot_map<T>::Iterator_base<Is_const>::operator[](int subscript) const
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::template Iterator_base<Is_const>::reference
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator*() const
 {
-	return (*ptr)[index + subscript];
+	return get(index);
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
-Glare::Slot_map<T>::Iterator_base<Is_const>&
-Glare::Slot_map<T>::Iterator_base<Is_const>::operator++()
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::template Iterator_base<Is_const>::reference
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator[](difference_type subscript) const
+{
+	return get(index + subscript);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+template<bool Is_const>
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>&
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator++()
 {
 	++index;
 	return *this;
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
-Glare::Slot_map<T>::Iterator_base<Is_const>&
-Glare::Slot_map<T>::Iterator_base<Is_const>::operator--()
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>&
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator--()
 {
 	--index;
 	return *this;
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
+template<bool Is_const>
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator++(int)
+{
+	Iterator_base old {*this};
+	++index;
+	return old;
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+template<bool Is_const>
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator--(int)
+{
+	Iterator_base old {*this};
+	--index;
+	return old;
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
-Glare::Slot_map<T>::Iterator_base<Is_const>&
-Glare::Slot_map<T>::Iterator_base<Is_const>::operator+=(difference_type rhs)
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>&
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator+=(difference_type rhs)
 {
 	index += rhs;
 	return *this;
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
-Glare::Slot_map<T>::Iterator_base<Is_const>&
-Glare::Slot_map<T>::Iterator_base<Is_const>::operator-=(difference_type rhs)
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>&
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator-=(difference_type rhs)
 {
 	index -= rhs;
 	return *this;
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
 template<bool U>
-typename Glare::Slot_map<T>::difference_type
-Glare::Slot_map<T>::Iterator_base<Is_const>::operator-
-(Glare::Slot_map<T>::Iterator_base<U> rhs) const
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::difference_type
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator-
+(Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<U> rhs) const
 {
 	if (ptr != rhs.ptr)
 		throw Out_of_range {"Attempted to subtract iterators to different containers"};
-	return index - rhs.index;
+	return static_cast<difference_type>(index) - static_cast<difference_type>(rhs.index);
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
 template<bool U>
-bool Glare::Slot_map<T>::Iterator_base<Is_const>::operator==
-(Glare::Slot_map<T>::Iterator_base<U> rhs) const
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator==
+(Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<U> rhs) const
 {
 	return ptr == rhs.ptr && index == rhs.index;
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
 template<bool U>
-bool Glare::Slot_map<T>::Iterator_base<Is_const>::operator!=
-(Glare::Slot_map<T>::Iterator_base<U> rhs) const
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator!=
+(Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<U> rhs) const
 {
 	return !(*this == rhs);
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
+template<bool Is_const>
+template<bool U>
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator<
+(Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<U> rhs) const
+{
+	return index < rhs.index;
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+template<bool Is_const>
+template<bool U>
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator>
+(Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<U> rhs) const
+{
+	return rhs < *this;
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+template<bool Is_const>
+template<bool U>
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator<=
+(Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<U> rhs) const
+{
+	return !(rhs < *this);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+template<bool Is_const>
+template<bool U>
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator>=
+(Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<U> rhs) const
+{
+	return !(*this < rhs);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
 template<bool U>
-bool Glare::Slot_map<T>::Iterator_base<Is_const>::operator==
-(Glare::Slot_map<T>::Index_base<U> rhs) const
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator==
+(Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<U> rhs) const
 {
 	return Index_base<Is_const>{*this} == rhs;
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
 template<bool U>
-bool Glare::Slot_map<T>::Iterator_base<Is_const>::operator!=
-(Glare::Slot_map<T>::Index_base<U> rhs) const
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator!=
+(Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<U> rhs) const
 {
 	return !(*this == rhs);
 }
 
-template<typename T>
-typename Glare::Slot_map<T>::size_type Glare::Slot_map<T>::size() const
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::size_type Glare::Slot_map<T, Handle, Storage, Allocator>::size() const
 {
 	return elem.size();
 }
 
-template<typename T>
-Glare::Slot_map<T>& Glare::Slot_map<T>::clean_buffers()
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Clean_stats
+Glare::Slot_map<T, Handle, Storage, Allocator>::clean_buffers()
 {
+	GLARE_PROFILE_ZONE("Slot_map::clean_buffers");
+
 	// remove first so that memory is not pointlessly allocated
-	clean_remove_buffer();
-	clean_add_buffer();
-	return *this;
+	const size_type removed {clean_remove_buffer()};
+	const size_type added {clean_add_buffer()};
+	return {added, removed};
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Slot_map<T, Handle, Storage, Allocator>::Buffer::Buffer(Command_queue& queue, const Allocator& alloc)
+	:queue {&queue},
+	creation(alloc),
+	deletion(alloc)
+{}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Stable_index
+Glare::Slot_map<T, Handle, Storage, Allocator>::Buffer::buffered_add(T&& t)
+{
+	return buffered_emplace(std::move(t));
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Stable_index
+Glare::Slot_map<T, Handle, Storage, Allocator>::Buffer::buffered_add(const T& t)
+{
+	return buffered_emplace(t);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+template<typename... Args>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Stable_index
+Glare::Slot_map<T, Handle, Storage, Allocator>::Buffer::buffered_emplace(Args&&... args)
+{
+	// if this throws the slot is reclaimed by commit
+	const Stable_index p {queue->reserve()};
+	creation.emplace_back(p.index(), std::forward<Args>(args)...);
+	return p;
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+void Glare::Slot_map<T, Handle, Storage, Allocator>::Buffer::buffered_remove(Stable_index p)
+{
+	deletion.push_back(p);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+bool Glare::Slot_map<T, Handle, Storage, Allocator>::Buffer::empty() const
+{
+	return creation.empty() && deletion.empty();
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Slot_map<T, Handle, Storage, Allocator>::Command_queue::Command_queue(Slot_map& map, size_type buffer_count)
+	:map {&map}
+{
+	reset(buffer_count);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+void Glare::Slot_map<T, Handle, Storage, Allocator>::Command_queue::reset(size_type buffer_count)
+{
+	for (auto& b : buffers) {
+		b.creation.clear();
+		b.deletion.clear();
+	}
+	while (buffers.size() < buffer_count)
+		buffers.push_back(Buffer {*this, map->get_allocator()});
+	active = buffer_count;
+
+	free_count = map->free_index.size();
+	slot_count = map->elem_indirect.size();
+	free_taken.store(0, std::memory_order_relaxed);
+	fresh_taken.store(0, std::memory_order_relaxed);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::size_type
+Glare::Slot_map<T, Handle, Storage, Allocator>::Command_queue::buffer_count() const
+{
+	return active;
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Buffer&
+Glare::Slot_map<T, Handle, Storage, Allocator>::Command_queue::buffer(size_type i)
+{
+	if (i >= active)
+		throw Out_of_range {"Command_queue buffer past buffer_count"};
+	return buffers[i];
 }
 
-template<typename T>
-Glare::Slot_map<T>::Slot_map(std::initializer_list<T> init)
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Stable_index
+Glare::Slot_map<T, Handle, Storage, Allocator>::Command_queue::reserve()
 {
-	for (auto x : init) {
+	// same order as get_free, newest free slot first
+	const size_type k {free_taken.fetch_add(1, std::memory_order_relaxed)};
+	if (k < free_count) {
+		const Index x {map->free_index[free_count - 1 - k]};
+		return {x, map->elem_indirect[x].counter};
+	}
+
+	const size_type x {slot_count + fresh_taken.fetch_add(1, std::memory_order_relaxed)};
+	if (x >= max_slots)
+		throw Full {"Slot_map has run out of slots"};
+
+	return {static_cast<Index>(x), 0};
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+void Glare::Slot_map<T, Handle, Storage, Allocator>::Command_queue::commit()
+{
+	GLARE_PROFILE_ZONE("Slot_map::Command_queue::commit");
+
+	auto& m = *map;
+
+	// slots handed out past the end become real, reused ones leave free_index
+	const size_type fresh {std::min<size_type>(fresh_taken.load(std::memory_order_relaxed), max_slots - slot_count)};
+	const size_type reused {std::min<size_type>(free_taken.load(std::memory_order_relaxed), free_count)};
+	m.elem_indirect.resize(slot_count + fresh, Checked_index {null_index, 0});
+
+	for (auto& b : buffers) {
+		for (auto& x : b.creation) {
+			m.elem_indirect[x.index].index = static_cast<Index>(m.creation_buffer.size()) | pending_flag;
+			m.creation_buffer.push_back(std::move(x));
+		}
+		b.creation.clear();
+	}
+
+	// slots reserved by additions that threw are still unused, so hand them back
+	size_type kept {free_count - reused};
+	for (size_type i = kept; i < free_count; ++i) {
+		const Index x {m.free_index[i]};
+		if (m.elem_indirect[x].index == null_index)
+			m.free_index[kept++] = x;
+	}
+	m.free_index.resize(kept);
+	for (size_type x = slot_count; x < slot_count + fresh; ++x)
+		if (m.elem_indirect[x].index == null_index)
+			m.free_index.push_back(static_cast<Index>(x));
+
+	for (auto& b : buffers) {
+		for (auto p : b.deletion)
+			m.buffered_remove(p);
+		b.deletion.clear();
+	}
+
+	// the queue can be filled again without a reset until the Slot_map changes
+	free_count = m.free_index.size();
+	slot_count = m.elem_indirect.size();
+	free_taken.store(0, std::memory_order_relaxed);
+	fresh_taken.store(0, std::memory_order_relaxed);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+void Glare::Slot_map<T, Handle, Storage, Allocator>::reserve(size_type n)
+{
+	elem.reserve(n);
+	elem_indirect.reserve(n);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Slot_map<T, Handle, Storage, Allocator>::Slot_map(const Allocator& alloc)
+	:Slot_map {Retirement_policy::retire, alloc}
+{}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Slot_map<T, Handle, Storage, Allocator>::Slot_map(Retirement_policy retirement, const Allocator& alloc)
+	:elem(alloc),
+	elem_indirect(alloc),
+	free_index(alloc),
+	deletion_buffer(alloc),
+	creation_buffer(alloc),
+	removal_order(alloc),
+	retirement {retirement}
+{}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Slot_map<T, Handle, Storage, Allocator>::Slot_map(std::initializer_list<T> init, const Allocator& alloc)
+	:Slot_map {Retirement_policy::retire, alloc}
+{
+	elem.reserve(init.size());
+	for (const auto& x : init) {
 		add(x);
 	}
 }
 
-template<typename T>
-Glare::Slot_map<T>& Glare::Slot_map<T>::operator=(std::initializer_list<T> init)
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Slot_map<T, Handle, Storage, Allocator>& Glare::Slot_map<T, Handle, Storage, Allocator>::operator=(std::initializer_list<T> init)
 {
 	clear();
-	for (auto x : init) {
+	elem.reserve(init.size());
+	for (const auto& x : init) {
 		add(x);
 	}
+	return *this;
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Stable_index Glare::Slot_map<T, Handle, Storage, Allocator>::add(T&& t)
+{
+	return emplace(std::move(t));
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Stable_index Glare::Slot_map<T, Handle, Storage, Allocator>::add(const T& t)
+{
+	return emplace(t);
 }
 
-template<typename T>
-typename Glare::Slot_map<T>::Stable_index Glare::Slot_map<T>::add(T t)
+template<typename T, typename Handle, typename Storage, typename Allocator>
+template<typename... Args>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Stable_index Glare::Slot_map<T, Handle, Storage, Allocator>::emplace(Args&&... args)
 {
 	const Index x {get_free()};
-	elem.push_back({t, x});
-	elem_indirect[x].index = elem.size() - 1;
-	elem_indirect[x].counter = counter;
-	return {x, counter++};
+	try {
+		elem.emplace_back(x, std::forward<Args>(args)...);
+	}
+	catch (...) {
+		free_index.push_back(x); // slot was never handed out
+		throw;
+	}
+	elem_indirect[x].index = static_cast<Index>(elem.size() - 1);
+	return {x, elem_indirect[x].counter};
 }
 
-template<typename T>
-typename Glare::Slot_map<T>::Index Glare::Slot_map<T>::get_free()
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Index Glare::Slot_map<T, Handle, Storage, Allocator>::get_free()
 {
 	if (free_index.empty()) {
-		elem_indirect.push_back({});
+		// the all ones index is reserved for invalid handles
+		if (elem_indirect.size() >= max_slots)
+			throw Full {"Slot_map has run out of slots"};
+
+		elem_indirect.push_back({Glare::Slot_map<T, Handle, Storage, Allocator>::null_index, 0});
 		return elem_indirect.size() - 1; // index of last element
 	}
 	else {
@@ -475,213 +1349,317 @@ typename Glare::Slot_map<T>::Index Glare::Slot_map<T>::get_free()
 	}
 }
 
-template<typename T>
-Glare::Slot_map<T>& Glare::Slot_map<T>::remove(Direct_index x)
+template<typename T, typename Handle, typename Storage, typename Allocator>
+void Glare::Slot_map<T, Handle, Storage, Allocator>::release(Index x)
+{
+	Checked_index& slot {elem_indirect[x]};
+	slot.index = Glare::Slot_map<T, Handle, Storage, Allocator>::null_index;
+
+	if (slot.counter == max_counter) {
+		if (retirement == Retirement_policy::retire) {
+			// slot is never pushed to free_index, so it stays invalid forever
+			++retired;
+			return;
+		}
+		slot.counter = 0;
+	}
+	else {
+		++slot.counter;
+	}
+
+	free_index.push_back(x);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Slot_map<T, Handle, Storage, Allocator>& Glare::Slot_map<T, Handle, Storage, Allocator>::remove(Direct_index x)
 {
 	assert(!elem.empty());
-	const Index last_index = elem.back().index;
-	const Index remove_index = elem[x].index;
+	const Index last_index = elem.index(elem.size() - 1);
+	const Index remove_index = elem.index(x);
 
-	// reset counter
-	elem_indirect[remove_index].counter = Glare::Slot_map<T>::null_index;
-	// swap indices
-	std::swap(elem_indirect[remove_index].index, elem_indirect[last_index].index);
+	// last element takes the place of the removed one
+	elem_indirect[last_index].index = static_cast<Index>(x);
+	release(remove_index);
 
-	// swap element to be removed with last element and pop
-	std::swap(elem[x], elem.back());
+	// move last element into the gap and pop
+	if (x != elem.size() - 1)
+		elem.move_element(elem.size() - 1, x);
 	elem.pop_back();
 
 	return *this;
 }
 
-template<typename T>
-typename Glare::Slot_map<T>::Stable_index Glare::Slot_map<T>::buffered_add(T t)
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Stable_index Glare::Slot_map<T, Handle, Storage, Allocator>::buffered_add(T&& t)
+{
+	return buffered_emplace(std::move(t));
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Stable_index Glare::Slot_map<T, Handle, Storage, Allocator>::buffered_add(const T& t)
+{
+	return buffered_emplace(t);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+template<typename... Args>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::Stable_index Glare::Slot_map<T, Handle, Storage, Allocator>::buffered_emplace(Args&&... args)
 {
 	const Index x {get_free()};
-	creation_buffer.push_back({t, x});
-	elem_indirect[x] = {Glare::Slot_map<T>::null_index, counter};
-	return {x, counter++};
+	try {
+		creation_buffer.emplace_back(x, std::forward<Args>(args)...);
+	}
+	catch (...) {
+		free_index.push_back(x);
+		throw;
+	}
+	elem_indirect[x].index = static_cast<Index>(creation_buffer.size() - 1) | pending_flag;
+	return {x, elem_indirect[x].counter};
 }
 
-template<typename T>
-void Glare::Slot_map<T>::clean_add_buffer()
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::size_type
+Glare::Slot_map<T, Handle, Storage, Allocator>::clean_add_buffer()
 {
-	while (!creation_buffer.empty()) {
-		const Index x {creation_buffer.back().index};
-		elem.push_back(creation_buffer.back());
-		creation_buffer.pop_back();
-		elem_indirect[x].index = elem.size() - 1;
+	const size_type added {creation_buffer.size()};
+	elem.grow(elem.size() + added);
+
+	// front to back, so elements end up in the order they were created,
+	// except that cancelling one moved the newest pending element into its place
+	for (auto& x : creation_buffer) {
+		elem_indirect[x.index].index = static_cast<Index>(elem.size());
+		elem.emplace_back(x.index, std::move(x.val));
 	}
+	creation_buffer.clear(); // keeps its capacity for the next frame
+
+	return added;
 }
 
-template<typename T>
-Glare::Slot_map<T>& Glare::Slot_map<T>::buffered_remove(Direct_index x)
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Slot_map<T, Handle, Storage, Allocator>& Glare::Slot_map<T, Handle, Storage, Allocator>::buffered_remove(Direct_index x)
 {
-	const Index redirect {elem[x].index};
+	const Index redirect {elem.index(x)};
 	deletion_buffer.emplace_back(redirect, elem_indirect[redirect].counter);
 	return *this;
 }
 
-template<typename T>
-void Glare::Slot_map<T>::clean_remove_buffer()
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::size_type
+Glare::Slot_map<T, Handle, Storage, Allocator>::clean_remove_buffer()
 {
-	while (!deletion_buffer.empty()) {
-		remove(deletion_buffer.back());
-		deletion_buffer.pop_back();
+	removal_order.clear();
+	for (auto p : deletion_buffer) {
+		if (is_valid(p))
+			removal_order.push_back(elem_indirect[p.index()].index);
 	}
+	deletion_buffer.clear();
+
+	// removing from the back first means the last element, which fills
+	// each gap, is never one that is about to be removed itself
+	std::sort(removal_order.begin(), removal_order.end(), std::greater<Direct_index> {});
+	const auto last = std::unique(removal_order.begin(), removal_order.end());
+
+	for (auto iter = removal_order.begin(); iter != last; ++iter)
+		remove(*iter);
+
+	return last - removal_order.begin();
 }
 
-template<typename T>
-void Glare::Slot_map<T>::clear()
+template<typename T, typename Handle, typename Storage, typename Allocator>
+void Glare::Slot_map<T, Handle, Storage, Allocator>::clear()
 {
+	// slots are kept so that handles from before the clear stay invalid
+	for (Direct_index i = 0; i < elem.size(); ++i) release(elem.index(i));
+	for (const auto& x : creation_buffer) release(x.index);
+
 	elem.clear();
-	elem_indirect.clear();
-	free_index.clear();
 	deletion_buffer.clear();
 	creation_buffer.clear();
 }
 
-template<typename T>
-Glare::Slot_map<T>& Glare::Slot_map<T>::remove
-(typename Glare::Slot_map<T>::Stable_index p)
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::size_type Glare::Slot_map<T, Handle, Storage, Allocator>::slot_count() const
+{
+	return elem_indirect.size();
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::size_type Glare::Slot_map<T, Handle, Storage, Allocator>::retired_count() const
+{
+	return retired;
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Retirement_policy Glare::Slot_map<T, Handle, Storage, Allocator>::retirement_policy() const
+{
+	return retirement;
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Allocator Glare::Slot_map<T, Handle, Storage, Allocator>::get_allocator() const
+{
+	return Allocator {elem_indirect.get_allocator()};
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Slot_map<T, Handle, Storage, Allocator>& Glare::Slot_map<T, Handle, Storage, Allocator>::remove
+(typename Glare::Slot_map<T, Handle, Storage, Allocator>::Stable_index p)
 {
 	if (is_valid(p)) {
-		const Direct_index x {elem_indirect[p.index].index};
+		const Direct_index x {elem_indirect[p.index()].index};
 		remove(x);
 		p.reset();
 	}
 	return *this;
 }
 
-template<typename T>
-Glare::Slot_map<T>& Glare::Slot_map<T>::buffered_remove
-(typename Glare::Slot_map<T>::Stable_index p)
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Slot_map<T, Handle, Storage, Allocator>& Glare::Slot_map<T, Handle, Storage, Allocator>::buffered_remove
+(typename Glare::Slot_map<T, Handle, Storage, Allocator>::Stable_index p)
 {
 	if (is_valid(p)) {
-		const Direct_index x {elem_indirect[p.index].index};
+		const Direct_index x {elem_indirect[p.index()].index};
 		buffered_remove(x);
 		p.reset();
-	} else { // ugly due to lack of C++17 support
-		const auto x = elem_in_creation_buffer(p.index);
-		if (x != Glare::Slot_map<T>::null_index) {
-			// element is being destroyed before it has been created
-
-			// swap element to be removed with last element and pop
-			std::swap(creation_buffer[x], creation_buffer.back());
-			creation_buffer.pop_back();
+	} else if (is_pending(p)) {
+		// element is being destroyed before it has been created
+		const Direct_index x {static_cast<Index>(elem_indirect[p.index()].index & ~pending_flag)};
+
+		// move last element into the gap and pop, so it is added out of order
+		if (x != creation_buffer.size() - 1) {
+			creation_buffer[x] = std::move(creation_buffer.back());
+			elem_indirect[creation_buffer[x].index].index = static_cast<Index>(x) | pending_flag;
 		}
+		creation_buffer.pop_back();
+		release(p.index());
 	}
 	return *this;
 }
 
-template<typename T>
-typename Glare::Slot_map<T>::Direct_index
-Glare::Slot_map<T>::elem_in_creation_buffer(Index x)
-{
-	const auto iter = std::find_if(creation_buffer.begin(), creation_buffer.end(),
-								   [x](Indexed_element p) {return p.index == x; });
-
-	if (iter != creation_buffer.end()) {
-		return iter - creation_buffer.begin();
-	}
-	else {
-		return Glare::Slot_map<T>::null_index;
-	}
-}
-
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
-void Glare::Slot_map<T>::Iterator_base<Is_const>::buffered_remove()
+void Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::buffered_remove()
 {
 	ptr->buffered_remove(index);
 }
 
-template<typename T>
-typename Glare::Slot_map<T>::iterator Glare::Slot_map<T>::begin()
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::iterator Glare::Slot_map<T, Handle, Storage, Allocator>::begin()
 {
 	return {this, 0};
 }
 
-template<typename T>
-typename Glare::Slot_map<T>::const_iterator Glare::Slot_map<T>::begin() const
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::const_iterator Glare::Slot_map<T, Handle, Storage, Allocator>::begin() const
 {
 	return {this, 0};
 }
 
-template<typename T>
-typename Glare::Slot_map<T>::const_iterator Glare::Slot_map<T>::cbegin() const
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::const_iterator Glare::Slot_map<T, Handle, Storage, Allocator>::cbegin() const
 {
 	return {this, 0};
 }
 
-template<typename T>
-typename Glare::Slot_map<T>::iterator Glare::Slot_map<T>::end()
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::iterator Glare::Slot_map<T, Handle, Storage, Allocator>::end()
 {
 	return {this, size()};
 }
 
-template<typename T>
-typename Glare::Slot_map<T>::const_iterator Glare::Slot_map<T>::end() const
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::const_iterator Glare::Slot_map<T, Handle, Storage, Allocator>::end() const
 {
 	return {this, size()};
 }
 
-template<typename T>
-typename Glare::Slot_map<T>::const_iterator Glare::Slot_map<T>::cend() const
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::const_iterator Glare::Slot_map<T, Handle, Storage, Allocator>::cend() const
 {
 	return {this, size()};
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
 template<bool U>
-Glare::Slot_map<T>::Iterator_base<Is_const>::operator
-Glare::Slot_map<T>::Index_base<U>() const
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator
+Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<U>() const
 {
 	static_assert(!Is_const || U, "Cannot convert from const to nonconst");
-	
-	const Checked_index redirect {ptr->elem_indirect[index]};
-	return {redirect.index, redirect.counter};
+
+	const Index x {ptr->elem.index(index)};
+	return {x, ptr->elem_indirect[x].counter};
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
 template<bool U>
-Glare::Slot_map<T>::Index_base<Is_const>::operator
-Glare::Slot_map<T>::Index_base<U>() const
+Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<Is_const>::operator
+Glare::Slot_map<T, Handle, Storage, Allocator>::Index_base<U>() const
 {
 	static_assert(!Is_const || U, "Cannot convert from const to nonconst");
 
-	return {index, counter};
+	return {index(), counter()};
 }
 
-template<typename T>
+template<typename T, typename Handle, typename Storage, typename Allocator>
 template<bool Is_const>
 template<bool U>
-Glare::Slot_map<T>::Iterator_base<Is_const>::operator
-Glare::Slot_map<T>::Iterator_base<U>() const
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<Is_const>::operator
+Glare::Slot_map<T, Handle, Storage, Allocator>::Iterator_base<U>() const
 {
 	static_assert(!Is_const || U, "Cannot convert from const to nonconst");
 
 	return {ptr, index};
 }
 
-template<typename T>
-const T& Glare::Slot_map<T>::operator[](Direct_index index) const
+template<typename T, typename Handle, typename Storage, typename Allocator>
+const T& Glare::Slot_map<T, Handle, Storage, Allocator>::operator[](Direct_index index) const
 {
 	if (index < 0 || index >= elem.size())
 		throw Out_of_range("Slot_map indexed with out of range index");
 	else
-		return elem[index].val;
+		return elem.value(index);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Utility::Span<T> Glare::Slot_map<T, Handle, Storage, Allocator>::values()
+{
+	return {elem.data(), elem.size()};
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Utility::Span<const T> Glare::Slot_map<T, Handle, Storage, Allocator>::values() const
+{
+	return {elem.data(), elem.size()};
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+typename Glare::Slot_map<T, Handle, Storage, Allocator>::size_type
+Glare::Slot_map<T, Handle, Storage, Allocator>::page_count() const
+{
+	return elem.page_count();
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Utility::Span<T> Glare::Slot_map<T, Handle, Storage, Allocator>::page(size_type i)
+{
+	return {elem.page_data(i), elem.page_size(i)};
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+Glare::Utility::Span<const T> Glare::Slot_map<T, Handle, Storage, Allocator>::page(size_type i) const
+{
+	return {elem.page_data(i), elem.page_size(i)};
 }
 
-template<typename T>
-T& Glare::Slot_map<T>::operator[](Direct_index index)
+template<typename T, typename Handle, typename Storage, typename Allocator>
+T& Glare::Slot_map<T, Handle, Storage, Allocator>::operator[](Direct_index index)
 {
 	if (index < 0 || index >= elem.size())
 		throw Out_of_range("Slot_map indexed with out of range index");
 	else
-		return elem[index].val;
+		return elem.value(index);
 }
 
 #endif // !GLARE_SLOT_MAP_HPP
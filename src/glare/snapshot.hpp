@@ -0,0 +1,880 @@
+#ifndef GLARE_SNAPSHOT_HPP
+#define GLARE_SNAPSHOT_HPP
+
+#include "ecs.hpp"
+#include "error.hpp"
+#include "slot_map.hpp"
+#include "utility.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GLARE_SNAPSHOT_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Glare {
+	// binary snapshots of Slot_maps and Entity_managers
+	// a snapshot is a header, a number of blobs each aligned to a cache line,
+	// and a table describing the blobs, in native byte order
+	// a blob is one internal array copied out as is, so loading is a memcpy
+	// per array, or no copy at all for a Slot_map_view over the mapped file
+	// only trivially copyable element and component types can be saved
+	namespace Snapshot {
+		using Tag = std::uint32_t;
+		using Io_error = Error::Snapshot_io_error;
+		using Not_valid = Error::Snapshot_not_valid;
+		using Pending_changes = Error::Snapshot_pending_changes;
+
+		// bumped whenever the layout of a snapshot changes
+		constexpr std::uint32_t format_version {1};
+		constexpr std::size_t blob_alignment {64};
+
+		// four characters packed into a Tag, first in the lowest byte
+		constexpr Tag make_tag(const char (&name)[5])
+		{
+			return static_cast<Tag>(static_cast<unsigned char>(name[0]))
+				| static_cast<Tag>(static_cast<unsigned char>(name[1])) << 8
+				| static_cast<Tag>(static_cast<unsigned char>(name[2])) << 16
+				| static_cast<Tag>(static_cast<unsigned char>(name[3])) << 24;
+		}
+
+		// an entry of the blob table
+		struct Blob {
+			Tag tag; // what the blob holds
+			std::uint32_t key; // which object it belongs to
+			std::uint32_t part; // which part of the object
+			std::uint32_t element_size;
+			std::uint64_t count;
+			std::uint64_t offset; // from the start of the file
+		};
+
+		struct Header {
+			char magic[8];
+			std::uint32_t version;
+			std::uint32_t byte_order; // byte_order_mark as written
+			std::uint64_t blob_count;
+			std::uint64_t table_offset;
+			std::uint64_t file_size;
+			std::uint64_t checksum; // of everything after the header
+			unsigned char reserved[16];
+		};
+
+		static_assert(sizeof(Header) == blob_alignment, "header must keep the blobs aligned");
+
+		namespace Impl {
+			constexpr char magic[8] {'G', 'L', 'A', 'R', 'E', 'S', 'N', 'P'};
+			constexpr std::uint32_t byte_order_mark {0x01020304};
+
+			// 64 bit hash of a stream of bytes, fed in pieces of any size
+			// uses the rounds of xxHash64 but isn't compatible with it
+			class Checksum {
+			public:
+				void update(const void*, std::size_t);
+				std::uint64_t value() const;
+			private:
+				static constexpr std::uint64_t p1 {0x9E3779B185EBCA87u};
+				static constexpr std::uint64_t p2 {0xC2B2AE3D27D4EB4Fu};
+				static constexpr std::uint64_t p3 {0x165667B19E3779F9u};
+				static constexpr std::uint64_t p4 {0x85EBCA77C2B2AE63u};
+				static constexpr std::uint64_t p5 {0x27D4EB2F165667C5u};
+
+				static std::uint64_t rotl(std::uint64_t, int);
+				static std::uint64_t round(std::uint64_t acc, std::uint64_t input);
+				static std::uint64_t read(const unsigned char*);
+				void block(const unsigned char*);
+
+				std::uint64_t lane[4] {p1 + p2, p2, 0, 0 - p1};
+				unsigned char tail[32];
+				std::size_t tail_size {0};
+				std::uint64_t total {0};
+			};
+
+			// the whole of a file in memory, mapped when the platform allows
+			class File_data {
+			public:
+				explicit File_data(const std::string& path);
+				~File_data();
+
+				File_data(const File_data&) = delete;
+				File_data& operator=(const File_data&) = delete;
+
+				const unsigned char* data() const;
+				std::size_t size() const;
+			private:
+				const unsigned char* bytes {nullptr};
+				std::size_t length {0};
+#ifndef GLARE_SNAPSHOT_MMAP
+				struct Free {
+					void operator()(unsigned char* p) const { ::operator delete[](p, std::align_val_t {blob_alignment}); }
+				};
+				std::unique_ptr<unsigned char[], Free> buffer;
+#endif
+			};
+		}
+
+		// writes a snapshot to a file as blobs are added
+		// the file is only valid once finish has returned
+		class Writer {
+		public:
+			// throws Io_error if the file can't be created
+			explicit Writer(const std::string& path);
+
+			Writer(const Writer&) = delete;
+			Writer& operator=(const Writer&) = delete;
+
+			// copies count elements of element_size bytes into a new blob
+			void add(Tag, std::uint32_t key, std::uint32_t part,
+					 const void* data, std::size_t element_size, std::size_t count);
+			template<typename T>
+			void add(Tag, std::uint32_t key, std::uint32_t part, const T* data, std::size_t count);
+
+			// writes the blob table and the header, throws Io_error on failure
+			void finish();
+		private:
+			void write(const void*, std::size_t);
+			void pad();
+
+			std::ofstream file;
+			std::vector<Blob> table;
+			std::uint64_t offset {sizeof(Header)};
+			Impl::Checksum checksum;
+		};
+
+		// maps a snapshot into memory and checks it
+		// arrays returned are used in place and live as long as the Reader
+		class Reader {
+		public:
+			// throws Io_error if the file can't be read, or Not_valid if it isn't
+			// a snapshot of this version, or if verify is set and the checksum fails
+			explicit Reader(const std::string& path, bool verify = true);
+
+			std::uint32_t version() const;
+			std::size_t blob_count() const;
+			const Blob& blob(std::size_t) const;
+			// nullptr if there is no such blob
+			const Blob* find(Tag, std::uint32_t key, std::uint32_t part = 0) const;
+
+			// the elements of a blob, throws Not_valid if the blob is missing
+			// or holds elements of a different size
+			template<typename T>
+			Utility::Span<const T> array(Tag, std::uint32_t key, std::uint32_t part = 0) const;
+		private:
+			Impl::File_data file;
+			Header header;
+			const Blob* table;
+		};
+
+		// adds the contents of sm to a snapshot, key tells apart the objects
+		// in one snapshot and must be unique among them
+		// throws Pending_changes unless clean_buffers has been called since
+		// the last buffered change
+		template<typename T, typename Handle, typename Storage, typename Allocator>
+		void save(Writer&, const Slot_map<T, Handle, Storage, Allocator>& sm, std::uint32_t key = 0);
+		// replaces the contents of sm, handles into the saved Slot_map stay valid
+		// throws Not_valid if the snapshot holds no matching Slot_map under key
+		template<typename T, typename Handle, typename Storage, typename Allocator>
+		void load(const Reader&, Slot_map<T, Handle, Storage, Allocator>& sm, std::uint32_t key = 0);
+
+		// the entities, their components and change ticks
+		template<typename... T>
+		void save(Writer&, const Ecs::Entity_manager<T...>& em, std::uint32_t key = 0);
+		template<typename... T>
+		void load(const Reader&, Ecs::Entity_manager<T...>& em, std::uint32_t key = 0);
+
+		// read only access to a Slot_map saved with any storage, straight
+		// from the mapped snapshot without copying it
+		template<typename Map>
+		class Slot_map_view {
+		public:
+			using value_type = typename Map::value_type;
+			using size_type = std::size_t;
+			using Stable_index = typename Map::Stable_index;
+			using Not_valid = typename Map::Not_valid;
+
+			// the Reader must outlive the view
+			explicit Slot_map_view(const Reader&, std::uint32_t key = 0);
+
+			bool is_valid(Stable_index) const;
+			// throws Not_valid if the handle isn't valid
+			const value_type& operator[](Stable_index) const;
+
+			size_type size() const;
+			bool empty() const;
+
+			// densely packed, in the order the Slot_map iterated them
+			Utility::Span<const value_type> values() const;
+			// handle to values()[i]
+			Stable_index handle(size_type i) const;
+		private:
+			Utility::Span<const value_type> val;
+			const void* indices;
+			const void* slots;
+			size_type slot_count;
+		};
+
+		namespace Impl {
+			// layout of a saved Slot_map, checked on load
+			struct Slot_map_info {
+				std::uint32_t value_size;
+				std::uint32_t value_alignment;
+				std::uint32_t index_size;
+				std::uint32_t counter_size;
+				std::uint64_t null_index;
+				std::uint64_t max_counter;
+				std::uint32_t retirement;
+				std::uint32_t storage_reserved;
+				std::uint64_t retired;
+			};
+
+			struct Entity_manager_info {
+				std::uint32_t component_count;
+				std::uint32_t archetype_count;
+				std::uint32_t tick;
+				std::uint32_t reserved;
+			};
+
+			constexpr Tag slot_map_info_tag {make_tag("SMAP")};
+			constexpr Tag slot_map_values_tag {make_tag("SMVA")};
+			constexpr Tag slot_map_indices_tag {make_tag("SMIX")};
+			constexpr Tag slot_map_slots_tag {make_tag("SMSL")};
+			constexpr Tag slot_map_free_tag {make_tag("SMFR")};
+
+			constexpr Tag manager_info_tag {make_tag("EMGR")};
+			constexpr Tag manager_sizes_tag {make_tag("EMSZ")};
+			constexpr Tag manager_masks_tag {make_tag("EMAM")};
+			constexpr Tag manager_entities_tag {make_tag("EMEN")};
+			constexpr Tag manager_column_tag {make_tag("EMCO")};
+			constexpr Tag manager_added_tag {make_tag("EMTA")};
+			constexpr Tag manager_changed_tag {make_tag("EMTC")};
+
+			// blobs of one archetype and component share a part
+			constexpr std::uint32_t column_part(std::size_t archetype, std::size_t component);
+
+			// befriended by Slot_map and Entity_manager
+			struct Access {
+				template<typename Map>
+				using Index = typename Map::Index;
+				template<typename Map>
+				using Checked_index = typename Map::Checked_index;
+
+				template<typename Map>
+				static Slot_map_info info(const Map*);
+
+				template<typename Map>
+				static void save(Writer&, const Map&, std::uint32_t key);
+				template<typename Map>
+				static void load(const Reader&, Map&, std::uint32_t key);
+				// checks the layout and returns the number of slots
+				template<typename Map>
+				static std::size_t check(const Reader&, std::uint32_t key);
+
+				template<typename Map>
+				static bool is_valid(const void* slots, std::size_t slot_count, typename Map::Stable_index);
+				template<typename Map>
+				static std::size_t position(const void* slots, typename Map::Stable_index);
+				template<typename Map>
+				static typename Map::Stable_index handle(const void* indices, const void* slots, std::size_t);
+
+				template<typename... T>
+				static void save(Writer&, const Ecs::Entity_manager<T...>&, std::uint32_t key);
+				template<typename... T>
+				static void load(const Reader&, Ecs::Entity_manager<T...>&, std::uint32_t key);
+				template<typename C, typename... T>
+				static constexpr std::size_t component_index(const Ecs::Entity_manager<T...>*);
+				template<typename C, typename Manager, typename Archetype>
+				static void save_column(Writer&, const Archetype&, std::uint32_t key, std::size_t a);
+				template<typename C, typename Manager, typename Archetype>
+				static void load_column(const Reader&, Archetype&, std::uint32_t key, std::size_t a);
+			};
+		}
+	}
+}
+
+/***** IMPLEMENTATION *****/
+
+constexpr std::uint32_t Glare::Snapshot::Impl::column_part(std::size_t archetype, std::size_t component)
+{
+	return static_cast<std::uint32_t>(archetype << 6 | component);
+}
+
+inline void Glare::Snapshot::Impl::Checksum::update(const void* data, std::size_t n)
+{
+	auto p = static_cast<const unsigned char*>(data);
+	total += n;
+
+	if (tail_size) {
+		const std::size_t take {std::min(n, sizeof tail - tail_size)};
+		std::memcpy(tail + tail_size, p, take);
+		tail_size += take;
+		p += take;
+		n -= take;
+		if (tail_size < sizeof tail)
+			return;
+		block(tail);
+		tail_size = 0;
+	}
+
+	for (; n >= sizeof tail; p += sizeof tail, n -= sizeof tail)
+		block(p);
+
+	std::memcpy(tail, p, n);
+	tail_size = n;
+}
+
+inline std::uint64_t Glare::Snapshot::Impl::Checksum::value() const
+{
+	std::uint64_t h {total >= sizeof tail
+		? rotl(lane[0], 1) + rotl(lane[1], 7) + rotl(lane[2], 12) + rotl(lane[3], 18)
+		: lane[2] + p5};
+	if (total >= sizeof tail)
+		for (const auto l : lane)
+			h = (h ^ round(0, l)) * p1 + p4;
+	h += total;
+
+	std::size_t i {0};
+	for (; i + 8 <= tail_size; i += 8)
+		h = rotl(h ^ round(0, read(tail + i)), 27) * p1 + p4;
+	for (; i < tail_size; ++i)
+		h = rotl(h ^ tail[i] * p5, 11) * p1;
+
+	h ^= h >> 33;
+	h *= p2;
+	h ^= h >> 29;
+	h *= p3;
+	h ^= h >> 32;
+	return h;
+}
+
+inline std::uint64_t Glare::Snapshot::Impl::Checksum::rotl(std::uint64_t x, int r)
+{
+	return x << r | x >> (64 - r);
+}
+
+inline std::uint64_t Glare::Snapshot::Impl::Checksum::round(std::uint64_t acc, std::uint64_t input)
+{
+	return rotl(acc + input * p2, 31) * p1;
+}
+
+inline std::uint64_t Glare::Snapshot::Impl::Checksum::read(const unsigned char* p)
+{
+	std::uint64_t x;
+	std::memcpy(&x, p, sizeof x);
+	return x;
+}
+
+inline void Glare::Snapshot::Impl::Checksum::block(const unsigned char* p)
+{
+	for (int i = 0; i != 4; ++i)
+		lane[i] = round(lane[i], read(p + i * 8));
+}
+
+inline Glare::Snapshot::Impl::File_data::File_data(const std::string& path)
+{
+#ifdef GLARE_SNAPSHOT_MMAP
+	const int fd {::open(path.c_str(), O_RDONLY)};
+	if (fd < 0)
+		throw Io_error {"Could not open snapshot " + path};
+
+	struct stat st;
+	if (::fstat(fd, &st) != 0) {
+		::close(fd);
+		throw Io_error {"Could not read snapshot " + path};
+	}
+	length = static_cast<std::size_t>(st.st_size);
+
+	if (length) {
+		void* p {::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0)};
+		if (p == MAP_FAILED) {
+			::close(fd);
+			throw Io_error {"Could not map snapshot " + path};
+		}
+		bytes = static_cast<const unsigned char*>(p);
+	}
+	// the mapping stays valid after the descriptor is closed
+	::close(fd);
+#else
+	std::ifstream in {path, std::ios::binary | std::ios::ate};
+	if (!in)
+		throw Io_error {"Could not open snapshot " + path};
+
+	length = static_cast<std::size_t>(in.tellg());
+	// aligned like a mapping would be, so that blobs can be used in place
+	buffer.reset(static_cast<unsigned char*>(::operator new[](length, std::align_val_t {blob_alignment})));
+	in.seekg(0);
+	if (!in.read(reinterpret_cast<char*>(buffer.get()), static_cast<std::streamsize>(length)))
+		throw Io_error {"Could not read snapshot " + path};
+	bytes = buffer.get();
+#endif
+}
+
+inline Glare::Snapshot::Impl::File_data::~File_data()
+{
+#ifdef GLARE_SNAPSHOT_MMAP
+	if (bytes)
+		::munmap(const_cast<unsigned char*>(bytes), length);
+#endif
+}
+
+inline const unsigned char* Glare::Snapshot::Impl::File_data::data() const
+{
+	return bytes;
+}
+
+inline std::size_t Glare::Snapshot::Impl::File_data::size() const
+{
+	return length;
+}
+
+inline Glare::Snapshot::Writer::Writer(const std::string& path)
+	:file {path, std::ios::binary | std::ios::trunc}
+{
+	if (!file)
+		throw Io_error {"Could not create snapshot " + path};
+
+	// filled in by finish, until then the file is not a valid snapshot
+	const Header blank {};
+	file.write(reinterpret_cast<const char*>(&blank), sizeof blank);
+}
+
+inline void Glare::Snapshot::Writer::add(Tag tag, std::uint32_t key, std::uint32_t part,
+										 const void* data, std::size_t element_size, std::size_t count)
+{
+	pad();
+	table.push_back({tag, key, part, static_cast<std::uint32_t>(element_size), count, offset});
+	write(data, element_size * count);
+}
+
+template<typename T>
+void Glare::Snapshot::Writer::add(Tag tag, std::uint32_t key, std::uint32_t part, const T* data, std::size_t count)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be saved");
+	static_assert(alignof(T) <= blob_alignment, "blobs are not aligned enough for this type");
+	add(tag, key, part, static_cast<const void*>(data), sizeof(T), count);
+}
+
+inline void Glare::Snapshot::Writer::finish()
+{
+	pad();
+	const std::uint64_t table_offset {offset};
+	write(table.data(), table.size() * sizeof(Blob));
+
+	Header h {};
+	std::memcpy(h.magic, Impl::magic, sizeof h.magic);
+	h.version = format_version;
+	h.byte_order = Impl::byte_order_mark;
+	h.blob_count = table.size();
+	h.table_offset = table_offset;
+	h.file_size = offset;
+	h.checksum = checksum.value();
+
+	file.seekp(0);
+	file.write(reinterpret_cast<const char*>(&h), sizeof h);
+	file.flush();
+	if (!file)
+		throw Io_error {"Could not write snapshot"};
+}
+
+inline void Glare::Snapshot::Writer::write(const void* data, std::size_t n)
+{
+	if (n == 0)
+		return;
+
+	file.write(static_cast<const char*>(data), static_cast<std::streamsize>(n));
+	if (!file)
+		throw Io_error {"Could not write snapshot"};
+	checksum.update(data, n);
+	offset += n;
+}
+
+inline void Glare::Snapshot::Writer::pad()
+{
+	static constexpr unsigned char zero[blob_alignment] {};
+	write(zero, (blob_alignment - offset % blob_alignment) % blob_alignment);
+}
+
+inline Glare::Snapshot::Reader::Reader(const std::string& path, bool verify)
+	:file {path}
+{
+	if (file.size() < sizeof(Header))
+		throw Not_valid {"Snapshot is truncated"};
+	std::memcpy(&header, file.data(), sizeof header);
+
+	if (std::memcmp(header.magic, Impl::magic, sizeof header.magic) != 0)
+		throw Not_valid {"Not a complete snapshot"};
+	if (header.version != format_version)
+		throw Not_valid {"Snapshot was written by an incompatible version"};
+	if (header.byte_order != Impl::byte_order_mark)
+		throw Not_valid {"Snapshot was written with a different byte order"};
+	if (header.file_size != file.size() || header.table_offset % blob_alignment != 0
+		|| header.table_offset > file.size()
+		|| header.blob_count > (file.size() - header.table_offset) / sizeof(Blob))
+		throw Not_valid {"Snapshot is truncated"};
+
+	if (verify) {
+		Impl::Checksum sum;
+		sum.update(file.data() + sizeof header, file.size() - sizeof header);
+		if (sum.value() != header.checksum)
+			throw Not_valid {"Snapshot checksum does not match"};
+	}
+
+	table = reinterpret_cast<const Blob*>(file.data() + header.table_offset);
+	for (std::size_t i = 0; i != header.blob_count; ++i) {
+		const auto& b = table[i];
+		if (b.offset % blob_alignment != 0 || b.offset > header.table_offset
+			|| (b.element_size && b.count > (header.table_offset - b.offset) / b.element_size))
+			throw Not_valid {"Snapshot blob table is corrupt"};
+	}
+}
+
+inline std::uint32_t Glare::Snapshot::Reader::version() const
+{
+	return header.version;
+}
+
+inline std::size_t Glare::Snapshot::Reader::blob_count() const
+{
+	return header.blob_count;
+}
+
+inline const Glare::Snapshot::Blob& Glare::Snapshot::Reader::blob(std::size_t i) const
+{
+	return table[i];
+}
+
+inline const Glare::Snapshot::Blob* Glare::Snapshot::Reader::find(Tag tag, std::uint32_t key, std::uint32_t part) const
+{
+	for (std::size_t i = 0; i != header.blob_count; ++i)
+		if (table[i].tag == tag && table[i].key == key && table[i].part == part)
+			return &table[i];
+
+	return nullptr;
+}
+
+template<typename T>
+Glare::Utility::Span<const T> Glare::Snapshot::Reader::array(Tag tag, std::uint32_t key, std::uint32_t part) const
+{
+	const Blob* b {find(tag, key, part)};
+	if (!b)
+		throw Not_valid {"Snapshot is missing a blob"};
+	if (b->element_size != sizeof(T))
+		throw Not_valid {"Snapshot blob has elements of the wrong size"};
+
+	return {reinterpret_cast<const T*>(file.data() + b->offset), static_cast<std::size_t>(b->count)};
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+void Glare::Snapshot::save(Writer& w, const Slot_map<T, Handle, Storage, Allocator>& sm, std::uint32_t key)
+{
+	Impl::Access::save(w, sm, key);
+}
+
+template<typename T, typename Handle, typename Storage, typename Allocator>
+void Glare::Snapshot::load(const Reader& r, Slot_map<T, Handle, Storage, Allocator>& sm, std::uint32_t key)
+{
+	Impl::Access::load(r, sm, key);
+}
+
+template<typename... T>
+void Glare::Snapshot::save(Writer& w, const Ecs::Entity_manager<T...>& em, std::uint32_t key)
+{
+	Impl::Access::save(w, em, key);
+}
+
+template<typename... T>
+void Glare::Snapshot::load(const Reader& r, Ecs::Entity_manager<T...>& em, std::uint32_t key)
+{
+	Impl::Access::load(r, em, key);
+}
+
+template<typename Map>
+Glare::Snapshot::Slot_map_view<Map>::Slot_map_view(const Reader& r, std::uint32_t key)
+	:slot_count {Impl::Access::check<Map>(r, key)}
+{
+	using Index = Impl::Access::Index<Map>;
+	val = r.array<value_type>(Impl::slot_map_values_tag, key);
+	indices = r.array<Index>(Impl::slot_map_indices_tag, key).data();
+	slots = r.array<Impl::Access::Checked_index<Map>>(Impl::slot_map_slots_tag, key).data();
+}
+
+template<typename Map>
+bool Glare::Snapshot::Slot_map_view<Map>::is_valid(Stable_index p) const
+{
+	return Impl::Access::is_valid<Map>(slots, slot_count, p);
+}
+
+template<typename Map>
+const typename Glare::Snapshot::Slot_map_view<Map>::value_type&
+Glare::Snapshot::Slot_map_view<Map>::operator[](Stable_index p) const
+{
+	if (!is_valid(p))
+		throw Not_valid {"Invalid Stable_index dereferenced"};
+
+	return val[Impl::Access::position<Map>(slots, p)];
+}
+
+template<typename Map>
+typename Glare::Snapshot::Slot_map_view<Map>::size_type Glare::Snapshot::Slot_map_view<Map>::size() const
+{
+	return val.size();
+}
+
+template<typename Map>
+bool Glare::Snapshot::Slot_map_view<Map>::empty() const
+{
+	return val.empty();
+}
+
+template<typename Map>
+Glare::Utility::Span<const typename Glare::Snapshot::Slot_map_view<Map>::value_type>
+Glare::Snapshot::Slot_map_view<Map>::values() const
+{
+	return val;
+}
+
+template<typename Map>
+typename Glare::Snapshot::Slot_map_view<Map>::Stable_index
+Glare::Snapshot::Slot_map_view<Map>::handle(size_type i) const
+{
+	return Impl::Access::handle<Map>(indices, slots, i);
+}
+
+template<typename Map>
+Glare::Snapshot::Impl::Slot_map_info Glare::Snapshot::Impl::Access::info(const Map* sm)
+{
+	using T = typename Map::value_type;
+	return {
+		sizeof(T),
+		alignof(T),
+		sizeof(Index<Map>),
+		sizeof(typename Map::Counter),
+		Map::null_index,
+		Map::max_counter,
+		sm ? static_cast<std::uint32_t>(sm->retirement) : 0,
+		0,
+		sm ? sm->retired : 0
+	};
+}
+
+template<typename Map>
+void Glare::Snapshot::Impl::Access::save(Writer& w, const Map& sm, std::uint32_t key)
+{
+	using T = typename Map::value_type;
+	using Storage = std::remove_const_t<std::remove_reference_t<decltype(sm.elem)>>;
+	static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be saved");
+
+	if (!sm.creation_buffer.empty() || !sm.deletion_buffer.empty())
+		throw Pending_changes {"Slot_map has buffered changes that have not been cleaned"};
+
+	const Slot_map_info i {info(&sm)};
+	w.add(slot_map_info_tag, key, 0, &i, 1);
+
+	const std::size_t n {sm.elem.size()};
+	if constexpr (std::is_same<Storage, Glare::Impl::Soa_container<T, Index<Map>, typename Map::allocator_type>>::value) {
+		w.add(slot_map_values_tag, key, 0, sm.elem.data(), n);
+		w.add(slot_map_indices_tag, key, 0, sm.elem.index_data(), n);
+	} else {
+		// gathered into the same layout as Soa_storage
+		std::vector<T> values;
+		std::vector<Index<Map>> indices;
+		values.reserve(n);
+		indices.reserve(n);
+		for (std::size_t j = 0; j != n; ++j) {
+			values.push_back(sm.elem.value(j));
+			indices.push_back(sm.elem.index(j));
+		}
+		w.add(slot_map_values_tag, key, 0, values.data(), n);
+		w.add(slot_map_indices_tag, key, 0, indices.data(), n);
+	}
+
+	w.add(slot_map_slots_tag, key, 0, sm.elem_indirect.data(), sm.elem_indirect.size());
+	w.add(slot_map_free_tag, key, 0, sm.free_index.data(), sm.free_index.size());
+}
+
+template<typename Map>
+std::size_t Glare::Snapshot::Impl::Access::check(const Reader& r, std::uint32_t key)
+{
+	const auto saved = r.array<Slot_map_info>(slot_map_info_tag, key);
+	const Slot_map_info expected {info<Map>(nullptr)};
+	if (saved.size() != 1
+		|| saved[0].value_size != expected.value_size
+		|| saved[0].value_alignment != expected.value_alignment
+		|| saved[0].index_size != expected.index_size
+		|| saved[0].counter_size != expected.counter_size
+		|| saved[0].null_index != expected.null_index
+		|| saved[0].max_counter != expected.max_counter)
+		throw Not_valid {"Snapshot holds a Slot_map of a different type"};
+
+	const auto values = r.array<typename Map::value_type>(slot_map_values_tag, key);
+	if (r.array<Index<Map>>(slot_map_indices_tag, key).size() != values.size())
+		throw Not_valid {"Snapshot Slot_map is corrupt"};
+
+	return r.array<Checked_index<Map>>(slot_map_slots_tag, key).size();
+}
+
+template<typename Map>
+void Glare::Snapshot::Impl::Access::load(const Reader& r, Map& sm, std::uint32_t key)
+{
+	static_assert(std::is_trivially_copyable<typename Map::value_type>::value,
+				  "only trivially copyable types can be loaded");
+	check<Map>(r, key);
+
+	const auto saved = r.array<Slot_map_info>(slot_map_info_tag, key)[0];
+	const auto values = r.array<typename Map::value_type>(slot_map_values_tag, key);
+	const auto indices = r.array<Index<Map>>(slot_map_indices_tag, key);
+	const auto slots = r.array<Checked_index<Map>>(slot_map_slots_tag, key);
+	const auto free = r.array<Index<Map>>(slot_map_free_tag, key);
+
+	sm.elem.assign(values.data(), indices.data(), values.size());
+	sm.elem_indirect.assign(slots.begin(), slots.end());
+	sm.free_index.assign(free.begin(), free.end());
+	sm.creation_buffer.clear();
+	sm.deletion_buffer.clear();
+	sm.retirement = static_cast<Retirement_policy>(saved.retirement);
+	sm.retired = static_cast<typename Map::size_type>(saved.retired);
+}
+
+template<typename Map>
+bool Glare::Snapshot::Impl::Access::is_valid(const void* slots, std::size_t slot_count, typename Map::Stable_index p)
+{
+	const auto s = static_cast<const Checked_index<Map>*>(slots);
+	const auto i = Map::index_of(p);
+
+	return i < slot_count && s[i].counter == Map::counter_of(p) && s[i].index != Map::null_index;
+}
+
+template<typename Map>
+std::size_t Glare::Snapshot::Impl::Access::position(const void* slots, typename Map::Stable_index p)
+{
+	return static_cast<const Checked_index<Map>*>(slots)[Map::index_of(p)].index;
+}
+
+template<typename Map>
+typename Map::Stable_index Glare::Snapshot::Impl::Access::handle(const void* indices, const void* slots, std::size_t i)
+{
+	const auto x = static_cast<const Index<Map>*>(indices)[i];
+	return {x, static_cast<const Checked_index<Map>*>(slots)[x].counter};
+}
+
+template<typename... T>
+void Glare::Snapshot::Impl::Access::save(Writer& w, const Ecs::Entity_manager<T...>& em, std::uint32_t key)
+{
+	using Manager = Ecs::Entity_manager<T...>;
+	static_assert((std::is_trivially_copyable<T>::value && ...), "only trivially copyable components can be saved");
+
+	save(w, em.records, key);
+
+	const Entity_manager_info i {
+		sizeof...(T),
+		static_cast<std::uint32_t>(em.archetypes.size()),
+		em.current_tick,
+		0
+	};
+	w.add(manager_info_tag, key, 0, &i, 1);
+
+	const std::uint32_t sizes[] {static_cast<std::uint32_t>(sizeof(T))...};
+	w.add(manager_sizes_tag, key, 0, sizes, sizeof...(T));
+
+	std::vector<typename Manager::Mask> masks;
+	for (const auto& a : em.archetypes)
+		masks.push_back(a.mask);
+	w.add(manager_masks_tag, key, 0, masks.data(), masks.size());
+
+	for (std::size_t a = 0; a != em.archetypes.size(); ++a) {
+		const auto& archetype = em.archetypes[a];
+		w.add(manager_entities_tag, key, static_cast<std::uint32_t>(a), archetype.entities.data(), archetype.entities.size());
+		(save_column<T, Manager>(w, archetype, key, a), ...);
+	}
+}
+
+template<typename... T>
+void Glare::Snapshot::Impl::Access::load(const Reader& r, Ecs::Entity_manager<T...>& em, std::uint32_t key)
+{
+	using Manager = Ecs::Entity_manager<T...>;
+	static_assert((std::is_trivially_copyable<T>::value && ...), "only trivially copyable components can be loaded");
+
+	const auto i = r.array<Entity_manager_info>(manager_info_tag, key);
+	const auto sizes = r.array<std::uint32_t>(manager_sizes_tag, key);
+	const std::uint32_t expected[] {static_cast<std::uint32_t>(sizeof(T))...};
+	if (i.size() != 1 || i[0].component_count != sizeof...(T)
+		|| sizes.size() != sizeof...(T) || std::memcmp(sizes.data(), expected, sizeof expected) != 0)
+		throw Not_valid {"Snapshot holds an Entity_manager with different components"};
+
+	const auto masks = r.array<typename Manager::Mask>(manager_masks_tag, key);
+	if (masks.size() != i[0].archetype_count || masks.empty() || masks[0] != 0)
+		throw Not_valid {"Snapshot Entity_manager is corrupt"};
+
+	load(r, em.records, key);
+
+	// rebuilt in the same order, so that the records still point at the right archetypes
+	em.archetypes.clear();
+	em.archetype_lookup.clear();
+	for (const auto m : masks)
+		em.find_archetype(m);
+
+	for (std::size_t a = 0; a != masks.size(); ++a) {
+		auto& archetype = em.archetypes[a];
+		const auto entities = r.array<typename Manager::Entity>(manager_entities_tag, key, static_cast<std::uint32_t>(a));
+		archetype.entities.assign(entities.begin(), entities.end());
+		(load_column<T, Manager>(r, archetype, key, a), ...);
+	}
+
+	em.current_tick = i[0].tick;
+}
+
+template<typename C, typename... T>
+constexpr std::size_t Glare::Snapshot::Impl::Access::component_index(const Ecs::Entity_manager<T...>*)
+{
+	return Ecs::Impl::Index_of<C, T...>::value;
+}
+
+template<typename C, typename Manager, typename Archetype>
+void Glare::Snapshot::Impl::Access::save_column(Writer& w, const Archetype& archetype, std::uint32_t key, std::size_t a)
+{
+	if (!(archetype.mask & Manager::template bit<C>()))
+		return;
+
+	constexpr auto n = component_index<C>(static_cast<const Manager*>(nullptr));
+	const auto part = column_part(a, n);
+	const auto& column = Manager::template column<C>(archetype);
+	w.add(manager_column_tag, key, part, column.data(), column.size());
+
+	if constexpr (Ecs::Track_changes<C>::value) {
+		w.add(manager_added_tag, key, part, archetype.added_tick[n].data(), archetype.added_tick[n].size());
+		w.add(manager_changed_tag, key, part, archetype.changed_tick[n].data(), archetype.changed_tick[n].size());
+	}
+}
+
+template<typename C, typename Manager, typename Archetype>
+void Glare::Snapshot::Impl::Access::load_column(const Reader& r, Archetype& archetype, std::uint32_t key, std::size_t a)
+{
+	if (!(archetype.mask & Manager::template bit<C>()))
+		return;
+
+	constexpr auto n = component_index<C>(static_cast<const Manager*>(nullptr));
+	const auto part = column_part(a, n);
+	const auto column = r.array<C>(manager_column_tag, key, part);
+	if (column.size() != archetype.entities.size())
+		throw Not_valid {"Snapshot Entity_manager is corrupt"};
+	Manager::template column<C>(archetype).assign(column.begin(), column.end());
+
+	if constexpr (Ecs::Track_changes<C>::value) {
+		const auto added = r.array<typename Manager::Tick>(manager_added_tag, key, part);
+		const auto changed = r.array<typename Manager::Tick>(manager_changed_tag, key, part);
+		archetype.added_tick[n].assign(added.begin(), added.end());
+		archetype.changed_tick[n].assign(changed.begin(), changed.end());
+	}
+}
+
+#endif // !GLARE_SNAPSHOT_HPP
@@ -0,0 +1,175 @@
+#ifndef GLARE_SPARSE_SET_HPP
+#define GLARE_SPARSE_SET_HPP
+
+#include "slot_map.hpp"
+#include "utility.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Glare {
+	namespace Ecs {
+		// packed array of T keyed by a small integer id
+		// sparse maps an id to its position in the packed arrays, so lookup,
+		// insertion and removal are O(1) and iteration touches only live values
+		template<typename T>
+		class Sparse_set {
+		public:
+			using value_type = T;
+			using size_type = std::size_t;
+			using Id = std::uint32_t;
+
+			bool contains(Id) const;
+			// position of id in the packed arrays, id must be present
+			size_type position(Id) const;
+
+			// id must not be present yet
+			template<typename... Args>
+			T& emplace(Id, Args&&...);
+			// moves the last element into the gap, id must be present
+			void remove(Id);
+			// exchanges the elements at two packed positions
+			void swap_positions(size_type, size_type);
+			void clear();
+			void reserve(size_type);
+
+			// id must be present
+			T& get(Id);
+			const T& get(Id) const;
+
+			size_type size() const;
+			bool empty() const;
+
+			// ids()[i] owns values()[i]
+			Utility::Span<T> values();
+			Utility::Span<const T> values() const;
+			Utility::Span<const Id> ids() const;
+		private:
+			static constexpr Id null {std::numeric_limits<Id>::max()};
+
+			std::vector<Id> sparse; // null if absent
+			std::vector<Id> dense;
+			std::vector<T> packed;
+		};
+	}
+}
+
+/***** IMPLEMENTATION *****/
+
+template<typename T>
+bool Glare::Ecs::Sparse_set<T>::contains(Id id) const
+{
+	return id < sparse.size() && sparse[id] != null;
+}
+
+template<typename T>
+typename Glare::Ecs::Sparse_set<T>::size_type Glare::Ecs::Sparse_set<T>::position(Id id) const
+{
+	return sparse[id];
+}
+
+template<typename T>
+template<typename... Args>
+T& Glare::Ecs::Sparse_set<T>::emplace(Id id, Args&&... args)
+{
+	if (id >= sparse.size())
+		sparse.resize(id + size_type {1}, null);
+
+	Glare::Impl::emplace_back(packed, std::forward<Args>(args)...);
+	dense.push_back(id);
+	sparse[id] = static_cast<Id>(dense.size() - 1);
+
+	return packed.back();
+}
+
+template<typename T>
+void Glare::Ecs::Sparse_set<T>::remove(Id id)
+{
+	const auto i = sparse[id];
+	const auto last = static_cast<Id>(dense.size() - 1);
+
+	if (i != last) {
+		packed[i] = std::move(packed.back());
+		dense[i] = dense.back();
+		sparse[dense[i]] = i;
+	}
+
+	packed.pop_back();
+	dense.pop_back();
+	sparse[id] = null;
+}
+
+template<typename T>
+void Glare::Ecs::Sparse_set<T>::swap_positions(size_type a, size_type b)
+{
+	if (a == b)
+		return;
+
+	using std::swap;
+	swap(packed[a], packed[b]);
+	swap(dense[a], dense[b]);
+	sparse[dense[a]] = static_cast<Id>(a);
+	sparse[dense[b]] = static_cast<Id>(b);
+}
+
+template<typename T>
+void Glare::Ecs::Sparse_set<T>::clear()
+{
+	sparse.clear();
+	dense.clear();
+	packed.clear();
+}
+
+template<typename T>
+void Glare::Ecs::Sparse_set<T>::reserve(size_type n)
+{
+	dense.reserve(n);
+	packed.reserve(n);
+}
+
+template<typename T>
+T& Glare::Ecs::Sparse_set<T>::get(Id id)
+{
+	return packed[sparse[id]];
+}
+
+template<typename T>
+const T& Glare::Ecs::Sparse_set<T>::get(Id id) const
+{
+	return packed[sparse[id]];
+}
+
+template<typename T>
+typename Glare::Ecs::Sparse_set<T>::size_type Glare::Ecs::Sparse_set<T>::size() const
+{
+	return dense.size();
+}
+
+template<typename T>
+bool Glare::Ecs::Sparse_set<T>::empty() const
+{
+	return dense.empty();
+}
+
+template<typename T>
+Glare::Utility::Span<T> Glare::Ecs::Sparse_set<T>::values()
+{
+	return {packed.data(), packed.size()};
+}
+
+template<typename T>
+Glare::Utility::Span<const T> Glare::Ecs::Sparse_set<T>::values() const
+{
+	return {packed.data(), packed.size()};
+}
+
+template<typename T>
+Glare::Utility::Span<const typename Glare::Ecs::Sparse_set<T>::Id> Glare::Ecs::Sparse_set<T>::ids() const
+{
+	return {dense.data(), dense.size()};
+}
+
+#endif // !GLARE_SPARSE_SET_HPP
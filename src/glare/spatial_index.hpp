@@ -0,0 +1,630 @@
+#ifndef GLARE_SPATIAL_INDEX_HPP
+#define GLARE_SPATIAL_INDEX_HPP
+
+#include "math.hpp"
+#include "profile.hpp"
+#include "sah.hpp"
+#include "slot_map.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Glare {
+	namespace Scene {
+		// dynamic bounding volume tree over objects named by a Handle, usually
+		// the Stable_index of a Slot_map, for finding which objects a volume meets
+		// leaf boxes are grown by a margin so that objects moving a little don't
+		// change the tree, and rotations keep it balanced as leaves come and go,
+		// so insert, move and remove are O(log n)
+		// queries write handles to a buffer the caller owns and never allocate
+		template<typename Handle>
+		class Spatial_index {
+			using Node_index = std::uint32_t;
+			using Proxy_map = Slot_map<Node_index>;
+		public:
+			using size_type = std::size_t;
+			// an object's place in the index, give an entity one by storing it in a component
+			using Proxy = typename Proxy_map::Stable_index;
+
+			using Not_valid = typename Proxy_map::Not_valid;
+
+			explicit Spatial_index(float margin = 0.1f);
+
+			Proxy insert(Handle, const Math::Aabb&);
+			// returns true if the bounds left the grown box of the leaf, so that
+			// it had to be put back in the tree
+			// throws Not_valid if the proxy isn't in the index
+			bool move(Proxy, const Math::Aabb&);
+			// does nothing if the proxy isn't in the index
+			void remove(Proxy);
+			bool is_valid(Proxy) const;
+			void clear();
+			// rebuilds the tree from the top down by the surface area heuristic,
+			// with each subtree in one run of memory, for faster queries once many
+			// objects have come in one at a time, such as after loading a level
+			// proxies stay valid
+			void optimize();
+
+			// throw Not_valid if the proxy isn't in the index
+			Handle handle(Proxy) const;
+			// as last inserted or moved, without the margin
+			const Math::Aabb& bounds(Proxy) const;
+
+			size_type size() const;
+			// of the root over the deepest leaf, 0 for one object or none
+			size_type height() const;
+
+			// each writes the handles of objects whose bounds meet the volume to
+			// out, as many as fit, and returns how many there were in all
+			// handles come out in no particular order
+			size_type query(const Math::Frustum&, Utility::Span<Handle> out) const;
+			size_type query(const Math::Aabb&, Utility::Span<Handle> out) const;
+			size_type query(const Math::Sphere&, Utility::Span<Handle> out) const;
+			// objects the ray passes through before max_t, nearest or not
+			size_type query(const Math::Ray&, Utility::Span<Handle> out) const;
+		private:
+			static constexpr Node_index null_node {std::numeric_limits<Node_index>::max()};
+			// past the height of any balanced tree that node indices can address
+			static constexpr int stack_size {64};
+			// optimize splits deeper nodes at the median, to stay within the stack
+			static constexpr int max_sah_depth {32};
+
+			struct Node {
+				Math::Aabb box; // grown by the margin for leaves
+				Node_index parent; // or the next free node, once freed
+				Node_index child[2]; // null_node for leaves
+				std::int32_t height; // 0 for leaves
+			};
+
+			struct Leaf {
+				Handle handle;
+				Proxy proxy;
+				Math::Aabb bounds; // without the margin
+			};
+
+			// how much of a box a query volume covers
+			enum class Overlap {
+				none,
+				some,
+				all
+			};
+
+			Node_index allocate();
+			void free(Node_index);
+			void insert_leaf(Node_index);
+			void remove_leaf(Node_index);
+			// rotates the taller child up if it is two taller than the other,
+			// returns whichever node is now where x was
+			Node_index balance(Node_index x);
+			// refits boxes and heights from x up to the root, balancing on the way
+			void fix_upwards(Node_index x);
+			Node_index leaf(Proxy) const;
+
+			// overlap(const Aabb&) -> Overlap is asked of nodes, and for leaves it
+			// only partly covers exact(const Aabb&) -> bool of the exact bounds
+			template<typename F, typename G>
+			size_type collect(F overlap, G exact, Utility::Span<Handle> out) const;
+
+			float margin;
+			std::vector<Node> nodes;
+			std::vector<Leaf> leaves; // by node, only meaningful for leaves
+			Node_index root {null_node};
+			Node_index free_nodes {null_node};
+			Proxy_map proxies;
+		};
+
+		namespace Impl {
+			using Glare::Impl::merge;
+			using Glare::Impl::area;
+
+			inline bool contains(const Math::Aabb& outer, const Math::Aabb& inner)
+			{
+				for (int i = 0; i != 3; ++i)
+					if (inner.min[i] < outer.min[i] || inner.max[i] > outer.max[i])
+						return false;
+				return true;
+			}
+
+			inline bool overlaps(const Math::Aabb& a, const Math::Aabb& b)
+			{
+				for (int i = 0; i != 3; ++i)
+					if (a.max[i] < b.min[i] || a.min[i] > b.max[i])
+						return false;
+				return true;
+			}
+		}
+	}
+}
+
+/***** IMPLEMENTATION *****/
+
+template<typename Handle>
+Glare::Scene::Spatial_index<Handle>::Spatial_index(float margin)
+	:margin {margin}
+{
+}
+
+template<typename Handle>
+typename Glare::Scene::Spatial_index<Handle>::Proxy
+Glare::Scene::Spatial_index<Handle>::insert(Handle h, const Math::Aabb& b)
+{
+	const Node_index x {allocate()};
+	Node& n {nodes[x]};
+	for (int i = 0; i != 3; ++i) {
+		n.box.min[i] = b.min[i] - margin;
+		n.box.max[i] = b.max[i] + margin;
+	}
+	n.child[0] = null_node;
+	n.child[1] = null_node;
+	n.height = 0;
+	leaves[x].handle = h;
+	leaves[x].bounds = b;
+
+	insert_leaf(x);
+	leaves[x].proxy = proxies.add(x);
+	return leaves[x].proxy;
+}
+
+template<typename Handle>
+bool Glare::Scene::Spatial_index<Handle>::move(Proxy p, const Math::Aabb& b)
+{
+	const Node_index x {leaf(p)};
+	leaves[x].bounds = b;
+	if (Impl::contains(nodes[x].box, b))
+		return false;
+
+	remove_leaf(x);
+	for (int i = 0; i != 3; ++i) {
+		nodes[x].box.min[i] = b.min[i] - margin;
+		nodes[x].box.max[i] = b.max[i] + margin;
+	}
+	insert_leaf(x);
+	return true;
+}
+
+template<typename Handle>
+void Glare::Scene::Spatial_index<Handle>::remove(Proxy p)
+{
+	if (!is_valid(p))
+		return;
+
+	const Node_index x {leaf(p)};
+	remove_leaf(x);
+	free(x);
+	proxies.remove(p);
+}
+
+template<typename Handle>
+bool Glare::Scene::Spatial_index<Handle>::is_valid(Proxy p) const
+{
+	return proxies.is_valid(p);
+}
+
+template<typename Handle>
+void Glare::Scene::Spatial_index<Handle>::clear()
+{
+	nodes.clear();
+	leaves.clear();
+	root = null_node;
+	free_nodes = null_node;
+	proxies = Proxy_map {};
+}
+
+template<typename Handle>
+void Glare::Scene::Spatial_index<Handle>::optimize()
+{
+	GLARE_PROFILE_ZONE("Spatial_index::optimize");
+
+	std::vector<Leaf> old_leaves;
+	std::vector<Math::Aabb> boxes;
+	std::vector<float> centroids;
+	for (size_type x = 0; x != nodes.size(); ++x) {
+		if (nodes[x].height == 0) {
+			old_leaves.push_back(leaves[x]);
+			boxes.push_back(nodes[x].box);
+			for (int i = 0; i != 3; ++i)
+				centroids.push_back((nodes[x].box.min[i] + nodes[x].box.max[i]) / 2);
+		}
+	}
+
+	nodes.clear();
+	leaves.clear();
+	root = null_node;
+	free_nodes = null_node;
+	if (old_leaves.empty())
+		return;
+
+	std::vector<Node_index> order(old_leaves.size());
+	for (Node_index i = 0; i != order.size(); ++i)
+		order[i] = i;
+
+	// nodes are made as tasks are taken, left first, so that every subtree
+	// is a run of nodes starting at its root
+	struct Task {
+		Node_index parent;
+		int side;
+		size_type begin;
+		size_type end;
+		int depth;
+	};
+	std::vector<Task> tasks {{null_node, 0, 0, old_leaves.size(), 0}};
+
+	while (!tasks.empty()) {
+		const Task task {tasks.back()};
+		tasks.pop_back();
+
+		const auto x = static_cast<Node_index>(nodes.size());
+		nodes.push_back({{}, task.parent, {null_node, null_node}, 0});
+		leaves.emplace_back();
+		if (task.parent == null_node)
+			root = x;
+		else
+			nodes[task.parent].child[task.side] = x;
+
+		if (task.end - task.begin == 1) {
+			const Node_index i {order[task.begin]};
+			nodes[x].box = boxes[i];
+			leaves[x] = old_leaves[i];
+			proxies[leaves[x].proxy] = x;
+			continue;
+		}
+
+		const auto split = Glare::Impl::sah_split(order.begin() + task.begin, order.begin() + task.end,
+			boxes.data(), centroids.data(), task.depth < max_sah_depth);
+		const size_type middle {task.begin + split.middle};
+
+		tasks.push_back({x, 1, middle, task.end, task.depth + 1});
+		tasks.push_back({x, 0, task.begin, middle, task.depth + 1});
+	}
+
+	// children come after their parents
+	for (size_type x = nodes.size(); x-- != 0;) {
+		Node& n {nodes[x]};
+		if (n.child[0] == null_node)
+			continue;
+		const Node& c0 {nodes[n.child[0]]};
+		const Node& c1 {nodes[n.child[1]]};
+		n.box = Impl::merge(c0.box, c1.box);
+		n.height = 1 + std::max(c0.height, c1.height);
+	}
+}
+
+template<typename Handle>
+Handle Glare::Scene::Spatial_index<Handle>::handle(Proxy p) const
+{
+	return leaves[leaf(p)].handle;
+}
+
+template<typename Handle>
+const Glare::Math::Aabb& Glare::Scene::Spatial_index<Handle>::bounds(Proxy p) const
+{
+	return leaves[leaf(p)].bounds;
+}
+
+template<typename Handle>
+typename Glare::Scene::Spatial_index<Handle>::size_type Glare::Scene::Spatial_index<Handle>::size() const
+{
+	return proxies.size();
+}
+
+template<typename Handle>
+typename Glare::Scene::Spatial_index<Handle>::size_type Glare::Scene::Spatial_index<Handle>::height() const
+{
+	return root == null_node ? 0 : static_cast<size_type>(nodes[root].height);
+}
+
+template<typename Handle>
+typename Glare::Scene::Spatial_index<Handle>::size_type
+Glare::Scene::Spatial_index<Handle>::query(const Math::Frustum& f, Utility::Span<Handle> out) const
+{
+	GLARE_PROFILE_ZONE("Spatial_index::query");
+
+	const auto overlap = [&f](const Math::Aabb& b) {
+		Overlap result {Overlap::all};
+		for (const auto& p : f.planes) {
+			// the corners furthest along and against the normal
+			float inner {p[3]}, outer {p[3]};
+			for (int i = 0; i != 3; ++i) {
+				inner += p[i] * (p[i] > 0 ? b.max[i] : b.min[i]);
+				outer += p[i] * (p[i] > 0 ? b.min[i] : b.max[i]);
+			}
+			if (inner < 0)
+				return Overlap::none;
+			if (outer < 0)
+				result = Overlap::some;
+		}
+		return result;
+	};
+
+	return collect(overlap, [&overlap](const Math::Aabb& b) { return overlap(b) != Overlap::none; }, out);
+}
+
+template<typename Handle>
+typename Glare::Scene::Spatial_index<Handle>::size_type
+Glare::Scene::Spatial_index<Handle>::query(const Math::Aabb& box, Utility::Span<Handle> out) const
+{
+	GLARE_PROFILE_ZONE("Spatial_index::query");
+
+	const auto overlap = [&box](const Math::Aabb& b) {
+		if (!Impl::overlaps(box, b))
+			return Overlap::none;
+		return Impl::contains(box, b) ? Overlap::all : Overlap::some;
+	};
+
+	return collect(overlap, [&box](const Math::Aabb& b) { return Impl::overlaps(box, b); }, out);
+}
+
+template<typename Handle>
+typename Glare::Scene::Spatial_index<Handle>::size_type
+Glare::Scene::Spatial_index<Handle>::query(const Math::Sphere& s, Utility::Span<Handle> out) const
+{
+	GLARE_PROFILE_ZONE("Spatial_index::query");
+
+	const float radius_squared {s.radius * s.radius};
+	// squared distances from the centre to the nearest and furthest points of b
+	const auto nearest = [&s](const Math::Aabb& b) {
+		float d {0};
+		for (int i = 0; i != 3; ++i) {
+			const float x {std::max(std::max(b.min[i] - s.centre[i], s.centre[i] - b.max[i]), 0.0f)};
+			d += x * x;
+		}
+		return d;
+	};
+	const auto overlap = [&](const Math::Aabb& b) {
+		if (nearest(b) > radius_squared)
+			return Overlap::none;
+		float furthest {0};
+		for (int i = 0; i != 3; ++i) {
+			const float x {std::max(s.centre[i] - b.min[i], b.max[i] - s.centre[i])};
+			furthest += x * x;
+		}
+		return furthest <= radius_squared ? Overlap::all : Overlap::some;
+	};
+
+	return collect(overlap, [&](const Math::Aabb& b) { return nearest(b) <= radius_squared; }, out);
+}
+
+template<typename Handle>
+typename Glare::Scene::Spatial_index<Handle>::size_type
+Glare::Scene::Spatial_index<Handle>::query(const Math::Ray& r, Utility::Span<Handle> out) const
+{
+	GLARE_PROFILE_ZONE("Spatial_index::query");
+
+	float inverse[3];
+	for (int i = 0; i != 3; ++i)
+		inverse[i] = 1 / r.direction[i];
+
+	// slab test, a ray never covers a whole box
+	const auto hits = [&](const Math::Aabb& b) {
+		float entry {0}, exit {r.max_t};
+		for (int i = 0; i != 3; ++i) {
+			const float lo {(b.min[i] - r.origin[i]) * inverse[i]};
+			const float hi {(b.max[i] - r.origin[i]) * inverse[i]};
+			entry = std::max(entry, std::min(lo, hi));
+			exit = std::min(exit, std::max(lo, hi));
+		}
+		return entry <= exit;
+	};
+
+	return collect([&hits](const Math::Aabb& b) { return hits(b) ? Overlap::some : Overlap::none; }, hits, out);
+}
+
+template<typename Handle>
+typename Glare::Scene::Spatial_index<Handle>::Node_index Glare::Scene::Spatial_index<Handle>::allocate()
+{
+	if (free_nodes != null_node) {
+		const Node_index x {free_nodes};
+		free_nodes = nodes[x].parent;
+		nodes[x].parent = null_node;
+		return x;
+	}
+
+	nodes.push_back({{}, null_node, {null_node, null_node}, 0});
+	leaves.emplace_back();
+	return static_cast<Node_index>(nodes.size() - 1);
+}
+
+template<typename Handle>
+void Glare::Scene::Spatial_index<Handle>::free(Node_index x)
+{
+	nodes[x].parent = free_nodes;
+	nodes[x].height = -1;
+	free_nodes = x;
+}
+
+template<typename Handle>
+void Glare::Scene::Spatial_index<Handle>::insert_leaf(Node_index x)
+{
+	if (root == null_node) {
+		root = x;
+		nodes[x].parent = null_node;
+		return;
+	}
+
+	// walk down to the cheapest sibling, going by the area every node on
+	// the way would gain and the area of a new parent beside the sibling
+	const Math::Aabb box {nodes[x].box};
+	Node_index sibling {root};
+	while (nodes[sibling].child[0] != null_node) {
+		const Node& n {nodes[sibling]};
+		const float combined {Impl::area(Impl::merge(n.box, box))};
+		// a new parent here
+		const float here {2 * combined};
+		// what every node from here down pays to grow
+		const float inherited {2 * (combined - Impl::area(n.box))};
+
+		float cost[2];
+		for (int c = 0; c != 2; ++c) {
+			const Node& child {nodes[n.child[c]]};
+			const float merged {Impl::area(Impl::merge(child.box, box))};
+			cost[c] = (child.child[0] == null_node ? merged : merged - Impl::area(child.box)) + inherited;
+		}
+
+		if (here < cost[0] && here < cost[1])
+			break;
+		sibling = n.child[cost[1] < cost[0]];
+	}
+
+	const Node_index old_parent {nodes[sibling].parent};
+	const Node_index parent {allocate()};
+	Node& p {nodes[parent]};
+	p.box = Impl::merge(box, nodes[sibling].box);
+	p.parent = old_parent;
+	p.child[0] = sibling;
+	p.child[1] = x;
+	p.height = nodes[sibling].height + 1;
+
+	if (old_parent == null_node)
+		root = parent;
+	else
+		nodes[old_parent].child[nodes[old_parent].child[1] == sibling] = parent;
+	nodes[sibling].parent = parent;
+	nodes[x].parent = parent;
+
+	fix_upwards(parent);
+}
+
+template<typename Handle>
+void Glare::Scene::Spatial_index<Handle>::remove_leaf(Node_index x)
+{
+	if (x == root) {
+		root = null_node;
+		return;
+	}
+
+	const Node_index parent {nodes[x].parent};
+	const Node_index grandparent {nodes[parent].parent};
+	const Node_index sibling {nodes[parent].child[nodes[parent].child[0] == x]};
+
+	// the sibling takes the parent's place
+	nodes[sibling].parent = grandparent;
+	free(parent);
+	if (grandparent == null_node) {
+		root = sibling;
+	} else {
+		nodes[grandparent].child[nodes[grandparent].child[1] == parent] = sibling;
+		fix_upwards(grandparent);
+	}
+}
+
+template<typename Handle>
+typename Glare::Scene::Spatial_index<Handle>::Node_index Glare::Scene::Spatial_index<Handle>::balance(Node_index a)
+{
+	Node& na {nodes[a]};
+	if (na.child[0] == null_node || na.height < 2)
+		return a;
+
+	const int skew {nodes[na.child[1]].height - nodes[na.child[0]].height};
+	if (skew >= -1 && skew <= 1)
+		return a;
+
+	// the taller child b replaces a, and a takes the shorter grandchild
+	// from under b in place of b
+	const int tall {skew > 1 ? 1 : 0};
+	const Node_index b {na.child[tall]};
+	const Node_index other {na.child[1 - tall]};
+	Node& nb {nodes[b]};
+
+	nb.parent = na.parent;
+	na.parent = b;
+	if (nb.parent == null_node)
+		root = b;
+	else
+		nodes[nb.parent].child[nodes[nb.parent].child[1] == a] = b;
+
+	const Node_index f {nb.child[0]};
+	const Node_index g {nb.child[1]};
+	const bool f_taller {nodes[f].height > nodes[g].height};
+	const Node_index keep {f_taller ? f : g};
+	const Node_index give {f_taller ? g : f};
+
+	nb.child[0] = a;
+	nb.child[1] = keep;
+	na.child[tall] = give;
+	nodes[give].parent = a;
+
+	na.box = Impl::merge(nodes[other].box, nodes[give].box);
+	na.height = 1 + std::max(nodes[other].height, nodes[give].height);
+	nb.box = Impl::merge(na.box, nodes[keep].box);
+	nb.height = 1 + std::max(na.height, nodes[keep].height);
+	return b;
+}
+
+template<typename Handle>
+void Glare::Scene::Spatial_index<Handle>::fix_upwards(Node_index x)
+{
+	while (x != null_node) {
+		x = balance(x);
+		Node& n {nodes[x]};
+		const Node& c0 {nodes[n.child[0]]};
+		const Node& c1 {nodes[n.child[1]]};
+		n.height = 1 + std::max(c0.height, c1.height);
+		n.box = Impl::merge(c0.box, c1.box);
+		x = n.parent;
+	}
+}
+
+template<typename Handle>
+typename Glare::Scene::Spatial_index<Handle>::Node_index Glare::Scene::Spatial_index<Handle>::leaf(Proxy p) const
+{
+	return proxies[typename Proxy_map::Stable_const_index {p}];
+}
+
+template<typename Handle>
+template<typename F, typename G>
+typename Glare::Scene::Spatial_index<Handle>::size_type
+Glare::Scene::Spatial_index<Handle>::collect(F overlap, G exact, Utility::Span<Handle> out) const
+{
+	if (root == null_node)
+		return 0;
+
+	size_type found {0};
+	const auto emit = [&](Node_index x) {
+		if (found < out.size())
+			out[found] = leaves[x].handle;
+		++found;
+	};
+
+	Node_index stack[stack_size];
+	int top {0};
+	stack[top++] = root;
+
+	while (top != 0) {
+		const Node_index x {stack[--top]};
+		const Node& n {nodes[x]};
+		const Overlap o {overlap(n.box)};
+		if (o == Overlap::none)
+			continue;
+
+		if (n.child[0] == null_node) {
+			if (o == Overlap::all || exact(leaves[x].bounds))
+				emit(x);
+		} else if (o == Overlap::all) {
+			// every leaf below is in, with no more tests
+			Node_index below[stack_size];
+			int below_top {0};
+			below[below_top++] = x;
+			while (below_top != 0) {
+				const Node& m {nodes[below[--below_top]]};
+				if (m.child[0] == null_node) {
+					emit(below[below_top]);
+				} else {
+					below[below_top++] = m.child[0];
+					below[below_top++] = m.child[1];
+				}
+			}
+		} else {
+			stack[top++] = n.child[0];
+			stack[top++] = n.child[1];
+		}
+	}
+
+	return found;
+}
+
+#endif // !GLARE_SPATIAL_INDEX_HPP
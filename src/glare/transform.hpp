@@ -0,0 +1,373 @@
+#ifndef GLARE_TRANSFORM_HPP
+#define GLARE_TRANSFORM_HPP
+
+#include "error.hpp"
+#include "job_system.hpp"
+#include "math.hpp"
+#include "parallel.hpp"
+#include "profile.hpp"
+#include "slot_map.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace Glare {
+	namespace Scene {
+		// parent/child tree of transforms
+		// nodes are kept in contiguous arrays, one tree after another and each
+		// tree in breadth first order, so parents always come before their
+		// children and world matrices are computed in a single linear pass
+		// only the part of a tree after its first changed node is visited,
+		// and only nodes below a change are recomputed
+		class Transform_hierarchy {
+			using Position = std::uint32_t; // in the sorted arrays
+			using Position_map = Slot_map<Position>;
+		public:
+			using size_type = std::size_t;
+			// handle to a node, give an entity a place in the scene by storing it in a component
+			using Node = Position_map::Stable_index;
+
+			using Not_valid = Position_map::Not_valid;
+			using Cycle = Error::Scene_hierarchy_cycle;
+
+			// local is relative to the parent, a null parent makes a root
+			Node create(const Math::Mat4& local = Math::Mat4::identity(), Node parent = {});
+			// destroys the node along with all its descendants
+			// they are invalid at once, but stay in the arrays until the next
+			// update drops every destroyed node in a single O(size()) pass
+			void destroy(Node);
+			bool is_valid(Node) const;
+			// counts destroyed nodes until the next update
+			size_type size() const;
+
+			// a null parent makes the node a root
+			// throws Cycle if parent is the node itself or one of its descendants
+			void set_parent(Node, Node parent);
+			// null for a root
+			Node parent(Node) const;
+
+			void set_local(Node, const Math::Mat4&);
+			const Math::Mat4& local(Node) const;
+			// as of the last update
+			const Math::Mat4& world(Node) const;
+			// true if the last update recomputed the world matrix of the node
+			bool world_changed(Node) const;
+
+			// recomputes the world matrix of every node whose local matrix,
+			// or that of an ancestor, changed since the last update
+			void update();
+			// as above, with trees shared out among jobs in runs of about grain nodes
+			void update(Utility::Job_system&, size_type grain = default_grain);
+		private:
+			static constexpr Position null_position {std::numeric_limits<Position>::max()};
+			// parent of a destroyed node until the next sort
+			static constexpr Position removed_position {null_position - 1};
+
+			// [begin, end) of the sorted arrays
+			struct Range {
+				Position begin;
+				Position end;
+			};
+
+			// throws Not_valid for destroyed nodes
+			Position position(Node) const;
+			// true if p or one of its ancestors was destroyed since the last sort
+			bool is_removed(Position p) const;
+			void mark(Position);
+
+			// puts the nodes back into tree and depth order, dropping destroyed ones
+			void sort();
+			// sorts if needed and works out the ranges update has to visit
+			void prepare();
+			void update_range(Range);
+
+			Position_map positions;
+
+			// sorted arrays
+			std::vector<Math::Mat4> local_matrix;
+			std::vector<Math::Mat4> world_matrix;
+			std::vector<Position> parent_position;
+			std::vector<Node> node;
+			std::vector<std::uint8_t> dirty; // local matrix or parent changed
+			std::vector<std::uint32_t> updated; // update_count when world_matrix was last computed
+
+			std::vector<Range> trees; // sorted by begin
+			std::vector<Position> dirty_nodes;
+			std::vector<Range> work; // of the current update, kept to reuse its memory
+			std::uint32_t update_count {0};
+			size_type removed_count {0}; // nodes destroyed since the last sort
+			bool sorted {true};
+		};
+	}
+}
+
+/***** IMPLEMENTATION *****/
+
+inline Glare::Scene::Transform_hierarchy::Node
+Glare::Scene::Transform_hierarchy::create(const Math::Mat4& local, Node parent)
+{
+	const Position pp {parent == Node {} ? null_position : position(parent)};
+	const auto p = static_cast<Position>(node.size());
+	const Node x {positions.add(p)};
+
+	local_matrix.push_back(local);
+	world_matrix.push_back(local);
+	parent_position.push_back(pp);
+	node.push_back(x);
+	dirty.push_back(0);
+	updated.push_back(0);
+	mark(p);
+
+	// a new root can go at the end as a tree of its own
+	if (pp == null_position)
+		trees.push_back({p, p + 1});
+	else
+		sorted = false;
+
+	return x;
+}
+
+inline void Glare::Scene::Transform_hierarchy::destroy(Node x)
+{
+	if (!is_valid(x))
+		return;
+
+	// the descendants are dropped along with it, as sort never reaches them
+	parent_position[position(x)] = removed_position;
+	++removed_count;
+	sorted = false;
+}
+
+inline bool Glare::Scene::Transform_hierarchy::is_valid(Node x) const
+{
+	return positions.is_valid(x) && !is_removed(positions[Position_map::Stable_const_index {x}]);
+}
+
+inline Glare::Scene::Transform_hierarchy::size_type Glare::Scene::Transform_hierarchy::size() const
+{
+	return node.size();
+}
+
+inline void Glare::Scene::Transform_hierarchy::set_parent(Node x, Node parent)
+{
+	const Position p {position(x)};
+	const Position pp {parent == Node {} ? null_position : position(parent)};
+
+	for (Position a {pp}; a != null_position; a = parent_position[a])
+		if (a == p)
+			throw Cycle {"Node cannot be moved below itself"};
+
+	if (parent_position[p] == pp)
+		return;
+
+	parent_position[p] = pp;
+	sorted = false;
+	mark(p);
+}
+
+inline Glare::Scene::Transform_hierarchy::Node Glare::Scene::Transform_hierarchy::parent(Node x) const
+{
+	const Position pp {parent_position[position(x)]};
+	return pp == null_position ? Node {} : node[pp];
+}
+
+inline void Glare::Scene::Transform_hierarchy::set_local(Node x, const Math::Mat4& m)
+{
+	const Position p {position(x)};
+	local_matrix[p] = m;
+	mark(p);
+}
+
+inline const Glare::Math::Mat4& Glare::Scene::Transform_hierarchy::local(Node x) const
+{
+	return local_matrix[position(x)];
+}
+
+inline const Glare::Math::Mat4& Glare::Scene::Transform_hierarchy::world(Node x) const
+{
+	return world_matrix[position(x)];
+}
+
+inline bool Glare::Scene::Transform_hierarchy::world_changed(Node x) const
+{
+	return update_count != 0 && updated[position(x)] == update_count;
+}
+
+inline void Glare::Scene::Transform_hierarchy::update()
+{
+	GLARE_PROFILE_ZONE("Transform_hierarchy::update");
+
+	prepare();
+	for (const auto r : work)
+		update_range(r);
+}
+
+inline void Glare::Scene::Transform_hierarchy::update(Utility::Job_system& jobs, size_type grain)
+{
+	GLARE_PROFILE_ZONE("Transform_hierarchy::update");
+
+	prepare();
+
+	Glare::Impl::Job_group group;
+	for (size_type i = 0; i != work.size();) {
+		// whole trees only, so that no job waits for another
+		size_type j {i};
+		size_type nodes {0};
+		do
+			nodes += work[j].end - work[j].begin;
+		while (++j != work.size() && nodes < grain);
+
+		group.submit(jobs, [this, i, j] {
+			for (size_type k {i}; k != j; ++k)
+				update_range(work[k]);
+		});
+		i = j;
+	}
+
+	group.wait(jobs);
+}
+
+inline Glare::Scene::Transform_hierarchy::Position Glare::Scene::Transform_hierarchy::position(Node x) const
+{
+	const Position p {positions[Position_map::Stable_const_index {x}]};
+	if (is_removed(p))
+		throw Not_valid {"Destroyed Transform_hierarchy node used"};
+	return p;
+}
+
+inline bool Glare::Scene::Transform_hierarchy::is_removed(Position p) const
+{
+	// only nodes destroyed since the last sort are still in the arrays
+	if (removed_count == 0)
+		return false;
+	for (; p != null_position; p = parent_position[p])
+		if (parent_position[p] == removed_position)
+			return true;
+	return false;
+}
+
+inline void Glare::Scene::Transform_hierarchy::mark(Position p)
+{
+	if (!dirty[p]) {
+		dirty[p] = 1;
+		dirty_nodes.push_back(p);
+	}
+}
+
+inline void Glare::Scene::Transform_hierarchy::sort()
+{
+	const auto n = static_cast<Position>(node.size());
+
+	// group children by parent with a counting sort, roots go under n
+	std::vector<Position> start(n + size_type {2}, 0);
+	for (Position i = 0; i != n; ++i)
+		if (parent_position[i] != removed_position)
+			++start[(parent_position[i] == null_position ? n : parent_position[i]) + size_type {1}];
+	for (Position k = 1; k != n + size_type {2}; ++k)
+		start[k] += start[k - 1];
+
+	std::vector<Position> children(start[n + size_type {1}]);
+	{
+		std::vector<Position> next(start.begin(), start.end() - 1);
+		for (Position i = 0; i != n; ++i)
+			if (parent_position[i] != removed_position)
+				children[next[parent_position[i] == null_position ? n : parent_position[i]]++] = i;
+	}
+
+	// breadth first from each root, in their current order
+	std::vector<Position> order;
+	order.reserve(n);
+	trees.clear();
+	for (Position r {start[n]}; r != start[n + size_type {1}]; ++r) {
+		const auto begin = static_cast<Position>(order.size());
+		order.push_back(children[r]);
+		for (size_type head {begin}; head != order.size(); ++head) {
+			const Position p {order[head]};
+			order.insert(order.end(), children.begin() + start[p], children.begin() + start[p + 1]);
+		}
+		trees.push_back({begin, static_cast<Position>(order.size())});
+	}
+
+	std::vector<Position> new_position(n, null_position);
+	for (Position j = 0; j != order.size(); ++j)
+		new_position[order[j]] = j;
+
+	// nodes that weren't reached are being destroyed
+	for (Position i = 0; i != n; ++i)
+		if (new_position[i] == null_position)
+			positions.remove(node[i]);
+
+	const auto permute = [&order](auto& v) {
+		std::remove_reference_t<decltype(v)> sorted_v;
+		sorted_v.reserve(order.size());
+		for (const auto i : order)
+			sorted_v.push_back(v[i]);
+		v.swap(sorted_v);
+	};
+	permute(local_matrix);
+	permute(world_matrix);
+	permute(node);
+	permute(dirty);
+	permute(updated);
+	permute(parent_position);
+	for (auto& pp : parent_position)
+		if (pp != null_position)
+			pp = new_position[pp];
+
+	dirty_nodes.clear();
+	for (Position j = 0; j != order.size(); ++j) {
+		positions[node[j]] = j;
+		if (dirty[j])
+			dirty_nodes.push_back(j);
+	}
+
+	removed_count = 0;
+	sorted = true;
+}
+
+inline void Glare::Scene::Transform_hierarchy::prepare()
+{
+	if (!sorted)
+		sort();
+	++update_count;
+
+	// each changed tree is visited from its first changed node on
+	std::vector<Position> first(trees.size(), null_position);
+	size_type t {0};
+	for (const auto p : dirty_nodes) {
+		// nodes tend to be marked a tree at a time
+		if (p < trees[t].begin || p >= trees[t].end)
+			t = std::upper_bound(trees.begin(), trees.end(), p,
+				[](Position x, const Range& r) { return x < r.begin; }) - trees.begin() - 1;
+		first[t] = std::min(first[t], p);
+	}
+	dirty_nodes.clear();
+
+	work.clear();
+	for (size_type t = 0; t != trees.size(); ++t)
+		if (first[t] != null_position)
+			work.push_back({first[t], trees[t].end});
+}
+
+inline void Glare::Scene::Transform_hierarchy::update_range(Range r)
+{
+	for (Position i {r.begin}; i != r.end; ++i) {
+		const Position pp {parent_position[i]};
+		const bool parent_changed {pp != null_position && updated[pp] == update_count};
+		if (!dirty[i] && !parent_changed)
+			continue;
+
+		if (pp == null_position)
+			world_matrix[i] = local_matrix[i];
+		else
+			Math::multiply(world_matrix[pp], local_matrix[i], world_matrix[i]);
+		updated[i] = update_count;
+		dirty[i] = 0;
+	}
+}
+
+#endif // !GLARE_TRANSFORM_HPP
@@ -1,9 +1,214 @@
 #ifndef GLARE_UTILITY_HPP
 #define GLARE_UTILITY_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+
 namespace Glare {
 	namespace Utility {
+		// non-owning view of a contiguous range
+		template<typename T>
+		class Span {
+		public:
+			using value_type = std::remove_cv_t<T>;
+			using size_type = std::size_t;
+			using pointer = T*;
+			using reference = T&;
+			using iterator = T*;
+
+			Span() = default;
+			Span(T* data, size_type size) :ptr {data}, len {size} {}
+
+			T* data() const { return ptr; }
+			size_type size() const { return len; }
+			bool empty() const { return len == 0; }
+
+			T* begin() const { return ptr; }
+			T* end() const { return ptr + len; }
+
+			T& operator[](size_type i) const { return ptr[i]; }
+		private:
+			T* ptr {nullptr};
+			size_type len {0};
+		};
+
+		// linear allocator for memory that only lives for one frame
+		// deallocation does nothing, everything is freed at once by reset
+		class Frame_arena : public std::pmr::memory_resource {
+		public:
+			explicit Frame_arena(std::size_t capacity,
+								 std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+			~Frame_arena();
+
+			Frame_arena(const Frame_arena&) = delete;
+			Frame_arena& operator=(const Frame_arena&) = delete;
+
+			// invalidates everything allocated since the last reset
+			void reset();
+
+			std::size_t used() const;
+			std::size_t capacity() const;
+		private:
+			// throws std::bad_alloc once the arena is full
+			void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+			void do_deallocate(void*, std::size_t, std::size_t) override;
+			bool do_is_equal(const std::pmr::memory_resource&) const noexcept override;
+
+			std::pmr::memory_resource* upstream;
+			std::byte* buffer;
+			std::size_t size;
+			std::size_t offset {0};
+		};
+
+		// fixed size blocks carved out of one preallocated chunk
+		// requests larger than a block, or made while the pool is empty, go upstream
+		class Block_pool : public std::pmr::memory_resource {
+		public:
+			Block_pool(std::size_t block_size, std::size_t block_count,
+					   std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+			~Block_pool();
+
+			Block_pool(const Block_pool&) = delete;
+			Block_pool& operator=(const Block_pool&) = delete;
+
+			std::size_t block_size() const;
+			std::size_t free_blocks() const;
+		private:
+			void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+			void do_deallocate(void*, std::size_t bytes, std::size_t alignment) override;
+			bool do_is_equal(const std::pmr::memory_resource&) const noexcept override;
+
+			bool owns(const void*) const;
+
+			// free blocks form a linked list through their first bytes
+			struct Free_block {
+				Free_block* next;
+			};
+
+			std::pmr::memory_resource* upstream;
+			std::size_t block;
+			std::size_t count;
+			std::byte* chunk;
+			Free_block* free_list {nullptr};
+			std::size_t free_count {0};
+		};
 	}
 }
 
+/***** IMPLEMENTATION *****/
+
+inline Glare::Utility::Frame_arena::Frame_arena
+(std::size_t capacity, std::pmr::memory_resource* upstream)
+	:upstream {upstream},
+	buffer {static_cast<std::byte*>(upstream->allocate(capacity, alignof(std::max_align_t)))},
+	size {capacity}
+{}
+
+inline Glare::Utility::Frame_arena::~Frame_arena()
+{
+	upstream->deallocate(buffer, size, alignof(std::max_align_t));
+}
+
+inline void Glare::Utility::Frame_arena::reset()
+{
+	offset = 0;
+}
+
+inline std::size_t Glare::Utility::Frame_arena::used() const
+{
+	return offset;
+}
+
+inline std::size_t Glare::Utility::Frame_arena::capacity() const
+{
+	return size;
+}
+
+inline void* Glare::Utility::Frame_arena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+	const auto base = reinterpret_cast<std::uintptr_t>(buffer);
+	const auto start = (base + offset + alignment - 1) & ~(std::uintptr_t {alignment} - 1);
+
+	if (start + bytes > base + size) throw std::bad_alloc {};
+
+	offset = start + bytes - base;
+	return reinterpret_cast<void*>(start);
+}
+
+inline void Glare::Utility::Frame_arena::do_deallocate(void*, std::size_t, std::size_t)
+{}
+
+inline bool Glare::Utility::Frame_arena::do_is_equal(const std::pmr::memory_resource& rhs) const noexcept
+{
+	return this == &rhs;
+}
+
+inline Glare::Utility::Block_pool::Block_pool
+(std::size_t block_size, std::size_t block_count, std::pmr::memory_resource* upstream)
+	:upstream {upstream},
+	// every block must be able to hold a Free_block and be suitably aligned
+	block {(std::max(block_size, sizeof(Free_block)) + alignof(std::max_align_t) - 1)
+		   / alignof(std::max_align_t) * alignof(std::max_align_t)},
+	count {block_count},
+	chunk {static_cast<std::byte*>(upstream->allocate(block * count, alignof(std::max_align_t)))}
+{
+	for (std::size_t i = count; i-- > 0;) {
+		free_list = ::new (chunk + i * block) Free_block {free_list};
+	}
+	free_count = count;
+}
+
+inline Glare::Utility::Block_pool::~Block_pool()
+{
+	upstream->deallocate(chunk, block * count, alignof(std::max_align_t));
+}
+
+inline std::size_t Glare::Utility::Block_pool::block_size() const
+{
+	return block;
+}
+
+inline std::size_t Glare::Utility::Block_pool::free_blocks() const
+{
+	return free_count;
+}
+
+inline bool Glare::Utility::Block_pool::owns(const void* p) const
+{
+	const auto x = reinterpret_cast<std::uintptr_t>(p);
+	const auto base = reinterpret_cast<std::uintptr_t>(chunk);
+	return x >= base && x < base + block * count;
+}
+
+inline void* Glare::Utility::Block_pool::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+	if (bytes > block || alignment > alignof(std::max_align_t) || !free_list)
+		return upstream->allocate(bytes, alignment);
+
+	Free_block* x {free_list};
+	free_list = x->next;
+	--free_count;
+	return x;
+}
+
+inline void Glare::Utility::Block_pool::do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+{
+	if (!owns(p)) {
+		upstream->deallocate(p, bytes, alignment);
+		return;
+	}
+
+	free_list = ::new (p) Free_block {free_list};
+	++free_count;
+}
+
+inline bool Glare::Utility::Block_pool::do_is_equal(const std::pmr::memory_resource& rhs) const noexcept
+{
+	return this == &rhs;
+}
+
 #endif // !GLARE_UTILITY_HPP
@@ -1,10 +1,742 @@
 #ifndef GLARE_VIDEO_HPP
 #define GLARE_VIDEO_HPP
 
+#include "error.hpp"
+#include "job_system.hpp"
+#include "math.hpp"
+#include "profile.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace Glare {
 	namespace Video {
+		// a colour as the four bytes of an rgba8 image, red first in memory
+		constexpr std::uint32_t rgba(std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint8_t a = 255)
+		{
+			return std::uint32_t {r} | std::uint32_t {g} << 8 | std::uint32_t {b} << 16 | std::uint32_t {a} << 24;
+		}
+
+		struct Vertex {
+			float position[3];
+			std::uint32_t color; // from rgba
+		};
+
+		namespace Impl {
+			// a row of pixels handled at once, as wide as the instruction set allows
+			// F holds a float per pixel, M a mask per pixel and I a packed colour per pixel
+			// Scalar_lanes holds one pixel, and is what Lanes is without SSE2
+			struct Scalar_lanes;
+		}
+
+		// draws triangles into an rgba8 image on the CPU, laid out as the
+		// image2D the presentation shader reads, with no graphics API involved
+		// the screen is split into tiles, triangles are set up and sorted into
+		// the tiles they touch by jobs, then each tile is drawn by its own job
+		// triangles within a tile are drawn in the order they were queued, so
+		// the image doesn't depend on how the jobs were scheduled
+		class Rasterizer {
+		public:
+			using size_type = std::size_t;
+
+			static constexpr size_type tile_size {64};
+
+			Rasterizer(size_type width, size_type height);
+
+			void resize(size_type width, size_type height);
+			// what every pixel starts as in each render
+			void set_clear(std::uint32_t color, float depth = 1);
+			// front faces are counter-clockwise on screen, as in OpenGL
+			// back faces are drawn unless this is set
+			void set_cull_back_faces(bool);
+
+			// queues every three indices as a triangle, with positions transformed
+			// by to_clip into OpenGL clip space
+			// vertices and indices aren't copied and must live until the next render
+			// throws Video_index_out_of_range if an index is past the vertices
+			void draw(Utility::Span<const Vertex>, Utility::Span<const std::uint32_t> indices, const Math::Mat4& to_clip);
+
+			// draws every queued triangle into the image, then empties the queue
+			// the nearest fragment wins, colours are interpolated with perspective
+			void render(Utility::Job_system&);
+			void render();
+
+			size_type width() const;
+			size_type height() const;
+			// width() * height() pixels packed by rgba, rows start from the
+			// bottom as gl_FragCoord counts them, so it can be uploaded as is
+			Utility::Span<const std::uint32_t> image() const;
+			// triangles that reached setup in the last render, after clipping and culling
+			size_type triangle_count() const;
+		private:
+			struct Draw {
+				Utility::Span<const Vertex> vertices;
+				Utility::Span<const std::uint32_t> indices;
+				Math::Mat4 to_clip;
+				// of all triangles and vertices queued this render
+				size_type first;
+				size_type first_vertex;
+			};
+
+			// value = a * x + b * y + c in window coordinates
+			struct Plane {
+				float a, b, c;
+			};
+
+			struct Triangle {
+				// window coordinates, snapped to a sixteenth of a pixel so that
+				// edges shared by two triangles are evaluated identically
+				float x[3], y[3];
+				Plane depth;
+				Plane inv_w;
+				Plane color[4]; // over w, so that they interpolate with perspective
+				int min_x, min_y, max_x, max_y; // pixels that may be covered, max exclusive
+			};
+
+			// a vertex in clip space
+			struct Clip_vertex {
+				float position[4];
+				float color[4];
+				// a bit for each side of the view it is beyond, and one more if it
+				// is beyond the near plane or guard band and has to be clipped
+				std::uint32_t outside;
+			};
+
+			// triangles set up by one job, and which of them touch each tile
+			struct Chunk {
+				size_type first;
+				size_type last;
+				std::vector<Triangle> triangles;
+				std::vector<std::vector<std::uint32_t>> bins;
+			};
+
+			// a tile being drawn, private to the job drawing it
+			struct Tile_buffer {
+				std::unique_ptr<float[]> depth;
+				std::unique_ptr<std::uint32_t[]> color;
+			};
+
+			void prepare(size_type thread_count);
+			// transforms the queued vertices in [first, last)
+			void transform(size_type first, size_type last);
+			void set_up(Chunk&);
+			void clip(const Clip_vertex&, const Clip_vertex&, const Clip_vertex&, Chunk&);
+			void add(const Clip_vertex&, const Clip_vertex&, const Clip_vertex&, Chunk&);
+			void draw_tile(size_type tile, Tile_buffer&);
+			void draw_triangle(const Triangle&, int origin_x, int origin_y, Tile_buffer&);
+			void finish();
+
+			size_type w;
+			size_type h;
+			size_type tiles_x;
+			size_type tiles_y;
+			std::uint32_t clear_color {rgba(0, 0, 0)};
+			float clear_depth {1};
+			bool cull_back_faces {false};
+
+			std::vector<Draw> draws;
+			size_type queued {0};
+			size_type queued_vertices {0};
+			std::vector<Clip_vertex> transformed;
+			size_type chunk_count {0};
+			std::vector<Chunk> chunks;
+			std::vector<Tile_buffer> tile_buffers;
+			std::vector<std::uint32_t> pixels;
+			size_type triangles {0};
+		};
+
+		namespace Impl {
+			struct Scalar_lanes {
+				static constexpr int width {1};
+				using F = float;
+				using M = bool;
+				using I = std::uint32_t;
+
+				static F set(float x) { return x; }
+				static F steps() { return 0; }
+				static F add(F a, F b) { return a + b; }
+				static F mul(F a, F b) { return a * b; }
+				static F sub(F a, F b) { return a - b; }
+				static F div(F a, F b) { return a / b; }
+				static F min(F a, F b) { return std::min(a, b); }
+				static F max(F a, F b) { return std::max(a, b); }
+				static F clamp(F x, float lo, float hi) { return std::min(std::max(x, lo), hi); }
+
+				static M greater(F a, F b) { return a > b; }
+				static M less(F a, F b) { return a < b; }
+				static M equal(F a, F b) { return a == b; }
+				static M less_equal(F a, F b) { return a <= b; }
+				static M mask(bool x) { return x; }
+				static M both(M a, M b) { return a && b; }
+				static M either(M a, M b) { return a || b; }
+				static bool any(M m) { return m; }
+				static int bits(M m) { return m; }
+
+				static F load(const float* p) { return *p; }
+				static void store(float* p, F x) { *p = x; }
+				static F select(M m, F a, F b) { return m ? a : b; }
+
+				static I pack(F r, F g, F b, F a)
+				{
+					const auto c = [](F x) { return static_cast<std::uint32_t>(std::nearbyint(x)); };
+					return c(r) | c(g) << 8 | c(b) << 16 | c(a) << 24;
+				}
+				static I load(const std::uint32_t* p) { return *p; }
+				static void store(std::uint32_t* p, I x) { *p = x; }
+				static I select(M m, I a, I b) { return m ? a : b; }
+			};
+
+#if defined(GLARE_AVX2)
+			struct Lanes {
+				static constexpr int width {8};
+				using F = __m256;
+				using M = __m256;
+				using I = __m256i;
+
+				static F set(float x) { return _mm256_set1_ps(x); }
+				// 0, 1, 2, ... for the position of each pixel in the row
+				static F steps() { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+				static F add(F a, F b) { return _mm256_add_ps(a, b); }
+				static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+				static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+				static F div(F a, F b) { return _mm256_div_ps(a, b); }
+				static F min(F a, F b) { return _mm256_min_ps(a, b); }
+				static F max(F a, F b) { return _mm256_max_ps(a, b); }
+				static F clamp(F x, float lo, float hi) { return _mm256_min_ps(_mm256_max_ps(x, set(lo)), set(hi)); }
+
+				static M greater(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+				static M less(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+				static M equal(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+				static M less_equal(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+				static M mask(bool x) { return _mm256_castsi256_ps(_mm256_set1_epi32(x ? -1 : 0)); }
+				static M both(M a, M b) { return _mm256_and_ps(a, b); }
+				static M either(M a, M b) { return _mm256_or_ps(a, b); }
+				static bool any(M m) { return _mm256_movemask_ps(m) != 0; }
+				// bit i set for each pixel i in the mask
+				static int bits(M m) { return _mm256_movemask_ps(m); }
+
+				static F load(const float* p) { return _mm256_loadu_ps(p); }
+				static void store(float* p, F x) { _mm256_storeu_ps(p, x); }
+				static F select(M m, F a, F b) { return _mm256_blendv_ps(b, a, m); }
+
+				// channels from 0 to 255
+				static I pack(F r, F g, F b, F a)
+				{
+					const I ri {_mm256_cvtps_epi32(r)};
+					const I gi {_mm256_slli_epi32(_mm256_cvtps_epi32(g), 8)};
+					const I bi {_mm256_slli_epi32(_mm256_cvtps_epi32(b), 16)};
+					const I ai {_mm256_slli_epi32(_mm256_cvtps_epi32(a), 24)};
+					return _mm256_or_si256(_mm256_or_si256(ri, gi), _mm256_or_si256(bi, ai));
+				}
+				static I load(const std::uint32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+				static void store(std::uint32_t* p, I x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+				static I select(M m, I a, I b)
+				{
+					return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b), _mm256_castsi256_ps(a), m));
+				}
+			};
+#elif defined(GLARE_SSE2)
+			struct Lanes {
+				static constexpr int width {4};
+				using F = __m128;
+				using M = __m128;
+				using I = __m128i;
+
+				static F set(float x) { return _mm_set1_ps(x); }
+				static F steps() { return _mm_setr_ps(0, 1, 2, 3); }
+				static F add(F a, F b) { return _mm_add_ps(a, b); }
+				static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+				static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+				static F div(F a, F b) { return _mm_div_ps(a, b); }
+				static F min(F a, F b) { return _mm_min_ps(a, b); }
+				static F max(F a, F b) { return _mm_max_ps(a, b); }
+				static F clamp(F x, float lo, float hi) { return _mm_min_ps(_mm_max_ps(x, set(lo)), set(hi)); }
+
+				static M greater(F a, F b) { return _mm_cmpgt_ps(a, b); }
+				static M less(F a, F b) { return _mm_cmplt_ps(a, b); }
+				static M equal(F a, F b) { return _mm_cmpeq_ps(a, b); }
+				static M less_equal(F a, F b) { return _mm_cmple_ps(a, b); }
+				static M mask(bool x) { return _mm_castsi128_ps(_mm_set1_epi32(x ? -1 : 0)); }
+				static M both(M a, M b) { return _mm_and_ps(a, b); }
+				static M either(M a, M b) { return _mm_or_ps(a, b); }
+				static bool any(M m) { return _mm_movemask_ps(m) != 0; }
+				static int bits(M m) { return _mm_movemask_ps(m); }
+
+				static F load(const float* p) { return _mm_loadu_ps(p); }
+				static void store(float* p, F x) { _mm_storeu_ps(p, x); }
+				static F select(M m, F a, F b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
 
+				static I pack(F r, F g, F b, F a)
+				{
+					const I ri {_mm_cvtps_epi32(r)};
+					const I gi {_mm_slli_epi32(_mm_cvtps_epi32(g), 8)};
+					const I bi {_mm_slli_epi32(_mm_cvtps_epi32(b), 16)};
+					const I ai {_mm_slli_epi32(_mm_cvtps_epi32(a), 24)};
+					return _mm_or_si128(_mm_or_si128(ri, gi), _mm_or_si128(bi, ai));
+				}
+				static I load(const std::uint32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+				static void store(std::uint32_t* p, I x) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x); }
+				static I select(M m, I a, I b)
+				{
+					const I mi {_mm_castps_si128(m)};
+					return _mm_or_si128(_mm_and_si128(mi, a), _mm_andnot_si128(mi, b));
+				}
+			};
+#else
+			using Lanes = Scalar_lanes;
+#endif
+		}
 	}
 }
 
+/***** IMPLEMENTATION *****/
+
+inline Glare::Video::Rasterizer::Rasterizer(size_type width, size_type height)
+{
+	resize(width, height);
+}
+
+inline void Glare::Video::Rasterizer::resize(size_type width, size_type height)
+{
+	w = width;
+	h = height;
+	tiles_x = (w + tile_size - 1) / tile_size;
+	tiles_y = (h + tile_size - 1) / tile_size;
+	pixels.assign(w * h, clear_color);
+}
+
+inline void Glare::Video::Rasterizer::set_clear(std::uint32_t color, float depth)
+{
+	clear_color = color;
+	clear_depth = depth;
+}
+
+inline void Glare::Video::Rasterizer::set_cull_back_faces(bool cull)
+{
+	cull_back_faces = cull;
+}
+
+inline void Glare::Video::Rasterizer::draw(Utility::Span<const Vertex> vertices,
+										   Utility::Span<const std::uint32_t> indices, const Math::Mat4& to_clip)
+{
+	for (const auto i : indices)
+		if (i >= vertices.size())
+			throw Error::Video_index_out_of_range {"Index " + std::to_string(i) + " is past the "
+				+ std::to_string(vertices.size()) + " vertices"};
+
+	draws.push_back({vertices, indices, to_clip, queued, queued_vertices});
+	queued += indices.size() / 3;
+	queued_vertices += vertices.size();
+}
+
+inline void Glare::Video::Rasterizer::render(Utility::Job_system& jobs)
+{
+	GLARE_PROFILE_ZONE("Rasterizer::render");
+
+	prepare(jobs.thread_count());
+
+	Utility::Job_system::Counter counter;
+	for (size_type c = 0; c != chunk_count; ++c) {
+		jobs.submit([this, c] {
+			transform(queued_vertices * c / chunk_count, queued_vertices * (c + 1) / chunk_count);
+		}, counter);
+	}
+	jobs.wait(counter);
+
+	for (size_type c = 0; c != chunk_count; ++c)
+		jobs.submit([this, c] { set_up(chunks[c]); }, counter);
+	jobs.wait(counter);
+
+	// each job has a buffer of its own and takes tiles until none are left,
+	// rather than going by thread_index, which threads outside the pool share
+	std::atomic<size_type> next_tile {0};
+	for (size_type b = 0; b != jobs.thread_count(); ++b) {
+		jobs.submit([this, b, &next_tile] {
+			for (size_type t; (t = next_tile.fetch_add(1, std::memory_order_relaxed)) < tiles_x * tiles_y;)
+				draw_tile(t, tile_buffers[b]);
+		}, counter);
+	}
+	jobs.wait(counter);
+
+	finish();
+}
+
+inline void Glare::Video::Rasterizer::render()
+{
+	GLARE_PROFILE_ZONE("Rasterizer::render");
+
+	prepare(1);
+	transform(0, queued_vertices);
+	for (size_type c = 0; c != chunk_count; ++c)
+		set_up(chunks[c]);
+	for (size_type t = 0; t != tiles_x * tiles_y; ++t)
+		draw_tile(t, tile_buffers[0]);
+	finish();
+}
+
+inline Glare::Video::Rasterizer::size_type Glare::Video::Rasterizer::width() const
+{
+	return w;
+}
+
+inline Glare::Video::Rasterizer::size_type Glare::Video::Rasterizer::height() const
+{
+	return h;
+}
+
+inline Glare::Utility::Span<const std::uint32_t> Glare::Video::Rasterizer::image() const
+{
+	return {pixels.data(), pixels.size()};
+}
+
+inline Glare::Video::Rasterizer::size_type Glare::Video::Rasterizer::triangle_count() const
+{
+	return triangles;
+}
+
+inline void Glare::Video::Rasterizer::prepare(size_type thread_count)
+{
+	// a few chunks per thread so that uneven ones balance out,
+	// but not so many that walking their bins costs more than the triangles
+	constexpr size_type min_chunk {1024};
+	chunk_count = std::min((queued + min_chunk - 1) / min_chunk, 4 * thread_count);
+	if (chunks.size() < chunk_count)
+		chunks.resize(chunk_count);
+
+	const size_type tiles {tiles_x * tiles_y};
+	for (size_type c = 0; c != chunk_count; ++c) {
+		chunks[c].first = queued * c / chunk_count;
+		chunks[c].last = queued * (c + 1) / chunk_count;
+		chunks[c].triangles.clear();
+		chunks[c].bins.resize(tiles);
+		for (auto& b : chunks[c].bins)
+			b.clear();
+	}
+
+	transformed.resize(queued_vertices);
+
+	while (tile_buffers.size() < thread_count)
+		tile_buffers.push_back({std::make_unique<float[]>(tile_size * tile_size),
+								std::make_unique<std::uint32_t[]>(tile_size * tile_size)});
+}
+
+inline void Glare::Video::Rasterizer::transform(size_type first, size_type last)
+{
+	GLARE_PROFILE_ZONE("Rasterizer::transform");
+
+	if (first == last)
+		return;
+
+	// past the guard band window coordinates grow beyond where a sixteenth
+	// of a pixel can be represented
+	const float guard_x {static_cast<float>(1 << 18) / static_cast<float>(std::max<size_type>(w, 1))};
+	const float guard_y {static_cast<float>(1 << 18) / static_cast<float>(std::max<size_type>(h, 1))};
+
+	auto d = std::upper_bound(draws.begin(), draws.end(), first,
+		[](size_type i, const Draw& x) { return i < x.first_vertex; }) - 1;
+
+	for (size_type i {first}; i != last; ++i) {
+		while (i >= d->first_vertex + d->vertices.size())
+			++d;
+
+		const Vertex& in {d->vertices[i - d->first_vertex]};
+		Clip_vertex& out {transformed[i]};
+		const float* m {d->to_clip.m};
+		for (int r = 0; r != 4; ++r)
+			out.position[r] = m[r] * in.position[0] + m[4 + r] * in.position[1] + m[8 + r] * in.position[2] + m[12 + r];
+		for (int c = 0; c != 4; ++c)
+			out.color[c] = static_cast<float>(in.color >> (8 * c) & 0xff) * (1.0f / 255);
+
+		const float* p {out.position};
+		out.outside = (p[0] > p[3]) | (p[0] < -p[3]) << 1 | (p[1] > p[3]) << 2 | (p[1] < -p[3]) << 3
+			| (p[2] > p[3]) << 4 | (p[2] < -p[3]) << 5
+			| (p[2] < -p[3] || p[0] > guard_x * p[3] || p[0] < -guard_x * p[3]
+			   || p[1] > guard_y * p[3] || p[1] < -guard_y * p[3]) << 6;
+	}
+}
+
+inline void Glare::Video::Rasterizer::set_up(Chunk& chunk)
+{
+	GLARE_PROFILE_ZONE("Rasterizer::set_up");
+
+	auto d = std::upper_bound(draws.begin(), draws.end(), chunk.first,
+		[](size_type t, const Draw& x) { return t < x.first; }) - 1;
+
+	for (size_type t {chunk.first}; t != chunk.last; ++t) {
+		while (t >= d->first + d->indices.size() / 3)
+			++d;
+
+		const auto* index = d->indices.data() + (t - d->first) * 3;
+		const Clip_vertex* v {transformed.data() + d->first_vertex};
+		clip(v[index[0]], v[index[1]], v[index[2]], chunk);
+	}
+}
+
+inline void Glare::Video::Rasterizer::clip(const Clip_vertex& v0, const Clip_vertex& v1, const Clip_vertex& v2,
+										   Chunk& chunk)
+{
+	// whole triangles outside one side of the view are dropped
+	if (v0.outside & v1.outside & v2.outside & 0x3f)
+		return;
+	if (!((v0.outside | v1.outside | v2.outside) & 0x40)) {
+		add(v0, v1, v2, chunk);
+		return;
+	}
+
+	// planes as (x, y, z, w) weights, kept on the side where the sum is positive
+	// past the near plane w goes to zero and below
+	const float guard_x {static_cast<float>(1 << 18) / static_cast<float>(std::max<size_type>(w, 1))};
+	const float guard_y {static_cast<float>(1 << 18) / static_cast<float>(std::max<size_type>(h, 1))};
+	const float planes[5][4] {
+		{0, 0, 1, 1},
+		{-1, 0, 0, guard_x}, {1, 0, 0, guard_x},
+		{0, -1, 0, guard_y}, {0, 1, 0, guard_y}
+	};
+	const auto distance = [](const float (&plane)[4], const Clip_vertex& x) {
+		return plane[0] * x.position[0] + plane[1] * x.position[1] + plane[2] * x.position[2] + plane[3] * x.position[3];
+	};
+
+	// each plane adds at most one vertex
+	Clip_vertex polygon[2][8] {{v0, v1, v2}};
+	int count {3};
+	int from {0};
+	for (const auto& plane : planes) {
+		const Clip_vertex* in {polygon[from]};
+		Clip_vertex* out {polygon[1 - from]};
+		int n {0};
+		for (int i = 0; i != count; ++i) {
+			const Clip_vertex& a {in[i]};
+			const Clip_vertex& b {in[(i + 1) % count]};
+			const float da {distance(plane, a)};
+			const float db {distance(plane, b)};
+			if (da >= 0)
+				out[n++] = a;
+			if ((da >= 0) != (db >= 0)) {
+				const float s {da / (da - db)};
+				Clip_vertex& x {out[n++]};
+				for (int k = 0; k != 4; ++k) {
+					x.position[k] = a.position[k] + s * (b.position[k] - a.position[k]);
+					x.color[k] = a.color[k] + s * (b.color[k] - a.color[k]);
+				}
+			}
+		}
+		count = n;
+		from = 1 - from;
+		if (count < 3)
+			return;
+	}
+
+	for (int i = 1; i + 1 < count; ++i)
+		add(polygon[from][0], polygon[from][i], polygon[from][i + 1], chunk);
+}
+
+inline void Glare::Video::Rasterizer::add(const Clip_vertex& v0, const Clip_vertex& v1, const Clip_vertex& v2, Chunk& chunk)
+{
+	// adding and taking away 1.5 * 2^23 rounds anything within the guard band
+	// to a whole number, without a call to nearbyint
+	const auto snap = [](float x) {
+		constexpr float magic {12582912.0f};
+		return (x * 16 + magic - magic) * (1.0f / 16);
+	};
+
+	const Clip_vertex* v[3] {&v0, &v1, &v2};
+	float x[3], y[3], z[3], inv_w[3];
+	for (int i = 0; i != 3; ++i) {
+		inv_w[i] = 1 / v[i]->position[3];
+		x[i] = snap((v[i]->position[0] * inv_w[i] * 0.5f + 0.5f) * static_cast<float>(w));
+		y[i] = snap((v[i]->position[1] * inv_w[i] * 0.5f + 0.5f) * static_cast<float>(h));
+		z[i] = v[i]->position[2] * inv_w[i] * 0.5f + 0.5f;
+	}
+
+	float area {(x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0])};
+	if (area < 0 && !cull_back_faces) {
+		// wound the other way, so that inside is where every edge is positive
+		std::swap(v[1], v[2]);
+		std::swap(x[1], x[2]);
+		std::swap(y[1], y[2]);
+		std::swap(z[1], z[2]);
+		std::swap(inv_w[1], inv_w[2]);
+		area = -area;
+	}
+	if (!(area > 0)) // back facing, empty or not a number
+		return;
+
+	// pixels whose centres are within the bounds, most distant triangles
+	// are smaller than a pixel and stop here
+	const auto bound = [](float lo, float hi, size_type size, int& first, int& last) {
+		const float limit {static_cast<float>(size)};
+		const float a {std::min(std::max(lo - 0.5f, 0.0f), limit)};
+		const float b {std::min(std::max(hi + 0.5f, 0.0f), limit)};
+		first = static_cast<int>(a);
+		first += static_cast<float>(first) < a;
+		last = static_cast<int>(b);
+		return first < last;
+	};
+	Triangle t;
+	if (!bound(std::min({x[0], x[1], x[2]}), std::max({x[0], x[1], x[2]}), w, t.min_x, t.max_x)
+		|| !bound(std::min({y[0], y[1], y[2]}), std::max({y[0], y[1], y[2]}), h, t.min_y, t.max_y))
+		return;
+
+	std::copy(x, x + 3, t.x);
+	std::copy(y, y + 3, t.y);
+
+	const float inv_area {1 / area};
+	const float dx1 {x[1] - x[0]};
+	const float dy1 {y[1] - y[0]};
+	const float dx2 {x[2] - x[0]};
+	const float dy2 {y[2] - y[0]};
+	const auto plane = [&](float a0, float a1, float a2) {
+		const float d1 {a1 - a0};
+		const float d2 {a2 - a0};
+		const float a {(d1 * dy2 - d2 * dy1) * inv_area};
+		const float b {(d2 * dx1 - d1 * dx2) * inv_area};
+		return Plane {a, b, a0 - a * x[0] - b * y[0]};
+	};
+	t.depth = plane(z[0], z[1], z[2]);
+	t.inv_w = plane(inv_w[0], inv_w[1], inv_w[2]);
+	for (int c = 0; c != 4; ++c)
+		t.color[c] = plane(v[0]->color[c] * inv_w[0], v[1]->color[c] * inv_w[1], v[2]->color[c] * inv_w[2]);
+
+	const auto index = static_cast<std::uint32_t>(chunk.triangles.size());
+	chunk.triangles.push_back(t);
+
+	// tiles in the bounds that some edge keeps entirely outside are skipped,
+	// tested at the corner of each tile furthest along the edge's normal
+	const auto tile = static_cast<int>(tile_size);
+	for (int ty = t.min_y / tile; ty <= (t.max_y - 1) / tile; ++ty) {
+		for (int tx = t.min_x / tile; tx <= (t.max_x - 1) / tile; ++tx) {
+			bool touches {true};
+			for (int e = 0; e != 3 && touches; ++e) {
+				const int f {(e + 1) % 3};
+				const float a {y[e] - y[f]};
+				const float b {x[f] - x[e]};
+				const float cx {static_cast<float>(a > 0 ? (tx + 1) * tile : tx * tile)};
+				const float cy {static_cast<float>(b > 0 ? (ty + 1) * tile : ty * tile)};
+				touches = a * (cx - x[e]) + b * (cy - y[e]) >= 0;
+			}
+			if (touches)
+				chunk.bins[static_cast<size_type>(ty) * tiles_x + static_cast<size_type>(tx)].push_back(index);
+		}
+	}
+}
+
+inline void Glare::Video::Rasterizer::draw_tile(size_type tile, Tile_buffer& buffer)
+{
+	GLARE_PROFILE_ZONE("Rasterizer::draw_tile");
+
+	std::fill(buffer.depth.get(), buffer.depth.get() + tile_size * tile_size, clear_depth);
+	std::fill(buffer.color.get(), buffer.color.get() + tile_size * tile_size, clear_color);
+
+	const auto origin_x = static_cast<int>(tile % tiles_x * tile_size);
+	const auto origin_y = static_cast<int>(tile / tiles_x * tile_size);
+	for (size_type c = 0; c != chunk_count; ++c)
+		for (const auto i : chunks[c].bins[tile])
+			draw_triangle(chunks[c].triangles[i], origin_x, origin_y, buffer);
+
+	// the parts of edge tiles past the image are dropped
+	const auto ox = static_cast<size_type>(origin_x);
+	const auto oy = static_cast<size_type>(origin_y);
+	const size_type row {std::min(tile_size, w - ox)};
+	for (size_type y = 0; y != std::min(tile_size, h - oy); ++y)
+		std::memcpy(&pixels[(oy + y) * w + ox], &buffer.color[y * tile_size], row * sizeof(std::uint32_t));
+}
+
+inline void Glare::Video::Rasterizer::draw_triangle(const Triangle& t, int origin_x, int origin_y, Tile_buffer& buffer)
+{
+	using L = Impl::Lanes;
+	const auto tile = static_cast<int>(tile_size);
+
+	const int x0 {std::max(t.min_x, origin_x) - origin_x};
+	const int x1 {std::min(t.max_x, origin_x + tile) - origin_x};
+	const int y0 {std::max(t.min_y, origin_y) - origin_y};
+	const int y1 {std::min(t.max_y, origin_y + tile) - origin_y};
+	const int first_x {x0 / L::width * L::width};
+
+	// edges relative to the tile, where every snapped coordinate is exact
+	// an edge shared with another triangle has all three terms negated there,
+	// and each pixel is evaluated the same way, so exactly one of them covers it
+	// pixels exactly on an edge belong to the triangle if it is a top or left edge
+	const auto ox = static_cast<float>(origin_x);
+	const auto oy = static_cast<float>(origin_y);
+	float ea[3], eb[3], ec[3];
+	L::M top_left[3];
+	for (int e = 0; e != 3; ++e) {
+		const int f {(e + 1) % 3};
+		const float xe {t.x[e] - ox};
+		const float ye {t.y[e] - oy};
+		const float xf {t.x[f] - ox};
+		const float yf {t.y[f] - oy};
+		ea[e] = ye - yf;
+		eb[e] = xf - xe;
+		ec[e] = xe * yf - xf * ye;
+		top_left[e] = L::mask(ea[e] > 0 || (ea[e] == 0 && eb[e] < 0));
+	}
+
+	const auto relative = [&](const Plane& p) {
+		return Plane {p.a, p.b, p.c + p.a * ox + p.b * oy};
+	};
+	const Plane depth {relative(t.depth)};
+	const Plane inv_w {relative(t.inv_w)};
+	const Plane color[4] {relative(t.color[0]), relative(t.color[1]), relative(t.color[2]), relative(t.color[3])};
+
+	const L::F zero {L::set(0)};
+	for (int y = y0; y != y1; ++y) {
+		const float qy {static_cast<float>(y) + 0.5f};
+		float row[3];
+		for (int e = 0; e != 3; ++e)
+			row[e] = eb[e] * qy + ec[e];
+
+		float* depth_row {&buffer.depth[static_cast<size_type>(y) * tile_size]};
+		std::uint32_t* color_row {&buffer.color[static_cast<size_type>(y) * tile_size]};
+
+		for (int x = first_x; x < x1; x += L::width) {
+			const L::F qx {L::add(L::set(static_cast<float>(x) + 0.5f), L::steps())};
+
+			L::M inside {L::mask(true)};
+			for (int e = 0; e != 3; ++e) {
+				const L::F d {L::add(L::mul(L::set(ea[e]), qx), L::set(row[e]))};
+				inside = L::both(inside, L::either(L::greater(d, zero), L::both(L::equal(d, zero), top_left[e])));
+			}
+			if (!L::any(inside))
+				continue;
+
+			const L::F z {L::add(L::mul(L::set(depth.a), qx), L::set(depth.b * qy + depth.c))};
+			const L::F old_z {L::load(depth_row + x)};
+			const L::M pass {L::both(inside, L::less(z, old_z))};
+			if (!L::any(pass))
+				continue;
+			L::store(depth_row + x, L::select(pass, z, old_z));
+
+			const L::F iw {L::add(L::mul(L::set(inv_w.a), qx), L::set(inv_w.b * qy + inv_w.c))};
+			const L::F scale {L::div(L::set(255), iw)};
+			L::F channel[4];
+			for (int c = 0; c != 4; ++c) {
+				const L::F over_w {L::add(L::mul(L::set(color[c].a), qx), L::set(color[c].b * qy + color[c].c))};
+				channel[c] = L::clamp(L::mul(over_w, scale), 0, 255);
+			}
+			const L::I packed {L::pack(channel[0], channel[1], channel[2], channel[3])};
+			L::store(color_row + x, L::select(pass, packed, L::load(color_row + x)));
+		}
+	}
+}
+
+inline void Glare::Video::Rasterizer::finish()
+{
+	triangles = 0;
+	for (size_type c = 0; c != chunk_count; ++c)
+		triangles += chunks[c].triangles.size();
+
+	draws.clear();
+	queued = 0;
+	queued_vertices = 0;
+}
+
 #endif // !GLARE_VIDEO_HPP
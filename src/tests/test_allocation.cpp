@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+#include "../glare/slot_map.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+// every global allocation in the test binary goes through here,
+// so tests can check that a piece of code does not allocate
+namespace {
+	std::atomic<std::size_t> allocations {0};
+
+	void* counted_alloc(std::size_t n)
+	{
+		++allocations;
+		if (void* p = std::malloc(n ? n : 1)) return p;
+		throw std::bad_alloc {};
+	}
+
+	void* counted_alloc(std::size_t n, std::align_val_t al)
+	{
+		++allocations;
+		const std::size_t a {static_cast<std::size_t>(al)};
+		// aligned_alloc wants the size to be a nonzero multiple of the alignment
+		const std::size_t size {n ? (n + a - 1) / a * a : a};
+#ifdef _MSC_VER
+		if (void* p = _aligned_malloc(size, a)) return p;
+#else
+		if (void* p = std::aligned_alloc(a, size)) return p;
+#endif
+		throw std::bad_alloc {};
+	}
+
+	void aligned_free(void* p)
+	{
+#ifdef _MSC_VER
+		_aligned_free(p);
+#else
+		std::free(p);
+#endif
+	}
+}
+
+// the whole set is replaced so every new has a matching delete,
+// sized and array forms all forward to the plain ones
+void* operator new(std::size_t n) { return counted_alloc(n); }
+void* operator new[](std::size_t n) { return counted_alloc(n); }
+void* operator new(std::size_t n, std::align_val_t al) { return counted_alloc(n, al); }
+void* operator new[](std::size_t n, std::align_val_t al) { return counted_alloc(n, al); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { ::operator delete(p); }
+void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete(void* p, std::align_val_t) noexcept { aligned_free(p); }
+void operator delete[](void* p, std::align_val_t al) noexcept { ::operator delete(p, al); }
+void operator delete(void* p, std::size_t, std::align_val_t al) noexcept { ::operator delete(p, al); }
+void operator delete[](void* p, std::size_t, std::align_val_t al) noexcept { ::operator delete(p, al); }
+
+namespace {
+	// deterministic and allocation free
+	struct Lcg {
+		std::uint32_t next() { return state = state * 1664525u + 1013904223u; }
+		std::uint32_t state {1};
+	};
+
+	// one frame of a typical game loop: some elements die, as many are born
+	// and everything is updated, returns the number of allocations made
+	template<typename Map>
+	std::size_t simulate_frame(Map& sm, std::vector<typename Map::Stable_index>& live, Lcg& rng)
+	{
+		const std::size_t before {allocations};
+
+		for (int i = 0; i < 50; ++i) {
+			auto& p = live[rng.next() % live.size()];
+			sm.buffered_remove(p);
+			p = sm.buffered_add(static_cast<int>(i));
+		}
+		for (auto& x : sm) ++x;
+		sm.clean_buffers();
+
+		return allocations - before;
+	}
+}
+
+TEST(Allocation, SlotMapSteadyState)
+{
+	Glare::Slot_map<int> sm;
+	std::vector<Glare::Slot_map<int>::Stable_index> live;
+	for (int i = 0; i < 1000; ++i)
+		live.push_back(sm.add(i));
+	Lcg rng;
+
+	for (int frame = 0; frame < 10; ++frame)
+		simulate_frame(sm, live, rng); // warm up
+
+	for (int frame = 0; frame < 100; ++frame)
+		ASSERT_EQ(simulate_frame(sm, live, rng), 0) << "frame " << frame;
+}
+
+TEST(Allocation, PmrSlotMapFromPool)
+{
+	// allocated up front, anything that spills upstream is counted below
+	Glare::Utility::Block_pool pool {64 * 1024, 16};
+	Glare::Pmr::Slot_map<int> sm {&pool};
+	std::vector<Glare::Pmr::Slot_map<int>::Stable_index> live;
+	live.reserve(1000);
+	Lcg rng;
+
+	const std::size_t before {allocations};
+	for (int i = 0; i < 1000; ++i)
+		live.push_back(sm.add(i));
+	for (int frame = 0; frame < 100; ++frame)
+		simulate_frame(sm, live, rng);
+
+	EXPECT_EQ(allocations - before, 0);
+	EXPECT_LT(pool.free_blocks(), 16);
+	EXPECT_EQ(sm.get_allocator().resource(), &pool);
+}
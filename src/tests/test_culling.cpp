@@ -0,0 +1,192 @@
+#include "gtest/gtest.h"
+#include "../glare/culling.hpp"
+#include "../glare/ecs.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+using Glare::Math::Aabb;
+using Glare::Math::Mat4;
+using Glare::Math::Sphere;
+
+namespace {
+	using Spheres = Glare::Slot_map<Sphere>;
+	using Sphere_culler = Glare::Scene::Culler<Spheres::Stable_index>;
+
+	// looking down -z from z = 100, with the eye there too
+	const Mat4 to_clip {Mat4::perspective(1.0f, 1.5f, 1, 150) * Mat4::translation(0, 0, -100)};
+	constexpr float eye[3] {0, 0, 100};
+	const std::vector<float> lod_distances {40, 80, 120};
+
+	float distance(const float* a, const float* b)
+	{
+		float d {0};
+		for (int i = 0; i != 3; ++i)
+			d += (a[i] - b[i]) * (a[i] - b[i]);
+		return d;
+	}
+
+	// the level of detail, or -1 if culled, by testing planes one object at a time
+	template<typename Reach>
+	int expected(const float* centre, Reach reach, float radius, float max_distance)
+	{
+		const auto f = Glare::Math::frustum(to_clip);
+		for (const auto& p : f.planes)
+			if (((p[0] * centre[0] + p[1] * centre[1]) + p[2] * centre[2]) + p[3] + reach(p) < 0)
+				return -1;
+
+		const float squared {distance(centre, eye)};
+		if (squared > (max_distance + radius) * (max_distance + radius))
+			return -1;
+		int lod {0};
+		for (const float d : lod_distances)
+			lod += squared >= d * d;
+		return lod;
+	}
+
+	std::vector<Sphere> random_spheres(std::size_t n, unsigned seed)
+	{
+		std::mt19937 rng {seed};
+		std::uniform_real_distribution<float> position {-100, 100};
+		std::uniform_real_distribution<float> radius {0.1f, 4};
+		std::vector<Sphere> s;
+		for (std::size_t i = 0; i != n; ++i)
+			s.push_back({{position(rng), position(rng), position(rng)}, radius(rng)});
+		return s;
+	}
+
+	template<typename Culler>
+	void set_view(Culler& c, float max_distance)
+	{
+		c.set_view(to_clip, eye);
+		c.set_lod_distances({lod_distances.data(), lod_distances.size()});
+		c.set_max_distance(max_distance);
+	}
+}
+
+TEST(Culling, Spheres)
+{
+	// not a whole number of batches, with a gap where some were removed
+	Spheres spheres;
+	std::vector<Spheres::Stable_index> handles;
+	for (const auto& s : random_spheres(5003, 1))
+		handles.push_back(spheres.add(s));
+	for (std::size_t i = 0; i < handles.size(); i += 5)
+		spheres.remove(handles[i]);
+
+	for (const float max_distance : {std::numeric_limits<float>::infinity(), 90.0f}) {
+		Sphere_culler culler;
+		set_view(culler, max_distance);
+		std::vector<Sphere_culler::Visible> out(spheres.size());
+		const auto n = culler.cull(spheres, {out.data(), out.size()});
+
+		std::size_t visible {0};
+		for (auto it = spheres.begin(); it != spheres.end(); ++it) {
+			const int lod {expected(it->centre, [&](const float*) { return it->radius; }, it->radius, max_distance)};
+			if (lod < 0)
+				continue;
+			ASSERT_LT(visible, n);
+			EXPECT_TRUE(out[visible].handle == Spheres::Stable_index(it));
+			EXPECT_EQ(out[visible].lod, lod);
+			++visible;
+		}
+		EXPECT_EQ(n, visible);
+		EXPECT_GT(n, 100);
+		EXPECT_LT(n, spheres.size() / 2);
+	}
+
+	// sees everything without a view
+	Sphere_culler all;
+	EXPECT_EQ(all.cull(spheres, {}), spheres.size());
+
+	Sphere_culler culler;
+	const std::vector<float> too_many(Sphere_culler::max_lods, 1);
+	EXPECT_THROW(culler.set_lod_distances({too_many.data(), too_many.size()}), Sphere_culler::Too_many_lods);
+}
+
+TEST(Culling, BoxesInView)
+{
+	struct Tag {};
+	using Manager = Glare::Ecs::Entity_manager<Aabb, Tag>;
+	using Culler = Glare::Scene::Culler<Manager::Entity, Aabb>;
+
+	// in two archetypes
+	Manager em;
+	std::vector<std::pair<Manager::Entity, Aabb>> boxes;
+	std::mt19937 rng {2};
+	std::uniform_real_distribution<float> position {-100, 100};
+	std::uniform_real_distribution<float> extent {0.1f, 6};
+	for (int i = 0; i != 3001; ++i) {
+		Aabb b;
+		for (int a = 0; a != 3; ++a) {
+			b.min[a] = position(rng);
+			b.max[a] = b.min[a] + extent(rng);
+		}
+		boxes.push_back({i % 3 ? em.create(Aabb {b}) : em.create(Aabb {b}, Tag {}), b});
+	}
+
+	Culler culler;
+	set_view(culler, 110);
+	std::vector<Culler::Visible> out(boxes.size());
+	const auto n = culler.cull(em.view<const Aabb>(), {out.data(), out.size()});
+
+	std::vector<std::pair<Manager::Entity, int>> visible;
+	for (const auto& [e, b] : boxes) {
+		float centre[3], half[3];
+		for (int a = 0; a != 3; ++a) {
+			centre[a] = (b.min[a] + b.max[a]) * 0.5f;
+			half[a] = (b.max[a] - b.min[a]) * 0.5f;
+		}
+		const auto reach = [&](const float* p) {
+			return (std::abs(p[0]) * half[0] + std::abs(p[1]) * half[1]) + std::abs(p[2]) * half[2];
+		};
+		const int lod {expected(centre, reach, std::sqrt(distance(half, std::array<float, 3> {}.data())), 110)};
+		if (lod >= 0)
+			visible.push_back({e, lod});
+	}
+
+	ASSERT_EQ(n, visible.size());
+	EXPECT_GT(n, 200);
+	for (const auto& v : visible) {
+		const auto found = std::find_if(out.begin(), out.begin() + n, [&](const Culler::Visible& x) { return x.handle == v.first; });
+		ASSERT_NE(found, out.begin() + n);
+		EXPECT_EQ(found->lod, v.second);
+	}
+}
+
+TEST(Culling, ParallelMatchesSerial)
+{
+	// several chunks, the last not full
+	Spheres spheres;
+	for (const auto& s : random_spheres(Sphere_culler::chunk_size * 3 + 77, 3))
+		spheres.add(s);
+
+	Sphere_culler serial;
+	set_view(serial, 1000);
+	std::vector<Sphere_culler::Visible> expect(spheres.size());
+	const auto n = serial.cull(spheres, {expect.data(), expect.size()});
+
+	Glare::Utility::Job_system jobs {3};
+	Sphere_culler parallel;
+	set_view(parallel, 1000);
+	std::vector<Sphere_culler::Visible> out(spheres.size());
+	for (int frame = 0; frame != 2; ++frame) {
+		ASSERT_EQ(parallel.cull(jobs, spheres, {out.data(), out.size()}), n);
+		for (std::size_t i = 0; i != n; ++i) {
+			EXPECT_TRUE(out[i].handle == expect[i].handle);
+			EXPECT_EQ(out[i].lod, expect[i].lod);
+		}
+	}
+
+	// only as many as fit are written
+	std::vector<Sphere_culler::Visible> few(n / 2);
+	EXPECT_EQ(parallel.cull(jobs, spheres, {few.data(), few.size()}), n);
+	for (std::size_t i = 0; i != few.size(); ++i)
+		EXPECT_TRUE(few[i].handle == expect[i].handle);
+}
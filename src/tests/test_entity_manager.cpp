@@ -1,11 +1,367 @@
 #include "gtest/gtest.h"
 #include "../glare/ecs.hpp"
 
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 struct Test1 {};
 struct Test2 {};
 struct Test3 {};
 
+struct Position {
+	float x, y;
+};
+
+struct Velocity {
+	float x, y;
+};
+
+struct Name {
+	std::string value;
+};
+
+using Manager = Glare::Ecs::Entity_manager<Position, Velocity, Name>;
+
 TEST(EntityManager, Constructor)
 {
 	Glare::Ecs::Entity_manager<Test1, Test2, Test3> em;
+	EXPECT_EQ(em.size(), 0);
+}
+
+TEST(EntityManager, CreateDestroy)
+{
+	Manager em;
+	auto e1 = em.create();
+	auto e2 = em.create(Position {1, 2});
+	EXPECT_TRUE(em.is_valid(e1));
+	EXPECT_TRUE(em.is_valid(e2));
+	EXPECT_NE(e1, e2);
+	EXPECT_EQ(em.size(), 2);
+
+	em.destroy(e1);
+	EXPECT_FALSE(em.is_valid(e1));
+	EXPECT_TRUE(em.is_valid(e2));
+	EXPECT_EQ(em.get<Position>(e2).y, 2);
+	EXPECT_EQ(em.size(), 1);
+
+	em.destroy(e1); // ignored
+	EXPECT_EQ(em.size(), 1);
+
+	EXPECT_FALSE(em.is_valid(Manager::Entity {}));
+	EXPECT_THROW(em.get<Position>(e1), Manager::Not_valid);
+}
+
+TEST(EntityManager, AddRemoveComponent)
+{
+	Manager em;
+	auto e = em.create(Name {"a"});
+	EXPECT_TRUE(em.has<Name>(e));
+	EXPECT_FALSE(em.has<Position>(e));
+	EXPECT_EQ(em.try_get<Position>(e), nullptr);
+	EXPECT_THROW(em.get<Position>(e), Manager::Missing_component);
+
+	em.add<Position>(e, 3.0f, 4.0f);
+	em.add<Velocity>(e, 1.0f, 0.0f);
+	EXPECT_TRUE(em.has<Position>(e));
+	EXPECT_EQ(em.get<Position>(e).x, 3);
+	EXPECT_EQ(em.get<Name>(e).value, "a"); // moved along with the entity
+
+	em.add<Position>(e, 5.0f, 6.0f); // replaces
+	EXPECT_EQ(em.get<Position>(e).x, 5);
+
+	em.remove<Position>(e);
+	EXPECT_FALSE(em.has<Position>(e));
+	EXPECT_EQ(em.get<Velocity>(e).x, 1);
+	EXPECT_EQ(em.get<Name>(e).value, "a");
+
+	em.remove<Position>(e); // ignored
+	EXPECT_TRUE(em.has<Velocity>(e));
+}
+
+TEST(EntityManager, SwapRemoveKeepsOthers)
+{
+	Manager em;
+	std::vector<Manager::Entity> v;
+	for (int i = 0; i != 100; ++i)
+		v.push_back(em.create(Position {static_cast<float>(i), 0}));
+
+	for (int i = 0; i < 100; i += 3)
+		em.destroy(v[i]);
+	for (int i = 1; i < 100; i += 3)
+		em.add<Velocity>(v[i], 0.0f, static_cast<float>(i));
+
+	for (int i = 0; i != 100; ++i) {
+		if (i % 3 == 0) {
+			EXPECT_FALSE(em.is_valid(v[i]));
+			continue;
+		}
+		EXPECT_EQ(em.get<Position>(v[i]).x, i);
+		if (i % 3 == 1)
+			EXPECT_EQ(em.get<Velocity>(v[i]).y, i);
+		else
+			EXPECT_FALSE(em.has<Velocity>(v[i]));
+	}
+}
+
+TEST(EntityManager, View)
+{
+	Manager em;
+	std::vector<Manager::Entity> moving;
+	for (int i = 0; i != 10; ++i) {
+		em.create(Position {0, 0});
+		moving.push_back(em.create(Position {0, 0}, Velocity {1, 2}));
+		em.create(Position {0, 0}, Velocity {1, 2}, Name {"x"});
+		em.create(Velocity {1, 2});
+	}
+	EXPECT_EQ(em.archetype_count(), 5); // including the empty one
+
+	auto v = em.view<Position, const Velocity>();
+	EXPECT_EQ(v.size(), 20);
+
+	int n = 0;
+	v.each([&](Position& p, const Velocity& vel) {
+		p.x += vel.x;
+		p.y += vel.y;
+		++n;
+	});
+	EXPECT_EQ(n, 20);
+
+	for (auto e : moving)
+		EXPECT_EQ(em.get<Position>(e).y, 2);
+
+	n = 0;
+	em.view<Name>().each([&](Manager::Entity e, Name& name) {
+		EXPECT_TRUE(em.has<Velocity>(e));
+		EXPECT_EQ(name.value, "x");
+		++n;
+	});
+	EXPECT_EQ(n, 10);
+
+	EXPECT_EQ(em.view<>().size(), 40);
+}
+
+TEST(EntityManager, MoveOnlyComponent)
+{
+	Glare::Ecs::Entity_manager<std::unique_ptr<int>, Position> em;
+	auto e = em.create(std::make_unique<int>(7));
+	em.add<Position>(e);
+	EXPECT_EQ(*em.get<std::unique_ptr<int>>(e), 7);
+	em.remove<Position>(e);
+	EXPECT_EQ(*em.get<std::unique_ptr<int>>(e), 7);
+}
+
+// throws when moved while *fail is set
+struct Fragile {
+	explicit Fragile(const bool* fail) :fail {fail} {}
+	Fragile(Fragile&& x) :fail {x.fail} { if (*fail) throw std::runtime_error("Fragile moved"); }
+	Fragile& operator=(Fragile&&) = default;
+
+	const bool* fail;
+};
+
+TEST(EntityManager, CreateThrowingComponent)
+{
+	Glare::Ecs::Entity_manager<Position, Velocity, Fragile> em;
+	bool fail {false};
+	const auto e = em.create(Position {1, 1}, Fragile {&fail});
+
+	// Position is already in its column when Fragile throws
+	fail = true;
+	EXPECT_THROW(em.create(Position {2, 2}, Fragile {&fail}), std::runtime_error);
+	fail = false;
+	EXPECT_EQ(em.size(), 1);
+
+	const auto f = em.create(Position {3, 3}, Fragile {&fail});
+	std::vector<float> xs;
+	em.view<const Position, const Fragile>().each([&](const Position& p, const Fragile&) { xs.push_back(p.x); });
+	EXPECT_EQ(xs, (std::vector<float> {1, 3}));
+	em.destroy(e);
+	EXPECT_EQ(em.get<Position>(f).x, 3);
+}
+
+TEST(EntityManager, AddThrowingMove)
+{
+	Glare::Ecs::Entity_manager<Position, Velocity, Fragile> em;
+	bool fail {false};
+	const auto e = em.create(Position {1, 1}, Fragile {&fail});
+
+	// Velocity is in the new archetype when moving Fragile there throws
+	fail = true;
+	EXPECT_THROW(em.add<Velocity>(e, Velocity {2, 2}), std::runtime_error);
+	fail = false;
+	EXPECT_FALSE(em.has<Velocity>(e));
+	EXPECT_EQ(em.get<Position>(e).x, 1);
+
+	em.add<Velocity>(e, Velocity {3, 3});
+	int count {0};
+	em.view<const Position, const Velocity, const Fragile>().each(
+		[&](const Position& p, const Velocity& v, const Fragile&) {
+			EXPECT_EQ(p.x, 1);
+			EXPECT_EQ(v.x, 3);
+			++count;
+		});
+	EXPECT_EQ(count, 1);
+}
+
+struct Transform {
+	float x;
+};
+
+template<>
+struct Glare::Ecs::Track_changes<Transform> : std::true_type {};
+
+TEST(EntityManager, ChangeDetection)
+{
+	using Tracked = Glare::Ecs::Entity_manager<Transform, Position, Velocity>;
+	Tracked em;
+	std::vector<Tracked::Entity> v;
+	for (int i = 0; i != 10; ++i)
+		v.push_back(em.create(Transform {0}, Position {0, 0}));
+	EXPECT_EQ(em.view<const Transform>().added<Transform>().size(), 10);
+
+	const auto start = em.next_tick();
+	EXPECT_EQ(em.view<const Transform>().changed<Transform>().size(), 0);
+
+	em.get<Transform>(v[2]).x = 1;
+	em.mark_changed<Transform>(v[4]);
+	em.add<Velocity>(v[4], 1.0f, 1.0f); // moves the ticks along with the entity
+	static_cast<const Tracked&>(em).get<Transform>(v[6]); // not a change
+	em.destroy(v[0]); // moves the last entity into its row
+	const auto e = em.create(Position {0, 0});
+	em.add<Transform>(e, 5.0f);
+
+	std::vector<Tracked::Entity> changed;
+	em.view<const Transform>().changed<Transform>().each([&](Tracked::Entity x, const Transform&) {
+		changed.push_back(x);
+	});
+	ASSERT_EQ(changed.size(), 3);
+	EXPECT_EQ(changed[0], v[2]);
+	EXPECT_EQ(changed[1], e);
+	EXPECT_EQ(changed[2], v[4]);
+	EXPECT_EQ(em.view<const Transform>().added<Transform>().size(), 1);
+	EXPECT_EQ(em.view<const Transform>().changed<Transform>(start - 2).size(), 10); // everything since before the first tick
+
+	// a mutable view stamps what it visits
+	em.next_tick();
+	em.view<Transform, const Velocity>().each([](Transform& t, const Velocity& vel) { t.x += vel.x; });
+	EXPECT_EQ(em.view<const Transform>().changed<Transform>().size(), 1);
+	EXPECT_EQ(em.view<Position>().changed<Transform>().size(), 1);
+}
+
+using Sparse_manager = Glare::Ecs::Sparse_entity_manager<Position, Velocity, Name>;
+
+TEST(SparseSet, EmplaceRemove)
+{
+	Glare::Ecs::Sparse_set<int> s;
+	s.emplace(5, 50);
+	s.emplace(2, 20);
+	s.emplace(9, 90);
+	EXPECT_TRUE(s.contains(2));
+	EXPECT_FALSE(s.contains(3));
+	EXPECT_FALSE(s.contains(100));
+	EXPECT_EQ(s.size(), 3);
+
+	s.remove(5);
+	EXPECT_FALSE(s.contains(5));
+	EXPECT_EQ(s.get(2), 20);
+	EXPECT_EQ(s.get(9), 90);
+	EXPECT_EQ(s.position(9), 0); // moved into the gap
+
+	s.swap_positions(0, 1);
+	EXPECT_EQ(s.ids()[0], 2);
+	EXPECT_EQ(s.values()[0], 20);
+	EXPECT_EQ(s.get(9), 90);
+}
+
+TEST(SparseEntityManager, CreateDestroy)
+{
+	Sparse_manager em;
+	auto e1 = em.create(Position {1, 2});
+	auto e2 = em.create(Position {3, 4}, Velocity {0, 1});
+	EXPECT_EQ(em.size(), 2);
+
+	em.destroy(e1);
+	EXPECT_FALSE(em.is_valid(e1));
+	EXPECT_EQ(em.get<Position>(e2).x, 3);
+	EXPECT_EQ(em.pool<Position>().size(), 1);
+	EXPECT_THROW(em.get<Position>(e1), Sparse_manager::Not_valid);
+
+	auto e3 = em.create(); // reuses the slot of e1
+	EXPECT_NE(e1, e3);
+	EXPECT_FALSE(em.is_valid(e1));
+	EXPECT_FALSE(em.has<Position>(e3));
+	EXPECT_THROW(em.get<Position>(e3), Sparse_manager::Missing_component);
+}
+
+TEST(SparseEntityManager, AddRemoveComponent)
+{
+	Sparse_manager em;
+	auto e = em.create(Name {"a"});
+	em.add<Position>(e, 1.0f, 2.0f);
+	EXPECT_EQ(em.get<Position>(e).y, 2);
+	em.add<Position>(e, 3.0f, 4.0f);
+	EXPECT_EQ(em.get<Position>(e).y, 4);
+
+	em.remove<Position>(e);
+	EXPECT_EQ(em.try_get<Position>(e), nullptr);
+	EXPECT_EQ(em.get<Name>(e).value, "a");
+}
+
+namespace {
+	// checks that the members of the group come first in every owned pool,
+	// in the same order
+	void check_group(const Sparse_manager& em, std::size_t members)
+	{
+		const auto p = em.pool<Position>().ids();
+		const auto v = em.pool<Velocity>().ids();
+		ASSERT_GE(p.size(), members);
+		ASSERT_GE(v.size(), members);
+		for (std::size_t i = 0; i != members; ++i)
+			EXPECT_EQ(p[i], v[i]);
+	}
+}
+
+TEST(SparseEntityManager, Group)
+{
+	Sparse_manager em;
+	std::vector<Sparse_manager::Entity> moving;
+	for (int i = 0; i != 10; ++i) {
+		em.create(Position {0, 0});
+		em.create(Velocity {1, 1});
+		moving.push_back(em.create(Position {0, 0}, Velocity {1, 2}));
+	}
+
+	EXPECT_FALSE((em.view<Position, const Velocity>().is_grouped()));
+	EXPECT_EQ((em.view<Position, const Velocity>().size()), 10);
+
+	auto g = em.group<Position, Velocity>();
+	EXPECT_TRUE((em.view<Position, const Velocity>().is_grouped()));
+	EXPECT_FALSE((em.view<Position>().is_grouped()));
+	EXPECT_EQ(g.size(), 10);
+	check_group(em, 10);
+
+	// joining and leaving the group keeps it packed
+	auto e = em.create(Position {0, 0});
+	em.add<Velocity>(e, 1.0f, 2.0f);
+	moving.push_back(e);
+	em.remove<Velocity>(moving[3]);
+	em.destroy(moving[5]);
+	em.create(Position {0, 0}, Velocity {1, 2}, Name {"c"});
+	EXPECT_EQ(g.size(), 10);
+	check_group(em, 10);
+
+	int n = 0;
+	em.view<Position, const Velocity>().each([&](Sparse_manager::Entity x, Position& p, const Velocity& v) {
+		EXPECT_TRUE(em.is_valid(x));
+		p.y += v.y;
+		++n;
+	});
+	EXPECT_EQ(n, 10);
+	EXPECT_EQ(em.get<Position>(e).y, 2);
+	EXPECT_EQ(em.get<Position>(moving[3]).y, 0);
+
+	EXPECT_NO_THROW((em.group<Position, Velocity>()));
+	EXPECT_THROW((em.group<Position, Name>()), Sparse_manager::Group_conflict);
 }
@@ -0,0 +1,147 @@
+#include "gtest/gtest.h"
+#include "../glare/history.hpp"
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace {
+	template<typename Map>
+	void expect_same(Map a, Map b)
+	{
+		ASSERT_EQ(a.size(), b.size());
+		ASSERT_EQ(a.slot_count(), b.slot_count());
+		auto j = b.begin();
+		for (auto i = a.begin(); i != a.end(); ++i, ++j)
+			ASSERT_EQ(*i, *j);
+
+		// the same slots are handed out next
+		EXPECT_EQ(a.add(-1), b.add(-1));
+	}
+
+	// adds, removes and changes a few elements
+	template<typename Map>
+	void step(Map& sm, std::vector<typename Map::Stable_index>& handles, std::mt19937& rng)
+	{
+		for (int k = 0; k != 20; ++k) {
+			const auto roll = rng() % 4;
+			if (roll == 0 || handles.empty()) {
+				handles.push_back(sm.add(static_cast<int>(rng() % 1000)));
+			} else {
+				const std::size_t i {rng() % handles.size()};
+				if (roll == 1) {
+					sm.remove(handles[i]);
+					handles[i] = handles.back();
+					handles.pop_back();
+				} else {
+					sm[handles[i]] = static_cast<int>(rng() % 1000);
+				}
+			}
+		}
+	}
+}
+
+TEST(History, RestoreAnyFrame)
+{
+	using Map = Glare::Slot_map<int>;
+	Map sm;
+	std::vector<Map::Stable_index> handles;
+	for (int i = 0; i != 500; ++i)
+		handles.push_back(sm.add(i));
+
+	Glare::Snapshot::History<Map> history {8, 1 << 20};
+	std::vector<Map> states;
+	std::mt19937 rng {1};
+	for (Glare::Snapshot::History<Map>::Frame f = 0; f != 12; ++f) {
+		step(sm, handles, rng);
+		history.record(sm, f);
+		states.push_back(sm);
+	}
+
+	EXPECT_EQ(history.size(), 8);
+	EXPECT_EQ(history.oldest(), 4);
+	EXPECT_EQ(history.newest(), 11);
+	EXPECT_FALSE(history.contains(3));
+	EXPECT_THROW(history.record(sm, 11), Glare::Snapshot::History<Map>::Frame_order);
+
+	// back a little, then further back
+	history.restore(sm, 9);
+	expect_same(sm, states[9]);
+	EXPECT_EQ(history.newest(), 9);
+	EXPECT_FALSE(history.contains(10));
+
+	Map copy {sm};
+	history.restore(sm, 5);
+	expect_same(sm, states[5]);
+
+	// and on from there
+	history.restore(sm, 5);
+	expect_same(sm, states[5]);
+	history.record(sm, 6);
+	history.restore(sm, 4);
+	expect_same(sm, states[4]);
+	EXPECT_THROW(history.restore(sm, 9), Glare::Snapshot::History<Map>::Frame_not_found);
+}
+
+TEST(History, Events)
+{
+	using Map = Glare::Slot_map<int>;
+	Map sm;
+	auto a = sm.add(1);
+	auto b = sm.add(2);
+
+	Glare::Snapshot::History<Map> history {4, 4096};
+	history.record(sm, 0);
+	sm.remove(a);
+	auto c = sm.add(3); // reuses the slot of a
+	history.record(sm, 1);
+	sm[b] = 5;
+	history.record(sm, 2);
+
+	EXPECT_THROW(history.added(0), Glare::Snapshot::History<Map>::Frame_not_found);
+	ASSERT_EQ(history.added(1).size(), 1);
+	EXPECT_EQ(history.added(1)[0], c);
+	ASSERT_EQ(history.removed(1).size(), 1);
+	EXPECT_EQ(history.removed(1)[0], a);
+	EXPECT_EQ(history.added(2).size(), 0);
+	EXPECT_EQ(history.removed(2).size(), 0);
+
+	history.restore(sm, 0);
+	EXPECT_TRUE(sm.is_valid(a));
+	EXPECT_FALSE(sm.is_valid(c));
+	EXPECT_EQ(sm[b], 2);
+}
+
+TEST(History, FixedMemory)
+{
+	using Map = Glare::Paged_slot_map<int, 64>;
+	Map sm;
+	std::vector<Map::Stable_index> handles;
+	for (int i = 0; i != 10000; ++i)
+		handles.push_back(sm.add(i));
+
+	// room for only a few frames of changes, so the oldest make way
+	Glare::Snapshot::History<Map> history {64, 32 * 1024};
+	std::vector<Map> states;
+	std::mt19937 rng {2};
+	for (Glare::Snapshot::History<Map>::Frame f = 0; f != 200; ++f) {
+		step(sm, handles, rng);
+		history.record(sm, f);
+		states.push_back(sm);
+		ASSERT_LE(history.bytes_used(), 32 * 1024);
+	}
+	EXPECT_LT(history.size(), 64);
+	EXPECT_EQ(history.newest(), 199);
+
+	history.restore(sm, history.oldest());
+	expect_same(sm, states[history.newest()]);
+
+	// a frame that can't fit
+	for (auto& x : sm)
+		x = -x - 1;
+	EXPECT_THROW(history.record(sm, 1000), Glare::Snapshot::History<Map>::Frame_too_large);
+
+	// buffered changes have to be cleaned first
+	sm.buffered_add(7);
+	EXPECT_THROW(history.record(sm, 1001), Glare::Snapshot::History<Map>::Pending_changes);
+}
@@ -0,0 +1,112 @@
+#include "gtest/gtest.h"
+#include "../glare/import.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using Glare::Video::Hit;
+using Glare::Video::Ray;
+using Glare::Video::Ray_tracer;
+using Glare::Video::rgba;
+
+namespace {
+	constexpr std::uint32_t red {rgba(255, 0, 0)};
+	constexpr std::uint32_t white {rgba(255, 255, 255)};
+
+	// a unit quad at z = 0 as one polygon, coloured red per vertex
+	aiMesh* quad()
+	{
+		auto m = new aiMesh;
+		m->mPrimitiveTypes = aiPrimitiveType_POLYGON;
+		m->mNumVertices = 4;
+		m->mVertices = new aiVector3D[4] {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+		m->mColors[0] = new aiColor4D[4];
+		for (unsigned i = 0; i != 4; ++i)
+			m->mColors[0][i] = aiColor4D {1, 0, 0, 1};
+		m->mNumFaces = 1;
+		m->mFaces = new aiFace[1];
+		m->mFaces[0].mNumIndices = 4;
+		m->mFaces[0].mIndices = new unsigned[4] {0, 1, 2, 3};
+		return m;
+	}
+
+	// a triangle in front of the quad with no colours, and a line that is dropped
+	aiMesh* triangle_and_line()
+	{
+		auto m = new aiMesh;
+		m->mPrimitiveTypes = aiPrimitiveType_TRIANGLE | aiPrimitiveType_LINE;
+		m->mNumVertices = 3;
+		m->mVertices = new aiVector3D[3] {{0, 0, 1}, {1, 0, 1}, {0, 1, 1}};
+		m->mNumFaces = 2;
+		m->mFaces = new aiFace[2];
+		m->mFaces[0].mNumIndices = 3;
+		m->mFaces[0].mIndices = new unsigned[3] {0, 1, 2};
+		m->mFaces[1].mNumIndices = 2;
+		m->mFaces[1].mIndices = new unsigned[2] {0, 1};
+		return m;
+	}
+
+	Hit cast(const Ray_tracer& r, float x, float y)
+	{
+		const Ray ray {{x, y, 5}, {0, 0, -1}, 100};
+		Hit hit;
+		r.intersect({&ray, 1}, {&hit, 1});
+		return hit;
+	}
+}
+
+TEST(Import, Mesh)
+{
+	aiScene scene;
+	scene.mNumMeshes = 2;
+	scene.mMeshes = new aiMesh*[2] {quad(), triangle_and_line()};
+
+	const auto q = Glare::Video::import_mesh(scene, *scene.mMeshes[0]);
+	ASSERT_EQ(q.vertices.size(), 4);
+	EXPECT_EQ(q.indices, (std::vector<std::uint32_t> {0, 1, 2, 0, 2, 3}));
+	EXPECT_EQ(q.vertices[2].position[0], 1);
+	EXPECT_EQ(q.vertices[2].color, red);
+
+	aiMatrix4x4 to_world;
+	to_world.a4 = 10; // translated along x
+	const auto t = Glare::Video::import_mesh(scene, *scene.mMeshes[1], to_world);
+	EXPECT_EQ(t.indices, (std::vector<std::uint32_t> {0, 1, 2}));
+	EXPECT_EQ(t.vertices[1].position[0], 11);
+	EXPECT_EQ(t.vertices[1].position[2], 1);
+	EXPECT_EQ(t.vertices[1].color, white);
+}
+
+TEST(Import, SceneIntoRayTracer)
+{
+	// the quad at the root, and both meshes again under a child moved along x
+	aiScene scene;
+	scene.mNumMeshes = 2;
+	scene.mMeshes = new aiMesh*[2] {quad(), triangle_and_line()};
+
+	auto child = new aiNode;
+	child->mTransformation.a4 = 10;
+	child->mNumMeshes = 2;
+	child->mMeshes = new unsigned[2] {0, 1};
+
+	scene.mRootNode = new aiNode;
+	scene.mRootNode->mNumMeshes = 1;
+	scene.mRootNode->mMeshes = new unsigned[1] {0};
+	scene.mRootNode->mNumChildren = 1;
+	scene.mRootNode->mChildren = new aiNode*[1] {child};
+	child->mParent = scene.mRootNode;
+
+	Ray_tracer r {8, 8};
+	EXPECT_EQ(Glare::Video::import_meshes(scene, r), (std::vector<Ray_tracer::size_type> {0, 1, 2}));
+	r.update();
+
+	const Hit root {cast(r, 0.75f, 0.75f)};
+	EXPECT_EQ(root.mesh, 0);
+	EXPECT_FLOAT_EQ(root.t, 5);
+
+	// the triangle is nearer than the moved quad where they overlap
+	const Hit front {cast(r, 10.25f, 0.25f)};
+	EXPECT_EQ(front.mesh, 2);
+	EXPECT_FLOAT_EQ(front.t, 4);
+	EXPECT_EQ(cast(r, 10.75f, 0.75f).mesh, 1);
+	EXPECT_EQ(cast(r, 5, 0.5f).mesh, Hit::none);
+}
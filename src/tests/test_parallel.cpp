@@ -0,0 +1,258 @@
+#include "gtest/gtest.h"
+#include "../glare/ecs.hpp"
+#include "../glare/parallel.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+	struct Position {
+		float x;
+	};
+
+	struct Velocity {
+		float x;
+	};
+
+	// throws when moved, if told to
+	struct Fragile {
+		explicit Fragile(bool fail) :fail {fail} {}
+		Fragile(Fragile&& x) :fail {x.fail} { if (fail) throw std::runtime_error("Fragile moved"); }
+		Fragile& operator=(Fragile&&) = default;
+
+		bool fail;
+	};
+}
+
+TEST(Parallel, Chunks)
+{
+	std::vector<std::pair<std::size_t, std::size_t>> chunks;
+	const auto record = [&](std::size_t begin, std::size_t end) { chunks.emplace_back(begin, end); };
+
+	// 12 byte elements starting 16 bytes into a line, so 4 elements reach the next line
+	Glare::Impl::for_each_chunk(100, 20, 16, 12, record);
+	ASSERT_EQ(chunks.size(), 4);
+	EXPECT_EQ(chunks[0], (std::pair<std::size_t, std::size_t> {0, 4}));
+	EXPECT_EQ(chunks[1], (std::pair<std::size_t, std::size_t> {4, 36})); // 32 elements are 6 lines
+	EXPECT_EQ(chunks[3], (std::pair<std::size_t, std::size_t> {68, 100}));
+
+	chunks.clear();
+	Glare::Impl::for_each_chunk(0, 20, 0, 4, record);
+	EXPECT_TRUE(chunks.empty());
+}
+
+TEST(Parallel, SlotMap)
+{
+	Glare::Slot_map<int> sm;
+	for (int i = 0; i != 10000; ++i)
+		sm.add(i);
+
+	Glare::Utility::Job_system jobs {3};
+	Glare::parallel_for_each(jobs, sm, [](int& x) { x *= 2; }, 100);
+
+	std::int64_t sum = 0;
+	for (auto x : sm)
+		sum += x;
+	EXPECT_EQ(sum, 9999LL * 10000);
+}
+
+TEST(Parallel, PagedSlotMap)
+{
+	Glare::Paged_slot_map<int, 64> sm;
+	std::vector<Glare::Paged_slot_map<int, 64>::Stable_index> v;
+	for (int i = 0; i != 1000; ++i)
+		v.push_back(sm.add(i));
+
+	Glare::Utility::Job_system jobs {2};
+	Glare::parallel_for_each(jobs, sm, [&](Glare::Paged_slot_map<int, 64>::Stable_index p, int& x) {
+		EXPECT_EQ(sm[p], x);
+		++x;
+	}, 10);
+
+	for (int i = 0; i != 1000; ++i)
+		EXPECT_EQ(sm[v[i]], i + 1);
+}
+
+TEST(Parallel, BufferedChanges)
+{
+	using Map = Glare::Slot_map<int>;
+	Map sm;
+	for (int i = 0; i != 1000; ++i)
+		sm.add(i);
+
+	Glare::Utility::Job_system jobs {3};
+	Glare::parallel_for_each(jobs, sm, [](Map::Stable_index p, int& x, Map::Buffer& b) {
+		if (x % 2)
+			b.buffered_remove(p);
+		else
+			b.buffered_add(x + 1000);
+	}, 64);
+
+	EXPECT_EQ(sm.size(), 1000); // nothing happens before clean_buffers
+	const auto stats = sm.clean_buffers();
+	EXPECT_EQ(stats.added, 500);
+	EXPECT_EQ(stats.removed, 500);
+
+	std::int64_t sum = 0;
+	for (auto x : sm)
+		sum += x;
+	EXPECT_EQ(sum, 2 * (499LL * 500) + 500 * 1000LL);
+}
+
+TEST(Parallel, CommandQueue)
+{
+	using Map = Glare::Slot_map<int>;
+	Map sm;
+	for (int i = 0; i != 100; ++i)
+		sm.add(i);
+	sm.remove(std::size_t {50});
+
+	// every job spawns from its own buffer while the others do the same
+	Glare::Utility::Job_system jobs {3};
+	Map::Command_queue commands {sm, 8};
+	std::vector<std::vector<Map::Stable_index>> spawned(commands.buffer_count());
+	std::atomic<std::size_t> pending {commands.buffer_count()};
+	for (std::size_t i = 0; i != commands.buffer_count(); ++i) {
+		jobs.submit([&, i] {
+			for (int j = 0; j != 1000; ++j)
+				spawned[i].push_back(commands.buffer(i).buffered_add(static_cast<int>(i * 1000 + j)));
+			pending.fetch_sub(1);
+		});
+	}
+	jobs.wait(pending);
+
+	commands.commit();
+	sm.clean_buffers();
+	ASSERT_EQ(sm.size(), 8099);
+
+	// every handle is distinct and refers to its own element,
+	// and the elements are in buffer order whatever the timing
+	for (std::size_t i = 0; i != spawned.size(); ++i)
+		for (int j = 0; j != 1000; ++j)
+			EXPECT_EQ(sm[spawned[i][j]], static_cast<int>(i * 1000 + j));
+	for (int i = 0; i != 8000; ++i)
+		EXPECT_EQ(sm[99 + i], i);
+	EXPECT_EQ(sm.slot_count(), 8099); // one freed slot reused
+}
+
+TEST(Parallel, EntityCommandQueue)
+{
+	using Manager = Glare::Ecs::Entity_manager<Position, Velocity>;
+	Manager em;
+	const auto old = em.create(Position {-1});
+
+	Glare::Utility::Job_system jobs {3};
+	Manager::Command_queue commands {em, 4};
+	std::vector<std::vector<Manager::Entity>> spawned(commands.buffer_count());
+	std::atomic<std::size_t> pending {commands.buffer_count()};
+	for (std::size_t i = 0; i != commands.buffer_count(); ++i) {
+		jobs.submit([&, i] {
+			auto& b = commands.buffer(i);
+			for (int j = 0; j != 100; ++j) {
+				const float x {static_cast<float>(i * 100 + j)};
+				spawned[i].push_back(j % 2 ? b.create(Position {x}, Velocity {x}) : b.create(Position {x}));
+			}
+			b.destroy(spawned[i][0]); // created and destroyed in the same round
+			if (i == 0)
+				b.destroy(old);
+			pending.fetch_sub(1);
+		});
+	}
+	jobs.wait(pending);
+	EXPECT_EQ(em.size(), 1);
+
+	commands.commit();
+	EXPECT_EQ(em.size(), 396);
+	EXPECT_FALSE(em.is_valid(old));
+
+	for (std::size_t i = 0; i != spawned.size(); ++i) {
+		EXPECT_FALSE(em.is_valid(spawned[i][0]));
+		for (int j = 1; j != 100; ++j) {
+			const auto e = spawned[i][j];
+			ASSERT_TRUE(em.is_valid(e));
+			EXPECT_EQ(em.get<Position>(e).x, i * 100 + j);
+			EXPECT_EQ(em.has<Velocity>(e), j % 2 == 1);
+		}
+	}
+
+	// components of each archetype are laid out in buffer order
+	float last {-1};
+	em.view<const Position, const Velocity>().each([&](const Position& p, const Velocity& v) {
+		EXPECT_EQ(p.x, v.x);
+		EXPECT_GT(p.x, last);
+		last = p.x;
+	});
+}
+
+TEST(Parallel, EntityCommandQueueThrowingComponent)
+{
+	using Manager = Glare::Ecs::Entity_manager<Position, Velocity, Fragile>;
+	Manager em;
+	Manager::Command_queue commands {em, 1};
+	auto& b = commands.buffer(0);
+
+	// Position is already in its column when Fragile throws
+	EXPECT_THROW(b.create(Position {1}, Fragile {true}), std::runtime_error);
+	const auto e = b.create(Position {2}, Velocity {3});
+	const auto f = b.create(Fragile {false});
+
+	commands.commit();
+	EXPECT_EQ(em.size(), 2);
+	ASSERT_TRUE(em.is_valid(e));
+	EXPECT_EQ(em.get<Position>(e).x, 2);
+	EXPECT_EQ(em.get<Velocity>(e).x, 3);
+	EXPECT_FALSE(em.has<Fragile>(e));
+	ASSERT_TRUE(em.is_valid(f));
+	EXPECT_FALSE(em.has<Position>(f));
+}
+
+TEST(Parallel, Exception)
+{
+	Glare::Slot_map<int> sm {1, 2, 3};
+	Glare::Utility::Job_system jobs {1};
+	EXPECT_THROW(Glare::parallel_for_each(jobs, sm, [](int x) {
+		if (x == 2)
+			throw std::runtime_error {"failed"};
+	}, 1), std::runtime_error);
+}
+
+TEST(Parallel, Views)
+{
+	using Manager = Glare::Ecs::Entity_manager<Position, Velocity>;
+	Manager em;
+	for (int i = 0; i != 5000; ++i) {
+		em.create(Position {0}, Velocity {1});
+		em.create(Position {0});
+	}
+
+	Glare::Utility::Job_system jobs {3};
+	std::atomic<int> n {0};
+	Glare::parallel_for_each(jobs, em.view<Position, const Velocity>(), [&](Manager::Entity e, Position& p, const Velocity& v) {
+		EXPECT_TRUE(em.is_valid(e));
+		p.x += v.x;
+		++n;
+	}, 100);
+	EXPECT_EQ(n, 5000);
+
+	using Sparse_manager = Glare::Ecs::Sparse_entity_manager<Position, Velocity>;
+	Sparse_manager sparse;
+	for (int i = 0; i != 5000; ++i) {
+		sparse.create(Position {0}, Velocity {1});
+		sparse.create(Position {0});
+	}
+
+	for (int grouped = 0; grouped != 2; ++grouped) {
+		if (grouped)
+			sparse.group<Position, Velocity>();
+
+		Glare::parallel_for_each(jobs, sparse.view<Position, const Velocity>(), [](Position& p, const Velocity& v) {
+			p.x += v.x;
+		}, 100);
+
+		float total = 0;
+		sparse.view<const Position>().each([&](const Position& p) { total += p.x; });
+		EXPECT_EQ(total, 5000 * (grouped + 1));
+	}
+}
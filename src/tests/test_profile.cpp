@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+#include "../glare/profile.hpp"
+#include "../glare/slot_map.hpp"
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using Glare::Utility::Profiler;
+
+namespace {
+	const Profiler::Zone_stats* find(const char* name)
+	{
+		for (const auto& s : Profiler::global().frame_stats())
+			if (std::strcmp(s.zone->name, name) == 0)
+				return &s;
+		return nullptr;
+	}
+
+	void inner()
+	{
+		GLARE_PROFILE_ZONE("inner");
+	}
+
+	void outer()
+	{
+		GLARE_PROFILE_ZONE("outer");
+		inner();
+		inner();
+	}
+
+	// leaves the profiler as the other tests expect it
+	struct Enabled {
+		Enabled() { Profiler::global().end_frame(); Profiler::global().enable(); }
+		~Enabled() { Profiler::global().enable(false); Profiler::global().end_frame(); }
+	};
+}
+
+TEST(Profiler, Zones)
+{
+	auto& p = Profiler::global();
+
+	outer();
+	p.end_frame();
+	EXPECT_EQ(find("outer"), nullptr); // disabled
+
+	{
+		const Enabled on;
+		outer();
+		outer();
+		p.end_frame();
+
+		const auto* o = find("outer");
+		const auto* i = find("inner");
+		ASSERT_NE(o, nullptr);
+		ASSERT_NE(i, nullptr);
+		EXPECT_EQ(o->calls, 2);
+		EXPECT_EQ(i->calls, 4);
+		EXPECT_GE(o->total_ms, i->total_ms);
+		EXPECT_GE(o->total_ms, o->max_ms);
+		EXPECT_GE(p.frame_ms(), o->total_ms);
+
+		// each frame starts over
+		p.end_frame();
+		EXPECT_EQ(find("outer"), nullptr);
+	}
+}
+
+TEST(Profiler, Threads)
+{
+	auto& p = Profiler::global();
+	const Enabled on;
+
+	std::thread t {[&p] {
+		p.set_thread_name("worker \"one\"");
+		for (int i = 0; i != 10; ++i)
+			outer();
+	}};
+	t.join();
+	outer();
+
+	p.start_capture();
+	p.end_frame();
+	p.stop_capture();
+	ASSERT_NE(find("outer"), nullptr);
+	EXPECT_EQ(find("outer")->calls, 11);
+
+	std::ostringstream trace;
+	p.write_chrome_trace(trace);
+	const std::string json {trace.str()};
+	EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+	EXPECT_NE(json.find("\"name\":\"outer\""), std::string::npos);
+	EXPECT_NE(json.find("worker \\\"one\\\""), std::string::npos);
+	EXPECT_NE(json.find("test_profile.cpp"), std::string::npos);
+	p.clear_capture();
+}
+
+TEST(Profiler, Overflow)
+{
+	auto& p = Profiler::global();
+	const Enabled on;
+	const auto before = p.dropped();
+
+	for (int i = 0; i != 20000; ++i)
+		inner();
+	p.end_frame();
+
+	ASSERT_NE(find("inner"), nullptr);
+	EXPECT_GT(p.dropped(), before);
+	EXPECT_EQ(find("inner")->calls + (p.dropped() - before), 20000);
+}
+
+TEST(Profiler, BuiltInZones)
+{
+	auto& p = Profiler::global();
+	const Enabled on;
+
+	Glare::Slot_map<int> sm;
+	sm.buffered_add(1);
+	sm.clean_buffers();
+	p.end_frame();
+	ASSERT_NE(find("Slot_map::clean_buffers"), nullptr);
+
+	EXPECT_EQ(&p.intern("a system"), &p.intern("a system"));
+	EXPECT_STREQ(p.intern("a system").name, "a system");
+}
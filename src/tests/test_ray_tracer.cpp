@@ -0,0 +1,246 @@
+#include "gtest/gtest.h"
+#include "../glare/ray_tracer.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using Glare::Math::Mat4;
+using Glare::Video::Hit;
+using Glare::Video::Ray;
+using Glare::Video::Ray_tracer;
+using Glare::Video::Vertex;
+using Glare::Video::rgba;
+
+namespace {
+	constexpr std::uint32_t red {rgba(255, 0, 0)};
+
+	std::size_t add(Ray_tracer& r, const std::vector<Vertex>& v, const std::vector<std::uint32_t>& i)
+	{
+		return r.add_mesh({v.data(), v.size()}, {i.data(), i.size()});
+	}
+
+	std::vector<Hit> intersect(const Ray_tracer& r, const std::vector<Ray>& rays)
+	{
+		std::vector<Hit> hits(rays.size());
+		r.intersect({rays.data(), rays.size()}, {hits.data(), hits.size()});
+		return hits;
+	}
+
+	// the nearest hit by testing every triangle
+	float brute_force(const std::vector<Vertex>& v, const Ray& ray)
+	{
+		float best {ray.max_t};
+		for (std::size_t t = 0; t + 2 < v.size(); t += 3) {
+			const float* p0 {v[t].position};
+			float e1[3], e2[3], o[3];
+			for (int a = 0; a != 3; ++a) {
+				e1[a] = v[t + 1].position[a] - p0[a];
+				e2[a] = v[t + 2].position[a] - p0[a];
+				o[a] = ray.origin[a] - p0[a];
+			}
+			const float* d {ray.direction};
+			const float p[3] {d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0]};
+			const float q[3] {o[1] * e1[2] - o[2] * e1[1], o[2] * e1[0] - o[0] * e1[2], o[0] * e1[1] - o[1] * e1[0]};
+			const float inv {1 / (e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2])};
+			const float u {(o[0] * p[0] + o[1] * p[1] + o[2] * p[2]) * inv};
+			const float w {(d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inv};
+			const float dist {(e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inv};
+			if (u >= 0 && w >= 0 && u + w <= 1 && dist > 0 && dist < best)
+				best = dist;
+		}
+		return best;
+	}
+
+	// unindexed triangles scattered through a cube
+	std::vector<Vertex> soup(std::size_t triangles, unsigned seed)
+	{
+		std::mt19937 rng {seed};
+		std::uniform_real_distribution<float> centre {-10, 10};
+		std::uniform_real_distribution<float> offset {-1, 1};
+		std::uniform_int_distribution<int> channel {0, 255};
+		std::vector<Vertex> v;
+		for (std::size_t t = 0; t != triangles; ++t) {
+			const float c[3] {centre(rng), centre(rng), centre(rng)};
+			for (int i = 0; i != 3; ++i) {
+				v.push_back({{c[0] + offset(rng), c[1] + offset(rng), c[2] + offset(rng)},
+							 rgba(static_cast<std::uint8_t>(channel(rng)), static_cast<std::uint8_t>(channel(rng)), 0)});
+			}
+		}
+		return v;
+	}
+
+	std::vector<std::uint32_t> sequence(std::size_t n)
+	{
+		std::vector<std::uint32_t> i(n);
+		for (std::uint32_t x = 0; x != n; ++x)
+			i[x] = x;
+		return i;
+	}
+
+	std::vector<Ray> random_rays(std::size_t n, unsigned seed)
+	{
+		std::mt19937 rng {seed};
+		std::uniform_real_distribution<float> position {-12, 12};
+		std::vector<Ray> rays;
+		for (std::size_t i = 0; i != n; ++i) {
+			Ray r {{position(rng), position(rng), position(rng)}, {}, 1};
+			for (int a = 0; a != 3; ++a)
+				r.direction[a] = position(rng) - r.origin[a];
+			rays.push_back(r);
+		}
+		return rays;
+	}
+}
+
+TEST(RayTracer, Intersect)
+{
+	Ray_tracer r {1, 1};
+	const std::vector<Vertex> quad {{{-1, -1, 0}, red}, {{1, -1, 0}, red}, {{1, 1, 0}, red}, {{-1, 1, 0}, red}};
+	const std::vector<std::uint32_t> indices {0, 1, 2, 0, 2, 3};
+	add(r, quad, indices);
+	std::vector<Vertex> moved {quad};
+	for (auto& v : moved)
+		v.position[2] = -2;
+	EXPECT_EQ(add(r, moved, indices), 1);
+	r.update();
+
+	// not a whole number of packets
+	const std::vector<Ray> rays {
+		{{0.5f, -0.5f, 2}, {0, 0, -1}, 10}, // lower right triangle of the nearer quad
+		{{-0.5f, 0.5f, 2}, {0, 0, -2}, 10}, // upper left, t in multiples of direction
+		{{3, 0, 2}, {0, 0, -1}, 10}, // misses
+		{{0.5f, -0.5f, 2}, {0, 0, -1}, 1}, // stops short
+		{{0.5f, -0.5f, -1}, {0, 0, -1}, 10}, // starts between them
+		{{0.5f, -0.5f, 2}, {0, 0, 1}, 10}, // points away
+		{{0.5f, 0.25f, -5}, {0, 0, 1}, 10} // from behind
+	};
+	const auto hits = intersect(r, rays);
+
+	EXPECT_EQ(hits[0].mesh, 0);
+	EXPECT_EQ(hits[0].triangle, 0);
+	EXPECT_FLOAT_EQ(hits[0].t, 2);
+	EXPECT_FLOAT_EQ(hits[0].u, 0.5f);
+	EXPECT_FLOAT_EQ(hits[0].v, 0.25f);
+	EXPECT_EQ(hits[1].triangle, 1);
+	EXPECT_FLOAT_EQ(hits[1].t, 1);
+	EXPECT_EQ(hits[2].mesh, Hit::none);
+	EXPECT_EQ(hits[2].triangle, Hit::none);
+	EXPECT_FLOAT_EQ(hits[2].t, 10);
+	EXPECT_EQ(hits[3].mesh, Hit::none);
+	EXPECT_EQ(hits[4].mesh, 1);
+	EXPECT_FLOAT_EQ(hits[4].t, 1);
+	EXPECT_EQ(hits[5].mesh, Hit::none);
+	EXPECT_EQ(hits[6].mesh, 1);
+	EXPECT_FLOAT_EQ(hits[6].t, 3);
+
+	std::vector<Hit> too_few(2);
+	EXPECT_THROW(r.intersect({rays.data(), rays.size()}, {too_few.data(), too_few.size()}),
+				 Glare::Error::Video_index_out_of_range);
+	const std::vector<std::uint32_t> bad {0, 1, 4};
+	EXPECT_THROW(add(r, quad, bad), Glare::Error::Video_index_out_of_range);
+	EXPECT_THROW(r.update_mesh(2, {quad.data(), quad.size()}), Glare::Error::Video_index_out_of_range);
+	EXPECT_THROW(r.update_mesh(0, {quad.data(), 3}), Glare::Error::Video_vertex_count_mismatch);
+}
+
+TEST(RayTracer, MatchesBruteForce)
+{
+	const auto v = soup(3000, 1);
+	Ray_tracer r {1, 1};
+	add(r, v, sequence(v.size()));
+	r.update();
+	// a split for every few triangles
+	EXPECT_GT(r.node_count(), 3000 / Ray_tracer::max_leaf_size);
+
+	const auto rays = random_rays(2000, 2);
+	const auto hits = intersect(r, rays);
+	int hit_count {0};
+	for (std::size_t i = 0; i != rays.size(); ++i) {
+		EXPECT_NEAR(hits[i].t, brute_force(v, rays[i]), 1e-5f);
+		hit_count += hits[i].mesh != Hit::none;
+	}
+	EXPECT_GT(hit_count, 200);
+}
+
+TEST(RayTracer, RefitMatchesRebuild)
+{
+	auto v = soup(1000, 3);
+	const auto indices = sequence(v.size());
+	Ray_tracer refit {1, 1};
+	add(refit, v, indices);
+	refit.update();
+	const std::size_t nodes {refit.node_count()};
+
+	// every triangle moves somewhere else, so the old hierarchy fits badly
+	std::mt19937 rng {4};
+	std::uniform_real_distribution<float> step {-3, 3};
+	for (std::size_t t = 0; t < v.size(); t += 3) {
+		const float d[3] {step(rng), step(rng), step(rng)};
+		for (std::size_t i = t; i != t + 3; ++i)
+			for (int a = 0; a != 3; ++a)
+				v[i].position[a] += d[a];
+	}
+	refit.update_mesh(0, {v.data(), v.size()});
+	refit.update();
+	EXPECT_EQ(refit.node_count(), nodes);
+
+	Ray_tracer rebuilt {1, 1};
+	add(rebuilt, v, indices);
+	rebuilt.update();
+
+	const auto rays = random_rays(1000, 5);
+	const auto a = intersect(refit, rays);
+	const auto b = intersect(rebuilt, rays);
+	for (std::size_t i = 0; i != rays.size(); ++i) {
+		EXPECT_EQ(a[i].mesh, b[i].mesh);
+		EXPECT_EQ(a[i].triangle, b[i].triangle);
+		EXPECT_FLOAT_EQ(a[i].t, b[i].t);
+	}
+}
+
+TEST(RayTracer, MatchesRasterizer)
+{
+	const auto v = soup(300, 6);
+	const auto indices = sequence(v.size());
+	const Mat4 to_clip {Mat4::perspective(1.2f, 1.5f, 1, 60) * Mat4::translation(0, 0, -25)};
+
+	Glare::Video::Rasterizer raster {96, 64};
+	raster.draw({v.data(), v.size()}, {indices.data(), indices.size()}, to_clip);
+	raster.render();
+
+	Ray_tracer traced {96, 64};
+	add(traced, v, indices);
+	traced.render(to_clip);
+	EXPECT_EQ(traced.ray_count(), 96 * 64);
+
+	// only pixels centred right on an edge may go to different triangles
+	int same {0};
+	for (std::size_t p = 0; p != 96 * 64; ++p) {
+		bool close {true};
+		for (int c = 0; c != 32; c += 8)
+			close = close && std::abs(static_cast<int>(raster.image()[p] >> c & 0xff)
+				- static_cast<int>(traced.image()[p] >> c & 0xff)) <= 2;
+		same += close;
+	}
+	EXPECT_GT(same, 96 * 64 * 97 / 100);
+}
+
+TEST(RayTracer, ParallelMatchesSerial)
+{
+	const auto v = soup(2000, 7);
+	const auto indices = sequence(v.size());
+	const Mat4 to_clip {Mat4::perspective(1.0f, 1.6f, 0.5f, 80) * Mat4::translation(0, 0, -20)};
+
+	Ray_tracer serial {150, 100};
+	add(serial, v, indices);
+	serial.render(to_clip);
+
+	Glare::Utility::Job_system jobs {3};
+	Ray_tracer parallel {150, 100};
+	add(parallel, v, indices);
+	parallel.render(jobs, to_clip);
+
+	EXPECT_TRUE(std::equal(serial.image().begin(), serial.image().end(), parallel.image().begin()));
+}
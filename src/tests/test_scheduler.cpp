@@ -0,0 +1,225 @@
+#include "gtest/gtest.h"
+#include "../glare/ecs.hpp"
+#include "../glare/scheduler.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+	struct Position {
+		float x;
+	};
+
+	struct Velocity {
+		float x;
+	};
+
+	struct Health {
+		int value;
+	};
+
+	using Manager = Glare::Ecs::Entity_manager<Position, Velocity, Health>;
+	using Dependencies = std::vector<std::size_t>;
+}
+
+TEST(JobSystem, RunsEverything)
+{
+	std::atomic<int> n {0};
+	{
+		Glare::Utility::Job_system jobs {3};
+		EXPECT_EQ(jobs.worker_count(), 3);
+		for (int i = 0; i != 1000; ++i)
+			jobs.submit([&] { ++n; });
+	}
+	EXPECT_EQ(n, 1000);
+}
+
+TEST(JobSystem, NoWorkers)
+{
+	Glare::Utility::Job_system jobs {0};
+	int n = 0;
+	jobs.submit([&] {
+		++n;
+		jobs.submit([&] { ++n; }); // nested jobs go to the same queue
+	});
+	EXPECT_EQ(n, 0);
+	EXPECT_TRUE(jobs.run_one());
+	EXPECT_TRUE(jobs.run_one());
+	EXPECT_FALSE(jobs.run_one());
+	EXPECT_EQ(n, 2);
+}
+
+TEST(JobSystem, Counters)
+{
+	Glare::Utility::Job_system jobs {3};
+	Glare::Utility::Job_system::Counter counter;
+	EXPECT_TRUE(counter.done());
+
+	std::atomic<int> n {0};
+	for (int i = 0; i != 100; ++i) {
+		jobs.submit([&] {
+			// nested jobs keep the counter up until they are done too
+			for (int j = 0; j != 10; ++j)
+				jobs.submit([&] { ++n; }, counter);
+		}, counter);
+	}
+	jobs.wait(counter);
+	EXPECT_TRUE(counter.done());
+	EXPECT_EQ(n, 1000);
+
+	// reusable once done
+	jobs.submit([&] { ++n; }, counter);
+	jobs.wait(counter);
+	EXPECT_EQ(n, 1001);
+}
+
+TEST(JobSystem, Continuations)
+{
+	Glare::Utility::Job_system jobs {2};
+	Glare::Utility::Job_system::Counter first;
+	Glare::Utility::Job_system::Counter second;
+	Glare::Utility::Job_system::Counter last;
+
+	std::atomic<int> stage {0};
+	std::atomic<bool> in_order {true};
+	for (int i = 0; i != 50; ++i)
+		jobs.submit([&] { stage.load() == 0 || (in_order = false); }, first);
+	for (int i = 0; i != 50; ++i) {
+		jobs.submit_after(first, [&] {
+			stage.store(1);
+			jobs.submit([&] {}, second); // counted before this job returns
+		}, second);
+	}
+	jobs.submit_after(second, [&] { stage.load() == 1 || (in_order = false); stage.store(2); }, last);
+	jobs.wait(last);
+
+	EXPECT_TRUE(in_order);
+	EXPECT_EQ(stage, 2);
+
+	// after a counter that is already done runs straight away
+	bool ran {false};
+	jobs.submit_after(first, [&] { ran = true; }, last);
+	jobs.wait(last);
+	EXPECT_TRUE(ran);
+}
+
+TEST(JobSystem, HelpWhileWaiting)
+{
+	// one worker and jobs that wait on jobs of their own, which only
+	// finishes if waiting threads run jobs rather than block
+	Glare::Utility::Job_system jobs {1};
+	std::atomic<int> n {0};
+
+	Glare::Utility::Job_system::Counter outer;
+	for (int i = 0; i != 8; ++i) {
+		jobs.submit([&] {
+			Glare::Utility::Job_system::Counter inner;
+			for (int j = 0; j != 8; ++j)
+				jobs.submit([&] { ++n; }, inner);
+			jobs.wait(inner);
+		}, outer);
+	}
+	jobs.wait(outer);
+	EXPECT_EQ(n, 64);
+}
+
+TEST(JobSystem, PoolExhausted)
+{
+	// past the capacity submit runs jobs itself rather than allocating
+	Glare::Utility::Job_system jobs {0, 4};
+	Glare::Utility::Job_system::Counter counter;
+	int n = 0;
+	for (int i = 0; i != 10; ++i)
+		jobs.submit([&] { ++n; }, counter);
+	EXPECT_EQ(n, 6);
+	EXPECT_EQ(counter.count(), 4);
+	jobs.wait(counter);
+	EXPECT_EQ(n, 10);
+}
+
+TEST(Scheduler, Dependencies)
+{
+	Manager em;
+	Glare::Ecs::Scheduler<Manager> s {em};
+
+	s.system<Position, const Velocity>([](Position&, const Velocity&) {}); // 0
+	s.system<const Position>([](const Position&) {}); // 1, reads what 0 writes
+	s.system<const Velocity>([](const Velocity&) {}); // 2, only reads
+	s.system<Health>([](Health&) {}); // 3, unrelated
+	s.system<Velocity>([](Velocity&) {}); // 4, writes what 0 and 2 read
+	s.system<const Position, Health>([](const Position&, Health&) {}); // 5
+
+	EXPECT_EQ(s.system_count(), 6);
+	EXPECT_EQ(s.dependencies(0), Dependencies {});
+	EXPECT_EQ(s.dependencies(1), Dependencies {0});
+	EXPECT_EQ(s.dependencies(2), Dependencies {});
+	EXPECT_EQ(s.dependencies(3), Dependencies {});
+	EXPECT_EQ(s.dependencies(4), (Dependencies {0, 2}));
+	EXPECT_EQ(s.dependencies(5), (Dependencies {0, 3}));
+}
+
+TEST(Scheduler, Run)
+{
+	Manager em;
+	for (int i = 0; i != 1000; ++i) {
+		em.create(Position {0}, Velocity {1});
+		em.create(Position {0}, Velocity {1}, Health {i});
+		em.create(Health {0});
+	}
+
+	Glare::Ecs::Scheduler<Manager> s {em};
+	s.system<Position, const Velocity>([](Position& p, const Velocity& v) { p.x += v.x; });
+	s.system<Velocity>([](Velocity& v) { v.x *= 2; });
+	s.system<Position, const Velocity>([](Position& p, const Velocity& v) { p.x += v.x; });
+	s.system<Health>([](Health& h) { ++h.value; });
+
+	// the result must match the serial order whatever runs concurrently
+	Glare::Utility::Job_system jobs {3};
+	s.run(jobs);
+	s.run(jobs);
+
+	em.view<const Position, const Velocity>().each([](const Position& p, const Velocity& v) {
+		EXPECT_EQ(p.x, 1 + 2 + 2 + 4);
+		EXPECT_EQ(v.x, 4);
+	});
+
+	int total = 0;
+	em.view<const Health>().each([&](const Health& h) { total += h.value; });
+	EXPECT_EQ(total, 999 * 1000 / 2 + 2 * 2000);
+}
+
+TEST(Scheduler, Exception)
+{
+	Manager em;
+	em.create(Position {0}, Velocity {1});
+
+	Glare::Ecs::Scheduler<Manager> s {em};
+	s.system<Position>([](Position&) { throw std::runtime_error {"system failed"}; });
+	s.system<Position>([](Position& p) { p.x = 5; });
+	s.system<Velocity>([](Velocity& v) { v.x = 5; });
+
+	Glare::Utility::Job_system jobs {0};
+	EXPECT_THROW(s.run(jobs), std::runtime_error);
+	em.view<const Position, const Velocity>().each([](const Position& p, const Velocity& v) {
+		EXPECT_EQ(p.x, 5);
+		EXPECT_EQ(v.x, 5);
+	});
+
+	EXPECT_THROW(s.run(), std::runtime_error);
+}
+
+TEST(Scheduler, SparseEntityManager)
+{
+	using Sparse_manager = Glare::Ecs::Sparse_entity_manager<Position, Velocity>;
+	Sparse_manager em;
+	em.group<Position, Velocity>();
+	em.create(Position {0}, Velocity {3});
+
+	Glare::Ecs::Scheduler<Sparse_manager> s {em};
+	s.system<Position, const Velocity>([](Position& p, const Velocity& v) { p.x += v.x; });
+
+	Glare::Utility::Job_system jobs {2};
+	s.run(jobs);
+	em.view<const Position>().each([](const Position& p) { EXPECT_EQ(p.x, 3); });
+}
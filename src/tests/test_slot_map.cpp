@@ -1,6 +1,12 @@
 #include "gtest/gtest.h"
 #include "../glare/slot_map.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <string>
+
 TEST(SlotMap, DefaultConstructor)
 {
 	Glare::Slot_map<int> sm;
@@ -256,3 +262,586 @@ TEST(SlotMap, IteratorToPointerConversions)
 	EXPECT_EQ(p1, p3);
 	EXPECT_EQ(sm[p3], 42);
 }
+
+TEST(SlotMap, SlotReuse)
+{
+	Glare::Slot_map<int> sm;
+	auto p1 = sm.add(1);
+	sm.remove(p1);
+
+	auto p2 = sm.add(2);
+	EXPECT_EQ(sm.slot_count(), 1);
+	EXPECT_FALSE(sm.is_valid(p1));
+	ASSERT_TRUE(sm.is_valid(p2));
+	EXPECT_EQ(sm[p2], 2);
+	EXPECT_NE(p1, p2);
+
+	// a stale handle must not remove the new occupant
+	sm.remove(p1);
+	EXPECT_EQ(sm.size(), 1);
+	ASSERT_TRUE(sm.is_valid(p2));
+}
+
+TEST(SlotMap, ChurnKeepsSlotCountBounded)
+{
+	Glare::Slot_map<int> sm;
+	std::vector<Glare::Slot_map<int>::Stable_index> live;
+	for (int i = 0; i < 16; ++i)
+		live.push_back(sm.add(i));
+
+	for (int i = 0; i < 1000; ++i) {
+		auto& p = live[i % live.size()];
+		sm.remove(p);
+		p = sm.add(i);
+	}
+
+	EXPECT_EQ(sm.size(), 16);
+	EXPECT_EQ(sm.slot_count(), 16);
+	for (auto p : live)
+		EXPECT_TRUE(sm.is_valid(p));
+}
+
+TEST(SlotMap, BufferedChurnKeepsSlotCountBounded)
+{
+	Glare::Slot_map<int> sm;
+	for (int i = 0; i < 100; ++i) {
+		auto p1 = sm.buffered_add(i);
+		auto p2 = sm.buffered_add(i);
+		sm.buffered_remove(p1); // cancelled before creation
+		sm.clean_buffers();
+		sm.buffered_remove(p2);
+		sm.clean_buffers();
+	}
+
+	EXPECT_EQ(sm.size(), 0);
+	EXPECT_EQ(sm.slot_count(), 2);
+}
+
+TEST(SlotMap, CommandQueue)
+{
+	using Map = Glare::Slot_map<int>;
+	Map sm;
+	auto p1 = sm.add(1);
+	auto p2 = sm.add(2);
+	sm.remove(p1);
+
+	Map::Command_queue commands {sm, 2};
+	auto p3 = commands.buffer(1).buffered_add(3); // reuses the slot of p1
+	auto p4 = commands.buffer(0).buffered_add(4);
+	auto p5 = commands.buffer(0).buffered_add(5);
+	commands.buffer(1).buffered_remove(p2);
+	commands.buffer(1).buffered_remove(p5); // cancelled before creation
+	EXPECT_FALSE(sm.is_valid(p3));
+	EXPECT_FALSE(sm.is_valid(p1));
+
+	commands.commit();
+	EXPECT_TRUE(commands.buffer(0).empty());
+	EXPECT_FALSE(sm.is_valid(p3)); // until clean_buffers
+	sm.clean_buffers();
+
+	ASSERT_TRUE(sm.is_valid(p3));
+	ASSERT_TRUE(sm.is_valid(p4));
+	EXPECT_FALSE(sm.is_valid(p2));
+	EXPECT_FALSE(sm.is_valid(p5));
+	EXPECT_EQ(sm[p3], 3);
+	EXPECT_EQ(sm[p4], 4);
+	EXPECT_EQ(sm.size(), 2);
+	EXPECT_EQ(sm[0], 4); // in buffer order
+	EXPECT_EQ(sm.slot_count(), 4);
+
+	// the slots of p2 and p5 are free again
+	commands.reset(1);
+	commands.buffer(0).buffered_add(6);
+	commands.buffer(0).buffered_add(7);
+	commands.commit();
+	sm.clean_buffers();
+	EXPECT_EQ(sm.size(), 4);
+	EXPECT_EQ(sm.slot_count(), 4);
+
+	// fewer buffers than last round
+	commands.reset(2);
+	EXPECT_EQ(commands.buffer_count(), 2);
+	commands.reset(1);
+	EXPECT_EQ(commands.buffer_count(), 1);
+	EXPECT_THROW(commands.buffer(1), Glare::Error::Slot_map_out_of_range);
+}
+
+TEST(SlotMap, StaleHandleDoesNotCancelCreation)
+{
+	Glare::Slot_map<int> sm;
+	auto p1 = sm.add(1);
+	sm.remove(p1);
+
+	auto p2 = sm.buffered_add(2); // reuses the slot of p1
+	sm.buffered_remove(p1);
+	sm.clean_buffers();
+
+	EXPECT_EQ(sm.size(), 1);
+	ASSERT_TRUE(sm.is_valid(p2));
+	EXPECT_EQ(sm[p2], 2);
+}
+
+TEST(SlotMap, ClearInvalidatesHandles)
+{
+	Glare::Slot_map<int> sm;
+	auto p1 = sm.add(1);
+	auto p2 = sm.buffered_add(2);
+	sm.clear();
+
+	auto p3 = sm.add(3);
+	auto p4 = sm.add(4);
+	EXPECT_FALSE(sm.is_valid(p1));
+	EXPECT_FALSE(sm.is_valid(p2));
+	ASSERT_TRUE(sm.is_valid(p3));
+	ASSERT_TRUE(sm.is_valid(p4));
+	EXPECT_EQ(sm.slot_count(), 2);
+}
+
+TEST(SlotMap, IteratorToPointerAfterReuse)
+{
+	using Pointer = typename Glare::Slot_map<int>::Stable_index;
+
+	Glare::Slot_map<int> sm;
+	auto p1 = sm.add(1);
+	auto p2 = sm.add(2);
+	sm.remove(p1); // 2 is moved to the front, but keeps its slot
+
+	Pointer p3 {sm.begin()};
+	EXPECT_EQ(p2, p3);
+	EXPECT_EQ(sm[p3], 2);
+}
+
+TEST(SlotMap, RetirementPolicy)
+{
+	Glare::Slot_map<int> sm1;
+	EXPECT_EQ(sm1.retirement_policy(), Glare::Retirement_policy::retire);
+
+	Glare::Slot_map<int> sm2 {Glare::Retirement_policy::wrap};
+	EXPECT_EQ(sm2.retirement_policy(), Glare::Retirement_policy::wrap);
+	EXPECT_EQ(sm2.retired_count(), 0);
+}
+
+TEST(SlotMap, HandleSize)
+{
+	EXPECT_EQ(sizeof(Glare::Slot_map<int>::Stable_index), 8);
+	EXPECT_EQ(sizeof(Glare::Slot_map<int, Glare::Compact_handle_traits>::Stable_index), 4);
+}
+
+TEST(SlotMap, CompactHandle)
+{
+	Glare::Slot_map<int, Glare::Compact_handle_traits> sm;
+	auto p1 = sm.add(1);
+	auto p2 = sm.add(2);
+	sm.remove(p1);
+	auto p3 = sm.add(3);
+
+	EXPECT_FALSE(sm.is_valid(p1));
+	ASSERT_TRUE(sm.is_valid(p2));
+	ASSERT_TRUE(sm.is_valid(p3));
+	EXPECT_EQ(sm[p2], 2);
+	EXPECT_EQ(sm[p3], 3);
+	EXPECT_NE(p1, p3);
+
+	decltype(p1) p4;
+	EXPECT_FALSE(sm.is_valid(p4));
+}
+
+TEST(SlotMap, RetireOnCounterWrap)
+{
+	// 2 bit counter, 3 is reserved so each slot can be used 3 times
+	Glare::Slot_map<int, Glare::Handle_traits<std::uint8_t, 6, 2>> sm;
+	auto p1 = sm.add(1);
+	for (int i = 0; i < 2; ++i) {
+		sm.remove(p1);
+		p1 = sm.add(1);
+	}
+	EXPECT_EQ(sm.slot_count(), 1);
+
+	sm.remove(p1);
+	EXPECT_EQ(sm.retired_count(), 1);
+
+	auto p2 = sm.add(2);
+	EXPECT_EQ(sm.slot_count(), 2);
+	EXPECT_FALSE(sm.is_valid(p1));
+	ASSERT_TRUE(sm.is_valid(p2));
+}
+
+TEST(SlotMap, WrapOnCounterWrap)
+{
+	Glare::Slot_map<int, Glare::Handle_traits<std::uint8_t, 6, 2>> sm {Glare::Retirement_policy::wrap};
+	auto p1 = sm.add(1);
+	for (int i = 0; i < 10; ++i) {
+		sm.remove(p1);
+		p1 = sm.add(1);
+	}
+
+	EXPECT_EQ(sm.slot_count(), 1);
+	EXPECT_EQ(sm.retired_count(), 0);
+	ASSERT_TRUE(sm.is_valid(p1));
+}
+
+TEST(SlotMap, OutOfSlots)
+{
+	// 2 bit index, 3 is reserved
+	Glare::Slot_map<int, Glare::Handle_traits<std::uint8_t, 2, 6>> sm;
+	sm.add(1);
+	sm.add(2);
+	auto p = sm.add(3);
+	EXPECT_THROW(sm.add(4), Glare::Error::Slot_map_full);
+
+	sm.remove(p);
+	EXPECT_NO_THROW(sm.add(4));
+}
+
+namespace {
+	// counts how often instances are created, copied and moved
+	struct Counted {
+		static int constructed;
+		static int copied;
+		static int moved;
+
+		static void reset() { constructed = copied = moved = 0; }
+
+		Counted(int a, int b) :value {a + b} { ++constructed; }
+		Counted(const Counted& x) :value {x.value} { ++copied; }
+		Counted(Counted&& x) noexcept :value {x.value} { ++moved; }
+		Counted& operator=(const Counted& x) { value = x.value; ++copied; return *this; }
+		Counted& operator=(Counted&& x) noexcept { value = x.value; ++moved; return *this; }
+
+		int value;
+	};
+
+	int Counted::constructed {0};
+	int Counted::copied {0};
+	int Counted::moved {0};
+
+	struct Aggregate {
+		int a;
+		double b;
+	};
+}
+
+TEST(SlotMap, EmplaceDoesNotCopy)
+{
+	Glare::Slot_map<Counted> sm;
+	Counted::reset();
+
+	auto p1 = sm.emplace(1, 2);
+	auto p2 = sm.emplace(3, 4);
+	auto p3 = sm.add(Counted {5, 6});
+	EXPECT_EQ(Counted::constructed, 3);
+
+	sm.remove(p1);
+	EXPECT_EQ(sm[p2].value, 7);
+	EXPECT_EQ(sm[p3].value, 11);
+
+	EXPECT_EQ(Counted::copied, 0);
+}
+
+TEST(SlotMap, BufferedEmplaceDoesNotCopy)
+{
+	Glare::Slot_map<Counted> sm;
+	Counted::reset();
+
+	auto p1 = sm.buffered_emplace(1, 2);
+	auto p2 = sm.buffered_emplace(3, 4);
+	auto p3 = sm.buffered_add(Counted {5, 6});
+	sm.buffered_remove(p1);
+	sm.clean_buffers();
+
+	sm.buffered_remove(p2);
+	sm.clean_buffers();
+
+	EXPECT_EQ(sm.size(), 1);
+	EXPECT_EQ(sm[p3].value, 11);
+	EXPECT_EQ(Counted::constructed, 3);
+	EXPECT_EQ(Counted::copied, 0);
+}
+
+TEST(SlotMap, AddCopiesOnce)
+{
+	Glare::Slot_map<Counted> sm;
+	const Counted c {1, 2};
+	Counted::reset();
+
+	sm.add(c);
+	EXPECT_EQ(Counted::copied, 1);
+}
+
+TEST(SlotMap, EmplaceAggregate)
+{
+	Glare::Slot_map<Aggregate> sm;
+	auto p = sm.emplace(1, 2.0);
+	EXPECT_EQ(sm[p].a, 1);
+	EXPECT_EQ(sm[p].b, 2.0);
+}
+
+TEST(SlotMap, MoveOnly)
+{
+	Glare::Slot_map<std::unique_ptr<int>> sm;
+	auto p1 = sm.emplace(new int {1});
+	auto p2 = sm.buffered_add(std::make_unique<int>(2));
+	sm.remove(p1);
+	sm.clean_buffers();
+
+	ASSERT_TRUE(sm.is_valid(p2));
+	EXPECT_EQ(*sm[p2], 2);
+}
+
+TEST(SlotMap, AosStorage)
+{
+	Glare::Slot_map<int, Glare::Handle_traits<>, Glare::Aos_storage> sm {0, 1, 2, 3};
+	auto p = sm.add(4);
+	sm.remove(0);
+	EXPECT_EQ(sm.size(), 4);
+	EXPECT_EQ(sm[0], 4); // moved into the gap
+	EXPECT_EQ(sm[p], 4);
+
+	auto p2 = sm.buffered_add(5);
+	sm.buffered_remove(p);
+	sm.clean_buffers();
+	EXPECT_FALSE(sm.is_valid(p));
+	ASSERT_TRUE(sm.is_valid(p2));
+	EXPECT_EQ(sm[p2], 5);
+
+	int sum {0};
+	for (auto x : sm) sum += x;
+	EXPECT_EQ(sum, 1 + 2 + 3 + 5);
+}
+
+TEST(SlotMap, AosEmplaceDoesNotCopy)
+{
+	Glare::Slot_map<Counted, Glare::Handle_traits<>, Glare::Aos_storage> sm;
+	Counted::reset();
+
+	auto p1 = sm.emplace(1, 2);
+	auto p2 = sm.buffered_emplace(3, 4);
+	sm.remove(p1);
+	sm.clean_buffers();
+
+	EXPECT_EQ(sm[p2].value, 7);
+	EXPECT_EQ(Counted::constructed, 2);
+	EXPECT_EQ(Counted::copied, 0);
+}
+
+TEST(SlotMap, Values)
+{
+	Glare::Slot_map<int> sm {0, 1, 2, 3};
+	sm.remove(0);
+
+	auto v = sm.values();
+	ASSERT_EQ(v.size(), sm.size());
+	EXPECT_EQ(v[0], 3);
+	EXPECT_EQ(v[1], 1);
+
+	int i {0};
+	for (auto x : v)
+		EXPECT_EQ(x, sm[i++]);
+
+	v[1] = 42;
+	EXPECT_EQ(sm[1], 42);
+
+	const auto& csm = sm;
+	EXPECT_EQ(csm.values().data(), v.data());
+}
+
+TEST(SlotMap, RandomAccessIterator)
+{
+	using Iterator = typename Glare::Slot_map<int>::iterator;
+	static_assert(std::is_same<std::iterator_traits<Iterator>::iterator_category,
+							   std::random_access_iterator_tag>::value, "");
+	static_assert(std::is_same<std::iterator_traits<Iterator>::reference, int&>::value, "");
+
+	Glare::Slot_map<int> sm {0, 1, 2, 3};
+	EXPECT_TRUE(std::is_sorted(sm.begin(), sm.end()));
+	EXPECT_EQ(std::lower_bound(sm.begin(), sm.end(), 2) - sm.begin(), 2);
+	EXPECT_EQ(*std::make_reverse_iterator(sm.end()), 3);
+
+	auto iter = sm.begin();
+	EXPECT_EQ(*iter++, 0);
+	EXPECT_EQ(*iter, 1);
+	EXPECT_EQ(*iter--, 1);
+	EXPECT_EQ(*(2 + iter), 2);
+
+	EXPECT_TRUE(sm.begin() < sm.end());
+	EXPECT_TRUE(sm.end() >= sm.cbegin());
+	EXPECT_EQ(std::distance(sm.begin(), sm.end()), 4);
+	EXPECT_EQ(std::accumulate(sm.cbegin(), sm.cend(), 0), 6);
+}
+
+TEST(SlotMap, CancelPendingCreation)
+{
+	Glare::Slot_map<int> sm;
+	std::vector<Glare::Slot_map<int>::Stable_index> p;
+	for (int i = 0; i < 10; ++i)
+		p.push_back(sm.buffered_add(i));
+
+	// cancel from the front, middle and back so elements are moved around
+	sm.buffered_remove(p[0]);
+	sm.buffered_remove(p[5]);
+	sm.buffered_remove(p[9]);
+	sm.buffered_remove(p[5]); // already cancelled, no effect
+	EXPECT_EQ(sm.size(), 0);
+
+	sm.clean_buffers();
+	EXPECT_EQ(sm.size(), 7);
+	for (int i = 0; i < 10; ++i) {
+		if (i == 0 || i == 5 || i == 9) {
+			EXPECT_FALSE(sm.is_valid(p[i]));
+		}
+		else {
+			ASSERT_TRUE(sm.is_valid(p[i]));
+			EXPECT_EQ(sm[p[i]], i);
+		}
+	}
+	EXPECT_EQ(sm.slot_count(), 10);
+}
+
+TEST(SlotMap, CleanStats)
+{
+	Glare::Slot_map<int> sm {0, 1, 2, 3};
+	auto p = sm.add(4);
+
+	sm.buffered_remove(p);
+	sm.buffered_remove(p); // duplicate
+	sm.buffered_remove(1);
+	sm.buffered_add(5);
+	sm.buffered_add(6);
+	auto p2 = sm.buffered_add(7);
+	sm.buffered_remove(p2); // cancelled, never counted
+
+	auto stats = sm.clean_buffers();
+	EXPECT_EQ(stats.removed, 2);
+	EXPECT_EQ(stats.added, 2);
+	EXPECT_EQ(sm.size(), 5);
+
+	stats = sm.clean_buffers();
+	EXPECT_EQ(stats.removed, 0);
+	EXPECT_EQ(stats.added, 0);
+}
+
+TEST(SlotMap, CleanKeepsCreationOrder)
+{
+	Glare::Slot_map<int> sm;
+	for (int i = 0; i < 5; ++i)
+		sm.buffered_add(i);
+	sm.clean_buffers();
+
+	for (int i = 0; i < 5; ++i)
+		EXPECT_EQ(sm[i], i);
+}
+
+TEST(SlotMap, BatchedRemove)
+{
+	Glare::Slot_map<int> sm;
+	std::vector<Glare::Slot_map<int>::Stable_index> p;
+	for (int i = 0; i < 100; ++i)
+		p.push_back(sm.add(i));
+
+	// remove every third element, in a scrambled order
+	for (int i = 0; i < 100; i += 3)
+		sm.buffered_remove(p[(i * 7) % 99]);
+	std::vector<bool> removed(100);
+	for (int i = 0; i < 100; i += 3)
+		removed[(i * 7) % 99] = true;
+
+	const auto stats = sm.clean_buffers();
+	EXPECT_EQ(stats.removed, std::count(removed.begin(), removed.end(), true));
+	EXPECT_EQ(sm.size(), 100 - stats.removed);
+
+	for (int i = 0; i < 100; ++i) {
+		if (removed[i]) {
+			EXPECT_FALSE(sm.is_valid(p[i]));
+		}
+		else {
+			ASSERT_TRUE(sm.is_valid(p[i]));
+			EXPECT_EQ(sm[p[i]], i);
+		}
+	}
+}
+
+TEST(PagedSlotMap, AddRemove)
+{
+	Glare::Paged_slot_map<int, 4> sm {0, 1, 2, 3, 4, 5};
+	auto p = sm.add(6);
+	EXPECT_EQ(sm.size(), 7);
+	EXPECT_EQ(sm.page_count(), 2);
+
+	sm.remove(0);
+	EXPECT_EQ(sm[0], 6);
+	EXPECT_EQ(sm[p], 6);
+
+	sm.buffered_remove(p);
+	auto p2 = sm.buffered_emplace(7);
+	sm.clean_buffers();
+	EXPECT_FALSE(sm.is_valid(p));
+	ASSERT_TRUE(sm.is_valid(p2));
+	EXPECT_EQ(sm[p2], 7);
+
+	int sum {0};
+	for (auto x : sm) sum += x;
+	EXPECT_EQ(sum, 1 + 2 + 3 + 4 + 5 + 7);
+
+	sum = 0;
+	std::size_t count {0};
+	for (std::size_t i = 0; i < sm.page_count(); ++i) {
+		for (auto x : sm.page(i)) sum += x;
+		count += sm.page(i).size();
+	}
+	EXPECT_EQ(count, sm.size());
+	EXPECT_EQ(sum, 1 + 2 + 3 + 4 + 5 + 7);
+}
+
+TEST(PagedSlotMap, StableAddresses)
+{
+	Glare::Paged_slot_map<int, 16> sm;
+	auto p = sm.add(42);
+	const int* address {&sm[p]};
+
+	for (int i = 0; i < 10'000; ++i)
+		sm.buffered_add(i);
+	sm.clean_buffers();
+	for (int i = 0; i < 1000; ++i)
+		sm.add(i);
+
+	EXPECT_EQ(&sm[p], address);
+	EXPECT_EQ(sm[p], 42);
+}
+
+TEST(PagedSlotMap, CopyAndMove)
+{
+	Glare::Paged_slot_map<std::unique_ptr<int>, 2> sm1;
+	auto p = sm1.emplace(new int {1});
+	sm1.emplace(new int {2});
+	sm1.emplace(new int {3});
+
+	auto sm2 = std::move(sm1);
+	ASSERT_TRUE(sm2.is_valid(p));
+	EXPECT_EQ(*sm2[p], 1);
+	EXPECT_EQ(sm2.size(), 3);
+
+	Glare::Paged_slot_map<std::string, 2> sm3 {"a", "b", "c"};
+	auto sm4 = sm3;
+	sm3[0] = "x";
+	EXPECT_EQ(sm4[0], "a");
+	EXPECT_EQ(sm4[2], "c");
+
+	sm4 = sm3;
+	EXPECT_EQ(sm4[0], "x");
+}
+
+TEST(PagedSlotMap, EmplaceDoesNotCopy)
+{
+	Glare::Paged_slot_map<Counted, 2> sm;
+	Counted::reset();
+
+	auto p1 = sm.emplace(1, 2);
+	auto p2 = sm.buffered_emplace(3, 4);
+	sm.emplace(5, 6);
+	sm.remove(p1);
+	sm.clean_buffers();
+
+	EXPECT_EQ(sm[p2].value, 7);
+	EXPECT_EQ(Counted::constructed, 3);
+	EXPECT_EQ(Counted::copied, 0);
+}
@@ -0,0 +1,204 @@
+#include "gtest/gtest.h"
+#include "../glare/snapshot.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+	struct Body {
+		float x, y, z;
+	};
+
+	struct Health {
+		int value;
+	};
+
+	struct Tag {};
+
+	using Manager = Glare::Ecs::Entity_manager<Body, Health, Tag>;
+
+	// a file in the working directory, removed once the test is done
+	struct Temp_file {
+		explicit Temp_file(std::string name) :path {std::move(name)} {}
+		~Temp_file() { std::remove(path.c_str()); }
+		std::string path;
+	};
+}
+
+template<>
+struct Glare::Ecs::Track_changes<Health> : std::true_type {};
+
+TEST(Snapshot, SlotMapRoundTrip)
+{
+	const Temp_file file {"test_snapshot_slot_map.snp"};
+
+	Glare::Slot_map<int> a;
+	Glare::Paged_slot_map<double, 4> b;
+	std::vector<Glare::Slot_map<int>::Stable_index> ha;
+	for (int i = 0; i != 8; ++i)
+		ha.push_back(a.add(i));
+	auto hb = b.add(2.5);
+	b.add(3.5);
+	a.remove(ha[2]);
+	a.remove(ha[5]);
+
+	{
+		Glare::Snapshot::Writer w {file.path};
+		Glare::Snapshot::save(w, a, 1);
+		Glare::Snapshot::save(w, b, 2);
+		w.finish();
+	}
+
+	const Glare::Snapshot::Reader r {file.path};
+	Glare::Slot_map<int> la {100};
+	Glare::Paged_slot_map<double, 4> lb;
+	Glare::Snapshot::load(r, la, 1);
+	Glare::Snapshot::load(r, lb, 2);
+
+	EXPECT_EQ(la.size(), 6);
+	EXPECT_FALSE(la.is_valid(ha[2]));
+	EXPECT_EQ(la[ha[7]], 7);
+	EXPECT_EQ(lb[hb], 2.5);
+
+	// freed slots are handed out in the same order
+	EXPECT_EQ(la.add(8), a.add(8));
+
+	// the wrong type under the key
+	Glare::Slot_map<double> wrong;
+	EXPECT_THROW(Glare::Snapshot::load(r, wrong, 1), Glare::Snapshot::Not_valid);
+	EXPECT_THROW(Glare::Snapshot::load(r, la, 3), Glare::Snapshot::Not_valid);
+}
+
+TEST(Snapshot, PendingChanges)
+{
+	const Temp_file file {"test_snapshot_pending.snp"};
+
+	Glare::Slot_map<int> sm;
+	sm.buffered_add(1);
+	Glare::Snapshot::Writer w {file.path};
+	EXPECT_THROW(Glare::Snapshot::save(w, sm), Glare::Snapshot::Pending_changes);
+
+	sm.clean_buffers();
+	EXPECT_NO_THROW(Glare::Snapshot::save(w, sm));
+}
+
+TEST(Snapshot, View)
+{
+	const Temp_file file {"test_snapshot_view.snp"};
+
+	Glare::Slot_map<int, Glare::Handle_traits<>, Glare::Aos_storage> sm;
+	std::vector<decltype(sm)::Stable_index> h;
+	for (int i = 0; i != 100; ++i)
+		h.push_back(sm.add(i));
+	for (int i = 0; i < 100; i += 3)
+		sm.remove(h[i]);
+
+	{
+		Glare::Snapshot::Writer w {file.path};
+		Glare::Snapshot::save(w, sm);
+		w.finish();
+	}
+
+	const Glare::Snapshot::Reader r {file.path};
+	const Glare::Snapshot::Slot_map_view<decltype(sm)> view {r};
+	EXPECT_EQ(view.size(), sm.size());
+	for (int i = 0; i != 100; ++i) {
+		ASSERT_EQ(view.is_valid(h[i]), i % 3 != 0);
+		if (i % 3) {
+			EXPECT_EQ(view[h[i]], i);
+		}
+	}
+	EXPECT_THROW(view[h[0]], decltype(view)::Not_valid);
+
+	for (std::size_t i = 0; i != view.size(); ++i)
+		ASSERT_EQ(view[view.handle(i)], view.values()[i]);
+}
+
+TEST(Snapshot, EntityManagerRoundTrip)
+{
+	const Temp_file file {"test_snapshot_entities.snp"};
+
+	Manager em;
+	auto a = em.create(Body {1, 2, 3}, Health {10});
+	auto b = em.create(Health {20}, Tag {});
+	auto c = em.create(Body {4, 5, 6});
+	auto d = em.create();
+	em.destroy(d);
+	const auto tick = em.next_tick();
+	em.get<Health>(b).value = 25;
+
+	{
+		Glare::Snapshot::Writer w {file.path};
+		Glare::Snapshot::save(w, em);
+		w.finish();
+	}
+
+	Manager loaded;
+	loaded.create(Body {}, Tag {});
+	Glare::Snapshot::load(Glare::Snapshot::Reader {file.path}, loaded);
+
+	EXPECT_EQ(loaded.size(), 3);
+	EXPECT_FALSE(loaded.is_valid(d));
+	EXPECT_EQ(loaded.get<Body>(a).z, 3);
+	EXPECT_EQ(loaded.get<Health>(b).value, 25);
+	EXPECT_TRUE(loaded.has<Tag>(b));
+	EXPECT_FALSE(loaded.has<Health>(c));
+	EXPECT_EQ(loaded.tick(), tick);
+	EXPECT_EQ(loaded.archetype_count(), em.archetype_count());
+
+	// change ticks came along
+	int changed {0};
+	loaded.view<const Health>().changed<Health>(tick - 1).each([&](const Health& h) {
+		EXPECT_EQ(h.value, 25);
+		++changed;
+	});
+	EXPECT_EQ(changed, 1);
+
+	// and the loaded manager carries on as usual
+	loaded.add<Health>(c, 5);
+	loaded.destroy(a);
+	EXPECT_EQ(loaded.size(), 2);
+	EXPECT_EQ(loaded.get<Health>(c).value, 5);
+}
+
+TEST(Snapshot, Corruption)
+{
+	const Temp_file file {"test_snapshot_corrupt.snp"};
+
+	Glare::Slot_map<int> sm {1, 2, 3};
+	{
+		Glare::Snapshot::Writer w {file.path};
+		Glare::Snapshot::save(w, sm);
+		// not finished
+	}
+	EXPECT_THROW(Glare::Snapshot::Reader {file.path}, Glare::Snapshot::Not_valid);
+
+	{
+		Glare::Snapshot::Writer w {file.path};
+		Glare::Snapshot::save(w, sm);
+		w.finish();
+	}
+
+	// flip a byte in the first blob
+	{
+		std::fstream f {file.path, std::ios::binary | std::ios::in | std::ios::out};
+		f.seekp(Glare::Snapshot::blob_alignment + 4);
+		f.put('\x7f');
+	}
+	EXPECT_THROW(Glare::Snapshot::Reader {file.path}, Glare::Snapshot::Not_valid);
+	EXPECT_NO_THROW(Glare::Snapshot::Reader(file.path, false));
+
+	// a version from the future
+	{
+		std::fstream f {file.path, std::ios::binary | std::ios::in | std::ios::out};
+		const std::uint32_t version {Glare::Snapshot::format_version + 1};
+		f.seekp(offsetof(Glare::Snapshot::Header, version));
+		f.write(reinterpret_cast<const char*>(&version), sizeof version);
+	}
+	EXPECT_THROW(Glare::Snapshot::Reader(file.path, false), Glare::Snapshot::Not_valid);
+
+	EXPECT_THROW(Glare::Snapshot::Reader {"no_such_snapshot.snp"}, Glare::Snapshot::Io_error);
+}
@@ -0,0 +1,206 @@
+#include "gtest/gtest.h"
+#include "../glare/slot_map.hpp"
+#include "../glare/spatial_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using Glare::Math::Aabb;
+using Glare::Math::Mat4;
+using Glare::Math::Ray;
+using Glare::Math::Sphere;
+
+namespace {
+	using Objects = Glare::Slot_map<int>;
+	using Index = Glare::Scene::Spatial_index<Objects::Stable_index>;
+
+	// objects scattered through a world, each knowing its proxy
+	struct World {
+		explicit World(int n, unsigned seed = 1)
+			:rng {seed}
+		{
+			for (int i = 0; i != n; ++i) {
+				const auto b = random_box();
+				const auto h = objects.add(i);
+				bounds.push_back(b);
+				handles.push_back(h);
+				proxies.push_back(index.insert(h, b));
+			}
+		}
+
+		Aabb random_box()
+		{
+			std::uniform_real_distribution<float> position {-100, 100};
+			std::uniform_real_distribution<float> extent {0.1f, 3};
+			Aabb b;
+			for (int i = 0; i != 3; ++i) {
+				b.min[i] = position(rng);
+				b.max[i] = b.min[i] + extent(rng);
+			}
+			return b;
+		}
+
+		// ids of what a query found, sorted
+		template<typename Volume>
+		std::vector<int> query(const Volume& v)
+		{
+			std::vector<Objects::Stable_index> out(objects.size());
+			const auto n = index.query(v, {out.data(), out.size()});
+			std::vector<int> ids;
+			for (std::size_t i = 0; i != n; ++i)
+				ids.push_back(objects[out[i]]);
+			std::sort(ids.begin(), ids.end());
+			return ids;
+		}
+
+		// ids of what passes test, sorted
+		template<typename F>
+		std::vector<int> scan(F test)
+		{
+			std::vector<int> ids;
+			for (std::size_t i = 0; i != bounds.size(); ++i)
+				if (index.is_valid(proxies[i]) && test(bounds[i]))
+					ids.push_back(static_cast<int>(i));
+			return ids;
+		}
+
+		std::mt19937 rng;
+		Objects objects;
+		Index index {0.5f};
+		std::vector<Aabb> bounds;
+		std::vector<Objects::Stable_index> handles;
+		std::vector<Index::Proxy> proxies;
+	};
+
+	bool overlaps(const Aabb& a, const Aabb& b)
+	{
+		for (int i = 0; i != 3; ++i)
+			if (a.max[i] < b.min[i] || a.min[i] > b.max[i])
+				return false;
+		return true;
+	}
+}
+
+TEST(SpatialIndex, InsertMoveRemove)
+{
+	World w {3000};
+	EXPECT_EQ(w.index.size(), 3000);
+	// balanced, a perfect tree of 3000 leaves is 12 high
+	EXPECT_LE(w.index.height(), 24);
+	EXPECT_TRUE(w.index.handle(w.proxies[7]) == w.handles[7]);
+
+	// a nudge stays within the margin, a jump doesn't
+	Aabb b {w.bounds[0]};
+	b.min[0] += 0.2f;
+	b.max[0] += 0.2f;
+	EXPECT_FALSE(w.index.move(w.proxies[0], b));
+	EXPECT_EQ(w.index.bounds(w.proxies[0]).min[0], b.min[0]);
+	w.bounds[0] = b;
+
+	std::uniform_int_distribution<int> pick {0, 2999};
+	for (int step = 0; step != 2000; ++step) {
+		const int i {pick(w.rng)};
+		if (step % 4 == 0) {
+			w.index.remove(w.proxies[i]);
+		} else if (w.index.is_valid(w.proxies[i])) {
+			w.bounds[i] = w.random_box();
+			EXPECT_TRUE(w.index.move(w.proxies[i], w.bounds[i]));
+		}
+	}
+	EXPECT_LE(w.index.height(), 24);
+	EXPECT_LT(w.index.size(), 3000);
+	EXPECT_EQ(w.index.size(), w.scan([](const Aabb&) { return true; }).size());
+
+	const Aabb region {{-30, -30, -30}, {20, 40, 10}};
+	const auto found = w.query(region);
+	EXPECT_EQ(found, w.scan([&](const Aabb& x) { return overlaps(region, x); }));
+	EXPECT_GT(found.size(), 20);
+
+	// rebuilding keeps every proxy, and the tree still changes as before
+	w.index.optimize();
+	EXPECT_EQ(w.query(region), found);
+	EXPECT_LE(w.index.height(), 24);
+	for (std::size_t i = 0; i < w.proxies.size(); i += 7) {
+		if (w.index.is_valid(w.proxies[i])) {
+			EXPECT_TRUE(w.index.handle(w.proxies[i]) == w.handles[i]);
+			w.bounds[i] = w.random_box();
+			w.index.move(w.proxies[i], w.bounds[i]);
+		}
+	}
+	EXPECT_EQ(w.query(region), w.scan([&](const Aabb& x) { return overlaps(region, x); }));
+
+	// removing twice does nothing, moving a removed proxy throws
+	const Index::Proxy gone {w.proxies[pick(w.rng)]};
+	w.index.remove(gone);
+	w.index.remove(gone);
+	EXPECT_FALSE(w.index.is_valid(gone));
+	EXPECT_THROW(w.index.move(gone, region), Index::Not_valid);
+
+	w.index.clear();
+	EXPECT_EQ(w.index.size(), 0);
+	EXPECT_EQ(w.query(region).size(), 0);
+}
+
+TEST(SpatialIndex, Queries)
+{
+	World w {5000, 2};
+
+	const Sphere sphere {{10, -5, 20}, 35};
+	const auto in_sphere = [&](const Aabb& b) {
+		float d {0};
+		for (int i = 0; i != 3; ++i) {
+			const float x {std::max(std::max(b.min[i] - sphere.centre[i], sphere.centre[i] - b.max[i]), 0.0f)};
+			d += x * x;
+		}
+		return d <= sphere.radius * sphere.radius;
+	};
+	EXPECT_EQ(w.query(sphere), w.scan(in_sphere));
+
+	// looking down -z from the edge of the world
+	const Mat4 to_clip {Mat4::perspective(1.0f, 1.5f, 1, 150) * Mat4::translation(0, 0, -100)};
+	const auto frustum = Glare::Math::frustum(to_clip);
+	const auto in_frustum = [&](const Aabb& b) {
+		for (const auto& p : frustum.planes) {
+			float d {p[3]};
+			for (int i = 0; i != 3; ++i)
+				d += p[i] * (p[i] > 0 ? b.max[i] : b.min[i]);
+			if (d < 0)
+				return false;
+		}
+		return true;
+	};
+	const auto visible = w.query(frustum);
+	EXPECT_EQ(visible, w.scan(in_frustum));
+	EXPECT_GT(visible.size(), 200);
+	EXPECT_LT(visible.size(), 5000);
+
+	const Ray ray {{-100, -90, -80}, {1, 0.9f, 0.8f}, 200};
+	const auto on_ray = [&](const Aabb& b) {
+		float entry {0}, exit {ray.max_t};
+		for (int i = 0; i != 3; ++i) {
+			const float lo {(b.min[i] - ray.origin[i]) / ray.direction[i]};
+			const float hi {(b.max[i] - ray.origin[i]) / ray.direction[i]};
+			entry = std::max(entry, std::min(lo, hi));
+			exit = std::min(exit, std::max(lo, hi));
+		}
+		return entry <= exit;
+	};
+	const auto crossed = w.query(ray);
+	EXPECT_EQ(crossed, w.scan(on_ray));
+	EXPECT_GT(crossed.size(), 0);
+}
+
+TEST(SpatialIndex, BufferTooSmall)
+{
+	World w {500, 3};
+	const Aabb everything {{-200, -200, -200}, {200, 200, 200}};
+
+	std::vector<Objects::Stable_index> out(10);
+	EXPECT_EQ(w.index.query(everything, {out.data(), out.size()}), 500);
+	for (const auto h : out)
+		EXPECT_TRUE(w.objects.is_valid(h));
+
+	EXPECT_EQ(w.index.query(everything, {}), 500);
+}
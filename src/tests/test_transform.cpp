@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+#include "../glare/transform.hpp"
+
+#include <vector>
+
+using Glare::Math::Mat4;
+using Hierarchy = Glare::Scene::Transform_hierarchy;
+
+TEST(Mat4, Multiply)
+{
+	const Mat4 t {Mat4::translation(1, 2, 3)};
+	const Mat4 s {Mat4::scale(2, 2, 2)};
+
+	// scale first, then translate
+	const Mat4 ts {t * s};
+	EXPECT_EQ(ts(0, 0), 2);
+	EXPECT_EQ(ts(0, 3), 1);
+	EXPECT_EQ(ts(2, 3), 3);
+
+	// translation is scaled too
+	const Mat4 st {s * t};
+	EXPECT_EQ(st(1, 3), 4);
+	EXPECT_EQ(st(3, 3), 1);
+
+	Mat4 m {t};
+	Glare::Math::multiply(m, m, m); // aliased
+	EXPECT_EQ(m, Mat4::translation(2, 4, 6));
+	EXPECT_EQ(Mat4::identity() * ts, ts);
+}
+
+TEST(TransformHierarchy, Propagation)
+{
+	Hierarchy h;
+	auto root = h.create(Mat4::translation(1, 0, 0));
+	auto child = h.create(Mat4::translation(0, 1, 0), root);
+	auto grandchild = h.create(Mat4::scale(2, 2, 2), child);
+	auto other = h.create(Mat4::translation(0, 0, 5));
+	EXPECT_EQ(h.size(), 4);
+	EXPECT_EQ(h.parent(grandchild), child);
+	EXPECT_EQ(h.parent(root), Hierarchy::Node {});
+
+	h.update();
+	EXPECT_EQ(h.world(child), Mat4::translation(1, 1, 0));
+	EXPECT_EQ(h.world(grandchild), Mat4::translation(1, 1, 0) * Mat4::scale(2, 2, 2));
+	EXPECT_EQ(h.world(other), Mat4::translation(0, 0, 5));
+	EXPECT_TRUE(h.world_changed(grandchild));
+
+	// only the changed subtree is recomputed
+	h.set_local(child, Mat4::translation(0, 3, 0));
+	h.update();
+	EXPECT_FALSE(h.world_changed(root));
+	EXPECT_TRUE(h.world_changed(child));
+	EXPECT_TRUE(h.world_changed(grandchild));
+	EXPECT_FALSE(h.world_changed(other));
+	EXPECT_EQ(h.world(grandchild)(1, 3), 3);
+
+	h.update();
+	EXPECT_FALSE(h.world_changed(grandchild));
+}
+
+TEST(TransformHierarchy, Reparent)
+{
+	Hierarchy h;
+	auto a = h.create(Mat4::translation(1, 0, 0));
+	auto b = h.create(Mat4::translation(10, 0, 0));
+	auto c = h.create(Mat4::translation(0, 1, 0), a);
+	auto d = h.create(Mat4::identity(), c);
+
+	EXPECT_THROW(h.set_parent(a, d), Hierarchy::Cycle);
+	EXPECT_THROW(h.set_parent(c, c), Hierarchy::Cycle);
+
+	h.update();
+	h.set_parent(c, b);
+	h.update();
+	EXPECT_EQ(h.world(d), Mat4::translation(10, 1, 0));
+	EXPECT_FALSE(h.world_changed(a));
+
+	h.set_parent(c, {});
+	h.update();
+	EXPECT_EQ(h.world(d), Mat4::translation(0, 1, 0));
+	EXPECT_EQ(h.parent(c), Hierarchy::Node {});
+}
+
+TEST(TransformHierarchy, Destroy)
+{
+	Hierarchy h;
+	auto a = h.create();
+	auto b = h.create(Mat4::translation(1, 0, 0), a);
+	auto c = h.create(Mat4::translation(0, 1, 0), b);
+	auto d = h.create(Mat4::translation(0, 0, 1), a);
+	auto e = h.create(Mat4::translation(2, 0, 0));
+
+	h.destroy(b);
+	EXPECT_FALSE(h.is_valid(b));
+	EXPECT_FALSE(h.is_valid(c));
+	EXPECT_TRUE(h.is_valid(d));
+	EXPECT_THROW(h.world(c), Hierarchy::Not_valid);
+	EXPECT_THROW(h.set_parent(d, c), Hierarchy::Not_valid);
+	h.destroy(b); // ignored
+	h.destroy(c); // ignored, already destroyed with b
+	EXPECT_EQ(h.size(), 5); // until the next update
+
+	h.update();
+	EXPECT_EQ(h.size(), 3);
+	EXPECT_EQ(h.world(d), Mat4::translation(0, 0, 1));
+	EXPECT_EQ(h.world(e), Mat4::translation(2, 0, 0));
+
+	// several destroyed before the same update
+	auto f = h.create(Mat4::translation(0, 3, 0), e);
+	h.destroy(d);
+	h.destroy(f);
+	h.set_local(e, Mat4::translation(3, 0, 0));
+	h.update();
+	EXPECT_EQ(h.size(), 2);
+	EXPECT_FALSE(h.is_valid(f));
+	EXPECT_EQ(h.world(e), Mat4::translation(3, 0, 0));
+
+	h.destroy(a);
+	h.update();
+	EXPECT_EQ(h.size(), 1);
+	EXPECT_TRUE(h.is_valid(e));
+}
+
+TEST(TransformHierarchy, ParallelUpdate)
+{
+	// chains of nodes under many roots, built out of order
+	Hierarchy serial;
+	Hierarchy parallel;
+	std::vector<Hierarchy::Node> s;
+	std::vector<Hierarchy::Node> p;
+	for (int i = 0; i != 2000; ++i) {
+		const bool root {i % 20 == 0};
+		const Mat4 m {Mat4::translation(static_cast<float>(i % 7), 1, 0)};
+		s.push_back(serial.create(m, root ? Hierarchy::Node {} : s[i - 1 - i % 3 % (i % 20)]));
+		p.push_back(parallel.create(m, root ? Hierarchy::Node {} : p[i - 1 - i % 3 % (i % 20)]));
+	}
+
+	Glare::Utility::Job_system jobs {3};
+	for (int pass = 0; pass != 3; ++pass) {
+		for (int i = pass; i < 2000; i += 37) {
+			serial.set_local(s[i], Mat4::translation(0, static_cast<float>(pass), 0));
+			parallel.set_local(p[i], Mat4::translation(0, static_cast<float>(pass), 0));
+		}
+
+		serial.update();
+		parallel.update(jobs, 50);
+		for (int i = 0; i != 2000; ++i) {
+			ASSERT_EQ(serial.world(s[i]), parallel.world(p[i]));
+			ASSERT_EQ(serial.world_changed(s[i]), parallel.world_changed(p[i]));
+		}
+	}
+}
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+#include "../glare/utility.hpp"
+
+#include <vector>
+
+TEST(Span, Basics)
+{
+	int a[] {1, 2, 3};
+	Glare::Utility::Span<int> s {a, 3};
+	EXPECT_EQ(s.size(), 3);
+	EXPECT_FALSE(s.empty());
+	EXPECT_EQ(s[1], 2);
+
+	int sum {0};
+	for (auto x : s) sum += x;
+	EXPECT_EQ(sum, 6);
+
+	Glare::Utility::Span<int> empty;
+	EXPECT_TRUE(empty.empty());
+}
+
+TEST(FrameArena, AllocateAndReset)
+{
+	Glare::Utility::Frame_arena arena {1024};
+	void* p1 = arena.allocate(10, 1);
+	void* p2 = arena.allocate(16, 16);
+	EXPECT_NE(p1, p2);
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p2) % 16, 0);
+	EXPECT_GE(arena.used(), 26);
+
+	arena.reset();
+	EXPECT_EQ(arena.used(), 0);
+	EXPECT_EQ(arena.allocate(10, 1), p1); // memory is reused after a reset
+}
+
+TEST(FrameArena, Full)
+{
+	Glare::Utility::Frame_arena arena {64};
+	EXPECT_NE(arena.allocate(60, 1), nullptr);
+	EXPECT_THROW(static_cast<void>(arena.allocate(8, 1)), std::bad_alloc);
+
+	arena.reset();
+	EXPECT_NO_THROW(static_cast<void>(arena.allocate(64, 1)));
+}
+
+TEST(FrameArena, PmrVector)
+{
+	Glare::Utility::Frame_arena arena {4096};
+	std::pmr::vector<int> v {&arena};
+	for (int i = 0; i < 100; ++i)
+		v.push_back(i);
+	EXPECT_EQ(v[99], 99);
+	EXPECT_GT(arena.used(), 100 * sizeof(int));
+}
+
+TEST(BlockPool, Reuse)
+{
+	Glare::Utility::Block_pool pool {32, 4};
+	EXPECT_GE(pool.block_size(), 32);
+	EXPECT_EQ(pool.free_blocks(), 4);
+
+	void* p1 = pool.allocate(32);
+	void* p2 = pool.allocate(8);
+	EXPECT_NE(p1, p2);
+	EXPECT_EQ(pool.free_blocks(), 2);
+
+	pool.deallocate(p1, 32);
+	EXPECT_EQ(pool.free_blocks(), 3);
+	EXPECT_EQ(pool.allocate(16), p1);
+}
+
+TEST(BlockPool, Upstream)
+{
+	Glare::Utility::Block_pool pool {16, 1};
+
+	// too large for a block
+	void* big = pool.allocate(64);
+	EXPECT_EQ(pool.free_blocks(), 1);
+	pool.deallocate(big, 64);
+
+	// pool is empty
+	void* p1 = pool.allocate(16);
+	void* p2 = pool.allocate(16);
+	EXPECT_EQ(pool.free_blocks(), 0);
+	pool.deallocate(p2, 16);
+	pool.deallocate(p1, 16);
+	EXPECT_EQ(pool.free_blocks(), 1);
+}
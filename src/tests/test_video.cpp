@@ -0,0 +1,236 @@
+#include "gtest/gtest.h"
+#include "../glare/video.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+using Glare::Math::Mat4;
+using Glare::Video::Rasterizer;
+using Glare::Video::Vertex;
+using Glare::Video::rgba;
+
+namespace {
+	constexpr std::uint32_t black {rgba(0, 0, 0)};
+	constexpr std::uint32_t red {rgba(255, 0, 0)};
+	constexpr std::uint32_t green {rgba(0, 255, 0)};
+
+	void draw(Rasterizer& r, const std::vector<Vertex>& v, const std::vector<std::uint32_t>& i,
+			  const Mat4& to_clip = Mat4::identity())
+	{
+		r.draw({v.data(), v.size()}, {i.data(), i.size()}, to_clip);
+	}
+
+	std::uint32_t pixel(const Rasterizer& r, std::size_t x, std::size_t y)
+	{
+		return r.image()[y * r.width() + x];
+	}
+
+	std::size_t count(const Rasterizer& r, std::uint32_t color)
+	{
+		std::size_t n {0};
+		for (const auto p : r.image())
+			n += p == color;
+		return n;
+	}
+
+	std::vector<Vertex> quad(float x0, float y0, float x1, float y1, float z, std::uint32_t color)
+	{
+		return {{{x0, y0, z}, color}, {{x1, y0, z}, color}, {{x1, y1, z}, color}, {{x0, y1, z}, color}};
+	}
+
+	const std::vector<std::uint32_t> quad_indices {0, 1, 2, 0, 2, 3};
+}
+
+TEST(Rasterizer, FillsAndInterpolates)
+{
+	// not a whole number of tiles either way
+	Rasterizer r {150, 100};
+	const std::vector<Vertex> v {
+		{{-1, -1, 0}, rgba(255, 0, 0)}, {{1, -1, 0}, rgba(255, 0, 0)},
+		{{1, 1, 0}, rgba(0, 0, 255)}, {{-1, 1, 0}, rgba(0, 0, 255)}
+	};
+	draw(r, v, quad_indices);
+	r.render();
+
+	EXPECT_EQ(r.triangle_count(), 2);
+	EXPECT_EQ(count(r, black), 0);
+	// row 0 is the bottom, a vertical blend from red to blue
+	EXPECT_EQ(pixel(r, 75, 0) & 0xff, 254);
+	EXPECT_EQ(pixel(r, 75, 99) >> 16 & 0xff, 254);
+	EXPECT_NEAR(static_cast<int>(pixel(r, 10, 50) & 0xff), 127, 2);
+	EXPECT_EQ(pixel(r, 10, 50) >> 24, 255);
+
+	// each render starts from the clear colour
+	r.set_clear(green);
+	r.render();
+	EXPECT_EQ(count(r, green), 150 * 100);
+}
+
+TEST(Rasterizer, Watertight)
+{
+	// a jittered grid covering the screen, every pixel is covered by exactly
+	// one triangle, drawn one at a time to count
+	constexpr int n {6};
+	std::mt19937 rng {7};
+	std::uniform_real_distribution<float> jitter {-0.12f, 0.12f};
+	std::vector<Vertex> v;
+	for (int y = 0; y <= n; ++y) {
+		for (int x = 0; x <= n; ++x) {
+			const bool edge_x {x == 0 || x == n};
+			const bool edge_y {y == 0 || y == n};
+			v.push_back({{-1 + 2.0f * x / n + (edge_x ? 0 : jitter(rng)), -1 + 2.0f * y / n + (edge_y ? 0 : jitter(rng)), 0},
+						 red});
+		}
+	}
+	std::vector<std::uint32_t> indices;
+	for (std::uint32_t y = 0; y != n; ++y) {
+		for (std::uint32_t x = 0; x != n; ++x) {
+			const std::uint32_t i {y * (n + 1) + x};
+			indices.insert(indices.end(), {i, i + 1, i + n + 2, i, i + n + 2, i + n + 1});
+		}
+	}
+
+	Rasterizer r {131, 77};
+	std::vector<int> covered(131 * 77, 0);
+	for (std::size_t t = 0; t < indices.size(); t += 3) {
+		const std::vector<std::uint32_t> one(indices.begin() + t, indices.begin() + t + 3);
+		draw(r, v, one);
+		r.render();
+		for (std::size_t p = 0; p != covered.size(); ++p)
+			covered[p] += r.image()[p] == red;
+	}
+
+	for (const auto c : covered)
+		ASSERT_EQ(c, 1);
+}
+
+TEST(Rasterizer, DepthAndCulling)
+{
+	Rasterizer r {64, 64};
+	const auto front = quad(-0.5f, -0.5f, 0.5f, 0.5f, -0.5f, green);
+	const auto back = quad(-1, -1, 1, 1, 0.5f, red);
+
+	// nearest wins in either order
+	draw(r, front, quad_indices);
+	draw(r, back, quad_indices);
+	r.render();
+	EXPECT_EQ(pixel(r, 32, 32), green);
+	EXPECT_EQ(pixel(r, 2, 2), red);
+
+	draw(r, back, quad_indices);
+	draw(r, front, quad_indices);
+	r.render();
+	EXPECT_EQ(pixel(r, 32, 32), green);
+
+	// clockwise is a back face
+	const std::vector<std::uint32_t> clockwise {0, 2, 1};
+	draw(r, back, clockwise);
+	r.render();
+	EXPECT_EQ(count(r, red), 64 * 64 / 2 + 32); // the diagonal is its left edge
+
+	r.set_cull_back_faces(true);
+	draw(r, back, clockwise);
+	r.render();
+	EXPECT_EQ(count(r, red), 0);
+	EXPECT_EQ(r.triangle_count(), 0);
+}
+
+TEST(Rasterizer, Clipping)
+{
+	Rasterizer r {128, 64};
+	const Mat4 projection {Mat4::perspective(1.2f, 2, 0.1f, 100)};
+
+	// a floor under the camera reaching behind it, only the lower half of
+	// the screen sees it and nothing goes wrong where it crosses the front plane
+	const std::vector<Vertex> floor {
+		{{-50, -1, 50}, red}, {{50, -1, 50}, red}, {{50, -1, -50}, red}, {{-50, -1, -50}, red}
+	};
+	draw(r, floor, quad_indices, projection);
+	r.render();
+	EXPECT_GT(r.triangle_count(), 2);
+	for (std::size_t x = 0; x != 128; ++x) {
+		EXPECT_EQ(pixel(r, x, 0), red);
+		EXPECT_EQ(pixel(r, x, 63), black);
+	}
+
+	// entirely behind the camera
+	const auto behind = quad(-1, -1, 1, 1, 5, red);
+	draw(r, behind, quad_indices, projection);
+	r.render();
+	EXPECT_EQ(r.triangle_count(), 0);
+	EXPECT_EQ(count(r, red), 0);
+
+	const std::vector<std::uint32_t> bad {0, 1, 4};
+	const auto v = quad(-1, -1, 1, 1, 0, red);
+	EXPECT_THROW(draw(r, v, bad), Glare::Error::Video_index_out_of_range);
+}
+
+TEST(Rasterizer, ParallelMatchesSerial)
+{
+	std::mt19937 rng {3};
+	std::uniform_real_distribution<float> position {-1.5f, 1.5f};
+	std::uniform_int_distribution<int> channel {0, 255};
+	std::vector<Vertex> v;
+	for (int i = 0; i != 900; ++i) {
+		v.push_back({{position(rng), position(rng), position(rng) * 0.6f},
+					 rgba(static_cast<std::uint8_t>(channel(rng)), static_cast<std::uint8_t>(channel(rng)), 0)});
+	}
+	std::vector<std::uint32_t> indices;
+	for (std::uint32_t i = 0; i != 900; ++i)
+		indices.push_back(i);
+
+	Rasterizer serial {300, 200};
+	draw(serial, v, indices);
+	serial.render();
+
+	Glare::Utility::Job_system jobs {3};
+	Rasterizer parallel {300, 200};
+	draw(parallel, v, indices);
+	parallel.render(jobs);
+
+	EXPECT_EQ(parallel.triangle_count(), serial.triangle_count());
+	EXPECT_TRUE(std::equal(serial.image().begin(), serial.image().end(), parallel.image().begin()));
+	EXPECT_LT(count(parallel, black), 300 * 200 / 2);
+}
+
+TEST(Rasterizer, RenderFromSeveralThreads)
+{
+	std::vector<Vertex> v;
+	std::vector<std::uint32_t> indices;
+	for (std::uint32_t i = 0; i != 16; ++i) {
+		const float x {static_cast<float>(i % 4) * 0.5f - 1};
+		const float y {static_cast<float>(i / 4) * 0.5f - 1};
+		const auto q = quad(x, y, x + 0.5f, y + 0.5f, 0, i % 2 ? red : green);
+		for (const auto k : quad_indices)
+			indices.push_back(static_cast<std::uint32_t>(v.size()) + k);
+		v.insert(v.end(), q.begin(), q.end());
+	}
+
+	Rasterizer serial {640, 480};
+	draw(serial, v, indices);
+	serial.render();
+
+	// with no workers, threads waiting on their own renders run
+	// each other's tiles, all sharing the one thread_index
+	Glare::Utility::Job_system jobs {0};
+	std::vector<std::thread> threads;
+	std::vector<int> matches(4, 0);
+	for (std::size_t i = 0; i != matches.size(); ++i) {
+		threads.emplace_back([&, i] {
+			Rasterizer r {640, 480};
+			for (int pass = 0; pass != 20; ++pass) {
+				draw(r, v, indices);
+				r.render(jobs);
+				matches[i] += std::equal(serial.image().begin(), serial.image().end(), r.image().begin());
+			}
+		});
+	}
+	for (auto& t : threads)
+		t.join();
+
+	for (const auto m : matches)
+		EXPECT_EQ(m, 20);
+}